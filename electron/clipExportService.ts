@@ -1,9 +1,10 @@
 import * as path from 'path'
 import * as fs from 'fs'
-import { app } from 'electron'
+import { app, BrowserWindow } from 'electron'
 import { spawn, ChildProcess } from 'child_process'
 import * as net from 'net'
 import { getSetting } from './settings'
+import type { CaptureStats, FrameStreamEvent } from './native-addon'
 
 export interface ClipRange {
   id: string
@@ -57,9 +58,14 @@ export class ClipExportService {
   private netconPort: number
   private tickRate: number = 64
   private tempDir: string
+  private getOverlayWindow: () => BrowserWindow | null
 
-  constructor(netconPort: number = 2121) {
+  /**
+   * @param getOverlayWindow Overlay to hide from native capture while a clip is recorded
+   */
+  constructor(netconPort: number = 2121, getOverlayWindow: () => BrowserWindow | null = () => null) {
     this.netconPort = netconPort
+    this.getOverlayWindow = getOverlayWindow
     this.tempDir = path.join(app.getPath('temp'), `cs2-clip-export-${Date.now()}`)
   }
 
@@ -706,10 +712,6 @@ export class ClipExportService {
     const recordDurationMs = (durationSeconds * 1000) / safePlaybackSpeed + 500 // Add safety buffer
     const framesDirForCs2 = framesDir.replace(/\\/g, '/')
 
-    if (!fs.existsSync(framesDir)) {
-      fs.mkdirSync(framesDir, { recursive: true })
-    }
-
     const commands: string[] = [
       'mirv_streams record stop',
       'mirv_streams settings edit afxDefault screen enabled false',
@@ -726,14 +728,32 @@ export class ClipExportService {
       commands.push(`spec_player ${playerQuoted}`)
     }
 
-    // Configure mirv_streams and start recording image sequence
     commands.push(`demo_timescale ${safePlaybackSpeed}`)
+
+    // Prefer streaming the CS2 window straight into ffmpeg over HLAE image sequences
+    const captureHwnd = await this.findCaptureWindow()
+    if (captureHwnd !== null) {
+      await this.sendCommandsSequentially(commands)
+      await this.recordClipCaptured(captureHwnd, recordDurationMs, clipFilePath, safePlaybackSpeed, safeId)
+      return clipFilePath
+    }
+
+    if (!fs.existsSync(framesDir)) {
+      fs.mkdirSync(framesDir, { recursive: true })
+    }
+
+    // Configure mirv_streams and start recording image sequence
     commands.push('mirv_streams settings edit afxDefault format tga')
     commands.push('mirv_streams settings edit afxDefault screen enabled true')
     commands.push(`mirv_streams settings edit afxDefault screen path "${framesDirForCs2}"`)
     commands.push('mirv_streams record start')
     commands.push('demo_resume')
 
+    // Encode while recording when the addon can stream the frames as they land
+    if (await this.recordClipStreamed(commands, framesDir, recordDurationMs, clipFilePath, safePlaybackSpeed, safeId)) {
+      return clipFilePath
+    }
+
     await this.sendCommandsSequentially(commands)
 
     await new Promise(resolve => setTimeout(resolve, recordDurationMs))
@@ -765,6 +785,163 @@ export class ClipExportService {
     return clipFilePath
   }
 
+  /**
+   * CS2 window to capture natively, or null to record through HLAE
+   * (the default: native capture is opt-in with 'clip_capture' set to 'native';
+   * also null if the addon is not loaded or there is no window yet)
+   */
+  private async findCaptureWindow(): Promise<bigint | null> {
+    if (getSetting('clip_capture', 'hlae') !== 'native') {
+      return null
+    }
+    const addon = await import('./native-addon')
+    if (!addon.isNativeAddonLoaded()) {
+      return null
+    }
+
+    const pids = this.cs2Process?.pid !== undefined ? [this.cs2Process.pid] : []
+    pids.push(...await addon.findProcessIdByNameAsync('cs2.exe'))
+    for (const pid of pids) {
+      const [largest] = await addon.findWindowByPidAsync(pid)
+      if (largest) {
+        return largest.hwnd
+      }
+    }
+    return null
+  }
+
+  /**
+   * Record the paused, positioned demo by capturing the CS2 client area on the GPU
+   * and piping raw frames into ffmpeg while it plays
+   */
+  private async recordClipCaptured(
+    hwnd: bigint,
+    recordDurationMs: number,
+    clipFilePath: string,
+    playbackSpeed: number,
+    safeId: string
+  ): Promise<void> {
+    const { startCapture, stopCapture, forceActivateWindow, setWindowExcludedFromCapture } = await import('./native-addon')
+    const { FfmpegService } = await import('./ffmpegService')
+
+    // Desktop duplication captures whatever is on top, so put CS2 there, minus the overlay
+    forceActivateWindow(hwnd)
+    const overlay = this.getOverlayWindow()
+    const overlayHandle = overlay && !overlay.isDestroyed() ? overlay.getNativeWindowHandle() : null
+    if (overlayHandle) {
+      setWindowExcludedFromCapture(overlayHandle, true)
+    }
+
+    let onEnded: (stats: CaptureStats) => void = () => {}
+    const ended = new Promise<CaptureStats>((resolve) => {
+      onEnded = resolve
+    })
+    // Null also when the desktop is HDR or not 8-bit BGRA
+    const capture = startCapture(hwnd, (stats) => onEnded(stats), { fps: 60 })
+    if (!capture) {
+      if (overlayHandle) {
+        setWindowExcludedFromCapture(overlayHandle, false)
+      }
+      throw new Error(`Recording failed: could not capture the CS2 window for ${safeId}`)
+    }
+
+    const encoding = new FfmpegService().encodeRawVideoPipe(capture, clipFilePath, playbackSpeed)
+    encoding.catch(() => {}) // Awaited below, after the capture has ended
+
+    try {
+      await this.sendCommand('demo_resume')
+      await new Promise(resolve => setTimeout(resolve, recordDurationMs))
+    } finally {
+      stopCapture(capture.id)
+      if (overlayHandle && !overlay?.isDestroyed()) {
+        setWindowExcludedFromCapture(overlayHandle, false)
+      }
+      await this.sendCommandsSequentially(['demo_pause', 'demo_timescale 1.0'])
+    }
+
+    const stats = await ended
+    console.log(
+      `[ClipExport] Captured ${safeId}: ${stats.frames} frames (${stats.repeated} repeated, ${stats.dropped} dropped)`
+    )
+    await encoding
+
+    if (stats.frames === 0) {
+      const reason = stats.error ? ` (${stats.stage} failed, 0x${stats.error.toString(16)})` : ''
+      throw new Error(`Recording failed: no frames captured for ${safeId}${reason}`)
+    }
+  }
+
+  /**
+   * Record through HLAE while the native frame stream hands each finished TGA
+   * frame to ffmpeg and deletes it, so encoding overlaps recording
+   * @returns false, before anything is sent, if the frames folder cannot be streamed
+   */
+  private async recordClipStreamed(
+    commands: string[],
+    framesDir: string,
+    recordDurationMs: number,
+    clipFilePath: string,
+    playbackSpeed: number,
+    safeId: string
+  ): Promise<boolean> {
+    const { startFrameStream, finishFrameStream } = await import('./native-addon')
+    const { FfmpegService } = await import('./ffmpegService')
+
+    type FrameStreamEnded = Extract<FrameStreamEvent, { type: 'ended' }>
+    let onEnded: (event: FrameStreamEnded) => void = () => {}
+    const ended = new Promise<FrameStreamEnded>((resolve) => {
+      onEnded = resolve
+    })
+    const encodings: Promise<string>[] = [] // Started once the first frame gives the format
+    let pipePath = ''
+    const stream = startFrameStream(framesDir, (event) => {
+      if (event.type === 'format') {
+        const encoding = new FfmpegService().encodeRawVideoPipe(
+          { pipePath, width: event.width, height: event.height, fps: 60, pixelFormat: event.pixelFormat },
+          clipFilePath,
+          playbackSpeed
+        )
+        encoding.catch(() => {}) // Awaited below, after the stream has ended
+        encodings.push(encoding)
+      } else {
+        onEnded(event)
+      }
+    })
+    if (!stream) {
+      return false
+    }
+    pipePath = stream.pipePath
+
+    try {
+      await this.sendCommandsSequentially(commands)
+      await new Promise(resolve => setTimeout(resolve, recordDurationMs))
+    } finally {
+      await this.sendCommandsSequentially([
+        'mirv_streams record stop',
+        'demo_pause',
+        'mirv_streams settings edit afxDefault screen enabled false',
+        'demo_timescale 1.0'
+      ])
+      finishFrameStream(stream.id)
+    }
+
+    const result = await ended
+    console.log(`[ClipExport] Streamed ${safeId}: ${result.frames} frames`)
+    await Promise.all(encodings)
+
+    if (result.frames === 0) {
+      const reason = result.error ? ` (${result.stage} failed, error ${result.error})` : ''
+      throw new Error(`Recording failed: no frames captured for ${safeId}${reason}`)
+    }
+
+    try {
+      fs.rmSync(framesDir, { recursive: true, force: true })
+    } catch (cleanupError) {
+      console.warn('[ClipExport] Failed to cleanup clip frames:', cleanupError)
+    }
+    return true
+  }
+
   private getPossibleRecordingDirs(): string[] {
     const cs2Path = getSetting('cs2_path', '')
     if (!cs2Path) return []
@@ -6,19 +6,33 @@
 
 import { BrowserWindow, app } from 'electron'
 import {
-  findWindowByPid,
-  findProcessIdByName,
+  findWindowByPidAsync,
+  waitForWindow,
   getClientBoundsOnScreen,
   isMinimized,
   getDpiScaleForHwnd,
   getForegroundPid,
   forceActivateWindow,
-  startWinEventHook,
+  startWinEventHookBatched,
+  drainWinEvents,
   stopWinEventHook,
+  setOverlayFollow,
+  setOverlayHotkeyWindow,
+  getHookStats,
+  resetHookStats,
   WindowBounds,
   WinEvent,
+  WIN_EVENT_RECORD_STRIDE_UINT32,
+  WIN_EVENT_TYPE_BY_CODE,
+  getWindowStateBlock,
+  readWindowState,
+  WindowStateSnapshot,
+  setResourceGovernor,
+  addSampledProcess,
+  removeSampledProcess,
 } from './native-addon'
 import { overlayHoverController } from './overlayHoverController'
+import { trackOverlaySession, trackProcessResources } from './stats'
 
 export interface TrackingOptions {
   /** Process ID if we already know it (from launching CS2) */
@@ -27,7 +41,7 @@ export interface TrackingOptions {
   processName?: string
   /** Timeout in ms to wait for window (default: 15000) */
   windowTimeout?: number
-  /** Retry interval in ms (default: 200) */
+  /** @deprecated Ignored; the window wait is event-driven */
   retryInterval?: number
 }
 
@@ -36,26 +50,24 @@ interface TrackingState {
   hwnd: bigint | null
   dpiScale: number
   isTracking: boolean
-  pendingBoundsUpdate: NodeJS.Timeout | null
   lastBounds: WindowBounds | null
-  lastUpdateTime: number
   lastLogTime: number | null // Track last time we logged syncBounds to reduce logging overhead
   healthCheckInterval: NodeJS.Timeout | null
   isMoving: boolean
   isCs2Foreground: boolean // Track if CS2 is the foreground window
   cs2Minimized: boolean // Track if CS2 is minimized
+  cs2Cloaked: boolean // CS2 is cloaked (e.g. on another virtual desktop)
   isInteractive: boolean // Track if overlay is interactive (not click-through)
   overlayPid: number | null // Track Electron process PID (for checking if overlay is foreground)
   handoffUntil: number | null // Timestamp until which overlay should stay visible during handoff (ms)
   explicitlyShown: boolean // Track if user explicitly toggled overlay to be shown
-  lastSetBoundsTime: number // Last time we actually called setBounds (to avoid overlay lag during playback)
+  nativeFollow: boolean // Overlay is positioned by the native hook; JS only handles visibility
 }
 
-const UPDATE_THROTTLE_MS = 8 // ~120fps max update rate for smoother tracking
-const UPDATE_THROTTLE_MS_ACTIVE = 16 // 60fps update rate when CS2 is actively rendering - balanced for responsiveness
-// During playback, locationchange fires very frequently; throttle heavily to prevent overlay lag (window doesn't move)
-const LOCATION_CHANGE_THROTTLE_MS = 100 // ~10fps max during active playback (was 33ms → ~30fps)
-const MIN_SETBOUNDS_INTERVAL_MS = 50 // Never call setBounds more than ~20/sec; each call triggers overlay repaint
+// Bounds updates need no JS throttling: the native hook coalesces locationchange
+// bursts and only emits 'boundschanged' when the CS2 client rect really moves
+const EVENT_BATCH_RECORDS = 256 // Records read per drainWinEvents call
+// Polling fallback, only used when the addon can't watch the CS2 process handle
 const HEALTH_CHECK_INTERVAL_MS = 1000 // Check every second if CS2 window still exists
 
 class CS2OverlayTracker {
@@ -64,23 +76,40 @@ class CS2OverlayTracker {
     hwnd: null,
     dpiScale: 1.0,
     isTracking: false,
-    pendingBoundsUpdate: null,
     lastBounds: null,
-    lastUpdateTime: 0,
     lastLogTime: null, // Track last log time to reduce logging overhead
     healthCheckInterval: null,
     isMoving: false,
     isCs2Foreground: false, // Will be set when tracking starts
     cs2Minimized: false,
+    cs2Cloaked: false,
     isInteractive: false, // Track overlay interactive state
     overlayPid: null, // Electron process PID
     handoffUntil: null, // Grace period for overlay-to-CS2 handoff
     explicitlyShown: false, // Track if user explicitly toggled overlay to be shown
-    lastSetBoundsTime: 0,
+    nativeFollow: false,
   }
 
   private overlayWindow: BrowserWindow | null = null
 
+  // Batch event delivery: records are drained into this buffer and decoded into
+  // a reused event object, so event bursts don't allocate per event
+  private eventBuffer = new Uint32Array(EVENT_BATCH_RECORDS * WIN_EVENT_RECORD_STRIDE_UINT32)
+  private scratchEvent: WinEvent = { type: 'foreground', hwnd: 0n, bounds: { x: 0, y: 0, width: 0, height: 0 } }
+  private scratchHwndLo = 0
+  private scratchHwndHi = 0
+
+  // Native window state block, kept current by the hook thread (read as plain memory)
+  private stateBlock: Int32Array | null = getWindowStateBlock()
+  private windowState: WindowStateSnapshot = {
+    valid: false,
+    bounds: { x: 0, y: 0, width: 0, height: 0 },
+    minimized: false,
+    foregroundPid: 0,
+    dpiScale: 1.0,
+    cloaked: false,
+  }
+
   /**
    * Set overlay explicitly shown state (user toggled via hotkey)
    */
@@ -118,11 +147,8 @@ class CS2OverlayTracker {
           console.log('[CS2OverlayTracker] CS2 window force activated successfully')
           // Update foreground state after activation
           setTimeout(() => {
-            const fgPid = getForegroundPid()
+            const fgPid = this.refreshWindowState()
             this.state.isCs2Foreground = fgPid === this.state.pid
-            if (this.state.hwnd) {
-              this.state.cs2Minimized = isMinimized(this.state.hwnd)
-            }
             console.log(`[CS2OverlayTracker] Post-activation state - foreground: ${this.state.isCs2Foreground}, minimized: ${this.state.cs2Minimized}`)
           }, 50)
         } else {
@@ -170,43 +196,21 @@ class CS2OverlayTracker {
 
     const processName = options.processName || 'cs2.exe'
     const windowTimeout = options.windowTimeout || 15000
-    const retryInterval = options.retryInterval || 200
 
     try {
-      // Resolve PID
-      let pid: number | null = null
-
-      if (options.pid) {
-        pid = options.pid
-        console.log(`[CS2OverlayTracker] Using provided PID: ${pid}`)
-      } else {
-        console.log(`[CS2OverlayTracker] Finding process: ${processName}`)
-        pid = findProcessIdByName(processName)
-        if (!pid) {
-          throw new Error(`Process ${processName} not found`)
-        }
-        console.log(`[CS2OverlayTracker] Found PID: ${pid}`)
+      // Resolve PID and main window together; the addon wakes on window
+      // show/title events, so a freshly launched CS2 is picked up immediately
+      const target = options.pid || processName
+      console.log(`[CS2OverlayTracker] Waiting for window of ${options.pid ? `PID ${options.pid}` : processName}`)
+      const found = await waitForWindow(target, windowTimeout)
+      if (!found) {
+        throw new Error(`Window for ${options.pid ? `PID ${options.pid}` : processName} not found within ${windowTimeout}ms`)
       }
 
-      this.state.pid = pid
-
-      // Wait for window to appear
-      const startTime = Date.now()
-      let hwnd: bigint | null = null
-
-      while (Date.now() - startTime < windowTimeout) {
-        hwnd = findWindowByPid(pid)
-        if (hwnd) {
-          console.log(`[CS2OverlayTracker] Found window: ${hwnd.toString(16)}`)
-          break
-        }
-        await new Promise(resolve => setTimeout(resolve, retryInterval))
-      }
-
-      if (!hwnd) {
-        throw new Error(`Window for PID ${pid} not found within ${windowTimeout}ms`)
-      }
+      const { pid, hwnd } = found
+      console.log(`[CS2OverlayTracker] Found window: ${hwnd.toString(16)} (PID ${pid})`)
 
+      this.state.pid = pid
       this.state.hwnd = hwnd
       this.state.dpiScale = getDpiScaleForHwnd(hwnd)
       this.state.overlayPid = process.pid // Store Electron process PID
@@ -218,31 +222,39 @@ class CS2OverlayTracker {
       this.state.cs2Minimized = isMinimized(hwnd)
       console.log(`[CS2OverlayTracker] Initial state - foreground PID: ${fgPid}, CS2 PID: ${pid}, isCs2Foreground: ${this.state.isCs2Foreground}, minimized: ${this.state.cs2Minimized}`)
 
-      // Start WinEvent hook
-      startWinEventHook(pid, (event: WinEvent) => {
-        this.handleWinEvent(event)
-      })
-
-      // Re-check foreground state after a short delay (in case it changed during hook setup)
-      // Also ensures we have the latest state before showing overlay
-      setTimeout(() => {
-        const currentFgPid = getForegroundPid()
-        const wasForeground = this.state.isCs2Foreground
-        this.state.isCs2Foreground = currentFgPid === pid
-        this.state.cs2Minimized = isMinimized(hwnd)
-        console.log(`[CS2OverlayTracker] Post-hook state - foreground PID: ${currentFgPid}, isCs2Foreground: ${this.state.isCs2Foreground}, minimized: ${this.state.cs2Minimized}`)
-        
-        // If foreground state changed or we need to update visibility, sync bounds
-        if (wasForeground !== this.state.isCs2Foreground || this.state.isCs2Foreground) {
-          this.syncBounds()
-        }
-      }, 100)
+      // Start WinEvent hook (native side coalesces location changes for this hwnd
+      // and queues events in a ring buffer that we drain in batches)
+      // The hook also reports 'processexit' the instant CS2 terminates
+      // With overlayPid, focus/minimize state is kept natively and only transitions
+      // arrive (alt-tabbing between other apps never wakes JS); the current state is
+      // delivered as soon as the hook is live
+      const watchingExit = startWinEventHookBatched(pid, () => {
+        this.drainPendingEvents()
+      }, { hwnd, overlayPid: process.pid })
+
+      // Background parsing, encoding and transcription yield to CS2 while it has focus
+      // (and while the overlay above it does)
+      setResourceGovernor(pid, { overlayPid: process.pid })
+      addSampledProcess(pid)
+
+      // Hand overlay positioning to the hook thread (same-frame alignment, no JS per move),
+      // paced to CS2's monitor refresh so drags cost one move per frame;
+      // if unavailable, 'boundschanged' events keep driving setBounds
+      this.state.nativeFollow = setOverlayFollow(overlayWin.getNativeWindowHandle(), { framePaced: true })
+      console.log(`[CS2OverlayTracker] Native overlay follow: ${this.state.nativeFollow}`)
+
+      // The overlay hotkey shows/hides this window from the keyboard hook thread
+      setOverlayHotkeyWindow(overlayWin.getNativeWindowHandle())
 
       // Initial bounds sync (will handle visibility based on foreground/minimized state)
       this.syncBounds()
 
-      // Start health check to verify window/process still exists
-      this.startHealthCheck()
+      // Process exit and destroy of the tracked window are event-driven; only poll
+      // if the addon could not open the process for waiting
+      if (!watchingExit) {
+        console.log('[CS2OverlayTracker] Process exit watch unavailable, falling back to health check')
+        this.startHealthCheck()
+      }
 
       console.log('[CS2OverlayTracker] Tracking started successfully')
     } catch (err) {
@@ -260,18 +272,35 @@ class CS2OverlayTracker {
 
     this.state.isTracking = false
 
-    // Stop WinEvent hook
+    // Log how much hook traffic was handled natively before stopping
+    const hookStats = getHookStats()
+    if (hookStats) {
+      console.log(`[CS2OverlayTracker] Hook stats - raw: ${hookStats.raw}, filtered: ${hookStats.filtered}, coalesced: ${hookStats.coalesced}, delivered: ${hookStats.delivered}, dropped: ${hookStats.dropped}, max queue: ${hookStats.maxQueueDepth}`)
+      if (hookStats.latency) {
+        const { delivery, bounds } = hookStats.latency
+        console.log(`[CS2OverlayTracker] Hook latency - delivery p50/p99/max: ${delivery.p50Us}/${delivery.p99Us}/${delivery.maxUs}us, bounds p50/p99/max: ${bounds.p50Us}/${bounds.p99Us}/${bounds.maxUs}us`)
+      }
+      if (hookStats.raw > 0) {
+        trackOverlaySession(hookStats)
+      }
+    }
+
+    // What CS2 cost over the session (memory, CPU time, I/O)
+    const cs2Usage = removeSampledProcess(this.state.pid ?? undefined)
+    if (cs2Usage) {
+      trackProcessResources('cs2', cs2Usage)
+    }
+
+    // Stop WinEvent hook (also ends native follow) and lift any limits on helpers
+    setOverlayHotkeyWindow(null)
+    setResourceGovernor(0)
     stopWinEventHook()
+    resetHookStats() // Reported above; don't count this session twice
+    this.state.nativeFollow = false
 
     // Stop health check
     this.stopHealthCheck()
 
-    // Clear pending updates
-    if (this.state.pendingBoundsUpdate) {
-      clearTimeout(this.state.pendingBoundsUpdate)
-      this.state.pendingBoundsUpdate = null
-    }
-
     // Hide overlay
     if (overlayWin && !overlayWin.isDestroyed()) {
       overlayWin.hide()
@@ -284,12 +313,51 @@ class CS2OverlayTracker {
     this.state.isMoving = false
     this.state.isCs2Foreground = false
     this.state.cs2Minimized = false
+    this.state.cs2Cloaked = false
     this.state.handoffUntil = null
     this.overlayWindow = null
 
     console.log('[CS2OverlayTracker] Tracking stopped')
   }
 
+  /**
+   * Drain all queued hook event records and dispatch them in order
+   */
+  private drainPendingEvents(): void {
+    const stride = WIN_EVENT_RECORD_STRIDE_UINT32
+    const buffer = this.eventBuffer
+    const event = this.scratchEvent
+    let count = 0
+    do {
+      count = drainWinEvents(buffer)
+      for (let i = 0; i < count && this.state.isTracking; i++) {
+        const base = i * stride
+        const type = WIN_EVENT_TYPE_BY_CODE[buffer[base]]
+        if (!type) {
+          continue
+        }
+        event.type = type
+        // Only rebuild the BigInt when the window changes (almost always the tracked hwnd)
+        if (buffer[base + 1] !== this.scratchHwndLo || buffer[base + 2] !== this.scratchHwndHi) {
+          this.scratchHwndLo = buffer[base + 1]
+          this.scratchHwndHi = buffer[base + 2]
+          event.hwnd = (BigInt(this.scratchHwndHi) << 32n) | BigInt(this.scratchHwndLo)
+        }
+        event.pid = buffer[base + 3]
+        event.timestamp = buffer[base + 4]
+        const bounds = event.bounds!
+        bounds.x = buffer[base + 5] | 0
+        bounds.y = buffer[base + 6] | 0
+        bounds.width = buffer[base + 7] | 0
+        bounds.height = buffer[base + 8] | 0
+        // monitorchanged records carry the DPI in the pid slot and the work area as bounds
+        event.dpi = type === 'monitorchanged' ? buffer[base + 3] : undefined
+        event.workArea = type === 'monitorchanged' ? bounds : undefined
+        this.handleWinEvent(event)
+      }
+    } while (count === EVENT_BATCH_RECORDS && this.state.isTracking)
+  }
+
   /**
    * Handle WinEvent callback
    */
@@ -298,105 +366,39 @@ class CS2OverlayTracker {
       return
     }
 
-    // For foreground events, check PID instead of hwnd
-    if (event.type === 'foreground') {
-      // Check if the foreground window is CS2 or the overlay itself
-      const fgPid = event.pid !== undefined ? event.pid : null
-      const isCs2Foreground = fgPid === this.state.pid
-      const isOverlayForeground = fgPid === this.state.overlayPid
-      const isHovered = overlayHoverController.getHovered()
-      const inHoverGrace = overlayHoverController.isInHoverGracePeriod()
-      const wasForeground = this.state.isCs2Foreground
-      this.state.isCs2Foreground = isCs2Foreground
-      
-      console.log(`[CS2OverlayTracker] Foreground event - PID: ${fgPid}, CS2 PID: ${this.state.pid}, Overlay PID: ${this.state.overlayPid}, isCs2Foreground: ${isCs2Foreground}, isOverlayForeground: ${isOverlayForeground}, isInteractive: ${this.state.isInteractive}, isHovered: ${isHovered}, inHoverGrace: ${inHoverGrace}`)
-      
-      if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
-        // Always update minimized state when we have a window handle
-        if (this.state.hwnd) {
-          this.state.cs2Minimized = isMinimized(this.state.hwnd)
-        }
-        
-        if (isCs2Foreground) {
-          // CS2 became foreground - show overlay if not minimized and not moving
-          if (!this.state.cs2Minimized && !this.state.isMoving) {
-            this.syncBounds()
-            console.log('[CS2OverlayTracker] Overlay shown (CS2 became foreground)')
-          } else {
-            // CS2 is foreground but minimized or moving - hide overlay
-            if (this.overlayWindow.isVisible() && !this.state.explicitlyShown) {
-              this.overlayWindow.hide()
-              console.log(`[CS2OverlayTracker] Overlay hidden (CS2 minimized: ${this.state.cs2Minimized}, moving: ${this.state.isMoving})`)
-            } else if (this.state.explicitlyShown) {
-              console.log('[CS2OverlayTracker] Overlay kept visible (explicitly shown by user, even though CS2 is minimized/moving)')
-            }
-          }
-        } else if (isOverlayForeground) {
-          // Overlay itself became foreground (user clicked on it) - keep it visible
-          // But check if CS2 is minimized - if so, hide overlay unless explicitly shown
-          if (this.state.cs2Minimized && !this.state.explicitlyShown) {
-            if (this.overlayWindow.isVisible()) {
-              this.overlayWindow.hide()
-              console.log('[CS2OverlayTracker] Overlay hidden (CS2 is minimized, overlay lost focus)')
-            }
-          } else {
-            console.log('[CS2OverlayTracker] Overlay kept visible (overlay is foreground)')
-            // Sync bounds to keep it positioned correctly
-            this.syncBounds()
-          }
-        } else {
-          // Another window became foreground (not CS2, not overlay)
-          // Hide overlay if CS2 is minimized OR if not explicitly shown
-          if (this.state.cs2Minimized || !this.state.explicitlyShown) {
-            if (this.overlayWindow.isVisible()) {
-              this.overlayWindow.hide()
-              console.log(`[CS2OverlayTracker] Overlay hidden (another window became foreground, minimized: ${this.state.cs2Minimized}, explicitlyShown: ${this.state.explicitlyShown})`)
-            }
-          } else if (this.state.explicitlyShown && !this.state.cs2Minimized) {
-            console.log('[CS2OverlayTracker] Overlay kept visible (explicitly shown by user, CS2 not minimized)')
-            // Still sync bounds even when another window is foreground if explicitly shown
-            this.syncBounds()
-          }
-        }
-      }
+    // Focus owner transitions from the native state machine (never repeated)
+    if (event.type === 'cs2-focused' || event.type === 'overlay-focused' || event.type === 'lost-focus') {
+      this.handleFocusTransition(event)
       return
     }
 
-    // For other events, verify hwnd matches (except destroy which might have different hwnd)
-    if (event.type !== 'destroy') {
-      if (!this.state.hwnd || event.hwnd !== this.state.hwnd) {
-        return
+    if (event.type === 'processexit') {
+      console.log('[CS2OverlayTracker] CS2 process exited')
+      if (this.overlayWindow) {
+        this.stopTrackingCs2(this.overlayWindow)
       }
+      return
+    }
+
+    // For other events, verify hwnd matches (destroy is already filtered to the tracked hwnd natively)
+    if (!this.state.hwnd || event.hwnd !== this.state.hwnd) {
+      return
     }
 
     switch (event.type) {
-      case 'locationchange':
-        // Regular location change (not during move/resize)
-        // Only update bounds if overlay should be visible (foreground & not minimized)
-        // Locationchange events fire very frequently during active playback, so throttle them more
-        if (!this.state.isMoving && this.state.isCs2Foreground && !this.state.cs2Minimized) {
-          // Throttle locationchange events more aggressively (30fps) to reduce overhead
-          // This is the main source of frequent updates during active playback
-          // But don't block - schedule it so it happens soon, just not every single event
-          const now = Date.now()
-          const timeSinceLastUpdate = now - this.state.lastUpdateTime
-          if (timeSinceLastUpdate >= LOCATION_CHANGE_THROTTLE_MS) {
-            // Enough time has passed, update immediately
-            this.scheduleBoundsUpdate()
-          } else {
-            // Within throttle window - schedule for later, but don't skip entirely
-            // This ensures we still update, just not on every single locationchange event
-            if (!this.state.pendingBoundsUpdate) {
-              this.state.pendingBoundsUpdate = setTimeout(() => {
-                this.state.pendingBoundsUpdate = null
-                this.scheduleBoundsUpdate()
-              }, LOCATION_CHANGE_THROTTLE_MS - timeSinceLastUpdate)
-            }
-          }
+      case 'boundschanged':
+        // CS2 client rect actually changed (already coalesced natively)
+        // The overlay is hidden during move/resize; moveend re-syncs it
+        if (!this.state.isMoving && event.bounds) {
+          this.syncBounds(event.bounds)
         }
         break
 
       case 'movestart':
+        // Natively followed overlays stay aligned while dragging, so keep them up
+        if (this.state.nativeFollow) {
+          break
+        }
         // Hide overlay when movement starts (like Discord)
         this.state.isMoving = true
         if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
@@ -416,7 +418,7 @@ class CS2OverlayTracker {
         }
         break
 
-      case 'minimizestart':
+      case 'minimized':
         this.state.cs2Minimized = true
         if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
           // Always hide overlay when CS2 is minimized, even if explicitly shown
@@ -427,7 +429,7 @@ class CS2OverlayTracker {
         }
         break
 
-      case 'minimizeend':
+      case 'restored':
         this.state.cs2Minimized = false
         if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
           // Only show if CS2 is foreground and not moving
@@ -442,6 +444,33 @@ class CS2OverlayTracker {
         }
         break
 
+      case 'monitorchanged':
+        // CS2 moved to a monitor with another scale (or its scale changed); the
+        // 'boundschanged' that follows is converted to DIP with the new scale
+        if (event.dpi) {
+          this.state.dpiScale = event.dpi / 96
+        }
+        this.state.lastBounds = null
+        console.log(`[CS2OverlayTracker] CS2 monitor changed - DPI scale: ${this.state.dpiScale}, work area: ${event.workArea ? `${event.workArea.width}x${event.workArea.height}` : 'unknown'}`)
+        break
+
+      case 'cloaked':
+        // CS2 is on another virtual desktop (or otherwise cloaked by DWM)
+        this.state.cs2Cloaked = true
+        if (this.overlayWindow && !this.overlayWindow.isDestroyed() && this.overlayWindow.isVisible()) {
+          this.overlayWindow.hide()
+          console.log('[CS2OverlayTracker] Overlay hidden (CS2 cloaked)')
+        }
+        break
+
+      case 'uncloaked':
+        this.state.cs2Cloaked = false
+        if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
+          this.syncBounds()
+          console.log('[CS2OverlayTracker] CS2 uncloaked')
+        }
+        break
+
       case 'destroy':
         console.log('[CS2OverlayTracker] CS2 window destroyed')
         if (this.overlayWindow) {
@@ -452,42 +481,62 @@ class CS2OverlayTracker {
   }
 
   /**
-   * Schedule a bounds update (with coalescing)
+   * Show, hide or keep the overlay when the focus owner changes
+   * (CS2, the overlay itself, or anything else)
    */
-  private scheduleBoundsUpdate(): void {
-    if (this.state.isMoving) {
-      // During movement, update more frequently
-      this.syncBounds()
-      return
-    }
-
-    if (this.state.pendingBoundsUpdate) {
-      return // Already scheduled
-    }
-
-    const now = Date.now()
-    const timeSinceLastUpdate = now - this.state.lastUpdateTime
+  private handleFocusTransition(event: WinEvent): void {
+    const fgPid = event.pid !== undefined ? event.pid : null
+    const isCs2Foreground = event.type === 'cs2-focused'
+    const isOverlayForeground = event.type === 'overlay-focused'
+    const isHovered = overlayHoverController.getHovered()
+    const inHoverGrace = overlayHoverController.isInHoverGracePeriod()
+    const wasForeground = this.state.isCs2Foreground
+    this.state.isCs2Foreground = isCs2Foreground
     
-    // Use slightly slower throttle when CS2 is foreground and actively rendering
-    // But keep it responsive (60fps) - only locationchange events get heavier throttling
-    const throttleMs = this.state.isCs2Foreground && !this.state.cs2Minimized 
-      ? UPDATE_THROTTLE_MS_ACTIVE 
-      : UPDATE_THROTTLE_MS
-
-    const doUpdate = () => {
-      this.state.pendingBoundsUpdate = null
-      this.syncBounds()
-    }
-
-    if (timeSinceLastUpdate >= throttleMs) {
-      // Update immediately
-      doUpdate()
-    } else {
-      // Schedule update
-      this.state.pendingBoundsUpdate = setTimeout(
-        doUpdate,
-        throttleMs - timeSinceLastUpdate
-      )
+    console.log(`[CS2OverlayTracker] Focus ${event.type} - PID: ${fgPid}, CS2 PID: ${this.state.pid}, Overlay PID: ${this.state.overlayPid}, isCs2Foreground: ${isCs2Foreground}, isOverlayForeground: ${isOverlayForeground}, isInteractive: ${this.state.isInteractive}, isHovered: ${isHovered}, inHoverGrace: ${inHoverGrace}`)
+    
+    if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
+      if (isCs2Foreground) {
+        // CS2 became foreground - show overlay if not minimized and not moving
+        if (!this.state.cs2Minimized && !this.state.isMoving) {
+          this.syncBounds()
+          console.log('[CS2OverlayTracker] Overlay shown (CS2 became foreground)')
+        } else {
+          // CS2 is foreground but minimized or moving - hide overlay
+          if (this.overlayWindow.isVisible() && !this.state.explicitlyShown) {
+            this.overlayWindow.hide()
+            console.log(`[CS2OverlayTracker] Overlay hidden (CS2 minimized: ${this.state.cs2Minimized}, moving: ${this.state.isMoving})`)
+          } else if (this.state.explicitlyShown) {
+            console.log('[CS2OverlayTracker] Overlay kept visible (explicitly shown by user, even though CS2 is minimized/moving)')
+          }
+        }
+      } else if (isOverlayForeground) {
+        // Overlay itself became foreground (user clicked on it) - keep it visible
+        // But check if CS2 is minimized - if so, hide overlay unless explicitly shown
+        if (this.state.cs2Minimized && !this.state.explicitlyShown) {
+          if (this.overlayWindow.isVisible()) {
+            this.overlayWindow.hide()
+            console.log('[CS2OverlayTracker] Overlay hidden (CS2 is minimized, overlay lost focus)')
+          }
+        } else {
+          console.log('[CS2OverlayTracker] Overlay kept visible (overlay is foreground)')
+          // Sync bounds to keep it positioned correctly
+          this.syncBounds()
+        }
+      } else {
+        // Another window became foreground (not CS2, not overlay)
+        // Hide overlay if CS2 is minimized OR if not explicitly shown
+        if (this.state.cs2Minimized || !this.state.explicitlyShown) {
+          if (this.overlayWindow.isVisible()) {
+            this.overlayWindow.hide()
+            console.log(`[CS2OverlayTracker] Overlay hidden (another window became foreground, minimized: ${this.state.cs2Minimized}, explicitlyShown: ${this.state.explicitlyShown})`)
+          }
+        } else if (this.state.explicitlyShown && !this.state.cs2Minimized) {
+          console.log('[CS2OverlayTracker] Overlay kept visible (explicitly shown by user, CS2 not minimized)')
+          // Still sync bounds even when another window is foreground if explicitly shown
+          this.syncBounds()
+        }
+      }
     }
   }
 
@@ -497,15 +546,19 @@ class CS2OverlayTracker {
   private startHealthCheck(): void {
     this.stopHealthCheck() // Clear any existing interval
 
-    this.state.healthCheckInterval = setInterval(() => {
+    this.state.healthCheckInterval = setInterval(async () => {
       if (!this.state.isTracking || !this.state.hwnd || !this.state.pid) {
         return
       }
 
       try {
-        // Check if window still exists
-        const currentHwnd = findWindowByPid(this.state.pid)
-        if (!currentHwnd || currentHwnd !== this.state.hwnd) {
+        // Check if window still exists (enumerated off the main thread)
+        const trackedHwnd = this.state.hwnd
+        const windows = await findWindowByPidAsync(this.state.pid)
+        if (!this.state.isTracking || this.state.hwnd !== trackedHwnd) {
+          return // Tracking stopped or restarted while enumerating
+        }
+        if (windows.length === 0 || windows[0].hwnd !== trackedHwnd) {
           console.log('[CS2OverlayTracker] CS2 window lost (health check)')
           if (this.overlayWindow) {
             this.stopTrackingCs2(this.overlayWindow)
@@ -543,20 +596,37 @@ class CS2OverlayTracker {
     }
   }
 
+  /**
+   * Refresh minimized/cloaked state and DPI scale and return the foreground PID.
+   * Reads the native state block when available (no addon calls); falls back
+   * to per-query addon calls otherwise.
+   */
+  private refreshWindowState(): number | null {
+    if (this.stateBlock && readWindowState(this.stateBlock, this.windowState)) {
+      this.state.cs2Minimized = this.windowState.minimized
+      this.state.cs2Cloaked = this.windowState.cloaked
+      this.state.dpiScale = this.windowState.dpiScale
+      return this.windowState.foregroundPid
+    }
+    this.windowState.valid = false
+    if (this.state.hwnd) {
+      this.state.cs2Minimized = isMinimized(this.state.hwnd)
+    }
+    return getForegroundPid()
+  }
+
   /**
    * Sync overlay bounds with CS2 window bounds
+   * @param knownBounds Client bounds from a 'boundschanged' event (skips re-querying the window)
    */
-  private syncBounds(): void {
+  private syncBounds(knownBounds?: WindowBounds): void {
     if (!this.state.hwnd || !this.overlayWindow || this.overlayWindow.isDestroyed()) {
       return
     }
 
     try {
-      // Update minimized state
-      this.state.cs2Minimized = isMinimized(this.state.hwnd)
-      
-      // Re-check foreground state to ensure we have the latest
-      const fgPid = getForegroundPid()
+      // Update minimized state and re-check foreground state to ensure we have the latest
+      const fgPid = this.refreshWindowState()
       this.state.isCs2Foreground = fgPid === this.state.pid
       const isOverlayForeground = fgPid === this.state.overlayPid
       
@@ -570,14 +640,14 @@ class CS2OverlayTracker {
 
       // Check if overlay should be visible
       // Overlay should be shown when:
-      // 1. CS2 is NOT minimized (always hide when minimized, regardless of other conditions)
+      // 1. CS2 is NOT minimized or cloaked (always hide then, regardless of other conditions)
       // AND one of:
       //    - User explicitly toggled it to be shown (via hotkey)
       //    - CS2 is foreground (isCs2Foreground) AND not moving
       //    - Overlay itself is foreground (user clicked on it)
       //    - During handoff grace period (don't require foreground during grace period)
       // Note: We ALWAYS hide overlay if CS2 is minimized, even if explicitly shown
-      const shouldShow = !this.state.cs2Minimized && (
+      const shouldShow = !this.state.cs2Minimized && !this.state.cs2Cloaked && (
         this.state.explicitlyShown ||
         (this.state.isCs2Foreground && !this.state.isMoving) ||
         isOverlayForeground ||
@@ -606,39 +676,27 @@ class CS2OverlayTracker {
         console.log('[CS2OverlayTracker] Overlay shown (CS2 is foreground and not minimized)')
       }
 
+      // The hook thread keeps the overlay on the CS2 client rect itself
+      if (this.state.nativeFollow) {
+        return
+      }
+
       // Get and update bounds
-      const bounds = getClientBoundsOnScreen(this.state.hwnd)
+      const bounds = knownBounds ??
+        (this.windowState.valid ? this.windowState.bounds : getClientBoundsOnScreen(this.state.hwnd))
       if (!bounds) {
         return
       }
 
-      // Check if bounds actually changed (with tolerance to avoid unnecessary updates)
-      // Use larger tolerance during active playback to reduce update frequency and overlay lag
-      const TOLERANCE = this.state.isCs2Foreground && !this.state.cs2Minimized ? 8 : 1
+      // setBounds triggers an overlay repaint, so skip it when nothing moved
       const boundsUnchanged =
         this.state.lastBounds &&
-        Math.abs(this.state.lastBounds.x - bounds.x) < TOLERANCE &&
-        Math.abs(this.state.lastBounds.y - bounds.y) < TOLERANCE &&
-        Math.abs(this.state.lastBounds.width - bounds.width) < TOLERANCE &&
-        Math.abs(this.state.lastBounds.height - bounds.height) < TOLERANCE
+        this.state.lastBounds.x === bounds.x &&
+        this.state.lastBounds.y === bounds.y &&
+        this.state.lastBounds.width === bounds.width &&
+        this.state.lastBounds.height === bounds.height
       if (boundsUnchanged) {
-        return // No significant change
-      }
-
-      // During playback, setBounds triggers overlay repaint; rate-limit to prevent lag
-      const now = Date.now()
-      const timeSinceLastSetBounds = now - this.state.lastSetBoundsTime
-      const bigChange =
-        !this.state.lastBounds ||
-        Math.abs(this.state.lastBounds.x - bounds.x) >= 16 ||
-        Math.abs(this.state.lastBounds.y - bounds.y) >= 16 ||
-        Math.abs(this.state.lastBounds.width - bounds.width) >= 16 ||
-        Math.abs(this.state.lastBounds.height - bounds.height) >= 16
-      if (
-        !bigChange &&
-        timeSinceLastSetBounds < MIN_SETBOUNDS_INTERVAL_MS
-      ) {
-        return // Skip to avoid overlay lag; next throttle cycle will apply
+        return
       }
 
       // Convert to DIP (Electron uses DIP internally)
@@ -650,9 +708,8 @@ class CS2OverlayTracker {
       }
 
       this.overlayWindow.setBounds(dipBounds, false)
-      this.state.lastBounds = bounds
-      this.state.lastUpdateTime = now
-      this.state.lastSetBoundsTime = now
+      // Copy: event bounds come from a reused scratch object
+      this.state.lastBounds = { ...bounds }
 
       // Only log bounds sync occasionally to reduce overhead (reuse shouldLog from above)
       if (shouldLog) {
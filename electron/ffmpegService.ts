@@ -2,6 +2,7 @@ import { spawn } from 'child_process'
 import * as fs from 'fs'
 import * as path from 'path'
 import { getSetting } from './settings'
+import { governProcess } from './native-addon'
 
 export class FfmpegService {
   private ffmpegPath: string
@@ -111,6 +112,7 @@ export class FfmpegService {
       ]
 
       const proc = spawn(this.ffmpegPath, args)
+      governProcess(proc.pid)
       let stderr = ''
 
       proc.stderr?.on('data', (data) => {
@@ -189,6 +191,7 @@ export class FfmpegService {
       console.log('[FFmpeg] Encoding image sequence:', args.join(' '))
 
       const proc = spawn(this.ffmpegPath, args)
+      governProcess(proc.pid)
       let stderr = ''
 
       proc.stderr?.on('data', (data) => {
@@ -209,6 +212,79 @@ export class FfmpegService {
     })
   }
 
+  /**
+   * Encoder arguments for the capture encoder setting ('libx264' unless a
+   * hardware encoder such as h264_nvenc, h264_qsv or h264_amf is configured)
+   */
+  private captureEncoderArgs(): string[] {
+    const encoder = getSetting('capture_video_encoder', 'libx264')
+    switch (encoder) {
+      case 'h264_nvenc':
+        return ['-c:v', encoder, '-preset', 'p4']
+      case 'h264_amf':
+        return ['-c:v', encoder, '-quality', 'speed']
+      default: // libx264, h264_qsv
+        return ['-c:v', encoder, '-preset', 'fast']
+    }
+  }
+
+  /**
+   * Encode raw frames streamed over a named pipe (native startCapture or
+   * startFrameStream) to MP4; pixelFormat defaults to the capture's 'bgra'.
+   * Resolves when the stream closes the pipe and ffmpeg has finished the file.
+   */
+  async encodeRawVideoPipe(
+    input: { pipePath: string; width: number; height: number; fps: number; pixelFormat?: string },
+    outputPath: string,
+    timescale: number = 1
+  ): Promise<string> {
+    return new Promise<string>((resolve, reject) => {
+      // Calculate setpts for speed normalization (same as encodeImageSequence)
+      const setpts = timescale > 1 ? `setpts=${timescale}*PTS` : null
+
+      const args = [
+        '-f', 'rawvideo',
+        '-pix_fmt', input.pixelFormat ?? 'bgra',
+        '-video_size', `${input.width}x${input.height}`,
+        '-framerate', input.fps.toString(),
+        '-i', input.pipePath,
+      ]
+
+      if (setpts) {
+        args.push('-vf', setpts)
+      }
+
+      args.push(
+        ...this.captureEncoderArgs(),
+        '-pix_fmt', 'yuv420p',
+        '-y',
+        outputPath
+      )
+
+      console.log('[FFmpeg] Encoding piped frames:', args.join(' '))
+
+      const proc = spawn(this.ffmpegPath, args)
+      governProcess(proc.pid)
+      let stderr = ''
+
+      proc.stderr?.on('data', (data) => {
+        stderr += data.toString()
+      })
+
+      proc.on('close', (code) => {
+        if (code === 0 && fs.existsSync(outputPath)) {
+          resolve(outputPath)
+        } else {
+          reject(new Error(`ffmpeg pipe encoding failed: ${stderr}`))
+        }
+      })
+
+      proc.on('error', (error) => {
+        reject(new Error(`ffmpeg error: ${error.message}`))
+      })
+    })
+  }
+
   /**
    * Create a montage from multiple clips with fades
    */
@@ -258,6 +334,7 @@ export class FfmpegService {
         console.log('[FFmpeg] Creating montage (no fades):', args.join(' '))
 
         const proc = spawn(this.ffmpegPath, args)
+        governProcess(proc.pid)
         let stderr = ''
 
         proc.stderr?.on('data', (data) => {
@@ -357,6 +434,7 @@ export class FfmpegService {
       console.log('[FFmpeg] Creating montage with fades:', args.join(' '))
 
       const proc = spawn(this.ffmpegPath, args)
+      governProcess(proc.pid)
       let stderr = ''
 
       proc.stderr?.on('data', (data) => {
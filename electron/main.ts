@@ -1,4 +1,4 @@
-import { app, BrowserWindow, dialog, ipcMain, shell, clipboard, protocol, net as electronNet, Menu, globalShortcut, screen } from 'electron'
+import { app, BrowserWindow, dialog, ipcMain, shell, clipboard, protocol, net as electronNet, Menu, globalShortcut, screen, nativeImage } from 'electron'
 import { autoUpdater, UpdateInfo } from 'electron-updater'
 import { spawn, ChildProcess, exec } from 'child_process'
 import * as path from 'path'
@@ -8,11 +8,13 @@ import * as crypto from 'crypto'
 import * as net from 'net'
 import { pathToFileURL } from 'url'
 import { initSettingsDb, getSetting, setSetting, getAllSettings } from './settings'
-import { initStatsDb, incrementStat, incrementMapParseCount, getAllStats, resetStats, trackDemoParsed, trackVoiceExtracted } from './stats'
+import { initStatsDb, incrementStat, incrementMapParseCount, getAllStats, resetStats, trackDemoParsed, trackVoiceExtracted, trackProcessResources } from './stats'
 import * as matchesService from './matchesService'
 
 import { pushCommand, getCommandLog } from './commandLog'
 import { cs2OverlayTracker } from './cs2OverlayTracker'
+import { isNativeAddonLoaded, findProcessIdByNameAsync, computeWaveformPeaks, scanDemos, startDemoWatcher, stopDemoWatcher, startNetconClient, netconSend, setNetconTickInterval, isNetconConnected, stopNetconClient, withMatchDbsClosed, extractVoice, startNdjsonReader, stopNdjsonReader, governProcess, addSampledProcess, removeSampledProcess, acceleratorToHotkeyChord, startOverlayHotkeys, stopOverlayHotkeys } from './native-addon'
+import type { WaveformPeaks, DemoHeader, DemoWatchEvent, NetconEvent, NdjsonRecord, NdjsonReaderEnd } from './native-addon'
 import { overlayHoverController } from './overlayHoverController'
 import { ClipExportService, ExportOptions } from './clipExportService'
 import { HlaeLauncher, HlaeLogger, CS2CommandSender } from './hlaeRecorder'
@@ -384,8 +386,8 @@ function setOverlayInteractiveState(value: boolean) {
   overlayInteractive = value
   
   if (overlayWindow && !overlayWindow.isDestroyed()) {
-    // Make overlay click-through when not interactive
-    overlayWindow.setIgnoreMouseEvents(!value, { forward: true })
+    // Make overlay click-through when not interactive (the native hit test owns the bit when running)
+    overlayHoverController.setInteractiveMode(value)
     // Make overlay non-focusable when not interactive
     overlayWindow.setFocusable(value)
     // Update opacity: click-through (not interactive) = more opaque
@@ -455,7 +457,7 @@ function createOverlayWindow() {
   // Set opacity before any paint so the window never flashes at full opacity
   overlayWindow.setOpacity(overlayInteractive ? 0.85 : 0.95)
 
-  // Set click-through by default
+  // Set click-through by default (the hover controller, and its native hit test, take the window at ready-to-show)
   overlayWindow.setIgnoreMouseEvents(true, { forward: true })
 
   // Load overlay route
@@ -483,6 +485,7 @@ function createOverlayWindow() {
       updateOverlayOpacity(!overlayInteractive)
       overlayWindow.showInactive()
       overlayHoverController.setOverlayWindow(overlayWindow)
+      overlayHoverController.setInteractiveMode(overlayInteractive)
     }
   })
 
@@ -627,6 +630,51 @@ function computeWavAmplitudes(buf: Buffer, numBars: number): { amplitudes: numbe
   return { amplitudes, duration }
 }
 
+/**
+ * Subtract the noise floor (20th percentile of non-silent bars) and apply a gamma
+ * curve so quiet speech stays visible next to shouting. In place.
+ */
+function shapeWaveformAmplitudes(amplitudes: number[], maxRms: number): void {
+  if (maxRms <= 0) return
+  const nonZero = amplitudes.filter(v => v > 0)
+  const sorted = [...nonZero].sort((a, b) => a - b)
+  const noiseFloor = sorted.length > 0 ? sorted[Math.floor((sorted.length - 1) * 0.2)] : 0
+  for (let i = 0; i < amplitudes.length; i++) {
+    const cleaned = Math.max(0, amplitudes[i] - noiseFloor * 0.85)
+    const normed = cleaned > 0 ? cleaned / Math.max(maxRms - noiseFloor * 0.85, 1e-6) : 0
+    amplitudes[i] = normed > 0 ? Math.max(0.08, Math.pow(normed, 0.45)) : 0
+  }
+}
+
+/**
+ * Native version of computeWavAmplitudesFromFile: the addon reads and reduces the
+ * WAV on a worker thread (SIMD min/max/RMS), one level-0 peak per bar.
+ * Returns null when the addon is unavailable or cannot decode the file.
+ */
+async function computeWavAmplitudesNative(
+  filePath: string,
+  numBars: number,
+): Promise<{ amplitudes: number[]; duration: number } | null> {
+  let peaks: WaveformPeaks | null
+  try {
+    peaks = await computeWaveformPeaks(filePath, { peakCount: numBars, levels: 1 })
+  } catch (error) {
+    console.warn('[computeWavAmplitudesNative] Falling back to JS decoder:', error)
+    return null
+  }
+  if (!peaks || peaks.levels.length === 0) return null
+
+  const rms = peaks.levels[0].rms
+  const amplitudes: number[] = new Array(numBars).fill(0)
+  let maxRms = 0
+  for (let i = 0; i < Math.min(numBars, rms.length); i++) {
+    amplitudes[i] = rms[i]
+    if (rms[i] > maxRms) maxRms = rms[i]
+  }
+  shapeWaveformAmplitudes(amplitudes, maxRms)
+  return { amplitudes, duration: peaks.duration }
+}
+
 /**
  * Streaming version of computeWavAmplitudes — reads the file in 256 KB chunks
  * so the entire WAV is never held in memory at once.
@@ -732,16 +780,7 @@ async function computeWavAmplitudesFromFile(
       if (amplitudes[barIdx] > maxRms) maxRms = amplitudes[barIdx]
     }
 
-    if (maxRms > 0) {
-      const nonZero = amplitudes.filter(v => v > 0)
-      const sorted = [...nonZero].sort((a, b) => a - b)
-      const noiseFloor = sorted.length > 0 ? sorted[Math.floor((sorted.length - 1) * 0.2)] : 0
-      for (let i = 0; i < numBars; i++) {
-        const cleaned = Math.max(0, amplitudes[i] - noiseFloor * 0.85)
-        const normed = cleaned > 0 ? cleaned / Math.max(maxRms - noiseFloor * 0.85, 1e-6) : 0
-        amplitudes[i] = normed > 0 ? Math.max(0.08, Math.pow(normed, 0.45)) : 0
-      }
-    }
+    shapeWaveformAmplitudes(amplitudes, maxRms)
 
     console.log(`[computeWavAmplitudesFromFile] bars=${numBars} duration=${duration.toFixed(2)}s maxRms=${maxRms.toFixed(6)}`)
     return { amplitudes, duration }
@@ -920,7 +959,8 @@ app.whenReady().then(async () => {
   ipcMain.handle('voice:computeWaveform', async (_, filePath: string, numBars: number) => {
     try {
       if (!fs.existsSync(filePath)) return { success: false, error: 'Audio file not found' }
-      const result = await computeWavAmplitudesFromFile(filePath, Math.max(1, numBars))
+      const bars = Math.max(1, numBars)
+      const result = (await computeWavAmplitudesNative(filePath, bars)) ?? await computeWavAmplitudesFromFile(filePath, bars)
       return { success: true, ...result }
     } catch (error) {
       console.error('[voice:computeWaveform]', error)
@@ -1056,7 +1096,7 @@ app.whenReady().then(async () => {
   
   // Register hotkey with error handling
   try {
-    const registered = globalShortcut.register(savedHotkey, () => {
+    const registered = registerOverlayHotkey(savedHotkey, () => {
       // Only allow overlay toggle when CS2 is running
       ;(async () => {
         const cs2Running = await isCS2Running()
@@ -1113,7 +1153,7 @@ app.whenReady().then(async () => {
     currentHotkey = defaultHotkey
     setSetting('overlay_hotkey', defaultHotkey)
     try {
-      globalShortcut.register(defaultHotkey, () => {
+      registerOverlayHotkey(defaultHotkey, () => {
         // Only allow overlay toggle when CS2 is running
         ;(async () => {
           const cs2Running = await isCS2Running()
@@ -1442,6 +1482,7 @@ app.on('before-quit', (event) => {
   
   // Unregister all global shortcuts
   globalShortcut.unregisterAll()
+  stopOverlayHotkeys()
   
   // Cleanup any leftover temp voice extraction directories
   cleanupRegisteredVoiceTempDirectories()
@@ -1452,6 +1493,10 @@ app.on('before-quit', (event) => {
     cs2OverlayTracker.stopTrackingCs2(overlayWindow)
   }
   
+  // Stop the native demo folder watcher and netcon client threads
+  stopDemoWatcher()
+  stopNetconClient()
+  
   // Close all windows to ensure renderer processes terminate
   const allWindows = BrowserWindow.getAllWindows()
   console.log(`[App] Closing ${allWindows.length} window(s)`)
@@ -1630,13 +1675,40 @@ function getVoiceExtractorPath(): string {
   }
 }
 
+// Native demo watcher events -> renderer
+function handleDemoWatchEvent(event: DemoWatchEvent) {
+  switch (event.type) {
+    case 'demoready':
+      console.log(`[Watcher] Demo file ready (${event.size} bytes): ${event.path}`)
+      mainWindow?.webContents.send('demos:fileAdded', { filePath: event.path })
+      break
+    case 'demoremoved':
+      console.log(`[Watcher] Demo file unlink: ${event.path}`)
+      mainWindow?.webContents.send('demos:fileRemoved', { filePath: event.path })
+      break
+    case 'overflow':
+      // Changes were dropped, so individual add/remove events can't be trusted
+      console.warn(`[Watcher] Change buffer overflowed for ${event.path}, requesting a rescan`)
+      mainWindow?.webContents.send('demos:rescan', { folderPath: event.path })
+      break
+    case 'error':
+      console.error(`[Watcher] Stopped watching ${event.path} (error ${event.error})`)
+      break
+  }
+}
+
 // Demo folder watcher management
 function setupDemoFolderWatcher(folderPaths: string[]) {
   // Clean up existing watchers
+  stopDemoWatcher()
   for (const watcher of demoFolderWatchers.values()) {
     watcher.close()
   }
   demoFolderWatchers.clear()
+  for (const timer of demoFileDebounce.values()) {
+    clearTimeout(timer)
+  }
+  demoFileDebounce.clear()
   watchedDemoFolders.clear()
   
   if (!folderPaths || folderPaths.length === 0) {
@@ -1660,7 +1732,17 @@ function setupDemoFolderWatcher(folderPaths: string[]) {
   
   console.log(`[Watcher] Setting up demo folder watcher for: ${Array.from(watchedDemoFolders).join(', ')}`)
   
-  // Use native fs.watch for each folder (more compatible with Electron)
+  // Native watcher: reports a demo only after its writer has closed it, so no debounce guessing
+  const nativeWatched = startDemoWatcher(validFolders, handleDemoWatchEvent)
+  if (nativeWatched >= 0) {
+    if (nativeWatched < validFolders.length) {
+      console.warn(`[Watcher] Native watcher could only open ${nativeWatched} of ${validFolders.length} folder(s)`)
+    }
+    console.log(`[Watcher] Successfully initialized native demo folder watcher for ${nativeWatched} folder(s)`)
+    return
+  }
+  
+  // Fallback: fs.watch for each folder with a per-file debounce
   for (const folderPath of validFolders) {
     try {
       const watcher = fs.watch(folderPath, { persistent: true, recursive: false }, (eventType, filename) => {
@@ -1814,16 +1896,18 @@ ipcMain.handle('parser:parse', async (_, { demoPath }: { demoPath: string }) =>
   const dbPath = path.join(matchesDir, `${matchId}.sqlite`)
   const parserPath = getParserPath()
   
-  // Clear old database if it exists (for reparsing)
-  if (fs.existsSync(dbPath)) {
-    try {
-      fs.unlinkSync(dbPath)
-      console.log(`[Parser] Deleted old database at ${dbPath} for fresh parse`)
-    } catch (err) {
-      console.warn(`[Parser] Warning: Failed to delete old database: ${err}`)
-      // Continue anyway, the parser will try to work with the existing database
+  // Clear old database if it exists (for reparsing); pooled readers would keep it open
+  withMatchDbsClosed([dbPath], () => {
+    if (fs.existsSync(dbPath)) {
+      try {
+        fs.unlinkSync(dbPath)
+        console.log(`[Parser] Deleted old database at ${dbPath} for fresh parse`)
+      } catch (err) {
+        console.warn(`[Parser] Warning: Failed to delete old database: ${err}`)
+        // Continue anyway, the parser will try to work with the existing database
+      }
     }
-  }
+  })
   
   // Note: demo_path and created_at_iso will be stored in meta table by the Go parser
   
@@ -1866,13 +1950,76 @@ ipcMain.handle('parser:parse', async (_, { demoPath }: { demoPath: string }) =>
   const useParallel = parallelEnabled && maxParallel > 1
   const processId = useParallel ? matchId : undefined
 
+  const parserLogs: string[] = []
+  let logsRef = parserLogs
+
+  // Log each record, then forward the decoded messages of the whole batch to the
+  // renderer in one IPC message
+  const handleParserRecords = (records: { line?: string; value: any }[]) => {
+    const messages: any[] = []
+    for (const { line, value: json } of records) {
+      if (json?.type === 'log') {
+        logsRef.push(`[${json.level?.toUpperCase() || 'INFO'}] ${json.msg}`)
+      } else if (json?.type === 'progress') {
+        const pctStr = (json.pct * 100).toFixed(1)
+        logsRef.push(`[PROGRESS] ${json.stage}: ${pctStr}% (round ${json.round}, tick ${json.tick})`)
+      } else if (json?.type === 'error') {
+        logsRef.push(`[ERROR] ${json.msg}`)
+      } else if (json == null) {
+        logsRef.push(line ?? '')
+      }
+      if (typeof json?.type === 'string') {
+        messages.push(json)
+      }
+    }
+    if (messages.length > 0) {
+      mainWindow?.webContents.send('parser:messages', processId != null ? { processId, messages } : { messages })
+    }
+  }
+
+  // Decode stdout natively when the addon can: the parser writes into a pipe read
+  // and split on a native thread, progress records superseded before the JS thread
+  // got to them are dropped, and JS gets one batch per turn instead of raw chunks
+  let stdoutFd: number | null = null
+  let resolveReaderEnded = () => {}
+  let readerEnded = new Promise<void>((resolve) => { resolveReaderEnded = resolve })
+  const reader = startNdjsonReader((records: NdjsonRecord[], end?: NdjsonReaderEnd) => {
+    handleParserRecords(records) // Invalid lines keep their text for the parser log
+    if (end) {
+      resolveReaderEnded()
+    }
+  }, { coalesce: ['progress'] })
+  if (reader) {
+    try {
+      stdoutFd = fs.openSync(reader.pipePath, 'w')
+    } catch (err) {
+      console.warn('[Parser] Failed to open NDJSON pipe, reading stdout instead:', err)
+      stopNdjsonReader(reader.id)
+    }
+  }
+  if (stdoutFd == null) {
+    readerEnded = Promise.resolve()
+  }
+
   // Spawn parser process with descriptive name
-  const proc = spawn(parserPath, parserArgs, {
-    env: {
-      ...process.env,
-      PROCESS_NAME: 'CS2 Demo Parser',
-    },
-  })
+  let proc: ChildProcess
+  try {
+    proc = spawn(parserPath, parserArgs, {
+      env: {
+        ...process.env,
+        PROCESS_NAME: 'CS2 Demo Parser',
+      },
+      stdio: stdoutFd != null ? ['ignore', stdoutFd, 'pipe'] : 'pipe',
+    })
+  } finally {
+    // The child holds its own handle; ours would keep the pipe open past its exit
+    if (stdoutFd != null) {
+      fs.closeSync(stdoutFd)
+    }
+  }
+
+  governProcess(proc.pid)
+  addSampledProcess(proc.pid)
 
   if (useParallel) {
     parserJobs.set(matchId, {
@@ -1890,33 +2037,22 @@ ipcMain.handle('parser:parse', async (_, { demoPath }: { demoPath: string }) =>
 
   const parsingStartTime = Date.now()
   const demoDemoSizeBytes = fs.statSync(demoPath).size
-  const parserLogs: string[] = []
-  const logsRef = useParallel ? parserJobs.get(matchId)!.parserLogs : parserLogs
+  logsRef = useParallel ? parserJobs.get(matchId)!.parserLogs : parserLogs
 
   mainWindow?.webContents.send('parser:started', processId != null ? { matchId, demoPath, processId } : { matchId, demoPath })
 
+  // Without the native reader stdout is a regular pipe
   proc.stdout?.on('data', (data: Buffer) => {
     const lines = data.toString().split('\n').filter((line: string) => line.trim())
-    for (const line of lines) {
+    handleParserRecords(lines.map((line: string) => {
+      let json: any = null
       try {
-        const json = JSON.parse(line)
-        if (json.type === 'log') {
-          logsRef.push(`[${json.level?.toUpperCase() || 'INFO'}] ${json.msg}`)
-        } else if (json.type === 'progress') {
-          const pctStr = (json.pct * 100).toFixed(1)
-          logsRef.push(`[PROGRESS] ${json.stage}: ${pctStr}% (round ${json.round}, tick ${json.tick})`)
-        } else if (json.type === 'error') {
-          logsRef.push(`[ERROR] ${json.msg}`)
-        }
+        json = JSON.parse(line)
       } catch {
-        logsRef.push(line)
+        // Logged as the raw line
       }
-      if (processId != null) {
-        mainWindow?.webContents.send('parser:message', { processId, message: line })
-      } else {
-        mainWindow?.webContents.send('parser:message', line)
-      }
-    }
+      return { line, value: json }
+    }))
   })
 
   proc.stderr?.on('data', (data: Buffer) => {
@@ -1932,7 +2068,14 @@ ipcMain.handle('parser:parse', async (_, { demoPath }: { demoPath: string }) =>
   })
 
   proc.on('exit', async (code, signal) => {
+    await readerEnded // The last records are still in flight when the process exits
     const exitLogs = useParallel ? (parserJobs.get(matchId)?.parserLogs ?? []) : parserLogs
+    const usage = removeSampledProcess(proc.pid)
+    if (usage) {
+      const mb = (bytes: number) => (bytes / (1024 * 1024)).toFixed(0)
+      exitLogs.push(`[RESOURCES] cpu ${(usage.cpuTimeMs / 1000).toFixed(1)}s, peak working set ${mb(usage.peakWorkingSetBytes)} MB, read ${mb(usage.readBytes)} MB, written ${mb(usage.writeBytes)} MB`)
+      trackProcessResources('parser', usage)
+    }
     if (useParallel) {
       parserJobs.delete(matchId)
     } else {
@@ -1966,7 +2109,8 @@ ipcMain.handle('parser:parse', async (_, { demoPath }: { demoPath: string }) =>
         
         const data = db.export()
         db.close()
-        fs.writeFileSync(dbPath, Buffer.from(data))
+        // A mapped file cannot be truncated
+        withMatchDbsClosed([dbPath], () => fs.writeFileSync(dbPath, Buffer.from(data)))
       } catch (err) {
         console.error('[Main] Failed to store parser logs:', err)
       }
@@ -2102,6 +2246,9 @@ ipcMain.handle('matches:list', async () => {
   return await matchesService.listMatches()
 })
 
+// Native demo header scans, keyed by path; revalidated against size and mtime
+const demoHeaderCache = new Map<string, DemoHeader>()
+
 ipcMain.handle('demos:getUnparsed', async () => {
   try {
     const appDataPath = app.getPath('userData')
@@ -2113,32 +2260,7 @@ ipcMain.handle('demos:getUnparsed', async () => {
     }
     
     // Get all parsed demo paths from .sqlite files
-    const parsedDemoPaths = new Set<string>()
-    const sqliteFiles = fs.readdirSync(matchesDir).filter(file => file.endsWith('.sqlite'))
-    
-    for (const sqliteFile of sqliteFiles) {
-      const dbPath = path.join(matchesDir, sqliteFile)
-      try {
-        const initSqlJs = require('sql.js')
-        const SQL = await initSqlJs()
-        const buffer = fs.readFileSync(dbPath)
-        const db = new SQL.Database(buffer)
-        
-        // Get demo_path from meta table
-        const metaStmt = db.prepare('SELECT value FROM meta WHERE key = ?')
-        metaStmt.bind(['demo_path'])
-        if (metaStmt.step()) {
-          const demoPaths = metaStmt.get()
-          if (demoPaths && demoPaths[0]) {
-            parsedDemoPaths.add(demoPaths[0])
-          }
-        }
-        metaStmt.free()
-        db.close()
-      } catch (err) {
-        console.error(`Failed to read demo path from ${sqliteFile}:`, err)
-      }
-    }
+    const parsedDemoPaths = await matchesService.getParsedDemoPaths()
     
     // Get demo folders from settings
     const demoFoldersSetting = getSetting('demo_folders', '')
@@ -2153,7 +2275,8 @@ ipcMain.handle('demos:getUnparsed', async () => {
     }
     
     // Scan all demo folders for .dem files
-    const unparsedDemos: Array<{ fileName: string; filePath: string; fileSize: number; createdAt: string }> = []
+    const unparsedDemos: Array<{ fileName: string; filePath: string; fileSize: number; createdAt: string; map?: string; serverName?: string; duration?: number; rounds?: number }> = []
+    const demoMtimes = new Map<string, number>()
     
     for (const demoFolder of demoFolders) {
       try {
@@ -2175,6 +2298,7 @@ ipcMain.handle('demos:getUnparsed', async () => {
               fileSize: stats.size,
               createdAt: stats.birthtime.toISOString(),
             })
+            demoMtimes.set(filePath, stats.mtimeMs)
           } catch (err) {
             console.warn(`Failed to stat demo file ${filePath}:`, err)
           }
@@ -2184,6 +2308,28 @@ ipcMain.handle('demos:getUnparsed', async () => {
       }
     }
     
+    // Header metadata (map, server, duration) for demos that are new or changed since the last scan
+    const staleDemos = unparsedDemos.filter(demo => {
+      const cached = demoHeaderCache.get(demo.filePath)
+      return !cached || cached.size !== demo.fileSize || Math.abs(cached.mtimeMs - (demoMtimes.get(demo.filePath) ?? 0)) >= 1
+    })
+    if (staleDemos.length > 0) {
+      try {
+        const headers = await scanDemos(staleDemos.map(demo => demo.filePath))
+        headers?.forEach((header, i) => demoHeaderCache.set(staleDemos[i].filePath, header))
+      } catch (err) {
+        console.warn('Failed to scan demo headers:', err)
+      }
+    }
+    for (const demo of unparsedDemos) {
+      const header = demoHeaderCache.get(demo.filePath)
+      if (!header || header.error) continue
+      demo.map = header.mapName || undefined
+      demo.serverName = header.serverName || undefined
+      demo.duration = header.playbackTime
+      demo.rounds = header.rounds
+    }
+    
     return unparsedDemos
   } catch (err) {
     console.error('Failed to get unparsed demos:', err)
@@ -3236,7 +3382,7 @@ ipcMain.handle('clips:export', async (event, payload: ExportOptions) => {
     }
 
     const netconPort = parseInt(getSetting('cs2_netconport', '2121'), 10)
-    const exportService = new ClipExportService(netconPort)
+    const exportService = new ClipExportService(netconPort, () => overlayWindow)
 
     // Get output directory from settings or use payload
     const clipsOutputDir = getSetting('clips_output_dir', '')
@@ -4063,7 +4209,9 @@ ipcMain.handle('overlay:create', () => {
 
 ipcMain.handle('overlay:close', () => {
   if (overlayWindow && !overlayWindow.isDestroyed()) {
-    // Make overlay click-through before closing to avoid stealing focus
+    // Make overlay click-through before closing to avoid stealing focus;
+    // the native hit test is stopped first so it cannot flip it back
+    overlayHoverController.setOverlayWindow(null)
     overlayWindow.setIgnoreMouseEvents(true, { forward: true })
     overlayWindow.setFocusable(false)
     // Small delay to ensure focus returns to CS2 before closing
@@ -4112,6 +4260,11 @@ ipcMain.handle('overlay:getHovered', () => {
   return overlayHoverController.getHovered()
 })
 
+// Interactive region rectangles for native hit testing (overlay CSS pixels)
+ipcMain.handle('overlay:interactiveRegions', (_, regions: Array<{ x: number; y: number; width: number; height: number }>, scaleFactor: number) => {
+  overlayHoverController.setInteractiveRegions(regions, scaleFactor)
+})
+
 // Overlay action IPC handlers
 ipcMain.handle('overlay:actions:viewOffender', async () => {
   if (!currentIncident) {
@@ -4515,7 +4668,7 @@ export function sendIncidentToOverlay(incident: {
         // If incident is sent and overlay is not interactive, make it interactive so user can see the events list
         if (incident && !overlayInteractive) {
           overlayInteractive = true
-          overlayWindow.setIgnoreMouseEvents(false, { forward: true })
+          overlayHoverController.setInteractiveMode(true)
           overlayWindow.setFocusable(false) // Don't make it focusable to avoid stealing focus from CS2
           updateOverlayOpacity(false) // Less opaque when interactive
           overlayWindow.webContents.send('overlay:interactiveChanged', true)
@@ -4537,7 +4690,7 @@ export function sendIncidentToOverlay(incident: {
       // If incident is sent and overlay is not interactive, make it interactive so user can see the events list
       if (incident && !overlayInteractive) {
         overlayInteractive = true
-        overlayWindow.setIgnoreMouseEvents(false, { forward: true })
+        overlayHoverController.setInteractiveMode(true)
         overlayWindow.setFocusable(false) // Don't make it focusable to avoid stealing focus from CS2
         updateOverlayOpacity(false) // Less opaque when interactive
         overlayWindow.webContents.send('overlay:interactiveChanged', true)
@@ -4587,6 +4740,42 @@ function exampleSendIncident() {
 // To clear the incident (hide the panel):
 // sendIncidentToOverlay(null)
 
+// Overlay hotkey: on Windows a native low-level keyboard hook matches the chord off the
+// main thread (works over fullscreen CS2) and, while CS2 is tracked, shows/hides the
+// overlay itself; globalShortcut is the fallback
+const OVERLAY_HOTKEY_CHORD_ID = 1
+let nativeOverlayHotkey = false
+
+function registerOverlayHotkey(accelerator: string, onHotkey: () => void): boolean {
+  if (process.platform === 'win32') {
+    const chord = acceleratorToHotkeyChord(accelerator, OVERLAY_HOTKEY_CHORD_ID)
+    const started = chord !== null && startOverlayHotkeys([{ ...chord, toggleOverlay: true }], (event) => {
+      if (event.shown === undefined) {
+        onHotkey() // No overlay handed to the addon yet
+        return
+      }
+      // Already shown or hidden natively; catch the tracker up
+      overlayExplicitlyShown = event.shown
+      cs2OverlayTracker.setOverlayExplicitlyShown(event.shown)
+    })
+    if (started) {
+      nativeOverlayHotkey = true
+      return true
+    }
+  }
+  nativeOverlayHotkey = false
+  return globalShortcut.register(accelerator, onHotkey)
+}
+
+function unregisterOverlayHotkey(accelerator: string): void {
+  if (nativeOverlayHotkey) {
+    stopOverlayHotkeys()
+    nativeOverlayHotkey = false
+  } else {
+    globalShortcut.unregister(accelerator)
+  }
+}
+
 // Hotkey settings IPC handlers
 ipcMain.handle('settings:getHotkey', () => {
   return getSetting('overlay_hotkey', 'CommandOrControl+Shift+O')
@@ -4607,13 +4796,13 @@ ipcMain.handle('settings:setHotkey', (_, accelerator: string) => {
   
   // Unregister old hotkey
   if (oldHotkey) {
-    globalShortcut.unregister(oldHotkey)
+    unregisterOverlayHotkey(oldHotkey)
   }
   
   // Register new hotkey with error handling
   let registered = false
   try {
-    registered = globalShortcut.register(normalizedAccelerator, () => {
+    registered = registerOverlayHotkey(normalizedAccelerator, () => {
       // Create overlay window if it doesn't exist
       if (!overlayWindow || overlayWindow.isDestroyed()) {
         createOverlayWindow()
@@ -4692,11 +4881,11 @@ ipcMain.handle('settings:resetHotkey', async () => {
   
   // Unregister old hotkey
   if (oldHotkey) {
-    globalShortcut.unregister(oldHotkey)
+    unregisterOverlayHotkey(oldHotkey)
   }
   
   // Register default hotkey
-  const registered = globalShortcut.register(defaultHotkey, () => {
+  const registered = registerOverlayHotkey(defaultHotkey, () => {
     // Create overlay window if it doesn't exist
     if (!overlayWindow || overlayWindow.isDestroyed()) {
       createOverlayWindow()
@@ -4756,7 +4945,11 @@ ipcMain.handle('file:showInFolder', async (_, filePath: string) => {
 })
 
 // Helper function to check if CS2 is running
-function isCS2Running(): Promise<boolean> {
+// (native process snapshot off the main thread when available, tasklist otherwise)
+async function isCS2Running(): Promise<boolean> {
+  if (process.platform === 'win32' && isNativeAddonLoaded()) {
+    return (await findProcessIdByNameAsync('cs2.exe')).length > 0
+  }
   return new Promise((resolve) => {
     if (process.platform === 'win32') {
       exec('tasklist /FI "IMAGENAME eq cs2.exe"', (error, stdout) => {
@@ -4775,7 +4968,10 @@ function isCS2Running(): Promise<boolean> {
   })
 }
 
-function isAkrosRunning(): Promise<boolean> {
+async function isAkrosRunning(): Promise<boolean> {
+  if (process.platform === 'win32' && isNativeAddonLoaded()) {
+    return (await findProcessIdByNameAsync('akros.exe')).length > 0
+  }
   return new Promise((resolve) => {
     if (process.platform === 'win32') {
       exec('tasklist /FI "IMAGENAME eq akros.exe"', (error, stdout) => {
@@ -4794,7 +4990,10 @@ function isAkrosRunning(): Promise<boolean> {
   })
 }
 
-function isFaceitRunning(): Promise<boolean> {
+async function isFaceitRunning(): Promise<boolean> {
+  if (process.platform === 'win32' && isNativeAddonLoaded()) {
+    return (await findProcessIdByNameAsync('faceitclient.exe')).length > 0
+  }
   return new Promise((resolve) => {
     if (process.platform === 'win32') {
       exec('tasklist /FI "IMAGENAME eq faceitclient.exe"', (error, stdout) => {
@@ -5273,6 +5472,18 @@ function parseCurrentTickFromDemoGoto(response: string): number | null {
 
 let povPollIntervalId: ReturnType<typeof setInterval> | null = null
 
+// Stop the POV round-skip loop, whether it is interval-polled or fed by netcon ticks
+function stopPOVPolling() {
+  if (povPollIntervalId) {
+    clearInterval(povPollIntervalId)
+    povPollIntervalId = null
+  }
+  if (netconTickListener) {
+    netconTickListener = null
+    setNetconTickInterval(0)
+  }
+}
+
 // CS2 Launch POV: start demo at round 0, spectate player, 2x speed, jump to next round when player dies (or round end).
 ipcMain.handle('cs2:launchPOV', async (
   _,
@@ -5338,10 +5549,67 @@ ipcMain.handle('cs2:launchPOV', async (
     }, 500)
     // Start poll loop: when current tick >= jump tick for current round, go to next round.
     // Track which round we last jumped from so we don't resend the same goto until we've actually moved.
-    if (povPollIntervalId) clearInterval(povPollIntervalId)
+    stopPOVPolling()
     const roundStartTime = Date.now()
     let lastKnownTick = startTick
     let lastJumpedFromRound: number | null = null
+    let specPendingRound: number | null = null // Jumped to this round; spec_player waits for the seek to land
+    const sendPOVCommands = async (commands: string[]) => {
+      if (!(isNetconClientReady(netconPort) && netconSend(commands))) {
+        await sendCS2CommandsSequentially(netconPort, commands)
+      }
+    }
+    // Returns false once playback has passed the last round's jump tick
+    const advancePOV = async (currentTick: number, reassertSpec: boolean): Promise<boolean> => {
+      let currentRound = -1
+      for (let i = 0; i < rounds.length; i++) {
+        if (currentTick >= rounds[i].startTick && currentTick <= rounds[i].endTick) {
+          currentRound = i
+          break
+        }
+      }
+      if (currentRound < 0) return true
+      // A seek swallows commands sent right behind it, so spectate only once a tick
+      // report shows demo_gototick has landed in the round we jumped to
+      if (specPendingRound !== null) {
+        if (currentRound !== specPendingRound) return true
+        specPendingRound = null
+        await sendPOVCommands([`spec_player ${playerNameQuoted}`])
+        reassertSpec = false
+      }
+      // We've moved into a new round; allow jumping again from this round when ready
+      if (lastJumpedFromRound !== null && currentRound !== lastJumpedFromRound) {
+        lastJumpedFromRound = null
+      }
+      const jumpTick = jumpTickByRound[currentRound]
+      if (currentTick >= jumpTick && currentRound + 1 < rounds.length) {
+        if (lastJumpedFromRound === currentRound) return true // already sent jump from this round, wait for seek to complete
+        lastJumpedFromRound = currentRound
+        specPendingRound = currentRound + 1
+        await sendPOVCommands([`demo_gototick ${rounds[currentRound + 1].startTick}`])
+      } else if (currentRound === rounds.length - 1 && currentTick >= jumpTick) {
+        return false
+      } else if (reassertSpec) {
+        // Re-assert spectate target to handle cases where CS2 loses focus after round skip
+        await sendCS2CommandsSequentially(netconPort, [`spec_player ${playerNameQuoted}`])
+      }
+      return true
+    }
+
+    if (isNetconClientReady(netconPort)) {
+      // The native client polls demo_goto itself and pushes tick changes
+      let lastSpecAssert = Date.now()
+      netconTickListener = (tick: number) => {
+        const reassertSpec = Date.now() - lastSpecAssert >= 1500
+        if (reassertSpec) lastSpecAssert = Date.now()
+        advancePOV(tick, reassertSpec)
+          .then(more => { if (!more) stopPOVPolling() })
+          .catch(() => stopPOVPolling())
+      }
+      setNetconTickInterval(parseInt(getSetting('netcon_tick_poll_ms', '250'), 10) || 250)
+      return
+    }
+
     povPollIntervalId = setInterval(async () => {
       try {
         const raw = await sendCS2CommandAndGetResponse(netconPort, 'demo_goto', 1200)
@@ -5351,37 +5619,12 @@ ipcMain.handle('cs2:launchPOV', async (
         }
         // Use parsed tick when available; otherwise lastKnownTick (so user seeks are respected); else time-based estimate
         const currentTick = parsedTick ?? lastKnownTick ?? Math.floor(startTick + (Date.now() - roundStartTime) / 1000 * tickRate * 2)
-        let currentRound = -1
-        for (let i = 0; i < rounds.length; i++) {
-          if (currentTick >= rounds[i].startTick && currentTick <= rounds[i].endTick) {
-            currentRound = i
-            break
-          }
-        }
-        if (currentRound < 0) return
-        // We've moved into a new round; allow jumping again from this round when ready
-        if (lastJumpedFromRound !== null && currentRound !== lastJumpedFromRound) {
-          lastJumpedFromRound = null
-        }
-        const jumpTick = jumpTickByRound[currentRound]
-        if (currentTick >= jumpTick && currentRound + 1 < rounds.length) {
-          if (lastJumpedFromRound === currentRound) return // already sent jump from this round, wait for seek to complete
-          const nextStart = rounds[currentRound + 1].startTick
-          await sendCS2CommandsSequentially(netconPort, [`demo_gototick ${nextStart}`, `spec_player ${playerNameQuoted}`])
-          lastJumpedFromRound = currentRound
-        } else if (currentRound === rounds.length - 1 && currentTick >= jumpTick) {
-          if (povPollIntervalId) clearInterval(povPollIntervalId)
-          povPollIntervalId = null
-        } else {
-          // Re-assert spectate target each interval to handle cases where CS2 loses focus after round skip
-          await sendCS2CommandsSequentially(netconPort, [`spec_player ${playerNameQuoted}`])
+        if (!(await advancePOV(currentTick, true))) {
+          stopPOVPolling()
         }
       } catch {
         // CS2 closed or netcon error: stop polling
-        if (povPollIntervalId) {
-          clearInterval(povPollIntervalId)
-          povPollIntervalId = null
-        }
+        stopPOVPolling()
       }
     }, 1500)
   }
@@ -5479,8 +5722,84 @@ async function sendCS2CommandAndGetResponse(port: number, command: string, respo
   })
 }
 
+// How long CS2 needs to act on a command before the next one is sent
+function netconFollowUpDelayMs(command: string): number {
+  if (command.startsWith('demo_gototick')) return 2000 // Wait for the tick to load
+  if (command.startsWith('playdemo')) return 3000 // Wait for the demo to load
+  if (command.startsWith('demo_pause')) return 300
+  return 500
+}
+
+// Update current demo path when playdemo is sent
+function trackSentPlaydemo(command: string) {
+  if (!command.startsWith('playdemo')) return
+  const demoMatch = command.match(/playdemo\s+["']?([^"']+)["']?/i)
+  if (demoMatch && demoMatch[1]) {
+    currentDemoPath = demoMatch[1]
+    console.log(`[CS2] Updated current demo path: ${currentDemoPath}`)
+  }
+}
+
+// Persistent native netcon connection, shared by command sends and POV tick polling
+let netconClientPort: number | null = null
+let netconTickListener: ((tick: number) => void) | null = null
+
+function handleNetconEvent(event: NetconEvent) {
+  switch (event.type) {
+    case 'connected':
+      console.log(`[netcon] Persistent connection to CS2 on port ${netconClientPort}`)
+      break
+    case 'disconnected':
+      // CS2 closed: a tick-driven POV loop has nothing left to follow
+      console.log('[netcon] Persistent connection closed')
+      stopPOVPolling()
+      break
+    case 'tick':
+      if (event.tick != null) netconTickListener?.(event.tick)
+      break
+    case 'error':
+      console.error(`[netcon] Native client unavailable (error ${event.error})`)
+      break
+  }
+}
+
+// Start (or retarget) the native client; it connects in the background, so callers
+// fall back to a one-off socket until isNetconConnected() turns true
+function ensureNetconClient(port: number) {
+  if (netconClientPort === port) return
+  if (startNetconClient(port, handleNetconEvent)) {
+    netconClientPort = port
+  }
+}
+
+function isNetconClientReady(port: number): boolean {
+  ensureNetconClient(port)
+  return netconClientPort === port && isNetconConnected()
+}
+
 // Function to connect to CS2 netconport and send commands sequentially
 async function sendCS2CommandsSequentially(port: number, commands: string[]): Promise<void> {
+  if (isNetconClientReady(port)) {
+    const debugMode = getSetting('debugMode', 'false') === 'true'
+    for (let i = 0; i < commands.length; i++) {
+      console.log(`[netcon] Sending command ${i + 1}/${commands.length}: ${commands[i]}`)
+      if (debugMode) {
+        pushCommand(commands[i])
+      }
+      if (!netconSend(commands[i].trimEnd())) {
+        throw new Error('Connection closed before all commands were sent')
+      }
+      trackSentPlaydemo(commands[i])
+      if (i + 1 < commands.length) {
+        await new Promise(r => setTimeout(r, netconFollowUpDelayMs(commands[i])))
+      }
+    }
+    if (debugMode) {
+      setTimeout(() => sendCommandLogToOverlay(), 100)
+    }
+    return
+  }
+  
   return new Promise((resolve, reject) => {
     const socket = net.createConnection({ host: '127.0.0.1', port })
     let commandIndex = 0
@@ -5565,29 +5884,9 @@ async function sendCS2CommandsSequentially(port: number, commands: string[]): Pr
         
         commandIndex++
         
-        // Determine delay based on the command type
-        let delay = 500 // Default delay
-        if (commandIndex > 0) {
-          const previousCommand = commands[commandIndex - 1]
-          // If previous command was demo_gototick, wait longer for tick to load
-          if (previousCommand.startsWith('demo_gototick')) {
-            delay = 2000 // 2 seconds delay after demo_gototick
-          }
-          // If previous command was playdemo, wait longer for demo to load
-          else if (previousCommand.startsWith('playdemo')) {
-            delay = 3000 // 3 seconds delay after playdemo
-            // Update current demo path when playdemo is sent
-            const demoMatch = previousCommand.match(/playdemo\s+["']?([^"']+)["']?/i)
-            if (demoMatch && demoMatch[1]) {
-              currentDemoPath = demoMatch[1]
-              console.log(`[CS2] Updated current demo path: ${currentDemoPath}`)
-            }
-          }
-          // If previous command was demo_pause, shorter delay
-          else if (previousCommand.startsWith('demo_pause')) {
-            delay = 300 // 300ms delay after demo_pause
-          }
-        }
+        const previousCommand = commands[commandIndex - 1]
+        const delay = netconFollowUpDelayMs(previousCommand)
+        trackSentPlaydemo(previousCommand)
         
         // Wait a bit before sending next command (CS2 needs time to process)
         if (commandIndex < commands.length) {
@@ -6007,6 +6306,55 @@ ipcMain.handle('voice:extract', async (_, options: { demoPath: string; outputPat
   
   // Get voice extractor path
   const extractorPath = getVoiceExtractorPath()
+
+  // Shared by the native decoder and the extractor: cache, stats, result
+  const finishExtraction = (files: { name: string; path: string }[], durationMs: number) => {
+    // Save to cache if extracting for a single player
+    if (steamIds.length === 1) {
+      try {
+        const cacheKey = generateCacheKey(demoPath, steamIds[0], mode)
+        saveToCache(cacheKey, files.map(f => f.path))
+        
+        // Notify renderer process
+        if (mainWindow) {
+          mainWindow.webContents.send('voice:extractionLog', `[Cache] Saved to cache for future use`)
+        }
+      } catch (cacheError) {
+        console.error(`[Voice Cache] Failed to save to cache:`, cacheError)
+        // Don't fail the extraction if caching fails
+      }
+    }
+    
+    trackVoiceExtracted(durationMs, files.length)
+    
+    // Track voice extraction (legacy counter)
+    incrementStat('total_voices_extracted', files.length)
+    
+    return { success: true, outputPath: outputPath ?? null, files: files.map(f => f.name), filePaths: files.map(f => f.path) }
+  }
+
+  // Decode in-process with the extractor's bundled opus.dll; CS:GO demos and a missing addon fall through
+  if (process.platform === 'win32') {
+    try {
+      const extraction = await extractVoice(demoPath, {
+        outputDirectory: outputPath,
+        mode,
+        steamIds,
+        codecDirectory: path.dirname(extractorPath),
+      })
+      if (extraction) {
+        const files = extraction.files.map(file => ({ name: path.basename(file.path), path: file.path }))
+        const summary = `[Voice Extraction] Decoded ${extraction.messages} voice message(s) into ${files.length} file(s)`
+        console.log(summary)
+        if (mainWindow) {
+          mainWindow.webContents.send('voice:extractionLog', summary)
+        }
+        return finishExtraction(files, extraction.voicedMs)
+      }
+    } catch (error) {
+      console.warn('[Voice Extraction] Native decoding unavailable, using extractor:', error)
+    }
+  }
   
   if (!fs.existsSync(extractorPath)) {
     throw new Error(`Voice extractor not found at: ${extractorPath}. Please install csgo-voice-extractor.`)
@@ -6055,6 +6403,7 @@ ipcMain.handle('voice:extract', async (_, options: { demoPath: string; outputPat
       shell: false,
       windowsHide: true,
     })
+    governProcess(extractorProcess.pid)
     
     let stdout = ''
     let stderr = ''
@@ -6100,30 +6449,8 @@ ipcMain.handle('voice:extract', async (_, options: { demoPath: string; outputPat
           console.log(`[Voice Extraction] stderr was: ${stderr}`)
         }
 
-        // Save to cache if extracting for a single player
-        if (steamIds.length === 1) {
-          try {
-            const cacheKey = generateCacheKey(demoPath, steamIds[0], mode)
-            saveToCache(cacheKey, files.map(f => f.path))
-            
-            // Notify renderer process
-            if (mainWindow) {
-              mainWindow.webContents.send('voice:extractionLog', `[Cache] Saved to cache for future use`)
-            }
-          } catch (cacheError) {
-            console.error(`[Voice Cache] Failed to save to cache:`, cacheError)
-            // Don't fail the extraction if caching fails
-          }
-        }
-        
         // Track voice extraction stats (use file count and assume ~60 seconds per extracted file as estimate)
-        const estimatedDurationMs = files.length * 60000
-        trackVoiceExtracted(estimatedDurationMs, files.length)
-        
-        // Track voice extraction (legacy counter)
-        incrementStat('total_voices_extracted', files.length)
-        
-        resolve({ success: true, outputPath, files: files.map(f => f.name), filePaths: files.map(f => f.path) })
+        resolve(finishExtraction(files, files.length * 60000))
       } else {
         console.error(`[Voice Extraction] Process exited with code ${code}`)
         console.error(`[Voice Extraction] stderr: ${stderr}`)
@@ -6140,6 +6467,48 @@ ipcMain.handle('voice:extract', async (_, options: { demoPath: string; outputPat
   })
 })
 
+// Waveform image style, matching the audiowaveform arguments below
+// (bars 2px wide with a 1px gap, 150px high, amplitude scale 1.8)
+const WAVEFORM_IMAGE_HEIGHT = 150
+const WAVEFORM_BAR_WIDTH = 2
+const WAVEFORM_BAR_STRIDE = 3
+const WAVEFORM_AMPLITUDE_SCALE = 1.8
+const WAVEFORM_BACKGROUND_BGRA = Buffer.from([0x30, 0x2b, 0x28, 0xff]) // #282b30
+const WAVEFORM_BAR_BGRA = Buffer.from([0x2d, 0x7a, 0xd0, 0xff]) // #d07a2d
+
+// Render the bar waveform PNG from native peaks instead of spawning audiowaveform.
+// Returns null when the addon is unavailable or cannot decode the file.
+async function renderWaveformPngNative(filePath: string, width: number): Promise<Buffer | null> {
+  const barCount = Math.max(1, Math.floor(width / WAVEFORM_BAR_STRIDE))
+  let peaks: WaveformPeaks | null
+  try {
+    peaks = await computeWaveformPeaks(filePath, { peakCount: barCount, levels: 1 })
+  } catch (error) {
+    console.warn('[Waveform] Native peaks failed, using audiowaveform:', error)
+    return null
+  }
+  if (!peaks || peaks.levels.length === 0) return null
+
+  const height = WAVEFORM_IMAGE_HEIGHT
+  const bitmap = Buffer.alloc(width * height * 4, WAVEFORM_BACKGROUND_BGRA)
+
+  const levelPeaks = peaks.levels[0].peaks
+  const centerY = height / 2
+  for (let bar = 0; bar < Math.min(barCount, levelPeaks.length / 2); bar++) {
+    const amplitude = Math.max(-levelPeaks[bar * 2], levelPeaks[bar * 2 + 1]) / 32768
+    const halfHeight = Math.min(centerY, Math.max(0.5, amplitude * WAVEFORM_AMPLITUDE_SCALE * centerY))
+    const top = Math.round(centerY - halfHeight)
+    const bottom = Math.round(centerY + halfHeight)
+    for (let y = top; y < bottom; y++) {
+      for (let x = bar * WAVEFORM_BAR_STRIDE; x < Math.min(width, bar * WAVEFORM_BAR_STRIDE + WAVEFORM_BAR_WIDTH); x++) {
+        WAVEFORM_BAR_BGRA.copy(bitmap, (y * width + x) * 4)
+      }
+    }
+  }
+
+  return nativeImage.createFromBitmap(bitmap, { width, height }).toPNG()
+}
+
 // Helper function to read PNG dimensions from buffer
 function getPngDimensions(buffer: Buffer): { width: number; height: number } | null {
   try {
@@ -6166,11 +6535,6 @@ ipcMain.handle('voice:generateWaveform', async (_, filePath: string, audioDurati
       return { success: false, error: 'Audio file not found' }
     }
 
-    const audiowaveformPath = getAudiowaveformPath()
-    if (!fs.existsSync(audiowaveformPath)) {
-      return { success: false, error: `audiowaveform not found at: ${audiowaveformPath}` }
-    }
-
     // Use temp directory for waveform cache (same as voice cache)
     const cacheDir = getVoiceCacheDir()
     const waveformDir = path.join(cacheDir, 'waveforms')
@@ -6219,6 +6583,22 @@ ipcMain.handle('voice:generateWaveform', async (_, filePath: string, audioDurati
         fs.unlinkSync(waveformPath) // corrupt / unreadable — regenerate
       }
 
+      const nativePng = await renderWaveformPngNative(filePath, wideTargetWidth)
+      if (nativePng) {
+        fs.writeFileSync(waveformPath, nativePng)
+        return {
+          success: true,
+          data: `data:image/png;base64,${nativePng.toString('base64')}`,
+          pixelsPerSecond: wideTargetWidth / audioDurationNumber,
+          actualWidth: wideTargetWidth,
+        }
+      }
+
+      const audiowaveformPath = getAudiowaveformPath()
+      if (!fs.existsSync(audiowaveformPath)) {
+        return { success: false, error: `audiowaveform not found at: ${audiowaveformPath}` }
+      }
+
       const wideArgs: string[] = [
         '-i', filePath,
         '-o', waveformPath,
@@ -6300,6 +6680,22 @@ ipcMain.handle('voice:generateWaveform', async (_, filePath: string, audioDurati
       fs.unlinkSync(waveformPath)
     }
 
+    const nativePng = await renderWaveformPngNative(filePath, targetWidth)
+    if (nativePng) {
+      fs.writeFileSync(waveformPath, nativePng)
+      return {
+        success: true,
+        data: `data:image/png;base64,${nativePng.toString('base64')}`,
+        pixelsPerSecond,
+        actualWidth: targetWidth,
+      }
+    }
+
+    const audiowaveformPath = getAudiowaveformPath()
+    if (!fs.existsSync(audiowaveformPath)) {
+      return { success: false, error: `audiowaveform not found at: ${audiowaveformPath}` }
+    }
+
     const args: string[] = [
       '-i', filePath,
       '-o', waveformPath,
@@ -3,6 +3,8 @@ import * as fs from 'fs'
 import * as fsPromises from 'fs/promises'
 import { app } from 'electron'
 import { getSetting } from './settings'
+import { isMatchDbAvailable, queryMatchDb, queryMatchDbs, closeMatchDbs, matchDbRows } from './native-addon'
+import type { MatchDbBatchResult, MatchDbQuery, MatchDbResult } from './native-addon'
 
 const initSqlJs = require('sql.js')
 const LIST_MATCHES_BATCH_SIZE = 10
@@ -152,6 +154,41 @@ async function checkDbIntegrity(dbPath: string): Promise<{ isOrphan: boolean; de
   return { isOrphan, demoPath, isCorrupt: false }
 }
 
+/**
+ * Demo path from the results of DEMO_PATH_QUERIES (meta first, then matches.demo_path)
+ */
+function demoPathFromResults(meta: MatchDbResult | { error: string }, match: MatchDbResult | { error: string }): string | null {
+  if (!('error' in meta) && meta.rowCount > 0) {
+    return (meta.values[0][0] as string) || null
+  }
+  if (!('error' in match) && match.rowCount > 0) {
+    return (match.values[0][0] as string) || null
+  }
+  return null
+}
+
+const DEMO_PATH_QUERIES: MatchDbQuery[] = [
+  { sql: 'SELECT value FROM meta WHERE key = ?', params: ['demo_path'] },
+  { sql: 'SELECT demo_path FROM matches LIMIT 1' },
+]
+
+/**
+ * checkDbIntegrity for many databases at once through the native reader
+ */
+async function checkDbIntegrityBatch(dbPaths: string[]): Promise<Array<{ isOrphan: boolean; demoPath: string | null; isCorrupt: boolean }>> {
+  const batches = await queryMatchDbs(dbPaths.map((dbPath) => ({ path: dbPath, queries: DEMO_PATH_QUERIES }))) ?? []
+  return batches.map((batch) => {
+    // A file that is not a database opens fine and fails its first query
+    const failed = batch.error ?? batch.results.map((result) => ('error' in result ? result.error : '')).find((error) => /not a database|malformed/.test(error))
+    if (failed) {
+      console.error(`Database ${batch.path} is corrupt or unreadable:`, failed)
+      return { isOrphan: true, demoPath: null, isCorrupt: true }
+    }
+    const demoPath = demoPathFromResults(batch.results[0], batch.results[1])
+    return { isOrphan: !demoPath || !fs.existsSync(demoPath), demoPath, isCorrupt: false }
+  })
+}
+
 /**
  * Perform startup integrity check
  * Returns list of orphaned/corrupt databases that were deleted
@@ -164,16 +201,19 @@ export async function performStartupIntegrityCheck(): Promise<Array<{ matchId: s
     return deleted
   }
   
-  const files = fs.readdirSync(matchesDir)
+  const files = fs.readdirSync(matchesDir).filter((f) => f.endsWith('.sqlite'))
   const autoCleanup = getSetting('auto_cleanup_missing_demos', 'true') === 'true'
+  const dbPaths = files.map((file) => path.join(matchesDir, file))
+  const integrity = isMatchDbAvailable() ? await checkDbIntegrityBatch(dbPaths) : null
+  // Pooled connections would keep the files from being deleted
+  closeMatchDbs(dbPaths)
   
-  for (const file of files) {
-    if (!file.endsWith('.sqlite')) continue
-    
+  for (let i = 0; i < files.length; i++) {
+    const file = files[i]
     const matchId = path.basename(file, '.sqlite')
-    const dbPath = path.join(matchesDir, file)
+    const dbPath = dbPaths[i]
     
-    const { isOrphan, isCorrupt } = await checkDbIntegrity(dbPath)
+    const { isOrphan, isCorrupt } = integrity ? integrity[i] : await checkDbIntegrity(dbPath)
     
     if (isCorrupt) {
       // Always delete corrupt databases
@@ -199,6 +239,92 @@ export async function performStartupIntegrityCheck(): Promise<Array<{ matchId: s
   return deleted
 }
 
+interface MatchMeta {
+  demoPath: string | null
+  createdAtIso: string | null
+  buildNum: number | null
+}
+
+function applyMetaRow(meta: MatchMeta, key: string, value: string): void {
+  if (key === 'demo_path') meta.demoPath = value || null
+  if (key === 'created_at_iso') meta.createdAtIso = value || null
+  if (key === 'build_num') {
+    const parsed = parseInt(value, 10)
+    if (!isNaN(parsed) && parsed > 0) meta.buildNum = parsed
+  }
+}
+
+function toMatchInfo(
+  matchId: string,
+  meta: MatchMeta,
+  matchResult: { map: any; started_at: any; source: string | null },
+  playerCount: number
+): MatchInfo {
+  const isMissingDemo = !meta.demoPath || !fs.existsSync(meta.demoPath)
+  return {
+    id: matchId,
+    map: matchResult.map || matchId,
+    startedAt: matchResult.started_at || null,
+    playerCount: playerCount || 0,
+    demoPath: meta.demoPath || null,
+    isMissingDemo,
+    createdAtIso: meta.createdAtIso || null,
+    source: matchResult.source,
+    buildNum: meta.buildNum,
+  }
+}
+
+/**
+ * Queries behind one MatchInfo, run natively for every match in one batch.
+ * The second and last are fallbacks for databases without a meta table or matches.source.
+ */
+function matchInfoQueries(matchId: string): MatchDbQuery[] {
+  return [
+    { sql: 'SELECT key, value FROM meta WHERE key IN (?, ?, ?)', params: ['demo_path', 'created_at_iso', 'build_num'] },
+    { sql: 'SELECT demo_path FROM matches LIMIT 1' },
+    { sql: 'SELECT COUNT(*) FROM players WHERE match_id = ?', params: [matchId] },
+    { sql: 'SELECT map, started_at, source FROM matches WHERE id = ?', params: [matchId] },
+    { sql: 'SELECT map, started_at FROM matches WHERE id = ?', params: [matchId] },
+  ]
+}
+
+/**
+ * MatchInfo from the results of matchInfoQueries, with the same fallbacks as loadOneMatchInfo
+ */
+function matchInfoFromBatch(matchId: string, batch: MatchDbBatchResult): MatchInfo | null {
+  const [metaResult, demoPathResult, playerResult, matchQuery, matchQueryWithoutSource] = batch.results
+  const failure = batch.error ?? ('error' in playerResult ? playerResult.error : null)
+  if (failure) {
+    console.error(`Failed to read match ${matchId}:`, failure)
+    return null
+  }
+
+  const meta: MatchMeta = { demoPath: null, createdAtIso: null, buildNum: null }
+  if (!('error' in metaResult)) {
+    for (const row of matchDbRows(metaResult)) {
+      applyMetaRow(meta, row[0], row[1])
+    }
+  } else {
+    meta.demoPath = demoPathFromResults(metaResult, demoPathResult)
+  }
+
+  let matchResult: { map: any; started_at: any; source: string | null } | null = null
+  if (!('error' in matchQuery)) {
+    const row = matchDbRows(matchQuery)[0]
+    if (row) matchResult = { map: row[0], started_at: row[1], source: row[2] || null }
+  } else if (matchQuery.error.includes('no such column: source') && !('error' in matchQueryWithoutSource)) {
+    const row = matchDbRows(matchQueryWithoutSource)[0]
+    if (row) matchResult = { map: row[0], started_at: row[1], source: null }
+  } else {
+    console.error(`Failed to read match ${matchId}:`, matchQuery.error)
+    return null
+  }
+
+  if (!matchResult) return null
+
+  return toMatchInfo(matchId, meta, matchResult, playerResult.rowCount > 0 ? (playerResult.values[0][0] as number) : 0)
+}
+
 /**
  * Load one match's info from a db file (single read, single DB open). Used by listMatches in parallel.
  */
@@ -211,20 +337,13 @@ async function loadOneMatchInfo(
     const buffer = await fsPromises.readFile(dbPath)
     const db = new SQL.Database(buffer)
 
-    let demoPath: string | null = null
-    let createdAtIso: string | null = null
-    let buildNum: number | null = null
+    const meta: MatchMeta = { demoPath: null, createdAtIso: null, buildNum: null }
     try {
       const metaStmt = db.prepare('SELECT key, value FROM meta WHERE key IN (?, ?, ?)')
       metaStmt.bind(['demo_path', 'created_at_iso', 'build_num'])
       while (metaStmt.step()) {
         const row = metaStmt.get()
-        if (row[0] === 'demo_path') demoPath = row[1] || null
-        if (row[0] === 'created_at_iso') createdAtIso = row[1] || null
-        if (row[0] === 'build_num') {
-          const parsed = parseInt(row[1], 10)
-          if (!isNaN(parsed) && parsed > 0) buildNum = parsed
-        }
+        applyMetaRow(meta, row[0], row[1])
       }
       metaStmt.free()
     } catch {
@@ -233,7 +352,7 @@ async function loadOneMatchInfo(
         const matchStmt = db.prepare('SELECT demo_path FROM matches LIMIT 1')
         if (matchStmt.step()) {
           const o = matchStmt.getAsObject()
-          demoPath = (o as any).demo_path || null
+          meta.demoPath = (o as any).demo_path || null
         }
         matchStmt.free()
       } catch {
@@ -277,18 +396,7 @@ async function loadOneMatchInfo(
 
     if (!matchResult) return null
 
-    const isMissingDemo = !demoPath || !fs.existsSync(demoPath)
-    return {
-      id: matchId,
-      map: matchResult.map || matchId,
-      startedAt: matchResult.started_at || null,
-      playerCount: playerCount || 0,
-      demoPath: demoPath || null,
-      isMissingDemo,
-      createdAtIso: createdAtIso || null,
-      source: matchResult.source,
-      buildNum,
-    }
+    return toMatchInfo(matchId, meta, matchResult, playerCount)
   } catch (err) {
     console.error(`Failed to read match ${matchId}:`, err)
     return null
@@ -308,9 +416,20 @@ export async function listMatches(): Promise<MatchInfo[]> {
   const files = fs.readdirSync(matchesDir).filter((f) => f.endsWith('.sqlite'))
   if (files.length === 0) return []
 
-  const SQL = await initSqlJs()
   const matches: MatchInfo[] = []
 
+  if (isMatchDbAvailable()) {
+    // Only the pages these queries touch are read, instead of every file in full
+    const matchIds = files.map((file) => path.basename(file, '.sqlite'))
+    const batches = await queryMatchDbs(files.map((file, i) => ({ path: path.join(matchesDir, file), queries: matchInfoQueries(matchIds[i]) })))
+    batches?.forEach((batch, i) => {
+      const m = matchInfoFromBatch(matchIds[i], batch)
+      if (m) matches.push(m)
+    })
+    return sortMatchesNewestFirst(matches)
+  }
+
+  const SQL = await initSqlJs()
   for (let i = 0; i < files.length; i += LIST_MATCHES_BATCH_SIZE) {
     const batch = files.slice(i, i + LIST_MATCHES_BATCH_SIZE)
     const results = await Promise.all(
@@ -325,6 +444,10 @@ export async function listMatches(): Promise<MatchInfo[]> {
     }
   }
 
+  return sortMatchesNewestFirst(matches)
+}
+
+function sortMatchesNewestFirst(matches: MatchInfo[]): MatchInfo[] {
   return matches.sort((a, b) => {
     if (a.createdAtIso && b.createdAtIso) {
       return new Date(b.createdAtIso).getTime() - new Date(a.createdAtIso).getTime()
@@ -336,6 +459,58 @@ export async function listMatches(): Promise<MatchInfo[]> {
   })
 }
 
+/**
+ * Demo paths recorded in every match database (meta.demo_path)
+ */
+export async function getParsedDemoPaths(): Promise<Set<string>> {
+  const matchesDir = getMatchesDir()
+  const parsedDemoPaths = new Set<string>()
+  if (!fs.existsSync(matchesDir)) {
+    return parsedDemoPaths
+  }
+
+  const sqliteFiles = fs.readdirSync(matchesDir).filter((file) => file.endsWith('.sqlite'))
+  if (isMatchDbAvailable()) {
+    const batches = await queryMatchDbs(sqliteFiles.map((file) => ({ path: path.join(matchesDir, file), queries: [DEMO_PATH_QUERIES[0]] })))
+    for (const batch of batches ?? []) {
+      const result = batch.results[0]
+      const failure = batch.error ?? ('error' in result ? result.error : null)
+      if (failure) {
+        console.error(`Failed to read demo path from ${path.basename(batch.path)}:`, failure)
+        continue
+      }
+      if (!('error' in result) && result.rowCount > 0 && result.values[0][0]) {
+        parsedDemoPaths.add(result.values[0][0] as string)
+      }
+    }
+    return parsedDemoPaths
+  }
+
+  const SQL = await initSqlJs()
+  for (const sqliteFile of sqliteFiles) {
+    const dbPath = path.join(matchesDir, sqliteFile)
+    try {
+      const buffer = fs.readFileSync(dbPath)
+      const db = new SQL.Database(buffer)
+
+      // Get demo_path from meta table
+      const metaStmt = db.prepare('SELECT value FROM meta WHERE key = ?')
+      metaStmt.bind(['demo_path'])
+      if (metaStmt.step()) {
+        const demoPaths = metaStmt.get()
+        if (demoPaths && demoPaths[0]) {
+          parsedDemoPaths.add(demoPaths[0])
+        }
+      }
+      metaStmt.free()
+      db.close()
+    } catch (err) {
+      console.error(`Failed to read demo path from ${sqliteFile}:`, err)
+    }
+  }
+  return parsedDemoPaths
+}
+
 /**
  * Delete specific matches by their IDs
  */
@@ -348,8 +523,12 @@ export async function deleteMatches(matchIds: string[]): Promise<number> {
   
   let deleted = 0
   
-  for (const matchId of matchIds) {
-    const dbPath = path.join(matchesDir, `${matchId}.sqlite`)
+  const dbPaths = matchIds.map((matchId) => path.join(matchesDir, `${matchId}.sqlite`))
+  closeMatchDbs(dbPaths)
+  
+  for (let i = 0; i < matchIds.length; i++) {
+    const matchId = matchIds[i]
+    const dbPath = dbPaths[i]
     if (fs.existsSync(dbPath)) {
       try {
         fs.unlinkSync(dbPath)
@@ -376,6 +555,7 @@ export async function deleteAllMatches(): Promise<number> {
   
   const files = fs.readdirSync(matchesDir)
   let deleted = 0
+  closeMatchDbs()
   
   for (const file of files) {
     if (!file.endsWith('.sqlite')) continue
@@ -427,6 +607,7 @@ export async function trimMatchesToCap(cap: number): Promise<Array<{ matchId: st
   // Delete oldest matches until we're at cap
   const toDelete = sorted.slice(0, sorted.length - cap)
   const matchesDir = getMatchesDir()
+  closeMatchDbs(toDelete.map((match) => path.join(matchesDir, `${match.id}.sqlite`)))
   
   for (const match of toDelete) {
     const dbPath = path.join(matchesDir, `${match.id}.sqlite`)
@@ -454,6 +635,11 @@ export async function listTables(matchId: string): Promise<string[]> {
   }
   
   try {
+    if (isMatchDbAvailable()) {
+      const result = await queryMatchDb(dbPath, "SELECT name FROM sqlite_master WHERE type='table' ORDER BY name")
+      return result ? matchDbRows(result).map((row) => row[0] as string) : []
+    }
+
     const SQL = await initSqlJs()
     const buffer = fs.readFileSync(dbPath)
     const db = new SQL.Database(buffer)
@@ -487,6 +673,16 @@ export async function getTableInfo(matchId: string, tableName: string): Promise<
   }
   
   try {
+    if (isMatchDbAvailable()) {
+      const schemaResult = await queryMatchDb(dbPath, `SELECT sql FROM sqlite_master WHERE type='table' AND name=?`, [tableName])
+      const countResult = await queryMatchDb(dbPath, `SELECT COUNT(*) FROM ${tableName}`)
+      return {
+        name: tableName,
+        rowCount: countResult && countResult.rowCount > 0 ? (countResult.values[0][0] as number) : 0,
+        schema: schemaResult && schemaResult.rowCount > 0 ? (schemaResult.values[0][0] as string) || '' : '',
+      }
+    }
+
     const SQL = await initSqlJs()
     const buffer = fs.readFileSync(dbPath)
     const db = new SQL.Database(buffer)
@@ -566,6 +762,11 @@ export async function runSelectQuery(matchId: string, sql: string): Promise<Quer
   }
   
   try {
+    if (isMatchDbAvailable()) {
+      const result = await queryMatchDb(dbPath, sanitized)
+      return result ? { columns: result.columns, rows: matchDbRows(result) } : { columns: [], rows: [] }
+    }
+
     const SQL = await initSqlJs()
     const buffer = fs.readFileSync(dbPath)
     const db = new SQL.Database(buffer)
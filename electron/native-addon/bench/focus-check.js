@@ -0,0 +1,110 @@
+// Focus transition check for the cs2_window_tracker addon, run under Electron so
+// the "overlay" is a real window of the process that loads the addon:
+//
+//   npm run bench:addon:focus
+//
+// Hooks the storm window (standing in for CS2) with overlayPid set to this
+// process, then moves the foreground CS2 -> overlay -> CS2 and expects the
+// focus state machine to report cs2-focused, overlay-focused, cs2-focused.
+// A governed helper must stay at idle priority through all three (the overlay
+// keeps the resource governor's limits) and return to normal once governing
+// stops. Exits non-zero if a transition or priority is wrong.
+
+const { app, BrowserWindow } = require('electron');
+const { spawn } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const { ADDON_PATH, STORM_PATH, startStorm, sleep } = require('./run-bench');
+
+const FOCUS_EVENTS = ['cs2-focused', 'overlay-focused', 'lost-focus'];
+const TRANSITION_TIMEOUT_MS = 2000;
+
+function handleToBigInt(buffer) {
+  return buffer.length >= 8 ? buffer.readBigUInt64LE(0) : BigInt(buffer.readUInt32LE(0));
+}
+
+async function main() {
+  if (process.platform !== 'win32') {
+    console.log('[focus] Windows-only addon; skipping on', process.platform);
+    return 0;
+  }
+  for (const required of [ADDON_PATH, STORM_PATH]) {
+    if (!fs.existsSync(required)) {
+      console.error(`[focus] Missing ${required}; build with: node electron/native-addon/build-addon.js --bench`);
+      return 1;
+    }
+  }
+
+  const addon = require(ADDON_PATH);
+  const storm = await startStorm('move', 0, 0);
+  const helper = spawn(process.execPath, ['-e', 'setInterval(() => {}, 1000)'], {
+    env: { ...process.env, ELECTRON_RUN_AS_NODE: '1' },
+    stdio: 'ignore',
+  });
+  const overlay = new BrowserWindow({ width: 320, height: 240, show: false, frame: false });
+  const overlayHwnd = handleToBigInt(overlay.getNativeWindowHandle());
+
+  // Latest focus transition; the hook seeds it with the state at start
+  let focus = null;
+  addon.startWinEventHook(storm.pid, (event) => {
+    if (FOCUS_EVENTS.includes(event.type)) {
+      focus = event;
+    }
+  }, { hwnd: storm.hwnd, overlayPid: process.pid });
+  addon.setResourceGovernor(storm.pid, { overlayPid: process.pid });
+  addon.governProcess(helper.pid);
+
+  const failures = [];
+  const expectPriority = (label, idle) => {
+    const priority = os.getPriority(helper.pid);
+    const isIdle = priority === os.constants.priority.PRIORITY_LOW;
+    console.log(`  ${''.padEnd(22)} helper priority ${priority}${isIdle === idle ? '' : ` (expected ${idle ? 'idle' : 'normal'})`}`);
+    if (isIdle !== idle) {
+      failures.push(`${label} priority`);
+    }
+  };
+  const expect = async (label, type, activate) => {
+    activate();
+    const deadline = Date.now() + TRANSITION_TIMEOUT_MS;
+    while ((!focus || focus.type !== type) && Date.now() < deadline) {
+      await sleep(10);
+    }
+    const received = focus && focus.type === type;
+    console.log(`  ${label.padEnd(22)} ${received ? `${type} (pid ${focus.pid})` : `no ${type} (last: ${focus ? focus.type : 'none'})`}`);
+    if (!received) {
+      failures.push(label);
+    }
+    expectPriority(label, true);
+  };
+
+  console.log('[focus] Foreground transitions (overlay pid %d, CS2 stand-in pid %d)', process.pid, storm.pid);
+  await expect('CS2 focused', 'cs2-focused', () => addon.forceActivateWindow(storm.hwnd));
+  await expect('overlay focused', 'overlay-focused', () => {
+    overlay.show();
+    addon.forceActivateWindow(overlayHwnd);
+  });
+  await expect('CS2 focused again', 'cs2-focused', () => addon.forceActivateWindow(storm.hwnd));
+  addon.setResourceGovernor(0);
+  expectPriority('governor stopped', false);
+
+  addon.stopWinEventHook();
+  helper.kill();
+  overlay.destroy();
+  await sleep(50);
+  await storm.quit();
+
+  if (failures.length > 0) {
+    console.error(`[focus] ${failures.length} check(s) failed: ${failures.join(', ')}`);
+    return 1;
+  }
+  console.log('[focus] All transitions delivered, limits kept on the overlay');
+  return 0;
+}
+
+app.whenReady()
+  .then(main)
+  .then((code) => app.exit(code))
+  .catch((err) => {
+    console.error('[focus] Failed:', err);
+    app.exit(1);
+  });
@@ -0,0 +1,302 @@
+// Benchmark / stress harness for the cs2_window_tracker addon.
+//
+//   npm run bench:addon -- [--iterations N] [--events N] [--interval-us N]
+//                          [--out report.json] [--baseline report.json] [--tolerance 0.25]
+//
+// Measures the per-call cost of every export against a dummy window
+// (cs2_window_storm.exe), then drives move/resize/minimize/foreground storms
+// at it in callback and batch delivery modes and reports sustained events/sec
+// and OS-to-JS latency from getHookStats(). With --baseline, exits non-zero if
+// any metric regressed by more than --tolerance.
+//
+// Runs under plain Node (the addon is N-API, so the Electron build loads too).
+
+const { spawn } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const readline = require('readline');
+
+const RELEASE_DIR = path.resolve(__dirname, '..', 'build', 'Release');
+const ADDON_PATH = path.join(RELEASE_DIR, 'cs2_window_tracker.node');
+const STORM_PATH = path.join(RELEASE_DIR, 'cs2_window_storm.exe');
+
+const ROUNDS = 5; // Each measurement is repeated and the median round reported
+const STORM_PATTERNS = ['move', 'resize', 'minimize', 'foreground', 'mixed'];
+const DELIVERY_MODES = ['callback', 'batch'];
+const DRAIN_RECORDS = 256;
+const DRAIN_STRIDE = 9; // Uint32Array record stride (WIN_EVENT_RECORD_STRIDE_UINT32)
+
+function parseArgs(argv) {
+  const options = {
+    iterations: 10000,
+    events: 2000,
+    intervalUs: 500,
+    out: null,
+    baseline: null,
+    tolerance: 0.25,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const next = () => argv[++i];
+    if (arg === '--iterations') options.iterations = Number(next());
+    else if (arg === '--events') options.events = Number(next());
+    else if (arg === '--interval-us') options.intervalUs = Number(next());
+    else if (arg === '--out') options.out = next();
+    else if (arg === '--baseline') options.baseline = next();
+    else if (arg === '--tolerance') options.tolerance = Number(next());
+    else throw new Error(`Unknown argument: ${arg}`);
+  }
+  return options;
+}
+
+function median(values) {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.floor(sorted.length / 2)];
+}
+
+function sleep(ms) {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// Spawn the storm window and wait for its READY line
+function startStorm(pattern, count, intervalUs) {
+  return new Promise((resolve, reject) => {
+    const child = spawn(STORM_PATH, [pattern, String(count), String(intervalUs)], {
+      stdio: ['pipe', 'pipe', 'inherit'],
+    });
+    const lines = readline.createInterface({ input: child.stdout });
+    const waiters = [];
+    lines.on('line', (line) => {
+      const waiter = waiters.shift();
+      if (waiter) waiter(line.trim().split(' '));
+    });
+    const nextLine = () => new Promise((res) => waiters.push(res));
+
+    child.once('error', reject);
+    nextLine().then(([tag, pid, hwnd]) => {
+      if (tag !== 'READY') {
+        reject(new Error(`Unexpected storm output: ${tag}`));
+        return;
+      }
+      resolve({
+        pid: Number(pid),
+        hwnd: BigInt(hwnd),
+        start: () => child.stdin.write('go\n'),
+        done: () => nextLine().then(([, operations, elapsedUs]) => ({
+          operations: Number(operations),
+          elapsedUs: Number(elapsedUs),
+        })),
+        quit: () => new Promise((res) => {
+          child.once('exit', res);
+          child.stdin.end('quit\n');
+        }),
+      });
+    });
+  });
+}
+
+// Mean ns per call over `iterations`, median of ROUNDS rounds
+function timeSync(iterations, fn) {
+  for (let i = 0; i < Math.min(1000, iterations); i++) fn();
+  const rounds = [];
+  for (let round = 0; round < ROUNDS; round++) {
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < iterations; i++) fn();
+    rounds.push(Number(process.hrtime.bigint() - start) / iterations);
+  }
+  return median(rounds);
+}
+
+async function timeAsync(iterations, fn) {
+  for (let i = 0; i < Math.min(20, iterations); i++) await fn();
+  const rounds = [];
+  for (let round = 0; round < ROUNDS; round++) {
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < iterations; i++) await fn();
+    rounds.push(Number(process.hrtime.bigint() - start) / iterations);
+  }
+  return median(rounds);
+}
+
+async function benchCalls(addon, options) {
+  const storm = await startStorm('move', 0, 0);
+  const { pid, hwnd } = storm;
+  const n = options.iterations;
+  const asyncN = Math.max(10, Math.floor(n / 50));
+  const stateBlock = new Int32Array(addon.getStateBlock());
+  const drainBuffer = new Uint32Array(DRAIN_RECORDS * DRAIN_STRIDE);
+
+  const results = {};
+  results.findWindowByPid = timeSync(Math.max(10, Math.floor(n / 10)), () => addon.findWindowByPid(pid));
+  results.findProcessIdByName = timeSync(Math.max(10, Math.floor(n / 100)), () => addon.findProcessIdByName('cs2_window_storm.exe'));
+  results.getClientBoundsOnScreen = timeSync(n, () => addon.getClientBoundsOnScreen(hwnd));
+  results.isMinimized = timeSync(n, () => addon.isMinimized(hwnd));
+  results.getDpiScaleForHwnd = timeSync(n, () => addon.getDpiScaleForHwnd(hwnd));
+  results.getForegroundPid = timeSync(n, () => addon.getForegroundPid());
+  results.getHookStats = timeSync(n, () => addon.getHookStats());
+  results.findWindowByPidAsync = await timeAsync(asyncN, () => addon.findWindowByPidAsync(pid));
+  results.findProcessIdByNameAsync = await timeAsync(asyncN, () => addon.findProcessIdByNameAsync('cs2_window_storm.exe'));
+  results.waitForWindow = await timeAsync(asyncN, () => addon.waitForWindow(pid, 1000));
+
+  // Hot-path reads while a hook is live
+  addon.startWinEventHook(pid, () => {}, { hwnd, delivery: 'batch' });
+  results.drainEvents = timeSync(n, () => addon.drainEvents(drainBuffer));
+  results.stateBlockRead = timeSync(n, () => {
+    let sequence;
+    let x;
+    do {
+      sequence = Atomics.load(stateBlock, 0);
+      x = stateBlock[2] + stateBlock[3] + stateBlock[4] + stateBlock[5];
+    } while ((sequence & 1) !== 0 || Atomics.load(stateBlock, 0) !== sequence);
+    return x;
+  });
+  addon.stopWinEventHook();
+
+  await storm.quit();
+  return results;
+}
+
+async function runStorm(addon, pattern, delivery, options) {
+  const storm = await startStorm(pattern, options.events, options.intervalUs);
+  const buffer = new Uint32Array(DRAIN_RECORDS * DRAIN_STRIDE);
+  let received = 0;
+
+  const onEvent = delivery === 'batch'
+    ? () => {
+        let count;
+        do {
+          count = addon.drainEvents(buffer);
+          received += count;
+        } while (count === DRAIN_RECORDS);
+      }
+    : () => {
+        received++;
+      };
+
+  addon.startWinEventHook(storm.pid, onEvent, { hwnd: storm.hwnd, delivery });
+  storm.start();
+  const { operations, elapsedUs } = await storm.done();
+  await sleep(100); // Let queued events reach JS
+  const stats = addon.getHookStats();
+  addon.stopWinEventHook();
+  await storm.quit();
+
+  const seconds = elapsedUs / 1e6;
+  return {
+    operations,
+    opsPerSec: operations / seconds,
+    rawPerSec: stats.raw / seconds,
+    eventsPerSec: received / seconds,
+    received,
+    delivered: stats.delivered,
+    coalesced: stats.coalesced,
+    dropped: stats.dropped,
+    maxQueueDepth: stats.maxQueueDepth,
+    deliveryP50Us: stats.latency.delivery.p50Us,
+    deliveryP99Us: stats.latency.delivery.p99Us,
+    deliveryMaxUs: stats.latency.delivery.maxUs,
+    boundsP99Us: stats.latency.bounds.p99Us,
+  };
+}
+
+// Metric direction for baseline comparison (anything else is informational)
+function isLowerBetter(section, key) {
+  return section === 'calls' || /Us$/.test(key) || key === 'dropped' || key === 'maxQueueDepth';
+}
+
+function compareToBaseline(report, baseline, tolerance) {
+  const regressions = [];
+  const check = (section, name, key, current, previous) => {
+    if (typeof current !== 'number' || typeof previous !== 'number' || previous === 0) {
+      return;
+    }
+    if (!isLowerBetter(section, key) && !/PerSec$/.test(key)) {
+      return;
+    }
+    const ratio = current / previous;
+    const regressed = isLowerBetter(section, key) ? ratio > 1 + tolerance : ratio < 1 - tolerance;
+    if (regressed) {
+      regressions.push(`${section}.${name}${key ? `.${key}` : ''}: ${previous.toFixed(1)} -> ${current.toFixed(1)}`);
+    }
+  };
+
+  for (const [name, ns] of Object.entries(report.calls)) {
+    check('calls', name, '', ns, baseline.calls && baseline.calls[name]);
+  }
+  for (const [name, result] of Object.entries(report.storms)) {
+    const previous = baseline.storms && baseline.storms[name];
+    if (!previous) continue;
+    for (const [key, value] of Object.entries(result)) {
+      check('storms', name, key, value, previous[key]);
+    }
+  }
+  return regressions;
+}
+
+async function main() {
+  if (process.platform !== 'win32') {
+    console.log('[bench] Windows-only addon; skipping on', process.platform);
+    return;
+  }
+  for (const required of [ADDON_PATH, STORM_PATH]) {
+    if (!fs.existsSync(required)) {
+      console.error(`[bench] Missing ${required}; build with: node electron/native-addon/build-addon.js --bench`);
+      process.exit(1);
+    }
+  }
+
+  const options = parseArgs(process.argv.slice(2));
+  const addon = require(ADDON_PATH);
+  const report = { date: new Date().toISOString(), options, calls: {}, storms: {} };
+
+  console.log('[bench] Per-call cost (ns/call, median of %d rounds)', ROUNDS);
+  report.calls = await benchCalls(addon, options);
+  for (const [name, ns] of Object.entries(report.calls)) {
+    console.log(`  ${name.padEnd(28)} ${ns.toFixed(0).padStart(10)}`);
+  }
+
+  console.log(`[bench] Storms (${options.events} operations, ${options.intervalUs}us apart)`);
+  for (const pattern of STORM_PATTERNS) {
+    for (const delivery of DELIVERY_MODES) {
+      const name = `${pattern}/${delivery}`;
+      const result = await runStorm(addon, pattern, delivery, options);
+      report.storms[name] = result;
+      console.log(
+        `  ${name.padEnd(22)} ops/s ${result.opsPerSec.toFixed(0).padStart(7)}` +
+        `  raw/s ${result.rawPerSec.toFixed(0).padStart(7)}` +
+        `  events/s ${result.eventsPerSec.toFixed(0).padStart(7)}` +
+        `  dropped ${String(result.dropped).padStart(5)}` +
+        `  queue ${String(result.maxQueueDepth).padStart(4)}` +
+        `  delivery p50/p99 ${result.deliveryP50Us}/${result.deliveryP99Us}us` +
+        `  bounds p99 ${result.boundsP99Us}us`
+      );
+    }
+  }
+
+  if (options.out) {
+    fs.writeFileSync(options.out, JSON.stringify(report, null, 2));
+    console.log('[bench] Report written to', options.out);
+  }
+
+  if (options.baseline) {
+    const baseline = JSON.parse(fs.readFileSync(options.baseline, 'utf8'));
+    const regressions = compareToBaseline(report, baseline, options.tolerance);
+    if (regressions.length > 0) {
+      console.error(`[bench] ${regressions.length} regression(s) beyond ${options.tolerance * 100}%:`);
+      for (const regression of regressions) {
+        console.error('  ' + regression);
+      }
+      process.exit(1);
+    }
+    console.log('[bench] No regressions against', options.baseline);
+  }
+}
+
+module.exports = { ADDON_PATH, STORM_PATH, startStorm, sleep };
+
+if (require.main === module) {
+  main().catch((err) => {
+    console.error('[bench] Failed:', err);
+    process.exit(1);
+  });
+}
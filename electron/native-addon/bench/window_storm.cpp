@@ -0,0 +1,196 @@
+// Synthetic event source for benchmarking the cs2_window_tracker addon.
+//
+// Creates a dummy top-level window (standing in for CS2) and, once told to
+// start, drives a storm of moves/resizes/minimizes/foreground changes at it:
+//
+//   cs2_window_storm.exe <move|resize|minimize|foreground|mixed> <count> <intervalUs>
+//
+// Protocol on stdio (one line each):
+//   -> READY <pid> <hwnd>         window created, hook can be attached
+//   <- go                         start the storm
+//   -> DONE <operations> <elapsedUs>
+//   <- quit                       destroy the window and exit
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#define WM_STORM_STEP (WM_APP + 1)
+#define WM_STORM_QUIT (WM_APP + 2)
+
+enum StormPattern {
+  STORM_MOVE,
+  STORM_RESIZE,
+  STORM_MINIMIZE,
+  STORM_FOREGROUND,
+  STORM_MIXED,
+};
+
+struct StormConfig {
+  StormPattern pattern;
+  unsigned count;
+  unsigned intervalUs;
+};
+
+static HWND g_target = NULL; // The tracked stand-in window
+static HWND g_decoy = NULL; // Second window, takes foreground away from the target
+
+LRESULT CALLBACK StormWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+  if (msg == WM_DESTROY && hwnd == g_target) {
+    PostQuitMessage(0);
+    return 0;
+  }
+  return DefWindowProcW(hwnd, msg, wParam, lParam);
+}
+
+bool ParsePattern(const char* name, StormPattern* out) {
+  static const struct { const char* name; StormPattern pattern; } kPatterns[] = {
+    { "move", STORM_MOVE },
+    { "resize", STORM_RESIZE },
+    { "minimize", STORM_MINIMIZE },
+    { "foreground", STORM_FOREGROUND },
+    { "mixed", STORM_MIXED },
+  };
+  for (const auto& entry : kPatterns) {
+    if (strcmp(name, entry.name) == 0) {
+      *out = entry.pattern;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Busy-wait with QPC; Sleep() granularity (~1ms+) is far too coarse for storms
+void SpinWaitUs(LONGLONG frequency, LONGLONG startQpc, LONGLONG targetUs) {
+  LARGE_INTEGER now;
+  do {
+    YieldProcessor();
+    QueryPerformanceCounter(&now);
+  } while ((now.QuadPart - startQpc) * 1000000 / frequency < targetUs);
+}
+
+// One storm operation. Runs on the window's own thread (posted from the pacer)
+// so it behaves like a game moving its own window.
+void StormStep(StormPattern pattern, unsigned index) {
+  const int baseX = 100;
+  const int baseY = 100;
+  switch (pattern) {
+    case STORM_MOVE:
+      SetWindowPos(g_target, NULL, baseX + (index % 200), baseY + (index % 100), 0, 0,
+        SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+      break;
+    case STORM_RESIZE:
+      SetWindowPos(g_target, NULL, 0, 0, 800 + (index % 320), 600 + (index % 180),
+        SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+      break;
+    case STORM_MINIMIZE:
+      ShowWindow(g_target, (index & 1) ? SW_RESTORE : SW_MINIMIZE);
+      break;
+    case STORM_FOREGROUND:
+      // Foreground changes are only granted while this process owns the
+      // foreground, so alternate between its two windows
+      SetForegroundWindow((index & 1) ? g_target : g_decoy);
+      break;
+    case STORM_MIXED:
+      StormStep(static_cast<StormPattern>(index % STORM_MIXED), index / STORM_MIXED);
+      break;
+  }
+}
+
+HWND CreateStormWindow(HINSTANCE instance, const wchar_t* title, int x, int y) {
+  return CreateWindowExW(
+    0, L"Cs2WindowStorm", title, WS_OVERLAPPEDWINDOW | WS_VISIBLE,
+    x, y, 800, 600, NULL, NULL, instance, NULL);
+}
+
+int main(int argc, char** argv) {
+  StormConfig config;
+  if (argc < 4 || !ParsePattern(argv[1], &config.pattern)) {
+    fprintf(stderr, "usage: %s <move|resize|minimize|foreground|mixed> <count> <intervalUs>\n", argv[0]);
+    return 2;
+  }
+  config.count = static_cast<unsigned>(strtoul(argv[2], NULL, 10));
+  config.intervalUs = static_cast<unsigned>(strtoul(argv[3], NULL, 10));
+
+  // Match the overlay: physical-pixel coordinates on every monitor
+  SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+
+  HINSTANCE instance = GetModuleHandleW(NULL);
+  WNDCLASSEXW windowClass = {};
+  windowClass.cbSize = sizeof(windowClass);
+  windowClass.lpfnWndProc = StormWndProc;
+  windowClass.hInstance = instance;
+  windowClass.hCursor = LoadCursor(NULL, IDC_ARROW);
+  windowClass.lpszClassName = L"Cs2WindowStorm";
+  if (!RegisterClassExW(&windowClass)) {
+    fprintf(stderr, "RegisterClassEx failed: %lu\n", GetLastError());
+    return 1;
+  }
+
+  g_target = CreateStormWindow(instance, L"cs2 window storm", 100, 100);
+  g_decoy = CreateStormWindow(instance, L"cs2 window storm (decoy)", 960, 100);
+  if (!g_target || !g_decoy) {
+    fprintf(stderr, "CreateWindowEx failed: %lu\n", GetLastError());
+    return 1;
+  }
+  SetForegroundWindow(g_target);
+
+  DWORD mainThreadId = GetCurrentThreadId();
+  printf("READY %lu %llu\n", GetCurrentProcessId(),
+    static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(g_target)));
+  fflush(stdout);
+
+  // Pacer: waits for "go", then posts one step per interval to the window thread
+  // (which does the actual work) and reports when every step has run
+  std::atomic<unsigned> completed(0);
+  std::thread pacer([&]() {
+    char line[64];
+    if (!fgets(line, sizeof(line), stdin) || strncmp(line, "go", 2) != 0) {
+      PostThreadMessageW(mainThreadId, WM_STORM_QUIT, 0, 0);
+      return;
+    }
+
+    LARGE_INTEGER frequency, start, end;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    for (unsigned i = 0; i < config.count; i++) {
+      PostThreadMessageW(mainThreadId, WM_STORM_STEP, static_cast<WPARAM>(config.pattern), i);
+      SpinWaitUs(frequency.QuadPart, start.QuadPart, static_cast<LONGLONG>(i + 1) * config.intervalUs);
+    }
+    while (completed.load() < config.count) {
+      Sleep(1);
+    }
+    QueryPerformanceCounter(&end);
+
+    printf("DONE %u %lld\n", config.count, (end.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart);
+    fflush(stdout);
+
+    // Wait for "quit" (or EOF when the harness goes away)
+    while (fgets(line, sizeof(line), stdin) && strncmp(line, "quit", 4) != 0) {
+    }
+    PostThreadMessageW(mainThreadId, WM_STORM_QUIT, 0, 0);
+  });
+
+  MSG msg;
+  while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+    if (msg.hwnd == NULL && msg.message == WM_STORM_STEP) {
+      StormStep(static_cast<StormPattern>(msg.wParam), static_cast<unsigned>(msg.lParam));
+      completed.fetch_add(1);
+      continue;
+    }
+    if (msg.hwnd == NULL && msg.message == WM_STORM_QUIT) {
+      DestroyWindow(g_decoy);
+      DestroyWindow(g_target); // Posts WM_QUIT
+      continue;
+    }
+    TranslateMessage(&msg);
+    DispatchMessageW(&msg);
+  }
+
+  pacer.join();
+  return 0;
+}
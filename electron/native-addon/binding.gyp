@@ -1,26 +1,85 @@
 {
+  "variables": {
+    # Set to 1 (node-gyp rebuild -- -Dbuild_bench=1) to also build the benchmark's storm window
+    "build_bench%": 0
+  },
   "targets": [
     {
       "target_name": "cs2_window_tracker",
       "cflags!": [ "-fno-exceptions" ],
       "cflags_cc!": [ "-fno-exceptions" ],
-      "sources": [
-        "src/cs2_window_tracker.cpp"
-      ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")"
       ],
       "defines": [ "NAPI_DISABLE_CPP_EXCEPTIONS" ],
       "conditions": [
         ["OS=='win'", {
+          "sources": [
+            "src/cs2_window_tracker.cpp",
+            "src/capture.cpp",
+            "src/waveform.cpp",
+            "src/demo_scan.cpp",
+            "src/voice_extract.cpp",
+            "src/demo_watcher.cpp",
+            "src/netcon.cpp",
+            "src/ndjson_reader.cpp",
+            "src/resource_sampler.cpp",
+            "src/match_db.cpp"
+          ],
           "defines": [ "_WINDOWS" ],
           "libraries": [
             "-luser32",
             "-lkernel32",
-            "-lpsapi"
+            "-lpsapi",
+            "-ldwmapi",
+            "-ld3d11",
+            "-ldxgi",
+            "-lwinmm",
+            "-lws2_32",
+            "-lwinsqlite3",
+            "-lpdh"
           ]
+        }],
+        ["OS=='mac'", {
+          "sources": [
+            "src/cs2_window_tracker_mac.mm"
+          ],
+          "xcode_settings": {
+            "CLANG_CXX_LIBRARY": "libc++",
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "MACOSX_DEPLOYMENT_TARGET": "10.15"
+          },
+          "link_settings": {
+            "libraries": [
+              "-framework AppKit",
+              "-framework ApplicationServices",
+              "-framework CoreGraphics"
+            ]
+          }
         }]
       ]
     }
+  ],
+  "conditions": [
+    ["OS=='win' and build_bench==1", {
+      "targets": [
+        {
+          "target_name": "cs2_window_storm",
+          "type": "executable",
+          "sources": [
+            "bench/window_storm.cpp"
+          ],
+          "libraries": [
+            "-luser32",
+            "-lkernel32"
+          ],
+          "msvs_settings": {
+            "VCLinkerTool": {
+              "SubSystem": 1
+            }
+          }
+        }
+      ]
+    }]
   ]
 }
@@ -3,20 +3,24 @@ const path = require('path');
 
 function main() {
   const isWindows = process.platform === 'win32';
+  const isMac = process.platform === 'darwin';
 
-  if (!isWindows) {
-    console.log('[native-addon] Windows-only addon; skipping build on', process.platform);
+  if (!isWindows && !isMac) {
+    console.log('[native-addon] No native backend for', process.platform, '- skipping build');
     return;
   }
 
+  // --bench also builds the storm window used by bench/run-bench.js
+  const buildBench = process.argv.includes('--bench');
+
   const projectRoot = path.resolve(__dirname, '..', '..');
   const addonDir = path.join(projectRoot, 'electron', 'native-addon');
 
-  console.log('[native-addon] Building Windows native addon in', addonDir);
+  console.log('[native-addon] Building', isWindows ? 'Windows' : 'macOS', 'native addon in', addonDir);
 
   const result = spawnSync(
     process.platform === 'win32' ? 'node-gyp.cmd' : 'node-gyp',
-    ['rebuild', '--directory', addonDir],
+    ['rebuild', '--directory', addonDir, ...(buildBench ? ['--', '-Dbuild_bench=1'] : [])],
     {
       stdio: 'inherit',
       shell: true,
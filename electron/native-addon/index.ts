@@ -4,7 +4,6 @@
 
 import * as path from 'path'
 import * as fs from 'fs'
-import { app } from 'electron'
 
 // Try to load the native addon
 let nativeAddon: any = null
@@ -44,6 +43,14 @@ try {
   // throw err
 }
 
+/**
+ * Whether the native addon was loaded (Windows and macOS builds; false elsewhere or when not built).
+ * The macOS build provides the window tracking functions only; the rest report unavailable there.
+ */
+export function isNativeAddonLoaded(): boolean {
+  return nativeAddon !== null
+}
+
 export interface WindowBounds {
   x: number
   y: number
@@ -51,10 +58,177 @@ export interface WindowBounds {
   height: number
 }
 
+export interface WindowCandidate {
+  hwnd: bigint
+  area: number // Window rect area in physical pixels
+  title: string
+}
+
 export interface WinEvent {
-  type: 'locationchange' | 'movestart' | 'moveend' | 'minimizestart' | 'minimizeend' | 'destroy' | 'foreground'
+  type: 'locationchange' | 'boundschanged' | 'movestart' | 'moveend' | 'minimizestart' | 'minimizeend' | 'destroy' | 'foreground' | 'processexit'
+    | 'cs2-focused' | 'overlay-focused' | 'lost-focus' | 'minimized' | 'restored'
+    | 'monitorchanged' | 'cloaked' | 'uncloaked'
   hwnd: bigint
-  pid?: number // Only present for 'foreground' events
+  pid?: number // Only present for 'foreground' and focus transition events (foreground PID)
+  bounds?: WindowBounds // Only present for 'boundschanged' events (client area, physical pixels)
+  dpi?: number // Only present for 'monitorchanged' events (tracked window's new DPI, 96 = 100%)
+  workArea?: WindowBounds // Only present for 'monitorchanged' events (new monitor's work area, physical pixels)
+  timestamp?: number // OS event time (GetTickCount clock, ms)
+}
+
+/**
+ * Numeric event codes used by batch delivery (must match HookEventCode in src/hook_events.h)
+ */
+export enum WinEventCode {
+  LocationChange = 1,
+  BoundsChanged = 2,
+  MoveStart = 3,
+  MoveEnd = 4,
+  MinimizeStart = 5,
+  MinimizeEnd = 6,
+  Destroy = 7,
+  Foreground = 8,
+  ProcessExit = 9,
+  Cs2Focused = 10,
+  OverlayFocused = 11,
+  LostFocus = 12,
+  Minimized = 13,
+  Restored = 14,
+  MonitorChanged = 15,
+  Cloaked = 16,
+  Uncloaked = 17,
+}
+
+/**
+ * Record layouts written by drainWinEvents (slots per record)
+ * - Uint32Array:   [code, hwndLo, hwndHi, pid, timestamp, x, y, width, height]
+ *   (x/y are signed; read them with `| 0`)
+ * - BigInt64Array: [code, hwnd, pid, timestamp, x, y, width, height]
+ * For 'monitorchanged' the pid slot holds the new DPI and x/y/width/height the
+ * monitor work area.
+ */
+export const WIN_EVENT_RECORD_STRIDE_UINT32 = 9
+export const WIN_EVENT_RECORD_STRIDE_BIGINT64 = 8
+
+/**
+ * Event type for each WinEventCode (index = code)
+ */
+export const WIN_EVENT_TYPE_BY_CODE: ReadonlyArray<WinEvent['type'] | undefined> = [
+  undefined,
+  'locationchange',
+  'boundschanged',
+  'movestart',
+  'moveend',
+  'minimizestart',
+  'minimizeend',
+  'destroy',
+  'foreground',
+  'processexit',
+  'cs2-focused',
+  'overlay-focused',
+  'lost-focus',
+  'minimized',
+  'restored',
+  'monitorchanged',
+  'cloaked',
+  'uncloaked',
+]
+
+export interface WinEventHookOptions {
+  /**
+   * Window to coalesce geometry for. When set, 'locationchange' events for this
+   * window are replaced by 'boundschanged', emitted only when its client rect
+   * on screen actually changes. Moves onto another monitor or DPI also emit
+   * 'monitorchanged' (ahead of the 'boundschanged').
+   */
+  hwnd?: bigint
+  /**
+   * Enable the native focus state machine. Foreground and minimize events are
+   * folded into (focus owner: target / overlay / other, minimized, moving) and
+   * only transitions are delivered: 'cs2-focused', 'overlay-focused',
+   * 'lost-focus', 'minimized' and 'restored' (instead of 'foreground' and
+   * 'minimizestart'/'minimizeend'). The current state is delivered once the
+   * hook is live.
+   */
+  overlayPid?: number
+}
+
+/**
+ * Int32 slots of the native window state block (must match WindowStateSlot in src/hook_events.h)
+ */
+export enum WindowStateSlot {
+  Sequence = 0, // Even = stable, odd = native side is writing
+  Valid = 1,
+  X = 2,
+  Y = 3,
+  Width = 4,
+  Height = 5,
+  Minimized = 6,
+  ForegroundPid = 7,
+  Dpi = 8, // Raw DPI (96 = 100%)
+  Cloaked = 9,
+}
+
+export interface WindowStateSnapshot {
+  /** True while the hooked target window exists */
+  valid: boolean
+  /** Client bounds on screen (physical pixels); last known while minimized */
+  bounds: WindowBounds
+  minimized: boolean
+  foregroundPid: number
+  dpiScale: number
+  cloaked: boolean
+}
+
+const WINDOW_STATE_READ_ATTEMPTS = 8
+
+let windowStateBlock: Int32Array | null = null
+
+/**
+ * Get the window state block kept current by the WinEvent hook thread.
+ * Reading it is plain memory access; use readWindowState() for a consistent snapshot.
+ * Fetch it before starting the hook so the initial state is published into it.
+ * @returns Int32Array view (same buffer on every call) or null if the addon is not loaded
+ */
+export function getWindowStateBlock(): Int32Array | null {
+  if (!nativeAddon) {
+    return null
+  }
+  if (!windowStateBlock) {
+    try {
+      windowStateBlock = new Int32Array(nativeAddon.getStateBlock())
+    } catch (err) {
+      console.error('[CS2WindowTracker] Error in getStateBlock:', err)
+      return null
+    }
+  }
+  return windowStateBlock
+}
+
+/**
+ * Read a consistent snapshot of the state block into `out` (no allocation)
+ * @returns false if no consistent read was possible or no window is tracked
+ */
+export function readWindowState(block: Int32Array, out: WindowStateSnapshot): boolean {
+  for (let attempt = 0; attempt < WINDOW_STATE_READ_ATTEMPTS; attempt++) {
+    const sequence = block[WindowStateSlot.Sequence]
+    if (sequence & 1) {
+      continue // Writer in progress
+    }
+    out.valid = block[WindowStateSlot.Valid] === 1
+    out.bounds.x = block[WindowStateSlot.X]
+    out.bounds.y = block[WindowStateSlot.Y]
+    out.bounds.width = block[WindowStateSlot.Width]
+    out.bounds.height = block[WindowStateSlot.Height]
+    out.minimized = block[WindowStateSlot.Minimized] === 1
+    out.foregroundPid = block[WindowStateSlot.ForegroundPid]
+    out.dpiScale = (block[WindowStateSlot.Dpi] || 96) / 96
+    out.cloaked = block[WindowStateSlot.Cloaked] === 1
+    if (block[WindowStateSlot.Sequence] === sequence) {
+      return out.valid
+    }
+  }
+  return false
 }
 
 /**
@@ -95,6 +269,69 @@ export function findProcessIdByName(processName: string): number | null {
   }
 }
 
+/**
+ * Find every window candidate of a process without blocking the main thread
+ * @param pid Process ID
+ * @returns Visible, titled, non-tool windows, largest first (empty if none)
+ */
+export async function findWindowByPidAsync(pid: number): Promise<WindowCandidate[]> {
+  if (!nativeAddon) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot find window')
+    return []
+  }
+  try {
+    return await nativeAddon.findWindowByPidAsync(pid)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in findWindowByPidAsync:', err)
+    return []
+  }
+}
+
+/**
+ * Find the PIDs of all processes with a name without blocking the main thread
+ * @param processName Process name (e.g., "cs2.exe")
+ * @returns Matching process IDs (empty if none)
+ */
+export async function findProcessIdByNameAsync(processName: string): Promise<number[]> {
+  if (!nativeAddon) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot find process')
+    return []
+  }
+  try {
+    return await nativeAddon.findProcessIdByNameAsync(processName)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in findProcessIdByNameAsync:', err)
+    return []
+  }
+}
+
+/**
+ * Wait for a process' main window to appear, without polling
+ * Resolves as soon as the window is shown or titled (or immediately if it already exists)
+ * @param target Process name (e.g., "cs2.exe") or PID
+ * @param timeoutMs Maximum time to wait
+ * @returns PID and window handle, or null on timeout
+ */
+export async function waitForWindow(
+  target: string | number,
+  timeoutMs: number
+): Promise<{ pid: number; hwnd: bigint } | null> {
+  if (!nativeAddon) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot wait for window')
+    return null
+  }
+  try {
+    const result = await nativeAddon.waitForWindow(target, timeoutMs)
+    if (!result) {
+      return null
+    }
+    return { pid: Number(result.pid), hwnd: result.hwnd }
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in waitForWindow:', err)
+    return null
+  }
+}
+
 /**
  * Get client bounds of a window in screen coordinates
  * @param hwnd Window handle
@@ -156,33 +393,937 @@ export function getDpiScaleForHwnd(hwnd: bigint): number {
   }
 }
 
+// Convert a raw event object from the addon into a WinEvent
+function toWinEvent(event: any): WinEvent {
+  const winEvent: WinEvent = {
+    type: event.type,
+    hwnd: BigInt(event.hwnd),
+  }
+  // Add pid if present (for foreground events)
+  if (event.pid !== undefined) {
+    winEvent.pid = Number(event.pid)
+  }
+  if (event.timestamp !== undefined) {
+    winEvent.timestamp = Number(event.timestamp)
+  }
+  // Add bounds if present (for boundschanged events)
+  if (event.width !== undefined) {
+    winEvent.bounds = {
+      x: Number(event.x),
+      y: Number(event.y),
+      width: Number(event.width),
+      height: Number(event.height),
+    }
+  }
+  // Add DPI and work area if present (for monitorchanged events)
+  if (event.workArea !== undefined) {
+    winEvent.dpi = Number(event.dpi)
+    winEvent.workArea = {
+      x: Number(event.workArea.x),
+      y: Number(event.workArea.y),
+      width: Number(event.workArea.width),
+      height: Number(event.workArea.height),
+    }
+  }
+  return winEvent
+}
+
 /**
  * Start WinEvent hook for a process
  * @param targetPid Target process ID
  * @param callback Callback function for events
+ * @param options Hook options
+ * @returns true if a 'processexit' event will be emitted when the target exits
+ */
+export function startWinEventHook(
+  targetPid: number,
+  callback: (event: WinEvent) => void,
+  options: WinEventHookOptions = {}
+): boolean {
+  if (!nativeAddon) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot start WinEvent hook')
+    return false
+  }
+  try {
+    return Boolean(nativeAddon.startWinEventHook(targetPid, (event: any) => callback(toWinEvent(event)), options))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startWinEventHook:', err)
+    return false
+  }
+}
+
+/**
+ * Start WinEvent hook with batch delivery: events are kept in a native ring
+ * buffer and read with drainWinEvents(), so a whole burst costs one crossing
+ * and no per-event allocations.
+ * @param targetPid Target process ID
+ * @param onEventsPending Called (without arguments) when records are waiting
+ * @param options Hook options
+ * @returns true if a 'processexit' event will be emitted when the target exits
  */
-export function startWinEventHook(targetPid: number, callback: (event: WinEvent) => void): void {
+export function startWinEventHookBatched(
+  targetPid: number,
+  onEventsPending: () => void,
+  options: WinEventHookOptions = {}
+): boolean {
   if (!nativeAddon) {
     console.warn('[CS2WindowTracker] Native addon not loaded, cannot start WinEvent hook')
+    return false
+  }
+  try {
+    return Boolean(nativeAddon.startWinEventHook(targetPid, onEventsPending, { ...options, delivery: 'batch' }))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startWinEventHookBatched:', err)
+    return false
+  }
+}
+
+/**
+ * Copy pending batch-mode event records into a caller-owned buffer
+ * @param buffer Uint32Array or BigInt64Array (see WIN_EVENT_RECORD_STRIDE_*)
+ * @param trackId trackWindow() id to drain (default: the startWinEventHook subscription)
+ * @returns Number of records written (0 if none or addon not loaded)
+ */
+export function drainWinEvents(buffer: Uint32Array | BigInt64Array, trackId?: number): number {
+  if (!nativeAddon) {
+    return 0
+  }
+  return trackId === undefined ? nativeAddon.drainEvents(buffer) : nativeAddon.drainEvents(buffer, trackId)
+}
+
+export interface TrackWindowOptions {
+  /**
+   * 'callback' (default) delivers one WinEvent per call; 'batch' calls back
+   * without arguments and records are read with drainWinEvents(buffer, id)
+   */
+  delivery?: 'callback' | 'batch'
+  /** Enable the focus state machine (see WinEventHookOptions.overlayPid) */
+  overlayPid?: number
+}
+
+/**
+ * Track an additional process or window alongside the startWinEventHook target.
+ * All subscriptions share one native hook thread; a process is hooked once no
+ * matter how many subscriptions target it.
+ * @param target Process ID, or window handle (events are coalesced to 'boundschanged' for it)
+ * @param callback Receives events ('batch' delivery: called without arguments)
+ * @param options Delivery options
+ * @returns Subscription id for untrack()/drainWinEvents(), or null on failure
+ */
+export function trackWindow(
+  target: number | bigint,
+  callback: (event?: WinEvent) => void,
+  options: TrackWindowOptions = {}
+): number | null {
+  if (!nativeAddon?.trackWindow) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot track window')
+    return null
+  }
+  try {
+    const onEvent = options.delivery === 'batch'
+      ? () => callback()
+      : (event: any) => callback(toWinEvent(event))
+    return nativeAddon.trackWindow(target, onEvent, options)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in trackWindow:', err)
+    return null
+  }
+}
+
+/**
+ * Stop a trackWindow() subscription
+ * @returns true if the subscription existed
+ */
+export function untrack(trackId: number): boolean {
+  if (!nativeAddon?.untrack) {
+    return false
+  }
+  return nativeAddon.untrack(trackId)
+}
+
+/**
+ * Let the hook position the overlay over the tracked window natively
+ * While enabled, the overlay follows every move/resize in the same frame and
+ * 'boundschanged' events are no longer delivered
+ * @param overlayHandle BrowserWindow.getNativeWindowHandle() (or hwnd), null to disable
+ * @param options.framePaced Coalesce moves to at most one per vblank of the tracked window's monitor
+ * @returns true if follow mode is now in the requested state (needs a hook started with an hwnd);
+ * false if overlayHandle names no window
+ */
+export function setOverlayFollow(overlayHandle: Buffer | bigint | null, options: { framePaced?: boolean } = {}): boolean {
+  if (!nativeAddon) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot set overlay follow')
+    return false
+  }
+  try {
+    return nativeAddon.setOverlayFollow(overlayHandle, options)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in setOverlayFollow:', err)
+    return false
+  }
+}
+
+/**
+ * Let the addon toggle overlay click-through from native hit testing.
+ * A low-level mouse hook compares the cursor with the regions passed to
+ * setOverlayHitRegions() and clears WS_EX_TRANSPARENT only while it is over one,
+ * so there is no IPC round trip per cursor move
+ * @param overlayHandle BrowserWindow.getNativeWindowHandle() (or hwnd)
+ * @param onHoverChange Called with true on 'hoverenter' and false on 'hoverleave'
+ * @returns true if native hit testing is active
+ */
+export function startOverlayHitTest(overlayHandle: Buffer | bigint, onHoverChange: (hovered: boolean) => void): boolean {
+  if (!nativeAddon?.startOverlayHitTest) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot start overlay hit test')
+    return false
+  }
+  try {
+    return Boolean(nativeAddon.startOverlayHitTest(overlayHandle, (type: string) => {
+      onHoverChange(type === 'hoverenter')
+    }))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startOverlayHitTest:', err)
+    return false
+  }
+}
+
+/**
+ * Replace the overlay's interactive regions
+ * @param regions Rectangles in overlay client coordinates (physical pixels)
+ * @returns false if no hit test is running
+ */
+export function setOverlayHitRegions(regions: WindowBounds[]): boolean {
+  if (!nativeAddon?.setOverlayHitRegions) {
+    return false
+  }
+  const flat = new Int32Array(regions.length * 4)
+  regions.forEach((region, i) => {
+    flat[i * 4] = Math.round(region.x)
+    flat[i * 4 + 1] = Math.round(region.y)
+    flat[i * 4 + 2] = Math.round(region.width)
+    flat[i * 4 + 3] = Math.round(region.height)
+  })
+  return nativeAddon.setOverlayHitRegions(flat)
+}
+
+/**
+ * Suspend click-through toggling (e.g. while the overlay is fully interactive);
+ * hover notifications keep coming
+ */
+export function setOverlayHitTestSuspended(suspended: boolean): void {
+  if (!nativeAddon?.setOverlayHitTestSuspended) {
+    return
+  }
+  nativeAddon.setOverlayHitTestSuspended(suspended)
+}
+
+/**
+ * Stop native hit testing (the overlay keeps its current click-through style)
+ */
+export function stopOverlayHitTest(): void {
+  if (!nativeAddon?.stopOverlayHitTest) {
+    return
+  }
+  nativeAddon.stopOverlayHitTest()
+}
+
+export interface HotkeyChord {
+  id: number
+  key: number // Windows virtual-key code
+  ctrl?: boolean
+  alt?: boolean
+  shift?: boolean
+  win?: boolean
+  toggleOverlay?: boolean // Show/hide the setOverlayHotkeyWindow() window natively
+}
+
+export interface HotkeyEvent {
+  id: number
+  shown?: boolean // Overlay state after a native toggle (missing when no window was set)
+}
+
+const ACCELERATOR_KEY_CODES: Record<string, number> = {
+  space: 0x20, tab: 0x09, enter: 0x0d, return: 0x0d, escape: 0x1b, esc: 0x1b, backspace: 0x08,
+  delete: 0x2e, insert: 0x2d, home: 0x24, end: 0x23, pageup: 0x21, pagedown: 0x22,
+  up: 0x26, down: 0x28, left: 0x25, right: 0x27, plus: 0xbb, '=': 0xbb, '-': 0xbd, ',': 0xbc,
+  '.': 0xbe, '/': 0xbf, '`': 0xc0, ';': 0xba, "'": 0xde, '[': 0xdb, ']': 0xdd, '\\': 0xdc,
+}
+
+/**
+ * Translate an Electron accelerator ('CommandOrControl+Shift+O') into a hotkey chord
+ * @returns null if the accelerator uses a key the native listener does not know
+ */
+export function acceleratorToHotkeyChord(accelerator: string, id: number): HotkeyChord | null {
+  const chord: HotkeyChord = { id, key: 0 }
+  for (const part of accelerator.split('+').map(p => p.trim().toLowerCase())) {
+    if (['commandorcontrol', 'cmdorctrl', 'command', 'cmd', 'control', 'ctrl'].includes(part)) {
+      chord.ctrl = true
+    } else if (['alt', 'option', 'altgr'].includes(part)) {
+      chord.alt = true
+    } else if (part === 'shift') {
+      chord.shift = true
+    } else if (['super', 'meta'].includes(part)) {
+      chord.win = true
+    } else if (chord.key !== 0) {
+      return null // Two non-modifier keys
+    } else if (/^[a-z0-9]$/.test(part)) {
+      chord.key = part.toUpperCase().charCodeAt(0)
+    } else if (/^f([1-9]|1[0-9]|2[0-4])$/.test(part)) {
+      chord.key = 0x6f + parseInt(part.slice(1), 10) // VK_F1 is 0x70
+    } else if (/^num[0-9]$/.test(part)) {
+      chord.key = 0x60 + parseInt(part.slice(3), 10)
+    } else if (ACCELERATOR_KEY_CODES[part] !== undefined) {
+      chord.key = ACCELERATOR_KEY_CODES[part]
+    } else {
+      return null
+    }
+  }
+  return chord.key !== 0 ? chord : null
+}
+
+/**
+ * Listen for hotkey chords with a low-level keyboard hook on a native thread
+ * Works while fullscreen CS2 has focus and does not wait on the main event loop;
+ * matched chords are swallowed. Replaces previous chords.
+ * @returns false if the addon is not loaded or the hook could not be set
+ */
+export function startOverlayHotkeys(chords: HotkeyChord[], onHotkey: (event: HotkeyEvent) => void): boolean {
+  if (!nativeAddon?.startOverlayHotkeys) {
+    return false
+  }
+  try {
+    return Boolean(nativeAddon.startOverlayHotkeys(chords, onHotkey))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startOverlayHotkeys:', err)
+    return false
+  }
+}
+
+/**
+ * Window that toggleOverlay chords show (click-through) and hide natively, kept
+ * across startOverlayHotkeys() calls; null makes them notify only
+ */
+export function setOverlayHotkeyWindow(overlayHandle: Buffer | bigint | null): boolean {
+  if (!nativeAddon?.setOverlayHotkeyWindow) {
+    return false
+  }
+  return nativeAddon.setOverlayHotkeyWindow(overlayHandle)
+}
+
+/**
+ * Remove the keyboard hook; no chords are matched afterwards
+ */
+export function stopOverlayHotkeys(): void {
+  if (!nativeAddon?.stopOverlayHotkeys) {
+    return
+  }
+  nativeAddon.stopOverlayHotkeys()
+}
+
+export interface WaveformPeaksOptions {
+  channels?: number // PCM input only: interleaved channel count (default 1)
+  sampleRate?: number // PCM input only (default 16000)
+  samplesPerPeak?: number // Frames per level-0 peak (default 256)
+  peakCount?: number // Size level 0 to this many peaks instead of samplesPerPeak
+  levels?: number // Maximum pyramid levels (default and cap 16)
+}
+
+export interface WaveformPeakLevel {
+  samplesPerPeak: number // Frames covered by each peak
+  peaks: Int16Array // [min, max] per peak, over all channels
+  rms: Float32Array // RMS per peak, 0..1 of full scale
+}
+
+export interface WaveformPeaks {
+  sampleRate: number
+  channels: number
+  frames: number
+  duration: number // Seconds
+  levels: WaveformPeakLevel[] // levels[i + 1] halves the resolution of levels[i]
+}
+
+/**
+ * Build min/max/RMS peak pyramids on a worker thread
+ * @param input WAV file path (8/16/24/32-bit PCM or 32-bit float) or interleaved PCM
+ * @returns null if the addon is not loaded
+ */
+export async function computeWaveformPeaks(
+  input: string | Int16Array | Float32Array,
+  options: WaveformPeaksOptions = {}
+): Promise<WaveformPeaks | null> {
+  if (!nativeAddon?.computeWaveformPeaks) {
+    return null
+  }
+  return nativeAddon.computeWaveformPeaks(input, options)
+}
+
+export interface DemoHeader {
+  path: string
+  size: number // Bytes
+  mtimeMs: number // Last write time, Unix epoch milliseconds
+  error?: string // Set when the file is missing or not a CS2 demo; no header fields then
+  mapName?: string
+  serverName?: string
+  clientName?: string
+  gameDirectory?: string
+  demoVersionName?: string
+  networkProtocol?: number
+  buildNum?: number
+  // From the file info frame; missing while a demo is still being recorded or was truncated
+  playbackTime?: number // Seconds
+  playbackTicks?: number
+  playbackFrames?: number
+  rounds?: number
+}
+
+/**
+ * Read the header and file info frames of many .dem files on a worker thread pool
+ * Only the pages holding those frames are touched, so this is cheap even for large demos
+ * @param paths Demo file paths
+ * @returns One entry per path in input order, or null if the addon is not loaded
+ */
+export async function scanDemos(paths: string[]): Promise<DemoHeader[] | null> {
+  if (!nativeAddon?.scanDemos) {
+    return null
+  }
+  return nativeAddon.scanDemos(paths)
+}
+
+export interface VoiceExtractionOptions {
+  outputDirectory: string // Must exist
+  mode?: 'split-compact' | 'split-full' | 'single-full' // Default 'split-compact'
+  steamIds?: string[] // Only these players (default: everyone who spoke)
+  codecDirectory?: string // Folder holding opus.dll
+}
+
+export interface VoiceExtraction {
+  files: Array<{
+    path: string
+    steamId?: string // Missing for the mixed single-full file
+    samples: number
+  }>
+  players: Array<{
+    steamId: string
+    voicedSamples: number // Decoded speech, without gaps
+    segments: number
+    error?: string
+  }>
+  sampleRate: number // Always 48000 (mono, 16-bit)
+  voicedMs: number
+  messages: number // Voice messages decoded
+}
+
+/**
+ * Decode players' voice from a CS2 demo into WAV files in-process, on a worker
+ * thread pool, instead of running the external extractor
+ * @param demoPath CS2 (PBDEMS2) demo; CS:GO demos are rejected
+ * @returns The written files, or null if the addon is not loaded
+ */
+export async function extractVoice(
+  demoPath: string,
+  options: VoiceExtractionOptions
+): Promise<VoiceExtraction | null> {
+  if (!nativeAddon?.extractVoice) {
+    return null
+  }
+  return nativeAddon.extractVoice(demoPath, options)
+}
+
+export type MatchDbParam = number | bigint | boolean | string | Buffer | null
+
+export interface MatchDbResult {
+  columns: string[]
+  rowCount: number
+  // Column-major. Float64Array when a column holds only numbers and NULLs (NULL is NaN);
+  // otherwise an array, with INTEGERs beyond Number.MAX_SAFE_INTEGER as bigint
+  values: Array<Float64Array | Array<number | bigint | string | Buffer | null>>
+}
+
+export interface MatchDbQuery {
+  sql: string
+  params?: MatchDbParam[]
+}
+
+export interface MatchDbBatchResult {
+  path: string
+  error?: string // The database could not be opened; results is empty then
+  results: Array<MatchDbResult | { error: string }> // One per query, in order
+}
+
+/**
+ * Whether match databases can be read natively (queryMatchDb/queryMatchDbs)
+ */
+export function isMatchDbAvailable(): boolean {
+  return Boolean(nativeAddon?.queryMatchDb)
+}
+
+/**
+ * Run one read-only statement against a match database on a worker thread.
+ * The file is memory-mapped and the connection with its prepared statement is kept
+ * in a small pool; delete or rewrite the file inside withMatchDbsClosed
+ * @returns null if the addon is not loaded; rejects with SQLite's error message
+ */
+export async function queryMatchDb(dbPath: string, sql: string, params: MatchDbParam[] = []): Promise<MatchDbResult | null> {
+  if (!nativeAddon?.queryMatchDb) {
+    return null
+  }
+  return nativeAddon.queryMatchDb(dbPath, sql, params)
+}
+
+/**
+ * Run a set of read-only statements against each of many match databases on a
+ * worker thread pool, one connection per database
+ * @returns One entry per request in input order, or null if the addon is not loaded
+ */
+export async function queryMatchDbs(requests: Array<{ path: string; queries: MatchDbQuery[] }>): Promise<MatchDbBatchResult[] | null> {
+  if (!nativeAddon?.queryMatchDbs) {
+    return null
+  }
+  return nativeAddon.queryMatchDbs(requests)
+}
+
+/**
+ * Close pooled connections to these databases (all when omitted) so they can be
+ * deleted or rewritten; Windows refuses to while SQLite holds them open
+ */
+export function closeMatchDbs(paths?: string[]): void {
+  if (!nativeAddon?.closeMatchDbs) {
+    return
+  }
+  try {
+    nativeAddon.closeMatchDbs(paths)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in closeMatchDbs:', err)
+  }
+}
+
+/**
+ * Close pooled connections to these databases and run `write` (which deletes or
+ * rewrites them) while no query can reopen them; queries issued meanwhile wait
+ * for it to finish. Queries already running on them are interrupted (and reject)
+ * first, so this holds the calling thread for milliseconds at most.
+ */
+export function withMatchDbsClosed<T>(paths: string[], write: () => T): T {
+  if (!nativeAddon?.holdMatchDbs) {
+    return write()
+  }
+  try {
+    if (!nativeAddon.holdMatchDbs(paths)) {
+      console.warn('[CS2WindowTracker] Queries still running on', paths)
+    }
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in holdMatchDbs:', err)
+  }
+  try {
+    return write()
+  } finally {
+    try {
+      nativeAddon.releaseMatchDbs(paths)
+    } catch (err) {
+      console.error('[CS2WindowTracker] Error in releaseMatchDbs:', err)
+    }
+  }
+}
+
+/**
+ * Row-major view of a result, with NULLs as null, in the shape sql.js' exec() returns
+ */
+export function matchDbRows(result: MatchDbResult): any[][] {
+  const rows: any[][] = []
+  for (let r = 0; r < result.rowCount; r++) {
+    const row = new Array(result.columns.length)
+    for (let c = 0; c < result.columns.length; c++) {
+      const value = result.values[c][r]
+      row[c] = typeof value === 'number' && Number.isNaN(value) ? null : value
+    }
+    rows.push(row)
+  }
+  return rows
+}
+
+export interface DemoWatchEvent {
+  type: 'demoready' | 'demoremoved' | 'overflow' | 'error'
+  path: string // Demo path, or the folder for 'overflow' and 'error'
+  size?: number // 'demoready' only
+  error?: number // Win32 error code, 'error' only
+}
+
+export interface DemoWatchOptions {
+  recursive?: boolean // Include subfolders (default false)
+  settleMs?: number // Quiet time after the last change before a demo is checked (default 1000)
+}
+
+/**
+ * Watch demo folders natively (ReadDirectoryChangesW on one completion port).
+ * 'demoready' fires only once the writer has closed the demo and its size is stable.
+ * Replaces a previous watcher
+ * @returns Number of folders being watched, or -1 if the addon is not loaded or failed
+ */
+export function startDemoWatcher(
+  folders: string[],
+  onEvent: (event: DemoWatchEvent) => void,
+  options: DemoWatchOptions = {}
+): number {
+  if (!nativeAddon?.startDemoWatcher) {
+    return -1
+  }
+  try {
+    return nativeAddon.startDemoWatcher(folders, onEvent, options)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startDemoWatcher:', err)
+    return -1
+  }
+}
+
+export function stopDemoWatcher(): void {
+  if (!nativeAddon?.stopDemoWatcher) {
     return
   }
+  nativeAddon.stopDemoWatcher()
+}
+
+export interface NetconEvent {
+  type: 'connected' | 'disconnected' | 'tick' | 'error'
+  tick?: number // 'tick' only: current demo tick
+  totalTicks?: number // 'tick' only
+  error?: number // 'error' only: Winsock error code
+}
+
+/**
+ * Keep one persistent netcon connection to CS2 (127.0.0.1:port) on a native thread.
+ * Reconnects every second while CS2 is not listening. Replaces a previous client
+ * @param tickIntervalMs Poll demo_goto this often and emit 'tick' on changes (0: off)
+ * @returns false if the addon is not loaded or the client failed to start
+ */
+export function startNetconClient(
+  port: number,
+  onEvent: (event: NetconEvent) => void,
+  options: { tickIntervalMs?: number } = {}
+): boolean {
+  if (!nativeAddon?.startNetconClient) {
+    return false
+  }
   try {
-    nativeAddon.startWinEventHook(targetPid, (event: any) => {
-      const winEvent: WinEvent = {
-        type: event.type,
-        hwnd: BigInt(event.hwnd),
-      }
-      // Add pid if present (for foreground events)
-      if (event.pid !== undefined) {
-        winEvent.pid = Number(event.pid)
-      }
-      callback(winEvent)
+    return Boolean(nativeAddon.startNetconClient(port, onEvent, options))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startNetconClient:', err)
+    return false
+  }
+}
+
+/**
+ * Queue console commands on the persistent connection, written back to back
+ * @returns false (nothing queued) if no client is connected
+ */
+export function netconSend(commands: string | string[]): boolean {
+  if (!nativeAddon?.netconSend) {
+    return false
+  }
+  return Boolean(nativeAddon.netconSend(commands))
+}
+
+/**
+ * Change how often the client polls the demo tick (0 stops polling).
+ * The next poll is reported even if the tick has not moved
+ */
+export function setNetconTickInterval(ms: number): boolean {
+  if (!nativeAddon?.setNetconTickInterval) {
+    return false
+  }
+  return Boolean(nativeAddon.setNetconTickInterval(ms))
+}
+
+export function isNetconConnected(): boolean {
+  if (!nativeAddon?.isNetconConnected) {
+    return false
+  }
+  return Boolean(nativeAddon.isNetconConnected())
+}
+
+export function stopNetconClient(): void {
+  if (!nativeAddon?.stopNetconClient) {
+    return
+  }
+  nativeAddon.stopNetconClient()
+}
+
+export const RESOURCE_SAMPLE_STRIDE = 11
+
+export interface ResourceSample {
+  pid: number
+  timeMs: number // Unix time
+  exited: boolean // Last sample of an exited process, with final totals
+  cpuPercent: number // Of all logical processors since the previous sample (-1 on the first)
+  cpuTimeMs: number // Kernel + user since the process started
+  workingSetBytes: number
+  peakWorkingSetBytes: number
+  privateBytes: number
+  readBytes: number // Since the process started
+  writeBytes: number
+  gpuPercent: number // Busiest GPU engine (-1 if unavailable)
+}
+
+/**
+ * Sample a process' CPU, memory, I/O and GPU use on a background thread
+ * (default every 1000 ms; the interval is shared by all sampled processes).
+ * Samples queue natively until drainResourceSamples()
+ * @returns false if the addon is not loaded or the process could not be opened
+ */
+export function addSampledProcess(pid: number | undefined, options: { intervalMs?: number } = {}): boolean {
+  if (!nativeAddon?.addSampledProcess || !pid) {
+    return false
+  }
+  return Boolean(nativeAddon.addSampledProcess(pid, options))
+}
+
+/**
+ * Stop sampling a process
+ * @returns Its totals so far (final ones once it has exited), or null if it was not sampled
+ */
+export function removeSampledProcess(pid: number | undefined): ResourceSample | null {
+  if (!nativeAddon?.removeSampledProcess || !pid) {
+    return null
+  }
+  return nativeAddon.removeSampledProcess(pid)
+}
+
+/**
+ * Drain queued samples (oldest first). The queue holds 1024 samples; newer ones
+ * are dropped while it is full
+ * @param buffer Reused between calls; its length / RESOURCE_SAMPLE_STRIDE bounds one drain
+ */
+export function drainResourceSamples(buffer: Float64Array = new Float64Array(RESOURCE_SAMPLE_STRIDE * 256)): ResourceSample[] {
+  if (!nativeAddon?.drainResourceSamples) {
+    return []
+  }
+  const count: number = nativeAddon.drainResourceSamples(buffer)
+  const samples: ResourceSample[] = []
+  for (let i = 0; i < count; i++) {
+    const base = i * RESOURCE_SAMPLE_STRIDE
+    samples.push({
+      pid: buffer[base],
+      timeMs: buffer[base + 1],
+      exited: (buffer[base + 2] & 1) !== 0,
+      cpuPercent: buffer[base + 3],
+      cpuTimeMs: buffer[base + 4],
+      workingSetBytes: buffer[base + 5],
+      peakWorkingSetBytes: buffer[base + 6],
+      privateBytes: buffer[base + 7],
+      readBytes: buffer[base + 8],
+      writeBytes: buffer[base + 9],
+      gpuPercent: buffer[base + 10],
     })
+  }
+  return samples
+}
+
+/**
+ * Govern registered helper processes while gamePid is the foreground process:
+ * their job gets a hard CPU cap and each runs at idle priority with EcoQoS.
+ * The limits lift when another app takes the foreground or the game exits
+ * (the addon follows both on a thread of its own). 0 stops governing
+ * @param options.cpuRatePercent Cap for all helpers together, percent of every core (default 25)
+ * @param options.overlayPid Process whose windows (the overlay above the game) keep the limits
+ * @returns Whether the limits are in force now
+ */
+export function setResourceGovernor(gamePid: number, options: { cpuRatePercent?: number; overlayPid?: number } = {}): boolean {
+  if (!nativeAddon?.setResourceGovernor) {
+    return false
+  }
+  return Boolean(nativeAddon.setResourceGovernor(gamePid, options))
+}
+
+/**
+ * Put a spawned helper (parser, ffmpeg, voice extraction) under the resource
+ * governor (whisper is left out so transcription keeps its pace). Exited processes
+ * drop out by themselves
+ * @returns false if the addon is not loaded or the process could not be governed
+ */
+export function governProcess(pid: number | undefined): boolean {
+  if (!nativeAddon?.governProcess || !pid) {
+    return false
+  }
+  return Boolean(nativeAddon.governProcess(pid))
+}
+
+export interface NdjsonRecord {
+  value: Record<string, string | number | boolean | null> | null // Top-level scalar fields; null if the line was not a JSON object
+  line?: string // Raw line: with lines: true, and always when value is null
+  coalesced?: number // Earlier records of the same type this one replaced
+}
+
+export interface NdjsonReaderEnd {
+  bytes: number
+  lines: number // Non-blank lines
+  invalidLines: number // Lines that were not a JSON object (or over 1 MB)
+  error: number // Win32 error that ended reading (0 at end of stream or on stop)
+}
+
+export interface NdjsonReaderOptions {
+  lines?: boolean // Keep every line's raw text
+  coalesce?: string[] // Record types ("type" field) where only the latest undelivered one matters
+}
+
+export interface NdjsonReader {
+  id: number
+  pipePath: string // Open for writing (fs.openSync(pipePath, 'w')) and pass as the child's stdout
+}
+
+/**
+ * Decode a child process' NDJSON output on a native thread. The child writes into
+ * a named pipe instead of a Node stream, so lines are split and parsed without
+ * passing through the JS thread; records arrive in batches, one call per JS turn.
+ * @param onRecords Called per batch; the last call adds end once the writer closed the pipe
+ * @returns The reader, or null if the addon is not loaded or the pipe could not be created
+ */
+export function startNdjsonReader(
+  onRecords: (records: NdjsonRecord[], end?: NdjsonReaderEnd) => void,
+  options: NdjsonReaderOptions = {}
+): NdjsonReader | null {
+  if (!nativeAddon?.startNdjsonReader) {
+    return null
+  }
+  try {
+    return nativeAddon.startNdjsonReader(onRecords, options)
   } catch (err) {
-    console.error('[CS2WindowTracker] Error in startWinEventHook:', err)
+    console.error('[CS2WindowTracker] Error in startNdjsonReader:', err)
+    return null
+  }
+}
+
+/**
+ * Stop reading early; records already decoded and the end call still follow
+ * @returns false if the reader already ended
+ */
+export function stopNdjsonReader(readerId: number): boolean {
+  if (!nativeAddon?.stopNdjsonReader) {
+    return false
+  }
+  return nativeAddon.stopNdjsonReader(readerId)
+}
+
+export interface CaptureOptions {
+  fps?: number // Output frame rate (default 60)
+}
+
+export interface CaptureSession {
+  id: number
+  pipePath: string // Named pipe carrying raw BGRA frames (ffmpeg: -f rawvideo -pix_fmt bgra)
+  width: number // Frame size in physical pixels, fixed for the whole capture
+  height: number
+  fps: number
+}
+
+export interface CaptureStats {
+  frames: number // Frames written to the pipe
+  repeated: number // Frames written again because the desktop had not changed
+  dropped: number // Ticks skipped after a stall
+  reacquired: number // Times the desktop duplication had to be rebuilt
+  error: number // HRESULT that ended the capture (0 if stopped or the reader closed the pipe)
+  stage?: 'connect' | 'write'
+}
+
+/**
+ * Capture a window's client area on the GPU (DXGI desktop duplication) and stream it
+ * as raw BGRA frames into a named pipe for ffmpeg, without intermediate image files.
+ * Frames start once a reader opens pipePath; the output rate is constant.
+ * @param hwnd Window to capture (visible, not minimized; whatever covers it is captured too)
+ * @param onEnded Called with the final stats after the pipe has been closed
+ * @returns The session, or null if the window cannot be captured or the desktop is HDR / not 8-bit BGRA
+ */
+export function startCapture(
+  hwnd: bigint,
+  onEnded: (stats: CaptureStats) => void,
+  options: CaptureOptions = {}
+): CaptureSession | null {
+  if (!nativeAddon?.startCapture) {
+    console.warn('[CS2WindowTracker] Native addon not loaded, cannot start capture')
+    return null
+  }
+  try {
+    return nativeAddon.startCapture(hwnd, onEnded, options)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startCapture:', err)
+    return null
   }
 }
 
+/**
+ * Stop a capture; onEnded follows once the last frames are flushed to the reader
+ * @returns false if the capture already ended
+ */
+export function stopCapture(captureId: number): boolean {
+  if (!nativeAddon?.stopCapture) {
+    return false
+  }
+  return nativeAddon.stopCapture(captureId)
+}
+
+export interface FrameStream {
+  id: number
+  pipePath: string // Named pipe carrying the frames as rawvideo, once the format is known
+}
+
+export type FrameStreamEvent =
+  | {
+      type: 'format' // First frame is complete: open pipePath with ffmpeg within 15 s
+      width: number
+      height: number
+      pixelFormat: 'bgra' | 'bgr24' // ffmpeg -pix_fmt
+    }
+  | {
+      type: 'ended' // Pipe closed
+      frames: number // Frames written (and deleted from the folder)
+      bytes: number
+      error: number // Win32 error that ended the stream early (0 if finished, stopped or the reader closed the pipe)
+      stage?: 'watch' | 'connect' | 'write'
+    }
+
+/**
+ * Stream an HLAE TGA recording into a named pipe while it is being recorded:
+ * frames are sent in name order as soon as they are complete and deleted once
+ * written, so encoding overlaps recording instead of following it.
+ * @param directory Folder HLAE records into (watched with its subfolders)
+ * @param onEvent Called with the format once known, then when the pipe closes
+ * @returns The stream, or null if the folder cannot be watched
+ */
+export function startFrameStream(
+  directory: string,
+  onEvent: (event: FrameStreamEvent) => void
+): FrameStream | null {
+  if (!nativeAddon?.startFrameStream) {
+    return null
+  }
+  try {
+    return nativeAddon.startFrameStream(directory, onEvent)
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in startFrameStream:', err)
+    return null
+  }
+}
+
+/**
+ * Recording has stopped: send the remaining frames, then close the pipe
+ * @returns false if the stream already ended
+ */
+export function finishFrameStream(streamId: number): boolean {
+  if (!nativeAddon?.finishFrameStream) {
+    return false
+  }
+  return nativeAddon.finishFrameStream(streamId)
+}
+
+/**
+ * Close the pipe after the frame in flight; unsent frames stay in the folder
+ * @returns false if the stream already ended
+ */
+export function stopFrameStream(streamId: number): boolean {
+  if (!nativeAddon?.stopFrameStream) {
+    return false
+  }
+  return nativeAddon.stopFrameStream(streamId)
+}
+
 /**
  * Stop WinEvent hook
  */
@@ -193,6 +1334,88 @@ export function stopWinEventHook(): void {
   nativeAddon.stopWinEventHook()
 }
 
+export interface HookTypeStats {
+  raw: number
+  filtered: number
+  delivered: number
+  coalesced: number
+}
+
+export interface LatencyHistogram {
+  count: number
+  meanUs: number
+  maxUs: number
+  /** Percentiles, rounded up to their histogram bucket bound */
+  p50Us: number
+  p95Us: number
+  p99Us: number
+  /** buckets[i] counts latencies below 2^(i+1) us (and at least 2^i us, except buckets[0]) */
+  buckets: number[]
+}
+
+export interface HookStats {
+  /** WinEventProc invocations since the hook was started */
+  raw: number
+  /** Callbacks dropped natively (other windows/objects, unhandled events) */
+  filtered: number
+  /** Events delivered to JS */
+  delivered: number
+  /** Location changes absorbed natively because the client rect did not change */
+  coalesced: number
+  /** Batch mode: records discarded because the ring buffer was full */
+  dropped: number
+  /** Deepest native event queue (ring buffer or thread-safe callback queue) */
+  maxQueueDepth: number
+  /** Counters by event type (raw/filtered/coalesced by source event, delivered by emitted event) */
+  byType: Partial<Record<WinEvent['type'], HookTypeStats>>
+  latency: {
+    /** OS event timestamp -> event handed to JS */
+    delivery: LatencyHistogram
+    /** OS event timestamp -> overlay repositioned (native follow) or 'boundschanged' handed to JS */
+    bounds: LatencyHistogram
+  }
+}
+
+/**
+ * Get WinEvent hook callback counters for the current hook session
+ * @returns Counters or null if the addon is not loaded
+ */
+export function getHookStats(): HookStats | null {
+  if (!nativeAddon) {
+    return null
+  }
+  try {
+    const result = nativeAddon.getHookStats()
+    return {
+      raw: Number(result.raw),
+      filtered: Number(result.filtered),
+      delivered: Number(result.delivered),
+      coalesced: Number(result.coalesced ?? 0),
+      dropped: Number(result.dropped),
+      maxQueueDepth: Number(result.maxQueueDepth ?? 0),
+      byType: result.byType ?? {},
+      latency: result.latency,
+    }
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in getHookStats:', err)
+    return null
+  }
+}
+
+/**
+ * Zero hook counters and latency histograms (starting the first hook target also does this)
+ */
+export function resetHookStats(): void {
+  if (!nativeAddon) {
+    return
+  }
+  try {
+    nativeAddon.resetHookStats()
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in resetHookStats:', err)
+  }
+}
+
 /**
  * Get the process ID of the foreground window
  * @returns Process ID or null if failed
@@ -228,4 +1451,22 @@ export function forceActivateWindow(hwnd: bigint): boolean {
     console.error('[CS2WindowTracker] Error in forceActivateWindow:', err)
     return false
   }
+}
+
+/**
+ * Hide one of this app's windows (e.g. the overlay) from screen capture, including
+ * the desktop duplication used by startCapture(), while it stays visible on screen
+ * @param handle BrowserWindow.getNativeWindowHandle() or hwnd
+ * @returns false on Windows before 10 2004, or if the window is not ours
+ */
+export function setWindowExcludedFromCapture(handle: Buffer | bigint, excluded: boolean): boolean {
+  if (!nativeAddon?.setWindowExcludedFromCapture) {
+    return false
+  }
+  try {
+    return Boolean(nativeAddon.setWindowExcludedFromCapture(handle, excluded))
+  } catch (err) {
+    console.error('[CS2WindowTracker] Error in setWindowExcludedFromCapture:', err)
+    return false
+  }
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+// Shared by the Windows backend's translation units: the per-environment
+// addon state, the helpers more than one subsystem uses and every subsystem's
+// JS entry points, which cs2_window_tracker.cpp registers in Init. Each
+// subsystem (capture, waveform, demo scan, voice, demo watcher, netcon, NDJSON
+// reader, resource sampler, match database) lives in its own source file.
+#pragma once
+
+#include <napi.h>
+#include <windows.h>
+#include <dxgi.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "hook_dispatch.h"
+
+// The waveform reducer and the NDJSON scanner have SSE2 paths; every x64
+// compiler provides them
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NATIVE_SSE2 1
+#endif
+
+struct HookHost;
+struct HookTarget;
+
+struct WindowStateFields {
+  bool valid;
+  RECT bounds;
+  bool minimized;
+  DWORD foregroundPid;
+  UINT dpi;
+  bool cloaked;
+};
+
+struct WindowWaitRequest;
+struct HitTestHost;
+struct HotkeyHost;
+struct FollowPacer;
+struct CaptureSession;
+struct FrameStream;
+struct DemoWatchHost;
+struct NetconClient;
+struct MatchDbPool;
+struct NdjsonReader;
+struct ResourceGovernor;
+struct ResourceSampler;
+
+// Per-environment addon state. Every Node environment that loads the addon (the
+// main process, a worker thread, a utilityProcess) gets its own instance, so
+// hooks, targets and the state block never cross environments. Node deletes it
+// on environment exit, after every thread-safe function has been finalized.
+class Cs2WindowTracker : public Napi::Addon<Cs2WindowTracker> {
+public:
+  Cs2WindowTracker(Napi::Env env, Napi::Object exports);
+  ~Cs2WindowTracker();
+
+  HookHost* hookHost; // Running while any target exists
+  std::map<uint32_t, HookTarget*> targets; // JS thread only
+  uint32_t nextTargetId;
+  std::set<WindowWaitRequest*> windowWaits; // Pending waitForWindow() calls (JS thread only)
+  HookTarget* primaryTarget; // startWinEventHook's target (JS thread only)
+  HookCounters hookCounters;
+  volatile LONG* stateBlock;
+  Napi::Reference<Napi::ArrayBuffer> stateBlockRef;
+  WindowStateFields published; // Last values written to the state block (hook thread)
+  HitTestHost* hitTest;
+  HotkeyHost* hotkeys;
+  HWND hotkeyOverlay; // setOverlayHotkeyWindow(), kept while hotkeys are re-registered
+  FollowPacer* followPacer; // Created with the first frame-paced follow
+  std::map<uint32_t, CaptureSession*> captures; // JS thread only
+  uint32_t nextCaptureId;
+  std::map<uint32_t, FrameStream*> frameStreams; // JS thread only
+  uint32_t nextFrameStreamId;
+  DemoWatchHost* demoWatch;
+  NetconClient* netcon;
+  std::map<uint32_t, NdjsonReader*> ndjsonReaders; // JS thread only
+  uint32_t nextNdjsonReaderId;
+  ResourceGovernor* governor;
+  ResourceSampler* sampler; // Started with the first sampled process
+  std::shared_ptr<MatchDbPool> matchDbs; // Shared with running queries, which may outlive the environment
+};
+
+inline Cs2WindowTracker* AddonFor(Napi::Env env) {
+  return env.GetInstanceData<Cs2WindowTracker>();
+}
+
+extern LONGLONG g_qpcFrequency; // QueryPerformanceFrequency, set in Init
+LONGLONG QpcNow();
+
+// Client area of a window in screen coordinates (left/top/right/bottom)
+bool GetClientRectOnScreen(HWND hwnd, RECT* out);
+
+template <typename T>
+void ReleaseCom(T*& object) {
+  if (object) {
+    object->Release();
+    object = nullptr;
+  }
+}
+
+// The DXGI output (and its adapter) showing a monitor, or nullptr
+IDXGIOutput* FindDxgiOutput(HMONITOR monitor, IDXGIAdapter1** adapterOut);
+
+// Convert a UTF-16 string (window title, path) to UTF-8 for JS
+std::string WideToUtf8(const std::wstring& wide);
+
+// Read a window handle passed as BrowserWindow.getNativeWindowHandle() (HWND bytes)
+// or as a bigint. Returns false if the value is neither.
+bool ParseWindowHandle(const Napi::Value& value, HWND* out);
+
+// capture.cpp: client-area capture and HLAE frame streaming
+Napi::Value StartCapture(const Napi::CallbackInfo& info);
+Napi::Value StopCapture(const Napi::CallbackInfo& info);
+Napi::Value StartFrameStream(const Napi::CallbackInfo& info);
+Napi::Value FinishFrameStream(const Napi::CallbackInfo& info);
+Napi::Value StopFrameStream(const Napi::CallbackInfo& info);
+
+// waveform.cpp
+Napi::Value ComputeWaveformPeaks(const Napi::CallbackInfo& info);
+
+// demo_scan.cpp
+Napi::Value ScanDemos(const Napi::CallbackInfo& info);
+
+// voice_extract.cpp
+Napi::Value ExtractVoice(const Napi::CallbackInfo& info);
+
+// demo_watcher.cpp
+Napi::Value StartDemoWatcher(const Napi::CallbackInfo& info);
+Napi::Value StopDemoWatcher(const Napi::CallbackInfo& info);
+
+// netcon.cpp
+Napi::Value StartNetconClient(const Napi::CallbackInfo& info);
+Napi::Value NetconSend(const Napi::CallbackInfo& info);
+Napi::Value SetNetconTickInterval(const Napi::CallbackInfo& info);
+Napi::Value IsNetconConnected(const Napi::CallbackInfo& info);
+Napi::Value StopNetconClient(const Napi::CallbackInfo& info);
+
+// ndjson_reader.cpp
+Napi::Value StartNdjsonReader(const Napi::CallbackInfo& info);
+Napi::Value StopNdjsonReader(const Napi::CallbackInfo& info);
+
+// resource_sampler.cpp
+void StopResourceSampler(Cs2WindowTracker* addon);
+Napi::Value AddSampledProcess(const Napi::CallbackInfo& info);
+Napi::Value RemoveSampledProcess(const Napi::CallbackInfo& info);
+Napi::Value DrainResourceSamples(const Napi::CallbackInfo& info);
+
+// match_db.cpp
+std::shared_ptr<MatchDbPool> CreateMatchDbPool();
+bool CloseMatchDbConnections(MatchDbPool* pool, const std::vector<std::string>* paths, bool hold);
+Napi::Value QueryMatchDb(const Napi::CallbackInfo& info);
+Napi::Value QueryMatchDbs(const Napi::CallbackInfo& info);
+Napi::Value CloseMatchDbs(const Napi::CallbackInfo& info);
+Napi::Value HoldMatchDbs(const Napi::CallbackInfo& info);
+Napi::Value ReleaseMatchDbs(const Napi::CallbackInfo& info);
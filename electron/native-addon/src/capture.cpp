@@ -0,0 +1,1016 @@
+#include "addon.h"
+#include <d3d11.h>
+#include <dxgi1_6.h>
+#include <mmsystem.h>
+#include <cstdio>
+#include <set>
+#include <cwctype>
+#include <future>
+
+// Client-area capture: DXGI desktop duplication of the monitor the tracked window
+// is on, cropped to its client rect on the GPU and read back once per output frame
+// as raw BGRA into a named pipe that ffmpeg reads as rawvideo, so no frame ever
+// touches the disk. Output runs at a constant rate: when the desktop has not
+// changed since the last tick, the previous frame is written again.
+#define CAPTURE_CONNECT_TIMEOUT_MS 15000 // How long the pipe waits for its reader
+#define CAPTURE_STOP_WRITE_TIMEOUT_MS 2000 // Grace for the frame in flight when stopped
+#define CAPTURE_MAX_CATCH_UP_FRAMES 30 // Late ticks written as repeats before the rest are dropped
+
+struct CaptureSession {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  uint32_t id;
+  HWND hwnd;
+  UINT fps;
+  UINT width; // Output frame size, fixed at start (even, as yuv420 encoders need)
+  UINT height;
+  HANDLE pipe;
+  HANDLE stopEvent; // Set by stopCapture()
+  // Capture thread only
+  ID3D11Device* device;
+  ID3D11DeviceContext* context;
+  IDXGIOutputDuplication* duplication;
+  ID3D11Texture2D* staging; // width x height, CPU readable
+  HMONITOR monitor;
+  RECT outputRect; // Duplicated output in desktop coordinates
+  bool stagingFresh; // staging holds a crop not yet read back into `frame`
+  std::vector<uint8_t> frame; // Packed BGRA rows, as written to the pipe
+  uint64_t framesWritten;
+  uint64_t framesRepeated;
+  uint64_t framesDropped;
+  uint32_t reacquired; // Duplications rebuilt (mode change, secure desktop, monitor change)
+  HRESULT error; // What ended the capture (0: stopped, or the reader closed the pipe)
+  const char* errorStage;
+  Napi::ThreadSafeFunction tsfn;
+};
+
+void ReleaseDuplication(CaptureSession* session) {
+  ReleaseCom(session->staging);
+  ReleaseCom(session->duplication);
+  ReleaseCom(session->context);
+  ReleaseCom(session->device);
+}
+
+// Capture thread: whether duplicated frames are plain 8-bit sRGB BGRA. HDR
+// outputs (PQ / BT.2020) and other desktop formats are refused rather than
+// mislabelled as bgra.
+bool IsBgraDuplication(IDXGIOutputDuplication* duplication, IDXGIOutput* output) {
+  DXGI_OUTDUPL_DESC duplDesc = {};
+  duplication->GetDesc(&duplDesc);
+  if (duplDesc.ModeDesc.Format != DXGI_FORMAT_B8G8R8A8_UNORM) {
+    return false;
+  }
+
+  IDXGIOutput6* output6 = nullptr;
+  if (FAILED(output->QueryInterface(__uuidof(IDXGIOutput6), reinterpret_cast<void**>(&output6)))) {
+    return true; // Pre-1803 Windows: no HDR desktop
+  }
+  DXGI_OUTPUT_DESC1 desc1 = {};
+  bool sdr = FAILED(output6->GetDesc1(&desc1)) || desc1.ColorSpace == DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
+  output6->Release();
+  return sdr;
+}
+
+// Capture thread: duplicate the output showing the window, on a device created
+// on that output's adapter (duplication only works there)
+HRESULT CreateDuplication(CaptureSession* session) {
+  ReleaseDuplication(session);
+  HMONITOR monitor = MonitorFromWindow(session->hwnd, MONITOR_DEFAULTTONEAREST);
+
+  IDXGIAdapter1* adapter = nullptr;
+  IDXGIOutput* output = FindDxgiOutput(monitor, &adapter);
+  if (!output) {
+    return DXGI_ERROR_NOT_FOUND;
+  }
+  DXGI_OUTPUT_DESC outputDesc = {};
+  output->GetDesc(&outputDesc);
+
+  IDXGIOutput1* output1 = nullptr;
+  HRESULT hr = D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+    NULL, 0, D3D11_SDK_VERSION, &session->device, NULL, &session->context);
+  if (SUCCEEDED(hr)) {
+    hr = output->QueryInterface(__uuidof(IDXGIOutput1), reinterpret_cast<void**>(&output1));
+  }
+  if (SUCCEEDED(hr)) {
+    hr = output1->DuplicateOutput(session->device, &session->duplication);
+  }
+  if (SUCCEEDED(hr) && !IsBgraDuplication(session->duplication, output)) {
+    hr = DXGI_ERROR_UNSUPPORTED; // The pipe is declared as 8-bit bgra rawvideo
+  }
+  if (SUCCEEDED(hr)) {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = session->width;
+    desc.Height = session->height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    hr = session->device->CreateTexture2D(&desc, NULL, &session->staging);
+  }
+  ReleaseCom(output1);
+  output->Release();
+  adapter->Release();
+
+  if (FAILED(hr)) {
+    ReleaseDuplication(session);
+    return hr;
+  }
+  session->monitor = monitor;
+  session->outputRect = outputDesc.DesktopCoordinates;
+  session->stagingFresh = false;
+  return S_OK;
+}
+
+// Capture thread: copy the window's client rect out of a duplicated desktop image
+// (GPU to GPU). Parts off the output, or beyond a window that has since shrunk,
+// keep their previous pixels.
+void CopyClientArea(CaptureSession* session, ID3D11Texture2D* desktop) {
+  RECT client;
+  if (IsIconic(session->hwnd) || !GetClientRectOnScreen(session->hwnd, &client)) {
+    return;
+  }
+
+  const RECT& output = session->outputRect;
+  LONG left = std::max(client.left, output.left);
+  LONG top = std::max(client.top, output.top);
+  LONG right = std::min({ client.right, client.left + static_cast<LONG>(session->width), output.right });
+  LONG bottom = std::min({ client.bottom, client.top + static_cast<LONG>(session->height), output.bottom });
+  if (right <= left || bottom <= top) {
+    return;
+  }
+
+  D3D11_BOX box = {
+    static_cast<UINT>(left - output.left), static_cast<UINT>(top - output.top), 0,
+    static_cast<UINT>(right - output.left), static_cast<UINT>(bottom - output.top), 1
+  };
+  session->context->CopySubresourceRegion(session->staging, 0,
+    static_cast<UINT>(left - client.left), static_cast<UINT>(top - client.top), 0, desktop, 0, &box);
+  session->stagingFresh = true;
+}
+
+// Capture thread: read the staging crop back into the packed frame buffer.
+// The copy was queued when the desktop frame arrived, so by the next tick the
+// GPU has normally finished it and Map does not stall.
+void ReadBackStaging(CaptureSession* session) {
+  D3D11_MAPPED_SUBRESOURCE mapped;
+  if (FAILED(session->context->Map(session->staging, 0, D3D11_MAP_READ, 0, &mapped))) {
+    return;
+  }
+  size_t rowBytes = static_cast<size_t>(session->width) * 4;
+  const uint8_t* source = static_cast<const uint8_t*>(mapped.pData);
+  for (UINT y = 0; y < session->height; y++) {
+    memcpy(&session->frame[y * rowBytes], source + static_cast<size_t>(y) * mapped.RowPitch, rowBytes);
+  }
+  session->context->Unmap(session->staging, 0);
+  session->stagingFresh = false;
+}
+
+void FailCapture(CaptureSession* session, HRESULT error, const char* stage) {
+  if (!session->error) {
+    session->error = error;
+    session->errorStage = stage;
+  }
+}
+
+// Capture thread: wait for ffmpeg to open the pipe. False on stop, timeout or error.
+bool ConnectCaptureReader(CaptureSession* session, OVERLAPPED* overlapped) {
+  if (!ConnectNamedPipe(session->pipe, overlapped)) {
+    DWORD error = GetLastError();
+    if (error == ERROR_PIPE_CONNECTED) {
+      return true;
+    }
+    if (error != ERROR_IO_PENDING) {
+      FailCapture(session, HRESULT_FROM_WIN32(error), "connect");
+      return false;
+    }
+  }
+
+  HANDLE waits[] = { overlapped->hEvent, session->stopEvent };
+  DWORD result = WaitForMultipleObjects(2, waits, FALSE, CAPTURE_CONNECT_TIMEOUT_MS);
+  DWORD transferred = 0;
+  if (result == WAIT_OBJECT_0) {
+    if (GetOverlappedResult(session->pipe, overlapped, &transferred, FALSE)) {
+      return true;
+    }
+    FailCapture(session, HRESULT_FROM_WIN32(GetLastError()), "connect");
+    return false;
+  }
+
+  CancelIoEx(session->pipe, overlapped);
+  GetOverlappedResult(session->pipe, overlapped, &transferred, TRUE);
+  if (result == WAIT_TIMEOUT) {
+    FailCapture(session, HRESULT_FROM_WIN32(ERROR_TIMEOUT), "connect");
+  }
+  return false;
+}
+
+// Capture thread: write the packed frame and wait until the pipe has taken it.
+// A stop only waits a little for the frame in flight. False if the capture is over.
+bool WriteCaptureFrame(CaptureSession* session, OVERLAPPED* overlapped) {
+  DWORD transferred = 0;
+  ResetEvent(overlapped->hEvent);
+  if (!WriteFile(session->pipe, session->frame.data(), static_cast<DWORD>(session->frame.size()), NULL, overlapped)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_IO_PENDING) {
+      // The reader closing its end is how ffmpeg ends the capture
+      if (error != ERROR_NO_DATA && error != ERROR_BROKEN_PIPE) {
+        FailCapture(session, HRESULT_FROM_WIN32(error), "write");
+      }
+      return false;
+    }
+  }
+
+  HANDLE waits[] = { overlapped->hEvent, session->stopEvent };
+  DWORD result = WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+  if (result != WAIT_OBJECT_0 && WaitForSingleObject(overlapped->hEvent, CAPTURE_STOP_WRITE_TIMEOUT_MS) != WAIT_OBJECT_0) {
+    CancelIoEx(session->pipe, overlapped);
+    GetOverlappedResult(session->pipe, overlapped, &transferred, TRUE);
+    return false;
+  }
+  if (!GetOverlappedResult(session->pipe, overlapped, &transferred, FALSE)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_NO_DATA && error != ERROR_BROKEN_PIPE) {
+      FailCapture(session, HRESULT_FROM_WIN32(error), "write");
+    }
+    return false;
+  }
+  session->framesWritten++;
+  return true;
+}
+
+// Capture thread: acquire desktop frames as they are presented and write one
+// frame per tick until stopped or the reader goes away
+void RunCaptureLoop(CaptureSession* session, OVERLAPPED* overlapped) {
+  LONGLONG period = std::max<LONGLONG>(1, g_qpcFrequency / session->fps);
+  LONGLONG deadline = QpcNow(); // The first frame goes out as soon as the reader is there
+
+  while (WaitForSingleObject(session->stopEvent, 0) == WAIT_TIMEOUT) {
+    LONGLONG now = QpcNow();
+    if (now >= deadline) {
+      if (session->stagingFresh) {
+        ReadBackStaging(session);
+      } else {
+        session->framesRepeated++;
+      }
+      if (!WriteCaptureFrame(session, overlapped)) {
+        break;
+      }
+      deadline += period;
+      // A long stall (reader busy, GPU reset) is not replayed frame by frame
+      LONGLONG behind = QpcNow() - deadline;
+      if (behind > period * CAPTURE_MAX_CATCH_UP_FRAMES) {
+        LONGLONG missed = behind / period;
+        session->framesDropped += static_cast<uint64_t>(missed);
+        deadline += missed * period;
+      }
+      continue;
+    }
+
+    // The window moved to another monitor: follow it to that output
+    if (session->duplication && MonitorFromWindow(session->hwnd, MONITOR_DEFAULTTONEAREST) != session->monitor) {
+      ReleaseDuplication(session);
+    }
+    DWORD waitMs = static_cast<DWORD>((deadline - now) * 1000 / g_qpcFrequency);
+    if (!session->duplication) {
+      if (FAILED(CreateDuplication(session))) {
+        WaitForSingleObject(session->stopEvent, waitMs); // Retry next tick; repeats meanwhile
+        continue;
+      }
+      session->reacquired++;
+    }
+
+    DXGI_OUTDUPL_FRAME_INFO frameInfo;
+    IDXGIResource* resource = nullptr;
+    HRESULT hr = session->duplication->AcquireNextFrame(waitMs, &frameInfo, &resource);
+    if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
+      continue;
+    }
+    if (FAILED(hr)) {
+      // DXGI_ERROR_ACCESS_LOST (mode change, fullscreen switch) and secure desktop
+      // errors: rebuilt on the next pass
+      ReleaseDuplication(session);
+      continue;
+    }
+    // A zero present time means only the pointer moved
+    if (frameInfo.LastPresentTime.QuadPart != 0) {
+      ID3D11Texture2D* desktop = nullptr;
+      if (SUCCEEDED(resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&desktop)))) {
+        CopyClientArea(session, desktop);
+        desktop->Release();
+      }
+    }
+    resource->Release();
+    session->duplication->ReleaseFrame();
+  }
+}
+
+Napi::Object CaptureStatsToObject(Napi::Env env, const CaptureSession* session) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("frames", Napi::Number::New(env, static_cast<double>(session->framesWritten)));
+  result.Set("repeated", Napi::Number::New(env, static_cast<double>(session->framesRepeated)));
+  result.Set("dropped", Napi::Number::New(env, static_cast<double>(session->framesDropped)));
+  result.Set("reacquired", Napi::Number::New(env, session->reacquired));
+  result.Set("error", Napi::Number::New(env, static_cast<double>(static_cast<uint32_t>(session->error))));
+  if (session->errorStage) {
+    result.Set("stage", Napi::String::New(env, session->errorStage));
+  }
+  return result;
+}
+
+// Capture thread: owns the D3D device and duplication. Reports the first
+// CreateDuplication result through `ready`; after a success it owns the session
+// until it hands it back to JS with the final stats.
+void CaptureThreadMain(CaptureSession* session, std::promise<HRESULT> ready) {
+  HRESULT hr = CreateDuplication(session);
+  ready.set_value(hr);
+  if (FAILED(hr)) {
+    return;
+  }
+
+  timeBeginPeriod(1); // AcquireNextFrame/WaitForSingleObject timeouts at frame granularity
+  OVERLAPPED overlapped = {};
+  overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (ConnectCaptureReader(session, &overlapped)) {
+    RunCaptureLoop(session, &overlapped);
+    // Closing a pipe discards unread bytes; let ffmpeg take the last frames first
+    FlushFileBuffers(session->pipe);
+  }
+  CloseHandle(overlapped.hEvent);
+  timeEndPeriod(1);
+  ReleaseDuplication(session);
+
+  // EOF tells ffmpeg the stream is complete
+  CloseHandle(session->pipe);
+  session->pipe = NULL;
+
+  Napi::ThreadSafeFunction tsfn = session->tsfn;
+  tsfn.BlockingCall(session, [](Napi::Env env, Napi::Function jsCallback, CaptureSession* ended) {
+    ended->addon->captures.erase(ended->id);
+    if (env != nullptr && jsCallback != nullptr) {
+      jsCallback.Call({ CaptureStatsToObject(env, ended) });
+    }
+  });
+  tsfn.Release();
+}
+
+// startCapture(hwnd: bigint, onEnded: (stats) => void, options?: { fps?: number }):
+//   { id, pipePath, width, height, fps } | null
+// Starts capturing the window's client area (size fixed now, rounded down to even)
+// into a new named pipe at pipePath; open it with ffmpeg as
+// `-f rawvideo -pix_fmt bgra -video_size WxH -framerate fps -i <pipePath>`.
+// Frames flow once the reader connects (within 15 s). onEnded receives
+// { frames, repeated, dropped, reacquired, error, stage? } after the pipe is closed.
+// Returns null if the window is gone or minimized; throws if duplication is unavailable
+// or the desktop is not 8-bit SDR BGRA (HDR, wide formats), which the pipe cannot carry.
+Napi::Value StartCapture(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  HWND hwnd = NULL;
+  if (info.Length() < 2 || !ParseWindowHandle(info[0], &hwnd) || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (bigint hwnd, function onEnded, options?)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  UINT fps = 60;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Value fpsValue = info[2].As<Napi::Object>().Get("fps");
+    if (fpsValue.IsNumber()) {
+      fps = std::min<UINT>(240, std::max<UINT>(1, fpsValue.As<Napi::Number>().Uint32Value()));
+    }
+  }
+
+  RECT client;
+  if (!IsWindow(hwnd) || IsIconic(hwnd) || !GetClientRectOnScreen(hwnd, &client)) {
+    return env.Null();
+  }
+  UINT width = static_cast<UINT>(std::max<LONG>(0, client.right - client.left)) & ~1u;
+  UINT height = static_cast<UINT>(std::max<LONG>(0, client.bottom - client.top)) & ~1u;
+  if (width == 0 || height == 0) {
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  uint32_t id = addon->nextCaptureId++;
+  std::string pipePath = "\\\\.\\pipe\\cs2-capture-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(id);
+  std::wstring widePipePath(pipePath.begin(), pipePath.end());
+  DWORD frameBytes = width * height * 4;
+  HANDLE pipe = CreateNamedPipeW(widePipePath.c_str(),
+    PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+    PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+    1, frameBytes, 0, 0, NULL);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    std::string errorMsg = "Failed to create capture pipe. Error code: " + std::to_string(GetLastError());
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  CaptureSession* session = new CaptureSession();
+  session->addon = addon;
+  session->id = id;
+  session->hwnd = hwnd;
+  session->fps = fps;
+  session->width = width;
+  session->height = height;
+  session->pipe = pipe;
+  session->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  session->device = nullptr;
+  session->context = nullptr;
+  session->duplication = nullptr;
+  session->staging = nullptr;
+  session->monitor = NULL;
+  session->outputRect = { 0, 0, 0, 0 };
+  session->stagingFresh = false;
+  session->frame.assign(frameBytes, 0); // Black until the first desktop frame arrives
+  session->framesWritten = 0;
+  session->framesRepeated = 0;
+  session->framesDropped = 0;
+  session->reacquired = 0;
+  session->error = S_OK;
+  session->errorStage = nullptr;
+  session->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2Capture",
+    0,
+    1,
+    [](Napi::Env, CaptureSession* finalized) {
+      // The thread has normally released and is exiting; on environment
+      // teardown mid-capture it is still running and must be stopped first
+      if (finalized->thread.joinable()) {
+        SetEvent(finalized->stopEvent);
+        finalized->thread.join();
+      }
+      finalized->addon->captures.erase(finalized->id);
+      if (finalized->pipe) {
+        CloseHandle(finalized->pipe);
+      }
+      CloseHandle(finalized->stopEvent);
+      delete finalized;
+    },
+    session
+  );
+
+  std::promise<HRESULT> ready;
+  std::future<HRESULT> readyResult = ready.get_future();
+  session->thread = std::thread(CaptureThreadMain, session, std::move(ready));
+  HRESULT hr = readyResult.get();
+  if (FAILED(hr)) {
+    session->thread.join();
+    session->tsfn.Release();
+    char errorMsg[96];
+    snprintf(errorMsg, sizeof(errorMsg), "Failed to start desktop duplication. HRESULT: 0x%08lX",
+      static_cast<unsigned long>(hr));
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  addon->captures[id] = session;
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("id", Napi::Number::New(env, id));
+  result.Set("pipePath", Napi::String::New(env, pipePath));
+  result.Set("width", Napi::Number::New(env, width));
+  result.Set("height", Napi::Number::New(env, height));
+  result.Set("fps", Napi::Number::New(env, fps));
+  return result;
+}
+
+// stopCapture(id: number): boolean
+// Ends a capture after the frame in flight; onEnded follows once the pipe is
+// flushed and closed. Returns false if the id is unknown or already ended.
+Napi::Value StopCapture(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected capture id").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  auto found = addon->captures.find(info[0].As<Napi::Number>().Uint32Value());
+  if (found == addon->captures.end()) {
+    return Napi::Boolean::New(env, false);
+  }
+  SetEvent(found->second->stopEvent);
+  return Napi::Boolean::New(env, true);
+}
+
+// Frame streaming: HLAE dumps a recording as one TGA per frame; instead of
+// waiting for the whole sequence, a thread watches the folder and feeds each
+// frame into a named pipe for ffmpeg (rawvideo) as soon as it is complete,
+// deleting it once written. Encoding overlaps recording and the folder never
+// holds more than the frames ffmpeg has not taken yet. A frame is complete once
+// a later one exists (HLAE writes them in order) or the recording has finished,
+// and HLAE no longer has it open.
+#define FRAME_STREAM_CONNECT_TIMEOUT_MS 15000 // How long the pipe waits for ffmpeg after the format is known
+#define FRAME_STREAM_POLL_MS 50 // Re-check for a frame still open for writing
+#define FRAME_STREAM_NOTIFY_BYTES (64 * 1024)
+#define FRAME_STREAM_STOP_WRITE_TIMEOUT_MS 1000
+
+struct FrameStream {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  uint32_t id;
+  std::wstring directory;
+  HANDLE directoryHandle;
+  HANDLE pipe;
+  HANDLE stopEvent; // stopFrameStream(): end now, leaving unsent frames on disk
+  HANDLE finishEvent; // finishFrameStream(): no frames will be added; send the rest, then end
+  // Stream thread only
+  std::set<std::wstring> frames; // Names relative to directory, not sent yet; HLAE's zero-padded numbers sort in order
+  std::vector<DWORD> notifyBuffer; // DWORD-aligned, as ReadDirectoryChangesW requires
+  std::vector<uint8_t> flipped; // Bottom-up frames are turned upright here
+  bool connected;
+  UINT width; // Fixed by the first frame
+  UINT height;
+  UINT bytesPerPixel;
+  uint64_t framesWritten;
+  uint64_t bytesWritten;
+  DWORD error; // What ended the stream early (0: finished, stopped or ffmpeg closed the pipe)
+  const char* errorStage;
+  Napi::ThreadSafeFunction tsfn;
+};
+
+bool IsTgaFileName(const std::wstring& name) {
+  if (name.size() < 4) {
+    return false;
+  }
+  const wchar_t* extension = name.c_str() + name.size() - 4;
+  return extension[0] == L'.' && towlower(extension[1]) == L't' &&
+    towlower(extension[2]) == L'g' && towlower(extension[3]) == L'a';
+}
+
+void FailFrameStream(FrameStream* stream, DWORD error, const char* stage) {
+  if (!stream->error) {
+    stream->error = error;
+    stream->errorStage = stage;
+  }
+}
+
+// Uncompressed true-color TGA: where the pixels start and how they are laid out
+struct TgaLayout {
+  UINT width;
+  UINT height;
+  UINT bytesPerPixel;
+  size_t pixelOffset;
+  bool topDown;
+};
+
+bool ParseTgaHeader(const uint8_t* data, size_t size, TgaLayout* layout) {
+  if (size < 18) {
+    return false;
+  }
+  uint8_t idLength = data[0];
+  uint8_t colorMapType = data[1];
+  uint8_t imageType = data[2];
+  uint8_t bitsPerPixel = data[16];
+  if (colorMapType != 0 || imageType != 2 || (bitsPerPixel != 24 && bitsPerPixel != 32)) {
+    return false; // Palettes and RLE are not something HLAE writes
+  }
+  layout->width = data[12] | (data[13] << 8);
+  layout->height = data[14] | (data[15] << 8);
+  layout->bytesPerPixel = bitsPerPixel / 8;
+  layout->pixelOffset = 18 + idLength;
+  layout->topDown = (data[17] & 0x20) != 0;
+  size_t frameBytes = static_cast<size_t>(layout->width) * layout->height * layout->bytesPerPixel;
+  return layout->width > 0 && layout->height > 0 && size >= layout->pixelOffset + frameBytes;
+}
+
+// Top level only, like ScanFrameDirectory: HLAE writes one stream's frames
+// into one folder, and frames of another stream below it must not be mixed in
+bool QueueFrameDirectoryRead(FrameStream* stream, OVERLAPPED* overlapped) {
+  ResetEvent(overlapped->hEvent);
+  return ReadDirectoryChangesW(stream->directoryHandle, stream->notifyBuffer.data(),
+    static_cast<DWORD>(stream->notifyBuffer.size() * sizeof(DWORD)), FALSE,
+    FILE_NOTIFY_CHANGE_FILE_NAME, NULL, overlapped, NULL) != FALSE;
+}
+
+// Stream thread: frames already there when the watch started, or missed when
+// a notification buffer overflowed
+void ScanFrameDirectory(FrameStream* stream) {
+  WIN32_FIND_DATAW found;
+  HANDLE search = FindFirstFileW((stream->directory + L"\\*.tga").c_str(), &found);
+  if (search == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  do {
+    if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      stream->frames.insert(found.cFileName);
+    }
+  } while (FindNextFileW(search, &found));
+  FindClose(search);
+}
+
+void HandleFrameDirectoryChanges(FrameStream* stream, DWORD bytes) {
+  if (bytes == 0) {
+    ScanFrameDirectory(stream); // Overflow: the system dropped the details
+    return;
+  }
+  const uint8_t* cursor = reinterpret_cast<const uint8_t*>(stream->notifyBuffer.data());
+  for (;;) {
+    const FILE_NOTIFY_INFORMATION* entry = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+    std::wstring name(entry->FileName, entry->FileNameLength / sizeof(WCHAR));
+    if (IsTgaFileName(name)) {
+      if (entry->Action == FILE_ACTION_ADDED || entry->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+        stream->frames.insert(name);
+      } else if (entry->Action == FILE_ACTION_REMOVED || entry->Action == FILE_ACTION_RENAMED_OLD_NAME) {
+        stream->frames.erase(name);
+      }
+    }
+    if (entry->NextEntryOffset == 0 || entry->NextEntryOffset >= bytes) {
+      break;
+    }
+    bytes -= entry->NextEntryOffset;
+    cursor += entry->NextEntryOffset;
+  }
+}
+
+// Stream thread: tell JS the frame format, so it can start ffmpeg on the pipe
+void EmitFrameStreamFormat(FrameStream* stream) {
+  FrameStream* data = stream;
+  stream->tsfn.NonBlockingCall(data, [](Napi::Env env, Napi::Function jsCallback, FrameStream* formatted) {
+    if (env != nullptr && jsCallback != nullptr) {
+      Napi::Object event = Napi::Object::New(env);
+      event.Set("type", Napi::String::New(env, "format"));
+      event.Set("width", Napi::Number::New(env, formatted->width));
+      event.Set("height", Napi::Number::New(env, formatted->height));
+      event.Set("pixelFormat", Napi::String::New(env, formatted->bytesPerPixel == 4 ? "bgra" : "bgr24"));
+      jsCallback.Call({ event });
+    }
+  });
+}
+
+// Stream thread: wait for ffmpeg to open the pipe. False on stop, timeout or error.
+bool ConnectFrameReader(FrameStream* stream, OVERLAPPED* overlapped) {
+  ResetEvent(overlapped->hEvent);
+  if (!ConnectNamedPipe(stream->pipe, overlapped)) {
+    DWORD error = GetLastError();
+    if (error == ERROR_PIPE_CONNECTED) {
+      return true;
+    }
+    if (error != ERROR_IO_PENDING) {
+      FailFrameStream(stream, error, "connect");
+      return false;
+    }
+  }
+
+  HANDLE waits[] = { overlapped->hEvent, stream->stopEvent };
+  DWORD result = WaitForMultipleObjects(2, waits, FALSE, FRAME_STREAM_CONNECT_TIMEOUT_MS);
+  DWORD transferred = 0;
+  if (result == WAIT_OBJECT_0) {
+    if (GetOverlappedResult(stream->pipe, overlapped, &transferred, FALSE)) {
+      return true;
+    }
+    FailFrameStream(stream, GetLastError(), "connect");
+    return false;
+  }
+
+  CancelIoEx(stream->pipe, overlapped);
+  GetOverlappedResult(stream->pipe, overlapped, &transferred, TRUE);
+  if (result == WAIT_TIMEOUT) {
+    FailFrameStream(stream, ERROR_TIMEOUT, "connect");
+  }
+  return false;
+}
+
+// Stream thread: write one frame and wait until the pipe has taken it. A stop
+// only waits a little for the write in flight. False if the stream is over.
+bool WriteFramePixels(FrameStream* stream, OVERLAPPED* overlapped, const uint8_t* pixels, DWORD size) {
+  DWORD transferred = 0;
+  ResetEvent(overlapped->hEvent);
+  if (!WriteFile(stream->pipe, pixels, size, NULL, overlapped)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_IO_PENDING) {
+      if (error != ERROR_NO_DATA && error != ERROR_BROKEN_PIPE) {
+        FailFrameStream(stream, error, "write");
+      }
+      return false;
+    }
+  }
+
+  HANDLE waits[] = { overlapped->hEvent, stream->stopEvent };
+  DWORD result = WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+  if (result != WAIT_OBJECT_0 && WaitForSingleObject(overlapped->hEvent, FRAME_STREAM_STOP_WRITE_TIMEOUT_MS) != WAIT_OBJECT_0) {
+    CancelIoEx(stream->pipe, overlapped);
+    GetOverlappedResult(stream->pipe, overlapped, &transferred, TRUE);
+    return false;
+  }
+  if (!GetOverlappedResult(stream->pipe, overlapped, &transferred, FALSE)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_NO_DATA && error != ERROR_BROKEN_PIPE) {
+      FailFrameStream(stream, error, "write");
+    }
+    return false;
+  }
+  stream->bytesWritten += transferred;
+  return true;
+}
+
+enum FrameSendResult {
+  FRAME_SENT,
+  FRAME_BUSY, // HLAE still has it open
+  FRAME_SKIPPED, // Gone or unreadable; dropped from the sequence
+  FRAME_STREAM_OVER,
+};
+
+// Stream thread: map one complete frame, write it to the pipe and delete it.
+// The first frame fixes the format and waits for ffmpeg to connect.
+FrameSendResult SendFrame(FrameStream* stream, OVERLAPPED* overlapped, const std::wstring& name) {
+  std::wstring path = stream->directory + L"\\" + name;
+  // Without FILE_SHARE_WRITE this fails while HLAE is still writing the frame
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    DWORD error = GetLastError();
+    return error == ERROR_SHARING_VIOLATION ? FRAME_BUSY : FRAME_SKIPPED;
+  }
+
+  LARGE_INTEGER size;
+  HANDLE mapping = NULL;
+  const uint8_t* view = nullptr;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  }
+  if (mapping) {
+    view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  }
+
+  FrameSendResult result = FRAME_SKIPPED;
+  TgaLayout layout;
+  if (view && ParseTgaHeader(view, static_cast<size_t>(size.QuadPart), &layout)) {
+    if (!stream->connected) {
+      stream->width = layout.width;
+      stream->height = layout.height;
+      stream->bytesPerPixel = layout.bytesPerPixel;
+      EmitFrameStreamFormat(stream);
+      stream->connected = ConnectFrameReader(stream, overlapped);
+      if (!stream->connected) {
+        result = FRAME_STREAM_OVER;
+      }
+    }
+
+    // rawvideo has no per-frame header: a frame of another size would garble the rest
+    if (result != FRAME_STREAM_OVER && layout.width == stream->width && layout.height == stream->height &&
+        layout.bytesPerPixel == stream->bytesPerPixel) {
+      size_t rowBytes = static_cast<size_t>(layout.width) * layout.bytesPerPixel;
+      size_t frameBytes = rowBytes * layout.height;
+      const uint8_t* pixels = view + layout.pixelOffset;
+      if (!layout.topDown) {
+        stream->flipped.resize(frameBytes);
+        for (UINT row = 0; row < layout.height; row++) {
+          memcpy(stream->flipped.data() + row * rowBytes, pixels + (layout.height - 1 - row) * rowBytes, rowBytes);
+        }
+        pixels = stream->flipped.data();
+      }
+      if (WriteFramePixels(stream, overlapped, pixels, static_cast<DWORD>(frameBytes))) {
+        stream->framesWritten++;
+        result = FRAME_SENT;
+      } else {
+        result = FRAME_STREAM_OVER;
+      }
+    }
+  }
+
+  if (view) {
+    UnmapViewOfFile(view);
+  }
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+  if (result == FRAME_SENT) {
+    DeleteFileW(path.c_str());
+  }
+  return result;
+}
+
+// Stream thread: send every frame that is complete, in order. False once the stream is over.
+bool SendCompleteFrames(FrameStream* stream, OVERLAPPED* pipeOverlapped, bool finishing, bool* waitingOnWriter) {
+  *waitingOnWriter = false;
+  while (!stream->frames.empty()) {
+    // The newest frame may still be growing until a later one appears or recording ends
+    if (stream->frames.size() == 1 && !finishing) {
+      return true;
+    }
+    auto first = stream->frames.begin();
+    FrameSendResult result = SendFrame(stream, pipeOverlapped, *first);
+    if (result == FRAME_STREAM_OVER) {
+      return false;
+    }
+    if (result == FRAME_BUSY) {
+      *waitingOnWriter = true;
+      return true;
+    }
+    stream->frames.erase(first);
+  }
+  return true;
+}
+
+void FrameStreamThreadMain(FrameStream* stream) {
+  OVERLAPPED notifyOverlapped = {};
+  notifyOverlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  OVERLAPPED pipeOverlapped = {};
+  pipeOverlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+  bool watching = QueueFrameDirectoryRead(stream, &notifyOverlapped);
+  if (!watching) {
+    FailFrameStream(stream, GetLastError(), "watch");
+  }
+  ScanFrameDirectory(stream);
+
+  bool finishing = false;
+  bool rescanned = false;
+  while (watching) {
+    bool waitingOnWriter = false;
+    if (!SendCompleteFrames(stream, &pipeOverlapped, finishing, &waitingOnWriter)) {
+      break;
+    }
+    if (finishing && stream->frames.empty()) {
+      if (rescanned) {
+        break;
+      }
+      // Notifications trail the writes a little: look once more before ending
+      ScanFrameDirectory(stream);
+      rescanned = true;
+      continue;
+    }
+
+    HANDLE waits[] = { notifyOverlapped.hEvent, stream->stopEvent, stream->finishEvent };
+    DWORD waitCount = finishing ? 2 : 3; // finishEvent stays set once signaled
+    DWORD result = WaitForMultipleObjects(waitCount, waits, FALSE, waitingOnWriter ? FRAME_STREAM_POLL_MS : INFINITE);
+    if (result == WAIT_OBJECT_0) {
+      DWORD bytes = 0;
+      if (!GetOverlappedResult(stream->directoryHandle, &notifyOverlapped, &bytes, FALSE)) {
+        FailFrameStream(stream, GetLastError(), "watch");
+        break;
+      }
+      HandleFrameDirectoryChanges(stream, bytes);
+      if (!QueueFrameDirectoryRead(stream, &notifyOverlapped)) {
+        FailFrameStream(stream, GetLastError(), "watch");
+        break;
+      }
+    } else if (result == WAIT_OBJECT_0 + 1) {
+      break;
+    } else if (result == WAIT_OBJECT_0 + 2) {
+      finishing = true;
+    }
+  }
+
+  // An outstanding directory read must complete before its buffer goes away
+  CancelIoEx(stream->directoryHandle, &notifyOverlapped);
+  DWORD ignored = 0;
+  GetOverlappedResult(stream->directoryHandle, &notifyOverlapped, &ignored, TRUE);
+  CloseHandle(notifyOverlapped.hEvent);
+  if (stream->connected) {
+    // Closing a pipe discards unread bytes; let ffmpeg take the last frames first
+    FlushFileBuffers(stream->pipe);
+  }
+  CloseHandle(pipeOverlapped.hEvent);
+
+  // EOF tells ffmpeg the stream is complete
+  CloseHandle(stream->pipe);
+  stream->pipe = NULL;
+
+  Napi::ThreadSafeFunction tsfn = stream->tsfn;
+  tsfn.BlockingCall(stream, [](Napi::Env env, Napi::Function jsCallback, FrameStream* ended) {
+    ended->addon->frameStreams.erase(ended->id);
+    if (env != nullptr && jsCallback != nullptr) {
+      Napi::Object event = Napi::Object::New(env);
+      event.Set("type", Napi::String::New(env, "ended"));
+      event.Set("frames", Napi::Number::New(env, static_cast<double>(ended->framesWritten)));
+      event.Set("bytes", Napi::Number::New(env, static_cast<double>(ended->bytesWritten)));
+      event.Set("error", Napi::Number::New(env, ended->error));
+      if (ended->errorStage) {
+        event.Set("stage", Napi::String::New(env, ended->errorStage));
+      }
+      jsCallback.Call({ event });
+    }
+  });
+  tsfn.Release();
+}
+
+// startFrameStream(directory: string, onEvent: (event) => void): { id, pipePath } | null
+// Watches directory (and below) for HLAE's TGA frames and streams them, in name
+// order, into a new named pipe at pipePath; each frame is deleted once written.
+// onEvent receives { type: 'format', width, height, pixelFormat: 'bgra' | 'bgr24' }
+// once the first frame is complete; open pipePath with ffmpeg as
+// `-f rawvideo -pix_fmt <pixelFormat> -video_size WxH -framerate <fps> -i <pipePath>`
+// within 15 s. Then { type: 'ended', frames, bytes, error, stage? } after the pipe
+// is closed. Returns null if the directory cannot be watched.
+Napi::Value StartFrameStream(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (string directory, function onEvent)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::u16string utf16 = info[0].As<Napi::String>().Utf16Value();
+  std::wstring directory(utf16.begin(), utf16.end());
+  while (!directory.empty() && (directory.back() == L'\\' || directory.back() == L'/')) {
+    directory.pop_back();
+  }
+  HANDLE directoryHandle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+  if (directoryHandle == INVALID_HANDLE_VALUE) {
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  uint32_t id = addon->nextFrameStreamId++;
+  std::string pipePath = "\\\\.\\pipe\\cs2-frames-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(id);
+  std::wstring widePipePath(pipePath.begin(), pipePath.end());
+  HANDLE pipe = CreateNamedPipeW(widePipePath.c_str(),
+    PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+    PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+    1, 1024 * 1024, 0, 0, NULL);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    DWORD error = GetLastError();
+    CloseHandle(directoryHandle);
+    std::string errorMsg = "Failed to create frame pipe. Error code: " + std::to_string(error);
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  FrameStream* stream = new FrameStream();
+  stream->addon = addon;
+  stream->id = id;
+  stream->directory = directory;
+  stream->directoryHandle = directoryHandle;
+  stream->pipe = pipe;
+  stream->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  stream->finishEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  stream->notifyBuffer.resize(FRAME_STREAM_NOTIFY_BYTES / sizeof(DWORD));
+  stream->connected = false;
+  stream->width = 0;
+  stream->height = 0;
+  stream->bytesPerPixel = 0;
+  stream->framesWritten = 0;
+  stream->bytesWritten = 0;
+  stream->error = 0;
+  stream->errorStage = nullptr;
+  stream->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2FrameStream",
+    0,
+    1,
+    [](Napi::Env, FrameStream* finalized) {
+      // The thread has normally released and is exiting; on environment
+      // teardown mid-stream it is still running and must be stopped first
+      if (finalized->thread.joinable()) {
+        SetEvent(finalized->stopEvent);
+        finalized->thread.join();
+      }
+      finalized->addon->frameStreams.erase(finalized->id);
+      if (finalized->pipe) {
+        CloseHandle(finalized->pipe);
+      }
+      CloseHandle(finalized->directoryHandle);
+      CloseHandle(finalized->stopEvent);
+      CloseHandle(finalized->finishEvent);
+      delete finalized;
+    },
+    stream
+  );
+  addon->frameStreams[id] = stream;
+  stream->thread = std::thread(FrameStreamThreadMain, stream);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("id", Napi::Number::New(env, id));
+  result.Set("pipePath", Napi::String::New(env, pipePath));
+  return result;
+}
+
+FrameStream* FindFrameStream(const Napi::CallbackInfo& info) {
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(info.Env(), "Expected frame stream id").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  Cs2WindowTracker* addon = AddonFor(info.Env());
+  auto found = addon->frameStreams.find(info[0].As<Napi::Number>().Uint32Value());
+  return found == addon->frameStreams.end() ? nullptr : found->second;
+}
+
+// finishFrameStream(id: number): boolean
+// Recording has stopped: send the remaining frames (the newest is now complete
+// too), then end. Returns false if the id is unknown or already ended.
+Napi::Value FinishFrameStream(const Napi::CallbackInfo& info) {
+  FrameStream* stream = FindFrameStream(info);
+  if (stream) {
+    SetEvent(stream->finishEvent);
+  }
+  return Napi::Boolean::New(info.Env(), stream != nullptr);
+}
+
+// stopFrameStream(id: number): boolean
+// End after the frame in flight; unsent frames stay on disk.
+// Returns false if the id is unknown or already ended.
+Napi::Value StopFrameStream(const Napi::CallbackInfo& info) {
+  FrameStream* stream = FindFrameStream(info);
+  if (stream) {
+    SetEvent(stream->stopEvent);
+  }
+  return Napi::Boolean::New(info.Env(), stream != nullptr);
+}
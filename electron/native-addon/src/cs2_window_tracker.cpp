@@ -1,12 +1,8 @@
-#include <napi.h>
-#include <windows.h>
+#include "addon.h"
 #include <tlhelp32.h>
-#include <psapi.h>
-#include <string>
-#include <vector>
-#include <map>
-#include <algorithm>
+#include <dwmapi.h>
 #include <cctype>
+#include <future>
 
 // Win32 constants
 #define EVENT_OBJECT_LOCATIONCHANGE 0x800B
@@ -16,236 +12,1823 @@
 #define EVENT_SYSTEM_MINIMIZEEND 0x0017
 #define EVENT_SYSTEM_FOREGROUND 0x0003
 #define EVENT_OBJECT_DESTROY 0x8001
+#define EVENT_OBJECT_SHOW 0x8002
+#define EVENT_OBJECT_NAMECHANGE 0x800C
+#define EVENT_OBJECT_CLOAKED 0x8017
+#define EVENT_OBJECT_UNCLOAKED 0x8018
 #define WINEVENT_OUTOFCONTEXT 0x0000
 #define WINEVENT_SKIPOWNPROCESS 0x0002
 #define GWL_EXSTYLE (-20)
 // WS_EX_TOOLWINDOW is already defined in winuser.h
 
-// Global state for WinEvent hook
-struct HookState {
-  DWORD targetPid;
-  Napi::FunctionReference jsCallback;
-  HWINEVENTHOOK hookHandle1; // Location change and destroy
-  HWINEVENTHOOK hookHandle2; // Move/resize
-  HWINEVENTHOOK hookHandle3; // Minimize
-  HWINEVENTHOOK hookHandle4; // Foreground (focus)
+// Message posted to the hook thread to make it uninstall all hooks and exit
+#define WM_HOOK_THREAD_STOP (WM_APP + 1)
+
+// A SetWinEventHook registration. Process-scoped hooks pass the target PID as
+// idProcess so Windows only calls back for CS2's windows; system-wide hooks
+// see every window on the desktop. skipOwnProcess drops events raised by our
+// own windows (WINEVENT_SKIPOWNPROCESS).
+struct WinEventHookRange {
+  DWORD eventMin;
+  DWORD eventMax;
+  bool processScoped;
+  bool skipOwnProcess;
 };
 
-static HookState* g_hookState = nullptr;
+static const WinEventHookRange kHookRanges[] = {
+  { EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, true, true },
+  { EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY, true, true },
+  { EVENT_SYSTEM_MOVESIZESTART, EVENT_SYSTEM_MOVESIZEEND, true, true },
+  { EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, true, true },
+  { EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED, true, true },
+  // Foreground changes must stay global: we need to see focus moving *away* from CS2,
+  // including to our own overlay (overlay-focused, and the governor keeping its caps)
+  { EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, false, false },
+};
 
-// WinEvent hook callback
-VOID CALLBACK WinEventProc(
-  HWINEVENTHOOK hWinEventHook,
-  DWORD event,
-  HWND hwnd,
-  LONG idObject,
-  LONG idChild,
-  DWORD dwEventThread,
-  DWORD dwmsTimeStamp
-) {
-  if (!g_hookState || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+#define HOOK_RANGE_COUNT (sizeof(kHookRanges) / sizeof(kHookRanges[0]))
+
+LONGLONG g_qpcFrequency = 1;
+
+LONGLONG QpcNow() {
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return now.QuadPart;
+}
+
+// When Windows raised an event, on the QPC clock. dwmsTimeStamp uses the
+// GetTickCount clock, so its age is measured there and projected back from now.
+LONGLONG EventOriginQpc(DWORD dwmsTimeStamp) {
+  LONGLONG now = QpcNow();
+  DWORD ageMs = GetTickCount() - dwmsTimeStamp;
+  if (ageMs > 60000) {
+    ageMs = 0; // Bogus or synthesized timestamp
+  }
+  return now - static_cast<LONGLONG>(ageMs) * g_qpcFrequency / 1000;
+}
+
+HookClockTicks HookClockNow() {
+  return QpcNow();
+}
+
+uint64_t HookElapsedUs(LONGLONG originQpc, LONGLONG nowQpc) {
+  LONGLONG elapsed = nowQpc > originQpc ? nowQpc - originQpc : 0;
+  return static_cast<uint64_t>(elapsed) * 1000000 / static_cast<uint64_t>(g_qpcFrequency);
+}
+
+void RecordLatency(LatencyHistogram& histogram, LONGLONG originQpc, LONGLONG nowQpc) {
+  RecordLatencyUs(histogram, HookElapsedUs(originQpc, nowQpc));
+}
+
+class Cs2WindowTracker;
+
+// A trackWindow()/startWinEventHook() subscription. Every target shares the
+// one hook set on the hook thread; events are routed to it natively.
+struct HookTarget {
+  Cs2WindowTracker* addon; // Environment that created it
+  uint32_t id;
+  DWORD pid;
+  HWND hwnd; // Optional: when set, only this window's events match and location changes are coalesced
+  bool batchDelivery; // true: events go to `ring`, callback is only a "pending" signal
+  bool publishesState; // startWinEventHook's target: drives the state block
+  RECT lastBounds; // Last client rect emitted via boundschanged (hook thread only)
+  bool hasLastBounds;
+  EventRing* ring; // Batch mode only
+  std::atomic<bool> wakeupPending; // Batch mode: a pending signal has been queued but not run
+  Napi::ThreadSafeFunction tsfn; // Its finalizer deletes the target once queued calls have run
+  std::atomic<HWND> followHwnd; // Overlay kept on the target's client rect by the hook thread (NULL = off)
+  std::atomic<bool> followPaced; // Follow moves wait for the next vblank (see FollowPacer)
+  // Focus state machine: when enabled, raw foreground/minimize events are folded into
+  // the state below and only transitions are delivered (fields are hook thread only)
+  bool trackFocus;
+  DWORD overlayPid;
+  HookEventCode focusState; // HOOK_EVENT_CS2FOCUSED/OVERLAYFOCUSED/LOSTFOCUS, NONE until seeded
+  bool minimized;
+  bool moving;
+  HMONITOR monitor; // Monitor and DPI last seen for hwnd (hook thread only)
+  UINT dpi;
+};
+
+// Process-scoped hooks and exit watch for one PID, shared by all its targets (hook thread only)
+struct HookedProcess {
+  DWORD pid;
+  HANDLE processHandle; // SYNCHRONIZE handle; NULL once exited or if it could not be opened
+  HWINEVENTHOOK hookHandles[HOOK_RANGE_COUNT]; // kHookRanges entries with processScoped set
+  std::vector<HookTarget*> targets;
+};
+
+// The shared hook thread. Started with the first target and stopped with the
+// last; adding targets for an already hooked process installs nothing.
+struct HookHost {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  DWORD threadId;
+  HWINEVENTHOOK globalHooks[HOOK_RANGE_COUNT]; // kHookRanges entries without processScoped
+  std::vector<HookedProcess*> processes; // Hook thread only
+  std::vector<HookTarget*> targets; // Hook thread only; every target (global events fan out to all)
+};
+
+// The host whose thread is running; WinEvent callbacks carry no context pointer
+static thread_local HookHost* t_hookHost = nullptr;
+
+// Client area of a window in screen coordinates (left/top/right/bottom)
+bool GetClientRectOnScreen(HWND hwnd, RECT* out) {
+  RECT clientRect;
+  if (!GetClientRect(hwnd, &clientRect)) {
+    return false;
+  }
+  
+  POINT topLeft = { clientRect.left, clientRect.top };
+  POINT bottomRight = { clientRect.right, clientRect.bottom };
+  
+  if (!ClientToScreen(hwnd, &topLeft) || !ClientToScreen(hwnd, &bottomRight)) {
+    return false;
+  }
+
+  out->left = topLeft.x;
+  out->top = topLeft.y;
+  out->right = bottomRight.x;
+  out->bottom = bottomRight.y;
+  return true;
+}
+
+// GetDpiForWindow is available on Windows 10 1607+; resolved once in Init
+typedef UINT (WINAPI *GetDpiForWindowProc)(HWND);
+static GetDpiForWindowProc g_getDpiForWindow = nullptr;
+
+void ResolveDpiApis() {
+  HMODULE user32 = GetModuleHandleW(L"user32.dll");
+  if (user32) {
+    g_getDpiForWindow = reinterpret_cast<GetDpiForWindowProc>(GetProcAddress(user32, "GetDpiForWindow"));
+  }
+}
+
+// Effective DPI of a window (96 = 100%)
+UINT GetWindowDpi(HWND hwnd) {
+  if (g_getDpiForWindow) {
+    return g_getDpiForWindow(hwnd);
+  }
+  
+  // Fallback: use system DPI
+  HDC hdc = GetDC(hwnd);
+  int dpi = GetDeviceCaps(hdc, LOGPIXELSX);
+  ReleaseDC(hwnd, hdc);
+  return static_cast<UINT>(dpi);
+}
+
+void WriteStateBlock(Cs2WindowTracker* addon) {
+  const WindowStateFields& fields = addon->published;
+  volatile LONG* slots = addon->stateBlock;
+  if (!slots) {
     return;
   }
 
-  // Handle foreground events differently - they fire for ANY window becoming foreground
-  if (event == EVENT_SYSTEM_FOREGROUND) {
-    DWORD windowPid;
-    GetWindowThreadProcessId(hwnd, &windowPid);
-    
-    // Emit a "foreground" event with the foreground window's PID
-    // The JavaScript side will determine if it's CS2 or not
-    if (!g_hookState->jsCallback.IsEmpty()) {
-      Napi::Env env = g_hookState->jsCallback.Env();
-      Napi::HandleScope scope(env);
-      
-      Napi::Object eventObj = Napi::Object::New(env);
-      eventObj.Set("type", Napi::String::New(env, "foreground"));
-      eventObj.Set("hwnd", Napi::BigInt::New(env, reinterpret_cast<int64_t>(hwnd)));
-      eventObj.Set("pid", Napi::Number::New(env, windowPid));
-      
-      g_hookState->jsCallback.Call({ eventObj });
+  LONG sequence = slots[STATE_SLOT_SEQUENCE];
+  InterlockedExchange(&slots[STATE_SLOT_SEQUENCE], sequence + 1); // Odd: write in progress
+  slots[STATE_SLOT_VALID] = fields.valid ? 1 : 0;
+  slots[STATE_SLOT_X] = fields.bounds.left;
+  slots[STATE_SLOT_Y] = fields.bounds.top;
+  slots[STATE_SLOT_WIDTH] = fields.bounds.right - fields.bounds.left;
+  slots[STATE_SLOT_HEIGHT] = fields.bounds.bottom - fields.bounds.top;
+  slots[STATE_SLOT_MINIMIZED] = fields.minimized ? 1 : 0;
+  slots[STATE_SLOT_FOREGROUND_PID] = static_cast<LONG>(fields.foregroundPid);
+  slots[STATE_SLOT_DPI] = static_cast<LONG>(fields.dpi);
+  slots[STATE_SLOT_CLOAKED] = fields.cloaked ? 1 : 0;
+  InterlockedExchange(&slots[STATE_SLOT_SEQUENCE], sequence + 2); // Even: stable
+}
+
+// Refresh the state block from the target window. Bounds keep their last
+// value while the window is minimized (its rect is parked off-screen).
+void PublishWindowState(HookTarget* target) {
+  WindowStateFields& fields = target->addon->published;
+  HWND hwnd = target->hwnd;
+
+  HWND fgHwnd = GetForegroundWindow();
+  DWORD fgPid = 0;
+  if (fgHwnd) {
+    GetWindowThreadProcessId(fgHwnd, &fgPid);
+  }
+  fields.foregroundPid = fgPid;
+
+  fields.valid = hwnd != NULL && IsWindow(hwnd);
+  if (fields.valid) {
+    fields.minimized = IsIconic(hwnd) != FALSE;
+    RECT bounds;
+    if (!fields.minimized && GetClientRectOnScreen(hwnd, &bounds)) {
+      fields.bounds = bounds;
     }
-    return;
+    fields.dpi = GetWindowDpi(hwnd);
+    DWORD cloaked = 0;
+    fields.cloaked = SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked != 0;
   }
 
-  // For other events, check if window belongs to target process
-  DWORD windowPid;
-  GetWindowThreadProcessId(hwnd, &windowPid);
-  if (windowPid != g_hookState->targetPid) {
-    return;
+  WriteStateBlock(target->addon);
+}
+
+// Move/resize the follower onto a client rect (physical pixels, like the rect itself).
+// Async so the hook thread never waits on the follower's (Electron UI) thread.
+void PositionFollower(HWND follower, const RECT& bounds) {
+  SetWindowPos(
+    follower,
+    NULL,
+    bounds.left,
+    bounds.top,
+    bounds.right - bounds.left,
+    bounds.bottom - bounds.top,
+    SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS
+  );
+}
+
+// The DXGI output (and its adapter) showing a monitor, or nullptr
+IDXGIOutput* FindDxgiOutput(HMONITOR monitor, IDXGIAdapter1** adapterOut) {
+  IDXGIFactory1* factory = nullptr;
+  if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&factory)))) {
+    return nullptr;
+  }
+
+  IDXGIAdapter1* adapter = nullptr;
+  IDXGIOutput* output = nullptr;
+  DXGI_OUTPUT_DESC outputDesc = {};
+  for (UINT a = 0; !output && factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; a++) {
+    for (UINT o = 0; adapter->EnumOutputs(o, &output) != DXGI_ERROR_NOT_FOUND; o++) {
+      if (SUCCEEDED(output->GetDesc(&outputDesc)) && outputDesc.Monitor == monitor) {
+        break;
+      }
+      ReleaseCom(output);
+    }
+    if (!output) {
+      ReleaseCom(adapter);
+    }
+  }
+  factory->Release();
+
+  if (adapterOut) {
+    *adapterOut = adapter;
+  } else {
+    ReleaseCom(adapter);
+  }
+  return output;
+}
+
+// Frame-paced follow: instead of moving the overlay on every location change
+// (a drag reports them at mouse rate), the hook thread leaves the latest rect
+// here and the pacer thread applies it right after the next vblank of the
+// monitor the tracked window is on. At most one move per refresh, none between
+// frames, and the hook thread never blocks on display timing.
+struct FollowPacer {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  HANDLE pendingEvent; // Auto-reset: bounds are waiting
+  HANDLE stopEvent;
+  std::mutex mutex;
+  // Guarded by mutex
+  HWND follower;
+  RECT bounds;
+  HMONITOR monitor;
+  LONGLONG originQpc; // Of the newest event folded into bounds
+  bool pending;
+  // Pacer thread only
+  HMONITOR outputMonitor;
+  IDXGIOutput* output; // Showing outputMonitor; NULL if none was found
+};
+
+// Hook thread: replace whatever rect is still waiting for a vblank
+void QueueFollowerBounds(FollowPacer* pacer, HWND follower, const RECT& bounds, HMONITOR monitor, LONGLONG originQpc) {
+  {
+    std::lock_guard<std::mutex> lock(pacer->mutex);
+    pacer->follower = follower;
+    pacer->bounds = bounds;
+    pacer->monitor = monitor;
+    pacer->originQpc = originQpc;
+    pacer->pending = true;
+  }
+  SetEvent(pacer->pendingEvent);
+}
+
+// Pacer thread: block until the next vblank on `monitor`. Without a DXGI output
+// for it (remote sessions, some hybrid GPU setups) the next DWM composition
+// pass stands in.
+void WaitForMonitorVblank(FollowPacer* pacer, HMONITOR monitor) {
+  if (monitor != pacer->outputMonitor) {
+    ReleaseCom(pacer->output);
+    pacer->output = FindDxgiOutput(monitor, nullptr);
+    pacer->outputMonitor = monitor;
+  }
+  if (!pacer->output || FAILED(pacer->output->WaitForVBlank())) {
+    DwmFlush();
+  }
+}
+
+void FollowPacerThreadMain(FollowPacer* pacer) {
+  // Display timing: a late wake-up is a visibly late overlay
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+  HANDLE waits[] = { pacer->pendingEvent, pacer->stopEvent };
+  while (WaitForMultipleObjects(2, waits, FALSE, INFINITE) == WAIT_OBJECT_0) {
+    HMONITOR monitor;
+    {
+      std::lock_guard<std::mutex> lock(pacer->mutex);
+      monitor = pacer->monitor;
+    }
+    WaitForMonitorVblank(pacer, monitor);
+
+    // Everything queued while waiting folds into this one move
+    HWND follower;
+    RECT bounds;
+    LONGLONG originQpc;
+    {
+      std::lock_guard<std::mutex> lock(pacer->mutex);
+      if (!pacer->pending) {
+        continue;
+      }
+      pacer->pending = false;
+      follower = pacer->follower;
+      bounds = pacer->bounds;
+      originQpc = pacer->originQpc;
+    }
+    PositionFollower(follower, bounds);
+    RecordLatency(pacer->addon->hookCounters.boundsLatency, originQpc, QpcNow());
+  }
+  ReleaseCom(pacer->output);
+}
+
+// JS thread: the pacer lives until environment exit once created, so the hook
+// thread may hold on to it without synchronizing with setOverlayFollow()
+FollowPacer* EnsureFollowPacer(Cs2WindowTracker* addon) {
+  if (!addon->followPacer) {
+    FollowPacer* pacer = new FollowPacer();
+    pacer->addon = addon;
+    pacer->pendingEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    pacer->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    pacer->follower = NULL;
+    pacer->monitor = NULL;
+    pacer->originQpc = 0;
+    pacer->pending = false;
+    pacer->outputMonitor = NULL;
+    pacer->output = nullptr;
+    pacer->thread = std::thread(FollowPacerThreadMain, pacer);
+    addon->followPacer = pacer;
+  }
+  return addon->followPacer;
+}
+
+// Environment exit, after the hook thread has stopped
+void StopFollowPacer(Cs2WindowTracker* addon) {
+  FollowPacer* pacer = addon->followPacer;
+  SetEvent(pacer->stopEvent);
+  pacer->thread.join();
+  CloseHandle(pacer->pendingEvent);
+  CloseHandle(pacer->stopEvent);
+  delete pacer;
+  addon->followPacer = nullptr;
+}
+
+// Emit monitorchanged (new DPI and the monitor's work area) if the tracked window
+// is now on another monitor or its DPI changed. The first call only records the
+// current monitor. Returns true if emitted.
+bool EmitMonitorIfChanged(HookTarget* target, DWORD timestamp, LONGLONG originQpc) {
+  HMONITOR monitor = MonitorFromWindow(target->hwnd, MONITOR_DEFAULTTONEAREST);
+  UINT dpi = GetWindowDpi(target->hwnd);
+  if (monitor == target->monitor && dpi == target->dpi) {
+    return false;
+  }
+
+  bool first = target->monitor == NULL;
+  target->monitor = monitor;
+  target->dpi = dpi;
+  MONITORINFO monitorInfo = {};
+  monitorInfo.cbSize = sizeof(monitorInfo);
+  if (first || !GetMonitorInfoW(monitor, &monitorInfo)) {
+    return false;
   }
 
-  // Map event to string
-  std::string eventType;
+  DispatchHookEvent(target, { HOOK_EVENT_MONITORCHANGED, target->hwnd, dpi, timestamp, monitorInfo.rcWork, originQpc });
+  return true;
+}
+
+// Re-read the tracked window's client rect and emit boundschanged only if it
+// differs from what was last emitted. Minimized windows report a parked
+// rect at (-32000, -32000), so they are skipped. Returns true if emitted.
+bool EmitBoundsIfChanged(HookTarget* target, DWORD timestamp, LONGLONG originQpc) {
+  HWND hwnd = target->hwnd;
+  if (IsIconic(hwnd)) {
+    return false;
+  }
+
+  RECT bounds;
+  if (!GetClientRectOnScreen(hwnd, &bounds)) {
+    return false;
+  }
+
+  if (target->hasLastBounds && EqualRect(&bounds, &target->lastBounds)) {
+    return false;
+  }
+
+  target->lastBounds = bounds;
+  target->hasLastBounds = true;
+
+  // A new rect may be on another monitor; JS hears about the new scale first
+  EmitMonitorIfChanged(target, timestamp, originQpc);
+
+  // Follow mode: the overlay is moved here and JS is not told about plain moves
+  HWND followHwnd = target->followHwnd.load(std::memory_order_acquire);
+  if (followHwnd) {
+    if (target->followPaced.load(std::memory_order_acquire)) {
+      QueueFollowerBounds(target->addon->followPacer, followHwnd, bounds, target->monitor, originQpc);
+    } else {
+      PositionFollower(followHwnd, bounds);
+      RecordLatency(target->addon->hookCounters.boundsLatency, originQpc, QpcNow());
+    }
+    return true;
+  }
+
+  HookEvent event = { HOOK_EVENT_BOUNDSCHANGED, hwnd, target->pid, timestamp, bounds, originQpc };
+  DispatchHookEvent(target, event);
+  return true;
+}
+
+// Map a Win32 event to the code delivered to JS (HOOK_EVENT_NONE if unhandled)
+HookEventCode HookEventCodeForWinEvent(DWORD event) {
   switch (event) {
     case EVENT_OBJECT_LOCATIONCHANGE:
-      eventType = "locationchange";
-      break;
+      return HOOK_EVENT_LOCATIONCHANGE;
     case EVENT_SYSTEM_MOVESIZESTART:
-      eventType = "movestart";
-      break;
+      return HOOK_EVENT_MOVESTART;
     case EVENT_SYSTEM_MOVESIZEEND:
-      eventType = "moveend";
-      break;
+      return HOOK_EVENT_MOVEEND;
     case EVENT_SYSTEM_MINIMIZESTART:
-      eventType = "minimizestart";
-      break;
+      return HOOK_EVENT_MINIMIZESTART;
     case EVENT_SYSTEM_MINIMIZEEND:
-      eventType = "minimizeend";
-      break;
+      return HOOK_EVENT_MINIMIZEEND;
     case EVENT_OBJECT_DESTROY:
-      eventType = "destroy";
-      break;
+      return HOOK_EVENT_DESTROY;
+    case EVENT_SYSTEM_FOREGROUND:
+      return HOOK_EVENT_FOREGROUND;
+    case EVENT_OBJECT_CLOAKED:
+      return HOOK_EVENT_CLOAKED;
+    case EVENT_OBJECT_UNCLOAKED:
+      return HOOK_EVENT_UNCLOAKED;
     default:
-      return; // Ignore other events
+      return HOOK_EVENT_NONE;
   }
+}
 
-  // Call JS callback
-  if (!g_hookState->jsCallback.IsEmpty()) {
-    Napi::Env env = g_hookState->jsCallback.Env();
-    Napi::HandleScope scope(env);
-    
-    Napi::Object eventObj = Napi::Object::New(env);
-    eventObj.Set("type", Napi::String::New(env, eventType));
-    eventObj.Set("hwnd", Napi::BigInt::New(env, reinterpret_cast<int64_t>(hwnd)));
-    
-    g_hookState->jsCallback.Call({ eventObj });
+// Focus state machine: fold a foreground change into the target's focus owner.
+// Returns true if it was a transition (and was delivered).
+bool UpdateFocusOwner(HookTarget* target, HWND fgHwnd, DWORD fgPid, DWORD timestamp, LONGLONG originQpc) {
+  HookEventCode state = HOOK_EVENT_LOSTFOCUS;
+  if (fgPid == target->pid) {
+    state = HOOK_EVENT_CS2FOCUSED;
+  } else if (target->overlayPid != 0 && fgPid == target->overlayPid) {
+    state = HOOK_EVENT_OVERLAYFOCUSED;
+  }
+  if (state == target->focusState) {
+    return false;
   }
+
+  target->focusState = state;
+  DispatchHookEvent(target, { state, fgHwnd, fgPid, timestamp, {}, originQpc });
+  return true;
 }
 
-// Helper: Check if window is a tool window
-bool IsToolWindow(HWND hwnd) {
-  LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-  return (exStyle & WS_EX_TOOLWINDOW) != 0;
+// Focus state machine: fold a minimize start/end into the target's minimized flag.
+// Returns true if it was a transition (and was delivered).
+bool UpdateMinimized(HookTarget* target, bool minimized, HWND hwnd, DWORD timestamp, LONGLONG originQpc) {
+  if (minimized == target->minimized) {
+    return false;
+  }
+
+  target->minimized = minimized;
+  DispatchHookEvent(target, { minimized ? HOOK_EVENT_MINIMIZED : HOOK_EVENT_RESTORED, hwnd, target->pid, timestamp, {}, originQpc });
+  return true;
 }
 
-// Helper: Get window area
-int GetWindowArea(HWND hwnd) {
-  RECT rect;
-  if (GetWindowRect(hwnd, &rect)) {
-    return (rect.right - rect.left) * (rect.bottom - rect.top);
+// Focus state machine: deliver the current state once the target is attached,
+// so JS starts from a snapshot taken after the hooks are live
+void SeedFocusState(HookTarget* target) {
+  DWORD timestamp = GetTickCount();
+  LONGLONG originQpc = QpcNow();
+
+  HWND fgHwnd = GetForegroundWindow();
+  DWORD fgPid = 0;
+  if (fgHwnd) {
+    GetWindowThreadProcessId(fgHwnd, &fgPid);
+  }
+  UpdateFocusOwner(target, fgHwnd, fgPid, timestamp, originQpc);
+
+  if (target->hwnd) {
+    HookEventCode code = IsIconic(target->hwnd) ? HOOK_EVENT_MINIMIZED : HOOK_EVENT_RESTORED;
+    target->minimized = code == HOOK_EVENT_MINIMIZED;
+    DispatchHookEvent(target, { code, target->hwnd, target->pid, timestamp, {}, originQpc });
   }
-  return 0;
 }
 
-// EnumWindows callback data structure
-struct EnumData {
+// Route one event to one process' target. Returns false if the target did
+// not match it; `emitted` is cleared if it matched but was coalesced away.
+bool RouteToTarget(HookTarget* target, HookEventCode code, HWND hwnd, DWORD dwmsTimeStamp, LONGLONG originQpc, bool* emitted) {
+  // With a known target window, events for the process' other windows
+  // (splash, child surfaces) are dropped
+  if (target->hwnd != NULL && hwnd != target->hwnd) {
+    return false;
+  }
+
+  // With a known target window, location changes are resolved to real geometry
+  // changes here instead of forwarding every (mostly redundant) event to JS
+  bool coalesceBounds = target->hwnd != NULL;
+  if (coalesceBounds && code == HOOK_EVENT_LOCATIONCHANGE) {
+    if (EmitBoundsIfChanged(target, dwmsTimeStamp, originQpc)) {
+      if (target->publishesState) {
+        PublishWindowState(target);
+      }
+      *emitted = true;
+    }
+    return true;
+  }
+
+  // Keep the state block ahead of the event so JS reading it from the
+  // event handler already sees the new state
+  if (target->publishesState) {
+    PublishWindowState(target);
+  }
+
+  if (target->trackFocus && (code == HOOK_EVENT_MINIMIZESTART || code == HOOK_EVENT_MINIMIZEEND)) {
+    *emitted = UpdateMinimized(target, code == HOOK_EVENT_MINIMIZESTART, hwnd, dwmsTimeStamp, originQpc) || *emitted;
+  } else if (target->trackFocus && (code == HOOK_EVENT_MOVESTART || code == HOOK_EVENT_MOVEEND)) {
+    // Move start/end are already transitions; repeats (e.g. a second MOVESIZESTART) are dropped
+    bool moving = code == HOOK_EVENT_MOVESTART;
+    if (moving != target->moving) {
+      target->moving = moving;
+      DispatchHookEvent(target, { code, hwnd, target->pid, dwmsTimeStamp, {}, originQpc });
+      *emitted = true;
+    }
+  } else {
+    DispatchHookEvent(target, { code, hwnd, target->pid, dwmsTimeStamp, {}, originQpc });
+    *emitted = true;
+  }
+
+  // Geometry may have settled on a new rect once a move/resize or restore completes
+  if (coalesceBounds && (code == HOOK_EVENT_MOVEEND || code == HOOK_EVENT_MINIMIZEEND)) {
+    if (EmitBoundsIfChanged(target, dwmsTimeStamp, originQpc) && target->publishesState) {
+      PublishWindowState(target);
+    }
+  }
+  return true;
+}
+
+// Resource governor: helper processes JS registers (parser, ffmpeg, voice
+// extraction; not whisper, which could not keep up under the cap) share one
+// job object. While the game is the foreground process the job gets a hard
+// CPU-rate cap and every member runs at idle priority with EcoQoS; the limits
+// are lifted as soon as another process takes the foreground or the game exits.
+// While governing, a thread of its own follows foreground changes and waits on
+// the game process, whether or not a WinEvent hook target exists. Windows of the
+// overlay's process (passed by JS, since the addon may run in a utility process)
+// keep the limits.
+#define GOVERNOR_DEFAULT_CPU_RATE_PERCENT 25 // Of all cores, for the whole job
+
+struct GovernedProcess {
   DWORD pid;
-  HWND bestHwnd;
-  int bestArea;
+  HANDLE handle;
+  DWORD priorityClass; // Restored when the limits are lifted
 };
 
-// EnumWindows callback function (must be at file scope, not local)
-BOOL CALLBACK EnumProc(HWND hwnd, LPARAM lParam) {
-  EnumData* ed = reinterpret_cast<EnumData*>(lParam);
-  
-  // Check visibility
-  if (!IsWindowVisible(hwnd)) {
-    return TRUE; // Continue
-  }
-  
-  // Check process ID
-  DWORD windowPid;
-  GetWindowThreadProcessId(hwnd, &windowPid);
-  if (windowPid != ed->pid) {
-    return TRUE; // Continue
+struct ResourceGovernor {
+  std::mutex mutex; // The JS thread registers processes, the hook thread flips the limits
+  HANDLE job; // Created with the first process
+  DWORD gamePid; // 0 while not governing
+  DWORD overlayPid; // Its foreground leaves the limits as they are (0: none)
+  UINT cpuRatePercent;
+  bool throttled;
+  std::vector<GovernedProcess> processes;
+  std::thread thread; // Follows the foreground while governing (JS thread starts and joins it)
+  HANDLE stopEvent;
+};
+
+DWORD ForegroundProcessId() {
+  DWORD pid = 0;
+  HWND foreground = GetForegroundWindow();
+  if (foreground) {
+    GetWindowThreadProcessId(foreground, &pid);
   }
-  
-  // Check if it's a tool window (skip those)
-  LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-  if (exStyle & WS_EX_TOOLWINDOW) {
-    return TRUE; // Continue
+  return pid;
+}
+
+// EcoQoS (execution speed throttling) and priority of one member. Lifting
+// hands the QoS decision back to the system rather than forcing high QoS.
+void ApplyProcessLimits(const GovernedProcess& process, bool throttled) {
+  PROCESS_POWER_THROTTLING_STATE state = {};
+  state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+  state.ControlMask = throttled ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+  state.StateMask = throttled ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+  SetProcessInformation(process.handle, ProcessPowerThrottling, &state, sizeof(state));
+  SetPriorityClass(process.handle, throttled ? IDLE_PRIORITY_CLASS : process.priorityClass);
+}
+
+// Apply or lift the limits; callers hold the governor's mutex. Exited members
+// are dropped first. `force` re-applies an unchanged state (a new CPU rate).
+void SetGovernorThrottled(ResourceGovernor* governor, bool throttled, bool force) {
+  auto& processes = governor->processes;
+  for (size_t i = processes.size(); i-- > 0;) {
+    if (WaitForSingleObject(processes[i].handle, 0) == WAIT_OBJECT_0) {
+      CloseHandle(processes[i].handle);
+      processes.erase(processes.begin() + i);
+    }
   }
-  
-  // Check if window has a title (non-empty)
-  wchar_t title[256];
-  int titleLen = GetWindowTextW(hwnd, title, 256);
-  if (titleLen == 0) {
-    return TRUE; // Continue
+  if (throttled == governor->throttled && !force) {
+    return;
   }
-  
-  // Calculate area
-  RECT rect;
-  int area = 0;
-  if (GetWindowRect(hwnd, &rect)) {
-    area = (rect.right - rect.left) * (rect.bottom - rect.top);
+  governor->throttled = throttled;
+
+  if (governor->job) {
+    JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate = {};
+    if (throttled) {
+      rate.ControlFlags = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP;
+      rate.CpuRate = governor->cpuRatePercent * 100; // In 1/100 of a percent
+    }
+    SetInformationJobObject(governor->job, JobObjectCpuRateControlInformation, &rate, sizeof(rate));
   }
-  
-  if (area > ed->bestArea) {
-    ed->bestHwnd = hwnd;
-    ed->bestArea = area;
+  for (const GovernedProcess& process : processes) {
+    ApplyProcessLimits(process, throttled);
   }
-  
-  return TRUE; // Continue
 }
 
-// findWindowByPid(pid: number): bigint | null
-Napi::Value FindWindowByPid(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected number (pid)").ThrowAsJavaScriptException();
-    return env.Null();
+// Governor thread: the foreground moved to `foregroundPid`. The overlay's
+// windows (above the game) leave the limits as they are.
+void GovernForeground(ResourceGovernor* governor, DWORD foregroundPid) {
+  std::lock_guard<std::mutex> lock(governor->mutex);
+  if (governor->gamePid == 0 || (governor->overlayPid != 0 && foregroundPid == governor->overlayPid)) {
+    return;
   }
-  
-  DWORD targetPid = info[0].As<Napi::Number>().Uint32Value();
-  
-  // EnumWindows callback data
-  EnumData data = { targetPid, NULL, 0 };
-  
-  EnumWindows(EnumProc, reinterpret_cast<LPARAM>(&data));
-  
-  if (data.bestHwnd) {
-    return Napi::BigInt::New(env, reinterpret_cast<int64_t>(data.bestHwnd));
+  SetGovernorThrottled(governor, foregroundPid == governor->gamePid, false);
+}
+
+// Governor thread: the game exited, stop governing
+void GovernGameExit(ResourceGovernor* governor, DWORD gamePid) {
+  std::lock_guard<std::mutex> lock(governor->mutex);
+  if (governor->gamePid == gamePid) {
+    governor->gamePid = 0;
+    SetGovernorThrottled(governor, false, false);
   }
-  
-  return env.Null();
 }
 
-// findProcessIdByName(processName: string): number | null
-Napi::Value FindProcessIdByName(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "Expected string (processName)").ThrowAsJavaScriptException();
-    return env.Null();
+// The governor thread's WinEvent callback finds its governor here
+static thread_local ResourceGovernor* t_governor = nullptr;
+
+VOID CALLBACK GovernorForegroundProc(
+  HWINEVENTHOOK hWinEventHook,
+  DWORD event,
+  HWND hwnd,
+  LONG idObject,
+  LONG idChild,
+  DWORD dwEventThread,
+  DWORD dwmsTimeStamp
+) {
+  if (!t_governor || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+    return;
+  }
+  DWORD windowPid = 0;
+  GetWindowThreadProcessId(hwnd, &windowPid);
+  GovernForeground(t_governor, windowPid);
+}
+
+// Follow the foreground (our own process included, it may be the overlay's)
+// until stopped or until the game exits. `game` is NULL if it cannot be waited on.
+void GovernorThreadMain(ResourceGovernor* governor, DWORD gamePid, HANDLE game) {
+  MSG msg;
+  PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+  t_governor = governor;
+
+  HWINEVENTHOOK hook = SetWinEventHook(
+    EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, NULL, GovernorForegroundProc,
+    0, 0, WINEVENT_OUTOFCONTEXT);
+  // The foreground may have moved since setResourceGovernor looked
+  GovernForeground(governor, ForegroundProcessId());
+
+  HANDLE handles[2] = { governor->stopEvent, game };
+  DWORD handleCount = game ? 2 : 1;
+  for (;;) {
+    DWORD wait = MsgWaitForMultipleObjectsEx(handleCount, handles, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    if (wait == WAIT_OBJECT_0) {
+      break;
+    }
+    if (game && wait == WAIT_OBJECT_0 + 1) {
+      GovernGameExit(governor, gamePid);
+      break;
+    }
+    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+      TranslateMessage(&msg);
+      DispatchMessage(&msg);
+    }
+  }
+
+  if (hook) {
+    UnhookWinEvent(hook);
+  }
+  if (game) {
+    CloseHandle(game);
+  }
+  t_governor = nullptr;
+}
+
+// JS thread, without the governor's mutex (the thread takes it)
+void StopGovernorThread(ResourceGovernor* governor) {
+  if (governor->thread.joinable()) {
+    SetEvent(governor->stopEvent);
+    governor->thread.join();
+    ResetEvent(governor->stopEvent);
+  }
+}
+
+// Environment exit: stop following the foreground, lift the limits (the job
+// outlives its handle while members run) and let go of every member
+void CloseResourceGovernor(ResourceGovernor* governor) {
+  StopGovernorThread(governor);
+  if (governor->stopEvent) {
+    CloseHandle(governor->stopEvent);
+    governor->stopEvent = NULL;
+  }
+  std::lock_guard<std::mutex> lock(governor->mutex);
+  SetGovernorThrottled(governor, false, false);
+  for (const GovernedProcess& process : governor->processes) {
+    CloseHandle(process.handle);
+  }
+  governor->processes.clear();
+  if (governor->job) {
+    CloseHandle(governor->job);
+    governor->job = NULL;
+  }
+}
+
+// setResourceGovernor(gamePid: number, options?: { cpuRatePercent?: number, overlayPid?: number }): boolean
+// Govern helpers while gamePid is foreground (0 lifts the limits and stops).
+// The foreground moving to overlayPid's windows keeps the limits. Returns
+// whether they are in force now.
+Napi::Value SetResourceGovernor(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (gamePid, options?)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  UINT cpuRatePercent = GOVERNOR_DEFAULT_CPU_RATE_PERCENT;
+  DWORD overlayPid = 0;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    Napi::Value rateValue = options.Get("cpuRatePercent");
+    if (rateValue.IsNumber()) {
+      cpuRatePercent = static_cast<UINT>(std::min(100.0, std::max(1.0, rateValue.As<Napi::Number>().DoubleValue())));
+    }
+    Napi::Value overlayPidValue = options.Get("overlayPid");
+    if (overlayPidValue.IsNumber()) {
+      overlayPid = overlayPidValue.As<Napi::Number>().Uint32Value();
+    }
+  }
+
+  ResourceGovernor* governor = AddonFor(env)->governor;
+  StopGovernorThread(governor);
+  DWORD gamePid = info[0].As<Napi::Number>().Uint32Value();
+  bool throttled = gamePid != 0 && ForegroundProcessId() == gamePid;
+  {
+    std::lock_guard<std::mutex> lock(governor->mutex);
+    governor->gamePid = gamePid;
+    governor->overlayPid = overlayPid;
+    governor->cpuRatePercent = cpuRatePercent;
+    SetGovernorThrottled(governor, throttled, true);
+  }
+
+  // Without the stop event the thread could never be joined; the limits then
+  // stay as set here until the next call
+  if (gamePid != 0 && governor->stopEvent) {
+    HANDLE game = OpenProcess(SYNCHRONIZE, FALSE, gamePid);
+    governor->thread = std::thread(GovernorThreadMain, governor, gamePid, game);
+  }
+  return Napi::Boolean::New(env, throttled);
+}
+
+// governProcess(pid: number): boolean
+// Put a helper process under the governor; it gets the current limits at once.
+// Exited processes drop out by themselves. False if the process cannot be
+// opened or assigned to the job.
+Napi::Value GovernProcess(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected process id").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  DWORD pid = info[0].As<Napi::Number>().Uint32Value();
+  ResourceGovernor* governor = AddonFor(env)->governor;
+  std::lock_guard<std::mutex> lock(governor->mutex);
+  for (const GovernedProcess& process : governor->processes) {
+    if (process.pid == pid) {
+      return Napi::Boolean::New(env, true);
+    }
+  }
+
+  if (!governor->job) {
+    governor->job = CreateJobObjectW(NULL, NULL);
+    if (!governor->job) {
+      return Napi::Boolean::New(env, false);
+    }
+  }
+
+  HANDLE handle = OpenProcess(PROCESS_SET_QUOTA | PROCESS_TERMINATE | PROCESS_SET_INFORMATION |
+    PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid);
+  if (!handle) {
+    return Napi::Boolean::New(env, false);
+  }
+  // Jobs nest, so this works even when Electron runs us inside a job of its own
+  if (!AssignProcessToJobObject(governor->job, handle)) {
+    CloseHandle(handle);
+    return Napi::Boolean::New(env, false);
+  }
+
+  DWORD priorityClass = GetPriorityClass(handle);
+  GovernedProcess process = { pid, handle, priorityClass ? priorityClass : NORMAL_PRIORITY_CLASS };
+  if (governor->throttled) {
+    ApplyProcessLimits(process, true);
+  }
+  governor->processes.push_back(process);
+  return Napi::Boolean::New(env, true);
+}
+
+HookedProcess* FindHookedProcess(HookHost* host, HWINEVENTHOOK hook) {
+  for (HookedProcess* process : host->processes) {
+    for (size_t i = 0; i < HOOK_RANGE_COUNT; i++) {
+      if (process->hookHandles[i] == hook) {
+        return process;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// WinEvent hook callback (hook thread). Process-scoped hooks identify their
+// process by handle, so routing needs no per-event process lookups.
+VOID CALLBACK WinEventProc(
+  HWINEVENTHOOK hWinEventHook,
+  DWORD event,
+  HWND hwnd,
+  LONG idObject,
+  LONG idChild,
+  DWORD dwEventThread,
+  DWORD dwmsTimeStamp
+) {
+  HookHost* host = t_hookHost;
+  if (!host) {
+    return;
+  }
+
+  Cs2WindowTracker* addon = host->addon;
+  HookCounters& counters = addon->hookCounters;
+  LONGLONG originQpc = EventOriginQpc(dwmsTimeStamp);
+  HookEventCode code = HookEventCodeForWinEvent(event);
+  CountRaw(counters, code);
+
+  if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || code == HOOK_EVENT_NONE) {
+    CountFiltered(counters, code);
+    return;
+  }
+
+  // Handle foreground events differently - they fire for ANY window becoming foreground
+  if (code == HOOK_EVENT_FOREGROUND) {
+    DWORD windowPid;
+    GetWindowThreadProcessId(hwnd, &windowPid);
+
+    // Emit a "foreground" event with the foreground window's PID to every target;
+    // targets with a focus state machine only hear about changes of focus owner
+    bool emitted = false;
+    for (HookTarget* target : host->targets) {
+      if (target->publishesState) {
+        addon->published.foregroundPid = windowPid;
+        WriteStateBlock(addon);
+      }
+      if (target->trackFocus) {
+        emitted = UpdateFocusOwner(target, hwnd, windowPid, dwmsTimeStamp, originQpc) || emitted;
+        continue;
+      }
+      DispatchHookEvent(target, { HOOK_EVENT_FOREGROUND, hwnd, windowPid, dwmsTimeStamp, {}, originQpc });
+      emitted = true;
+    }
+    if (!emitted) {
+      CountCoalesced(counters, code);
+    }
+    return;
+  }
+
+  HookedProcess* process = FindHookedProcess(host, hWinEventHook);
+  if (!process) {
+    CountFiltered(counters, code);
+    return;
+  }
+
+  bool matched = false;
+  bool emitted = false;
+  for (HookTarget* target : process->targets) {
+    matched = RouteToTarget(target, code, hwnd, dwmsTimeStamp, originQpc, &emitted) || matched;
+  }
+
+  if (!matched) {
+    CountFiltered(counters, code);
+  } else if (!emitted) {
+    CountCoalesced(counters, code);
+  }
+}
+
+// Hook thread commands, posted with a HookTargetCommand* as lParam
+#define WM_HOOK_ADD_TARGET (WM_APP + 2)
+#define WM_HOOK_REMOVE_TARGET (WM_APP + 3)
+
+struct HookTargetCommand {
+  HookTarget* target;
+  bool watchingExit; // Add: the target's process exit is being waited on
+  std::promise<DWORD> done; // 0 or a SetWinEventHook error code
+};
+
+// Install kHookRanges entries on the calling (hook) thread: the global ones
+// (idProcess 0) or the process-scoped ones for `pid`. WINEVENT_OUTOFCONTEXT
+// callbacks are delivered to the installing thread, so it must pump messages.
+bool InstallWinEventHooks(HWINEVENTHOOK* handles, bool processScoped, DWORD pid) {
+  bool anyInstalled = false;
+  for (size_t i = 0; i < HOOK_RANGE_COUNT; i++) {
+    const WinEventHookRange& range = kHookRanges[i];
+    handles[i] = NULL;
+    if (range.processScoped != processScoped) {
+      continue;
+    }
+    handles[i] = SetWinEventHook(
+      range.eventMin,
+      range.eventMax,
+      NULL,
+      WinEventProc,
+      processScoped ? pid : 0,
+      0,
+      WINEVENT_OUTOFCONTEXT | (range.skipOwnProcess ? WINEVENT_SKIPOWNPROCESS : 0)
+    );
+    anyInstalled = anyInstalled || handles[i] != NULL;
+  }
+
+  // Succeed if at least one hook was set
+  // Note: SetWinEventHook returns NULL on failure, but GetLastError() might have more info
+  return anyInstalled;
+}
+
+// Uninstall hooks; must run on the thread that installed them
+void RemoveWinEventHooks(HWINEVENTHOOK* handles) {
+  for (size_t i = 0; i < HOOK_RANGE_COUNT; i++) {
+    if (handles[i]) {
+      UnhookWinEvent(handles[i]);
+      handles[i] = NULL;
+    }
+  }
+}
+
+size_t WatchedProcessCount(HookHost* host) {
+  size_t count = 0;
+  for (HookedProcess* process : host->processes) {
+    count += process->processHandle ? 1 : 0;
+  }
+  return count;
+}
+
+// Hook thread: attach a target, hooking its process first if nothing else tracks it
+DWORD AddHookTarget(HookHost* host, HookTargetCommand* command) {
+  HookTarget* target = command->target;
+  HookedProcess* process = nullptr;
+  for (HookedProcess* candidate : host->processes) {
+    if (candidate->pid == target->pid) {
+      process = candidate;
+      break;
+    }
+  }
+
+  if (!process) {
+    process = new HookedProcess();
+    process->pid = target->pid;
+    if (!InstallWinEventHooks(process->hookHandles, true, target->pid)) {
+      DWORD error = GetLastError();
+      delete process;
+      return error ? error : ERROR_GEN_FAILURE;
+    }
+    // MsgWaitForMultipleObjectsEx waits on at most MAXIMUM_WAIT_OBJECTS - 1 handles
+    process->processHandle = WatchedProcessCount(host) < MAXIMUM_WAIT_OBJECTS - 1
+      ? OpenProcess(SYNCHRONIZE, FALSE, target->pid)
+      : NULL;
+    host->processes.push_back(process);
+  }
+
+  process->targets.push_back(target);
+  host->targets.push_back(target);
+  command->watchingExit = process->processHandle != NULL;
+
+  if (target->publishesState) {
+    PublishWindowState(target);
+  }
+  if (target->trackFocus) {
+    SeedFocusState(target);
+  }
+  if (target->hwnd) {
+    EmitMonitorIfChanged(target, 0, 0); // Record the starting monitor
+  }
+  return 0;
+}
+
+// Hook thread: detach a target, unhooking its process if it was the last one
+void RemoveHookTarget(HookHost* host, HookTarget* target) {
+  auto& targets = host->targets;
+  targets.erase(std::remove(targets.begin(), targets.end(), target), targets.end());
+
+  auto& processes = host->processes;
+  for (size_t i = 0; i < processes.size(); i++) {
+    HookedProcess* process = processes[i];
+    if (process->pid != target->pid) {
+      continue;
+    }
+    process->targets.erase(std::remove(process->targets.begin(), process->targets.end(), target), process->targets.end());
+    if (process->targets.empty()) {
+      RemoveWinEventHooks(process->hookHandles);
+      if (process->processHandle) {
+        CloseHandle(process->processHandle);
+      }
+      delete process;
+      processes.erase(processes.begin() + i);
+    }
+    break;
+  }
+}
+
+// Hook thread: a watched process exited
+void HandleProcessExit(HookHost* host, HookedProcess* process) {
+  // Signaled handles stay signaled, so stop waiting on it once reported
+  CloseHandle(process->processHandle);
+  process->processHandle = NULL;
+  for (HookTarget* target : process->targets) {
+    if (target->publishesState) {
+      PublishWindowState(target);
+    }
+    DispatchHookEvent(target, { HOOK_EVENT_PROCESSEXIT, target->hwnd, target->pid, GetTickCount(), {}, QpcNow() });
+  }
+}
+
+// Hook thread: owns every hook and a message pump independent of the Electron main loop.
+// Reports 0 (success) or the SetWinEventHook error code through `ready`.
+void HookThreadMain(HookHost* host, std::promise<DWORD> ready) {
+  // Force creation of this thread's message queue before anyone posts to it
+  MSG msg;
+  PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+  host->threadId = GetCurrentThreadId();
+  t_hookHost = host;
+
+  if (!InstallWinEventHooks(host->globalHooks, false, 0)) {
+    DWORD error = GetLastError();
+    ready.set_value(error ? error : ERROR_GEN_FAILURE);
+    return;
+  }
+  ready.set_value(0);
+
+  // Pump messages (WinEvent callbacks are delivered while retrieving them) and
+  // also wake the instant a tracked process exits
+  HANDLE waitHandles[MAXIMUM_WAIT_OBJECTS];
+  HookedProcess* waitProcesses[MAXIMUM_WAIT_OBJECTS];
+  bool running = true;
+  while (running) {
+    DWORD handleCount = 0;
+    for (HookedProcess* process : host->processes) {
+      if (process->processHandle && handleCount < MAXIMUM_WAIT_OBJECTS - 1) {
+        waitHandles[handleCount] = process->processHandle;
+        waitProcesses[handleCount] = process;
+        handleCount++;
+      }
+    }
+
+    DWORD waitResult = MsgWaitForMultipleObjectsEx(
+      handleCount, waitHandles, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+    if (waitResult < WAIT_OBJECT_0 + handleCount) {
+      HandleProcessExit(host, waitProcesses[waitResult - WAIT_OBJECT_0]);
+      continue;
+    }
+
+    while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+      if (msg.hwnd == NULL && msg.message == WM_HOOK_ADD_TARGET) {
+        HookTargetCommand* command = reinterpret_cast<HookTargetCommand*>(msg.lParam);
+        command->done.set_value(AddHookTarget(host, command));
+        continue;
+      }
+      if (msg.hwnd == NULL && msg.message == WM_HOOK_REMOVE_TARGET) {
+        HookTargetCommand* command = reinterpret_cast<HookTargetCommand*>(msg.lParam);
+        RemoveHookTarget(host, command->target);
+        command->done.set_value(0);
+        continue;
+      }
+      if (msg.message == WM_QUIT || (msg.hwnd == NULL && msg.message == WM_HOOK_THREAD_STOP)) {
+        running = false;
+        break;
+      }
+      TranslateMessage(&msg);
+      DispatchMessage(&msg);
+    }
+  }
+
+  while (!host->processes.empty()) {
+    RemoveHookTarget(host, host->processes.back()->targets.back());
+  }
+  RemoveWinEventHooks(host->globalHooks);
+  t_hookHost = nullptr;
+}
+
+// Run a target command on the hook thread and wait for it. The hook thread
+// never waits on the JS thread, so this cannot deadlock.
+DWORD RunHookTargetCommand(HookHost* host, UINT message, HookTargetCommand* command) {
+  std::future<DWORD> result = command->done.get_future();
+  if (!PostThreadMessage(host->threadId, message, 0, reinterpret_cast<LPARAM>(command))) {
+    return GetLastError();
+  }
+  return result.get();
+}
+
+void StopHookHost(Cs2WindowTracker* addon) {
+  PostThreadMessage(addon->hookHost->threadId, WM_HOOK_THREAD_STOP, 0, 0);
+  addon->hookHost->thread.join();
+  delete addon->hookHost;
+  addon->hookHost = nullptr;
+}
+
+// Register a target on the shared hook thread (starting it if needed). JS thread.
+// Returns 0 or an error code; on error the target has not been registered.
+DWORD AttachHookTarget(HookTarget* target, bool* watchingExit) {
+  Cs2WindowTracker* addon = target->addon;
+  if (!addon->hookHost) {
+    // Counters describe the current hook session, which starts with its first
+    // target; later targets (and a replaced primary) leave them running
+    ResetHookCounters(addon->hookCounters);
+    HookHost* host = new HookHost();
+    host->addon = addon;
+    host->threadId = 0;
+    std::promise<DWORD> ready;
+    std::future<DWORD> readyResult = ready.get_future();
+    host->thread = std::thread(HookThreadMain, host, std::move(ready));
+    DWORD error = readyResult.get();
+    if (error) {
+      host->thread.join();
+      delete host;
+      return error;
+    }
+    addon->hookHost = host;
+  }
+
+  HookTargetCommand command = { target, false };
+  DWORD error = RunHookTargetCommand(addon->hookHost, WM_HOOK_ADD_TARGET, &command);
+  if (error) {
+    if (addon->targets.empty()) {
+      StopHookHost(addon);
+    }
+    return error;
+  }
+
+  addon->targets[target->id] = target;
+  *watchingExit = command.watchingExit;
+  return 0;
+}
+
+// Take a target off the hook thread (stopping it if this was the last). JS thread.
+void UnregisterHookTarget(HookTarget* target) {
+  Cs2WindowTracker* addon = target->addon;
+  HookTargetCommand command = { target, false };
+  RunHookTargetCommand(addon->hookHost, WM_HOOK_REMOVE_TARGET, &command);
+  addon->targets.erase(target->id);
+
+  if (target == addon->primaryTarget) {
+    addon->primaryTarget = nullptr;
+    addon->published.valid = false;
+    WriteStateBlock(addon);
+  }
+
+  // The hook itself stays up while other targets need it
+  if (addon->targets.empty()) {
+    StopHookHost(addon);
+  }
+}
+
+// Unregister a target and release its thread-safe function; events still
+// queued are delivered before the finalizer frees the target. JS thread.
+void DetachHookTarget(HookTarget* target) {
+  UnregisterHookTarget(target);
+  target->tsfn.Release();
+}
+
+// Create a target whose thread-safe function calls `callback`
+HookTarget* NewHookTarget(Napi::Env env, Napi::Function callback, DWORD pid, HWND hwnd, bool batchDelivery) {
+  HookTarget* target = new HookTarget();
+  target->addon = AddonFor(env);
+  target->id = target->addon->nextTargetId++;
+  target->pid = pid;
+  target->hwnd = hwnd;
+  target->batchDelivery = batchDelivery;
+  target->publishesState = false;
+  target->hasLastBounds = false;
+  target->ring = nullptr;
+  if (batchDelivery) {
+    target->ring = new EventRing();
+    target->ring->head.store(0, std::memory_order_relaxed);
+    target->ring->tail.store(0, std::memory_order_relaxed);
+    target->ring->dropped.store(0, std::memory_order_relaxed);
+  }
+  target->wakeupPending.store(false, std::memory_order_relaxed);
+  target->followHwnd.store(NULL, std::memory_order_relaxed);
+  target->followPaced.store(false, std::memory_order_relaxed);
+  target->trackFocus = false;
+  target->overlayPid = 0;
+  target->focusState = HOOK_EVENT_NONE;
+  target->minimized = false;
+  target->moving = false;
+  target->monitor = NULL;
+  target->dpi = 0;
+  target->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    callback,
+    "cs2WinEventHook",
+    0, // Unlimited queue; WinEventProc must never block
+    1,
+    [](Napi::Env, HookTarget* finalized) {
+      // Environment teardown finalizes targets that were never untracked
+      if (finalized->addon->targets.count(finalized->id)) {
+        UnregisterHookTarget(finalized);
+      }
+      delete finalized->ring;
+      delete finalized;
+    },
+    target
+  );
+  return target;
+}
+
+// Helper: Check if window is a tool window
+bool IsToolWindow(HWND hwnd) {
+  LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+  return (exStyle & WS_EX_TOOLWINDOW) != 0;
+}
+
+// Helper: Get window area
+int GetWindowArea(HWND hwnd) {
+  RECT rect;
+  if (GetWindowRect(hwnd, &rect)) {
+    return (rect.right - rect.left) * (rect.bottom - rect.top);
+  }
+  return 0;
+}
+
+// A window that passed the EnumProc filters (reported by findWindowByPidAsync)
+struct WindowCandidate {
+  HWND hwnd;
+  int area;
+  std::wstring title;
+};
+
+// EnumWindows callback data structure
+struct EnumData {
+  DWORD pid;
+  HWND bestHwnd;
+  int bestArea;
+  std::vector<WindowCandidate>* candidates; // When set, every matching window is collected
+};
+
+// EnumWindows callback function (must be at file scope, not local)
+BOOL CALLBACK EnumProc(HWND hwnd, LPARAM lParam) {
+  EnumData* ed = reinterpret_cast<EnumData*>(lParam);
+  
+  // Check visibility
+  if (!IsWindowVisible(hwnd)) {
+    return TRUE; // Continue
+  }
+  
+  // Check process ID
+  DWORD windowPid;
+  GetWindowThreadProcessId(hwnd, &windowPid);
+  if (windowPid != ed->pid) {
+    return TRUE; // Continue
+  }
+  
+  // Check if it's a tool window (skip those)
+  LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+  if (exStyle & WS_EX_TOOLWINDOW) {
+    return TRUE; // Continue
+  }
+  
+  // Check if window has a title (non-empty)
+  wchar_t title[256];
+  int titleLen = GetWindowTextW(hwnd, title, 256);
+  if (titleLen == 0) {
+    return TRUE; // Continue
+  }
+  
+  // Calculate area
+  RECT rect;
+  int area = 0;
+  if (GetWindowRect(hwnd, &rect)) {
+    area = (rect.right - rect.left) * (rect.bottom - rect.top);
+  }
+  
+  if (area > ed->bestArea) {
+    ed->bestHwnd = hwnd;
+    ed->bestArea = area;
+  }
+
+  if (ed->candidates) {
+    ed->candidates->push_back({ hwnd, area, std::wstring(title, titleLen) });
+  }
+  
+  return TRUE; // Continue
+}
+
+// Best (largest titled, non-tool) visible top-level window of a process
+HWND FindBestWindowForPid(DWORD pid) {
+  EnumData data = { pid, NULL, 0, nullptr };
+  EnumWindows(EnumProc, reinterpret_cast<LPARAM>(&data));
+  return data.bestHwnd;
+}
+
+// findWindowByPid(pid: number): bigint | null
+Napi::Value FindWindowByPid(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number (pid)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  DWORD targetPid = info[0].As<Napi::Number>().Uint32Value();
+  
+  HWND bestHwnd = FindBestWindowForPid(targetPid);
+  
+  if (bestHwnd) {
+    return Napi::BigInt::New(env, reinterpret_cast<int64_t>(bestHwnd));
+  }
+  
+  return env.Null();
+}
+
+// findProcessIdByName(processName: string): number | null
+Napi::Value FindProcessIdByName(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected string (processName)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  std::string processName = info[0].As<Napi::String>().Utf8Value();
+  
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (snapshot == INVALID_HANDLE_VALUE) {
+    return env.Null();
+  }
+  
+  PROCESSENTRY32 entry;
+  entry.dwSize = sizeof(PROCESSENTRY32);
+  
+  if (Process32First(snapshot, &entry)) {
+    do {
+      // Compare process names case-insensitively
+      std::string entryName = entry.szExeFile;
+      std::string lowerEntryName;
+      std::string lowerProcessName;
+      for (char c : entryName) {
+        lowerEntryName += std::tolower(static_cast<unsigned char>(c));
+      }
+      for (char c : processName) {
+        lowerProcessName += std::tolower(static_cast<unsigned char>(c));
+      }
+      if (lowerEntryName == lowerProcessName) {
+        CloseHandle(snapshot);
+        return Napi::Number::New(env, entry.th32ProcessID);
+      }
+    } while (Process32Next(snapshot, &entry));
+  }
+  
+  CloseHandle(snapshot);
+  return env.Null();
+}
+
+// Lowercase a UTF-8 string into UTF-16 for case-insensitive exe name matching
+std::wstring ToLowerWide(const std::string& utf8) {
+  int length = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, NULL, 0);
+  if (length <= 0) {
+    return std::wstring();
+  }
+  std::wstring wide(static_cast<size_t>(length - 1), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wide[0], length);
+  CharLowerBuffW(&wide[0], static_cast<DWORD>(wide.size()));
+  return wide;
+}
+
+// Does the process' executable file name (without directory) equal lowerName?
+bool ProcessExeNameMatches(DWORD pid, const std::wstring& lowerName) {
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+  if (!process) {
+    return false;
+  }
+
+  wchar_t path[MAX_PATH];
+  DWORD pathLength = MAX_PATH;
+  bool matches = false;
+  if (QueryFullProcessImageNameW(process, 0, path, &pathLength)) {
+    CharLowerBuffW(path, pathLength);
+    const wchar_t* fileName = wcsrchr(path, L'\\');
+    fileName = fileName ? fileName + 1 : path;
+    matches = lowerName == fileName;
+  }
+
+  CloseHandle(process);
+  return matches;
+}
+
+// Collect the PIDs of every running process whose exe name equals lowerName
+bool FindProcessIdsByName(const std::wstring& lowerName, std::vector<DWORD>* pids) {
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (snapshot == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  PROCESSENTRY32W entry;
+  entry.dwSize = sizeof(PROCESSENTRY32W);
+  if (Process32FirstW(snapshot, &entry)) {
+    do {
+      CharLowerBuffW(entry.szExeFile, static_cast<DWORD>(wcslen(entry.szExeFile)));
+      if (lowerName == entry.szExeFile) {
+        pids->push_back(entry.th32ProcessID);
+      }
+    } while (Process32NextW(snapshot, &entry));
+  }
+
+  CloseHandle(snapshot);
+  return true;
+}
+
+// Convert a UTF-16 window title to UTF-8 for JS
+std::string WideToUtf8(const std::wstring& wide) {
+  if (wide.empty()) {
+    return std::string();
+  }
+  int length = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), static_cast<int>(wide.size()), NULL, 0, NULL, NULL);
+  std::string utf8(static_cast<size_t>(length), '\0');
+  WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), static_cast<int>(wide.size()), &utf8[0], length, NULL, NULL);
+  return utf8;
+}
+
+// Toolhelp snapshot off the JS thread; resolves every matching PID
+class FindProcessIdsWorker : public Napi::AsyncWorker {
+public:
+  FindProcessIdsWorker(Napi::Env env, const std::wstring& lowerName)
+    : Napi::AsyncWorker(env, "cs2FindProcessIds"), lowerName(lowerName), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    if (!FindProcessIdsByName(lowerName, &pids)) {
+      SetError("Failed to create process snapshot. Error code: " + std::to_string(GetLastError()));
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, pids.size());
+    for (size_t i = 0; i < pids.size(); i++) {
+      result.Set(static_cast<uint32_t>(i), Napi::Number::New(env, pids[i]));
+    }
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  std::wstring lowerName;
+  std::vector<DWORD> pids;
+  Napi::Promise::Deferred deferred;
+};
+
+// EnumWindows off the JS thread, so a slow GetWindowTextW never stalls it.
+// Resolves every candidate window, largest first (the first is what findWindowByPid returns).
+class FindWindowsWorker : public Napi::AsyncWorker {
+public:
+  FindWindowsWorker(Napi::Env env, DWORD pid)
+    : Napi::AsyncWorker(env, "cs2FindWindows"), pid(pid), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    EnumData data = { pid, NULL, 0, &candidates };
+    EnumWindows(EnumProc, reinterpret_cast<LPARAM>(&data));
+    std::stable_sort(candidates.begin(), candidates.end(),
+      [](const WindowCandidate& a, const WindowCandidate& b) { return a.area > b.area; });
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+      Napi::Object window = Napi::Object::New(env);
+      window.Set("hwnd", Napi::BigInt::New(env, reinterpret_cast<int64_t>(candidates[i].hwnd)));
+      window.Set("area", Napi::Number::New(env, candidates[i].area));
+      window.Set("title", Napi::String::New(env, WideToUtf8(candidates[i].title)));
+      result.Set(static_cast<uint32_t>(i), window);
+    }
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  DWORD pid;
+  std::vector<WindowCandidate> candidates;
+  Napi::Promise::Deferred deferred;
+};
+
+// findProcessIdByNameAsync(processName: string): Promise<number[]>
+Napi::Value FindProcessIdByNameAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected string processName").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  FindProcessIdsWorker* worker = new FindProcessIdsWorker(env, ToLowerWide(info[0].As<Napi::String>().Utf8Value()));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+// findWindowByPidAsync(pid: number): Promise<Array<{ hwnd, area, title }>>
+Napi::Value FindWindowByPidAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number pid").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  FindWindowsWorker* worker = new FindWindowsWorker(env, info[0].As<Napi::Number>().Uint32Value());
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+// A pending waitForWindow() call, listed in the addon's windowWaits until its
+// thread-safe function is finalized, which joins the waiter thread
+struct WindowWaitRequest {
+  Cs2WindowTracker* addon;
+  DWORD pid; // Target PID, or 0 to match any process named processName
+  std::wstring processName; // Lowercase exe name (when pid == 0)
+  DWORD timeoutMs;
+  std::map<DWORD, bool> exeMatchCache; // pid -> exe name matched, so each process is opened once
+  DWORD foundPid;
+  HWND foundHwnd;
+  Napi::Promise::Deferred deferred;
+  Napi::ThreadSafeFunction tsfn;
+  HANDLE stopEvent; // Set on environment teardown: give up without settling
+  std::thread thread;
+
+  explicit WindowWaitRequest(Napi::Env env)
+    : addon(nullptr), pid(0), timeoutMs(0), foundPid(0), foundHwnd(NULL), deferred(env), stopEvent(NULL) {}
+};
+
+// Waiter threads each own one request; their WinEvent callbacks find it here
+static thread_local WindowWaitRequest* t_windowWait = nullptr;
+
+bool IsWaitTargetPid(WindowWaitRequest* request, DWORD pid) {
+  if (request->pid) {
+    return pid == request->pid;
+  }
+  auto cached = request->exeMatchCache.find(pid);
+  if (cached != request->exeMatchCache.end()) {
+    return cached->second;
+  }
+  bool matches = ProcessExeNameMatches(pid, request->processName);
+  request->exeMatchCache[pid] = matches;
+  return matches;
+}
+
+// Check for an existing window before waiting (process may already be up)
+bool FindExistingWaitTarget(WindowWaitRequest* request) {
+  if (request->pid) {
+    request->foundHwnd = FindBestWindowForPid(request->pid);
+    request->foundPid = request->pid;
+    return request->foundHwnd != NULL;
+  }
+
+  std::vector<DWORD> pids;
+  FindProcessIdsByName(request->processName, &pids);
+  for (DWORD pid : pids) {
+    HWND hwnd = FindBestWindowForPid(pid);
+    if (hwnd) {
+      request->foundPid = pid;
+      request->foundHwnd = hwnd;
+      break;
+    }
+  }
+
+  return request->foundHwnd != NULL;
+}
+
+// Show/name-change events: a top-level window appeared or got its title.
+// Only top-level windows of matching processes trigger a (pid-filtered) enumeration.
+VOID CALLBACK WindowWaitEventProc(
+  HWINEVENTHOOK hWinEventHook,
+  DWORD event,
+  HWND hwnd,
+  LONG idObject,
+  LONG idChild,
+  DWORD dwEventThread,
+  DWORD dwmsTimeStamp
+) {
+  WindowWaitRequest* request = t_windowWait;
+  if (!request || request->foundHwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+    return;
+  }
+  if (GetAncestor(hwnd, GA_ROOT) != hwnd) {
+    return;
+  }
+
+  DWORD windowPid;
+  GetWindowThreadProcessId(hwnd, &windowPid);
+  if (!IsWaitTargetPid(request, windowPid)) {
+    return;
+  }
+
+  HWND best = FindBestWindowForPid(windowPid);
+  if (best) {
+    request->foundPid = windowPid;
+    request->foundHwnd = best;
+  }
+}
+
+void WindowWaitThreadMain(WindowWaitRequest* request) {
+  MSG msg;
+  PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+  t_windowWait = request;
+
+  // Hook first, then scan, so a window appearing in between is not missed
+  HWINEVENTHOOK showHook = SetWinEventHook(
+    EVENT_OBJECT_SHOW, EVENT_OBJECT_SHOW, NULL, WindowWaitEventProc,
+    request->pid, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+  HWINEVENTHOOK nameHook = SetWinEventHook(
+    EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, NULL, WindowWaitEventProc,
+    request->pid, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+
+  if (!FindExistingWaitTarget(request)) {
+    ULONGLONG deadline = GetTickCount64() + request->timeoutMs;
+    while (!request->foundHwnd) {
+      ULONGLONG now = GetTickCount64();
+      if (now >= deadline) {
+        break;
+      }
+      DWORD wait = MsgWaitForMultipleObjectsEx(1, &request->stopEvent, static_cast<DWORD>(deadline - now),
+        QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+      if (wait == WAIT_OBJECT_0) {
+        break;
+      }
+      while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+      }
+    }
+  }
+
+  if (showHook) {
+    UnhookWinEvent(showHook);
+  }
+  if (nameHook) {
+    UnhookWinEvent(nameHook);
+  }
+  t_windowWait = nullptr;
+
+  // Settle the promise on the JS thread; the finalizer frees the request. On
+  // teardown the call is refused and the promise is left with the environment
+  request->tsfn.BlockingCall(request, [](Napi::Env env, Napi::Function, WindowWaitRequest* data) {
+    if (env != nullptr) {
+      if (data->foundHwnd) {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("pid", Napi::Number::New(env, data->foundPid));
+        result.Set("hwnd", Napi::BigInt::New(env, reinterpret_cast<int64_t>(data->foundHwnd)));
+        data->deferred.Resolve(result);
+      } else {
+        data->deferred.Resolve(env.Null());
+      }
+    }
+  });
+  request->tsfn.Release();
+}
+
+// waitForWindow(target: string | number, timeoutMs: number): Promise<{ pid, hwnd } | null>
+// Resolves as soon as the main window of the process (by exe name or PID) appears,
+// driven by window show/title events instead of polling. Resolves null on timeout.
+Napi::Value WaitForWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !(info[0].IsString() || info[0].IsNumber()) || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (string processName | number pid, number timeoutMs)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  HANDLE stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (!stopEvent) {
+    Napi::Error::New(env, "Failed to create wait event. Error code: " + std::to_string(GetLastError()))
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  WindowWaitRequest* request = new WindowWaitRequest(env);
+  request->addon = addon;
+  request->stopEvent = stopEvent;
+  if (info[0].IsNumber()) {
+    request->pid = info[0].As<Napi::Number>().Uint32Value();
+  } else {
+    request->processName = ToLowerWide(info[0].As<Napi::String>().Utf8Value());
+  }
+  request->timeoutMs = info[1].As<Napi::Number>().Uint32Value();
+
+  Napi::Promise promise = request->deferred.Promise();
+  request->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+    "cs2WaitForWindow",
+    0,
+    1,
+    [](Napi::Env, WindowWaitRequest* finalized) {
+      // Normally the thread has settled the promise and is exiting; on
+      // environment teardown it may still be waiting and is stopped first
+      if (finalized->thread.joinable()) {
+        SetEvent(finalized->stopEvent);
+        finalized->thread.join();
+      }
+      finalized->addon->windowWaits.erase(finalized);
+      CloseHandle(finalized->stopEvent);
+      delete finalized;
+    },
+    request
+  );
+  addon->windowWaits.insert(request);
+
+  // The thread settles the promise and releases the function itself
+  request->thread = std::thread(WindowWaitThreadMain, request);
+
+  return promise;
+}
+
+// getClientBoundsOnScreen(hwnd: bigint): { x, y, width, height }
+Napi::Value GetClientBoundsOnScreen(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+    return env.Null();
   }
   
-  std::string processName = info[0].As<Napi::String>().Utf8Value();
+  bool lossless;
+  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
+  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
   
-  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-  if (snapshot == INVALID_HANDLE_VALUE) {
+  RECT bounds;
+  if (!GetClientRectOnScreen(hwnd, &bounds)) {
     return env.Null();
   }
   
-  PROCESSENTRY32 entry;
-  entry.dwSize = sizeof(PROCESSENTRY32);
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("x", Napi::Number::New(env, bounds.left));
+  result.Set("y", Napi::Number::New(env, bounds.top));
+  result.Set("width", Napi::Number::New(env, bounds.right - bounds.left));
+  result.Set("height", Napi::Number::New(env, bounds.bottom - bounds.top));
   
-  if (Process32First(snapshot, &entry)) {
-    do {
-      // Compare process names case-insensitively
-      std::string entryName = entry.szExeFile;
-      std::string lowerEntryName;
-      std::string lowerProcessName;
-      for (char c : entryName) {
-        lowerEntryName += std::tolower(static_cast<unsigned char>(c));
-      }
-      for (char c : processName) {
-        lowerProcessName += std::tolower(static_cast<unsigned char>(c));
-      }
-      if (lowerEntryName == lowerProcessName) {
-        CloseHandle(snapshot);
-        return Napi::Number::New(env, entry.th32ProcessID);
-      }
-    } while (Process32Next(snapshot, &entry));
+  return result;
+}
+
+// isMinimized(hwnd: bigint): boolean
+Napi::Value IsMinimized(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+    return env.Null();
   }
   
-  CloseHandle(snapshot);
-  return env.Null();
+  bool lossless;
+  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
+  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
+  
+  return Napi::Boolean::New(env, IsIconic(hwnd) != FALSE);
 }
 
-// getClientBoundsOnScreen(hwnd: bigint): { x, y, width, height }
-Napi::Value GetClientBoundsOnScreen(const Napi::CallbackInfo& info) {
+// getDpiScaleForHwnd(hwnd: bigint): number
+Napi::Value GetDpiScaleForHwnd(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
   if (info.Length() < 1 || !info[0].IsBigInt()) {
@@ -257,284 +1840,1045 @@ Napi::Value GetClientBoundsOnScreen(const Napi::CallbackInfo& info) {
   int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
   HWND hwnd = reinterpret_cast<HWND>(hwndValue);
   
-  RECT clientRect;
-  if (!GetClientRect(hwnd, &clientRect)) {
+  return Napi::Number::New(env, GetWindowDpi(hwnd) / 96.0);
+}
+
+// getForegroundPid(): number
+Napi::Value GetForegroundPid(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  HWND fgHwnd = GetForegroundWindow();
+  if (!fgHwnd) {
     return env.Null();
   }
   
-  POINT topLeft = { clientRect.left, clientRect.top };
-  POINT bottomRight = { clientRect.right, clientRect.bottom };
+  DWORD pid;
+  GetWindowThreadProcessId(fgHwnd, &pid);
   
-  if (!ClientToScreen(hwnd, &topLeft) || !ClientToScreen(hwnd, &bottomRight)) {
+  return Napi::Number::New(env, pid);
+}
+
+// forceActivateWindow(hwnd: bigint): boolean
+Napi::Value ForceActivateWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 1 || !info[0].IsBigInt()) {
+    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+    return Napi::Boolean::New(env, false);
+  }
+  
+  bool lossless;
+  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
+  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
+  
+  if (!IsWindow(hwnd)) {
+    return Napi::Boolean::New(env, false);
+  }
+  
+  // Get current foreground window and its thread
+  HWND fgHwnd = GetForegroundWindow();
+  DWORD fgThreadId = 0;
+  if (fgHwnd) {
+    fgThreadId = GetWindowThreadProcessId(fgHwnd, NULL);
+  }
+  
+  // Get target window's thread
+  DWORD targetThreadId = GetWindowThreadProcessId(hwnd, NULL);
+  DWORD currentThreadId = GetCurrentThreadId();
+  
+  // Attach to foreground thread if different from current thread
+  bool attached = false;
+  if (fgThreadId != 0 && fgThreadId != currentThreadId) {
+    attached = AttachThreadInput(currentThreadId, fgThreadId, TRUE) != FALSE;
+  }
+  
+  // Restore window if minimized
+  if (IsIconic(hwnd)) {
+    ShowWindow(hwnd, SW_RESTORE);
+  }
+  
+  // Bring window to foreground
+  SetForegroundWindow(hwnd);
+  BringWindowToTop(hwnd);
+  SetFocus(hwnd);
+  
+  // Detach if we attached
+  if (attached) {
+    AttachThreadInput(currentThreadId, fgThreadId, FALSE);
+  }
+  
+  // Verify it worked
+  HWND newFgHwnd = GetForegroundWindow();
+  bool success = (newFgHwnd == hwnd);
+  
+  return Napi::Boolean::New(env, success);
+}
+
+// Shared option parsing for startWinEventHook/trackWindow:
+// { delivery: 'batch' } stores events in the ring for drainEvents(); cb() is then only a signal
+bool ParseBatchDelivery(const Napi::CallbackInfo& info, size_t index) {
+  if (info.Length() > index && info[index].IsObject()) {
+    Napi::Value deliveryOpt = info[index].As<Napi::Object>().Get("delivery");
+    if (deliveryOpt.IsString()) {
+      return deliveryOpt.As<Napi::String>().Utf8Value() == "batch";
+    }
+  }
+  return false;
+}
+
+// { overlayPid } turns on the focus state machine: foreground and minimize events
+// are replaced by cs2-focused/overlay-focused/lost-focus and minimized/restored transitions
+void ParseFocusOptions(const Napi::CallbackInfo& info, size_t index, HookTarget* target) {
+  if (info.Length() > index && info[index].IsObject()) {
+    Napi::Value overlayPidOpt = info[index].As<Napi::Object>().Get("overlayPid");
+    if (overlayPidOpt.IsNumber()) {
+      target->trackFocus = true;
+      target->overlayPid = overlayPidOpt.As<Napi::Number>().Uint32Value();
+    }
+  }
+}
+
+void ThrowHookError(Napi::Env env, DWORD error) {
+  std::string errorMsg = "Failed to set WinEvent hooks. Error code: " + std::to_string(error);
+  Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+}
+
+// startWinEventHook(targetPid: number, cb: function,
+//                   options?: { hwnd?: bigint, delivery?: 'callback' | 'batch', overlayPid?: number }): boolean
+// The primary target: replaces the previous one, drives the state block and overlay
+// follow mode, and is drained by drainEvents(buffer) without an id. Other trackWindow()
+// targets are unaffected. Returns true when a processexit event will be emitted when
+// the target exits (the process could be opened for SYNCHRONIZE).
+Napi::Value StartWinEventHook(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (number pid, function callback)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // { hwnd } enables native bounds coalescing for that window
+  HWND targetHwnd = NULL;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Value hwndOpt = info[2].As<Napi::Object>().Get("hwnd");
+    if (hwndOpt.IsBigInt()) {
+      bool lossless;
+      targetHwnd = reinterpret_cast<HWND>(hwndOpt.As<Napi::BigInt>().Int64Value(&lossless));
+    }
+  }
+  
+  // Replace the existing primary target if any
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (addon->primaryTarget) {
+    DetachHookTarget(addon->primaryTarget);
+  }
+
+  HookTarget* target = NewHookTarget(
+    env, info[1].As<Napi::Function>(), info[0].As<Napi::Number>().Uint32Value(), targetHwnd, ParseBatchDelivery(info, 2));
+  target->publishesState = true;
+  ParseFocusOptions(info, 2, target);
+  addon->published = {};
+
+  bool watchingExit = false;
+  DWORD error = AttachHookTarget(target, &watchingExit);
+  if (error) {
+    target->tsfn.Release();
+    ThrowHookError(env, error);
+    return env.Undefined();
+  }
+  addon->primaryTarget = target;
+  
+  return Napi::Boolean::New(env, watchingExit);
+}
+
+// stopWinEventHook(): void
+// Stops the primary target; trackWindow() targets keep running
+Napi::Value StopWinEventHook(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (addon->primaryTarget) {
+    DetachHookTarget(addon->primaryTarget);
+  }
+  
+  return env.Undefined();
+}
+
+// trackWindow(target: number pid | bigint hwnd, cb: function,
+//             options?: { delivery?: 'callback' | 'batch', overlayPid?: number }): number
+// Subscribe to a process' (or one window's) events on the shared hook set and return
+// a target id for untrack()/drainEvents(). Events are the same as startWinEventHook's;
+// with an hwnd, location changes are coalesced into boundschanged for that window.
+Napi::Value TrackWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !(info[0].IsNumber() || info[0].IsBigInt()) || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (number pid | bigint hwnd, function callback)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  DWORD pid = 0;
+  HWND hwnd = NULL;
+  if (info[0].IsBigInt()) {
+    bool lossless;
+    hwnd = reinterpret_cast<HWND>(info[0].As<Napi::BigInt>().Int64Value(&lossless));
+    if (!IsWindow(hwnd) || !GetWindowThreadProcessId(hwnd, &pid)) {
+      Napi::Error::New(env, "Window handle is not valid").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  } else {
+    pid = info[0].As<Napi::Number>().Uint32Value();
+  }
+
+  HookTarget* target = NewHookTarget(env, info[1].As<Napi::Function>(), pid, hwnd, ParseBatchDelivery(info, 2));
+  ParseFocusOptions(info, 2, target);
+  bool watchingExit = false;
+  DWORD error = AttachHookTarget(target, &watchingExit);
+  if (error) {
+    target->tsfn.Release();
+    ThrowHookError(env, error);
+    return env.Null();
+  }
+
+  return Napi::Number::New(env, target->id);
+}
+
+// untrack(id: number): boolean
+Napi::Value Untrack(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number id").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  auto found = addon->targets.find(info[0].As<Napi::Number>().Uint32Value());
+  if (found == addon->targets.end()) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  DetachHookTarget(found->second);
+  return Napi::Boolean::New(env, true);
+}
+
+// Read a window handle passed as BrowserWindow.getNativeWindowHandle() (HWND bytes)
+// or as a bigint. Returns false if the value is neither.
+bool ParseWindowHandle(const Napi::Value& value, HWND* out) {
+  *out = NULL;
+  if (value.IsBuffer()) {
+    Napi::Buffer<uint8_t> handle = value.As<Napi::Buffer<uint8_t>>();
+    if (handle.Length() >= sizeof(HWND)) {
+      memcpy(out, handle.Data(), sizeof(HWND));
+    }
+    return true;
+  }
+  if (value.IsBigInt()) {
+    bool lossless;
+    *out = reinterpret_cast<HWND>(value.As<Napi::BigInt>().Int64Value(&lossless));
+    return true;
+  }
+  return false;
+}
+
+#ifndef WDA_EXCLUDEFROMCAPTURE
+#define WDA_EXCLUDEFROMCAPTURE 0x00000011 // Windows 10 2004+
+#endif
+
+// setWindowExcludedFromCapture(handle: Buffer | bigint, excluded: boolean): boolean
+// Hides one of this process' windows from desktop duplication and other screen
+// capture while it stays on screen. False on older Windows or foreign windows.
+Napi::Value SetWindowExcludedFromCapture(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  HWND hwnd = NULL;
+  if (info.Length() < 2 || !ParseWindowHandle(info[0], &hwnd) || !info[1].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected (Buffer or bigint handle, boolean excluded)").ThrowAsJavaScriptException();
+    return Napi::Boolean::New(env, false);
+  }
+
+  DWORD affinity = info[1].As<Napi::Boolean>().Value() ? WDA_EXCLUDEFROMCAPTURE : WDA_NONE;
+  return Napi::Boolean::New(env, IsWindow(hwnd) && SetWindowDisplayAffinity(hwnd, affinity) != FALSE);
+}
+
+// setOverlayFollow(overlayHandle: Buffer | bigint | null, options?: { framePaced?: boolean }): boolean
+// Hands the overlay window to the hook: from now on it is positioned over the tracked
+// window's client rect natively on every move/resize, and 'boundschanged' is no longer
+// delivered. Requires an active hook started with an hwnd. Pass null to turn it off;
+// a handle that names no window returns false.
+// framePaced: move at most once per vblank of the tracked window's monitor.
+Napi::Value SetOverlayFollow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  HWND follower = NULL;
+  bool parsed = info.Length() >= 1 && ParseWindowHandle(info[0], &follower);
+  if (!parsed && (info.Length() < 1 || !(info[0].IsNull() || info[0].IsUndefined()))) {
+    Napi::TypeError::New(env, "Expected Buffer or bigint overlay handle, or null").ThrowAsJavaScriptException();
     return env.Null();
   }
-  
-  Napi::Object result = Napi::Object::New(env);
-  result.Set("x", Napi::Number::New(env, topLeft.x));
-  result.Set("y", Napi::Number::New(env, topLeft.y));
-  result.Set("width", Napi::Number::New(env, bottomRight.x - topLeft.x));
-  result.Set("height", Napi::Number::New(env, bottomRight.y - topLeft.y));
-  
-  return result;
+
+  // A handle that resolves to no window (a zeroed buffer, a destroyed window)
+  // fails rather than turning follow off, so JS keeps positioning the overlay
+  if (parsed && (!follower || !IsWindow(follower))) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  HookTarget* target = AddonFor(env)->primaryTarget;
+  if (!target || !target->hwnd) {
+    return Napi::Boolean::New(env, !parsed);
+  }
+
+  bool framePaced = false;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Value pacedValue = info[1].As<Napi::Object>().Get("framePaced");
+    framePaced = pacedValue.IsBoolean() && pacedValue.As<Napi::Boolean>().Value();
+  }
+  if (follower && framePaced) {
+    EnsureFollowPacer(target->addon);
+  }
+
+  // Snap into place right away rather than waiting for the next move
+  if (follower) {
+    RECT bounds;
+    if (!IsIconic(target->hwnd) && GetClientRectOnScreen(target->hwnd, &bounds)) {
+      PositionFollower(follower, bounds);
+    }
+  }
+  target->followPaced.store(follower && framePaced, std::memory_order_release);
+  target->followHwnd.store(follower, std::memory_order_release);
+  if (!follower && target->addon->followPacer) {
+    // A move still waiting for its vblank must not land after follow is off
+    std::lock_guard<std::mutex> lock(target->addon->followPacer->mutex);
+    target->addon->followPacer->pending = false;
+  }
+
+  return Napi::Boolean::New(env, true);
+}
+
+// Overlay hit testing: a low-level mouse hook on its own thread checks the cursor
+// against the overlay's interactive rectangles and clears WS_EX_TRANSPARENT only
+// while it is over one of them, so the overlay is click-through everywhere else
+// without a renderer -> main round trip per cursor move. JS only hears
+// hoverenter/hoverleave.
+#define WM_HITTEST_SET_REGIONS (WM_APP + 10) // lParam: std::vector<RECT>*, owned by the hit-test thread
+#define WM_HITTEST_SUSPEND (WM_APP + 11) // wParam: TRUE to leave the overlay's style alone
+#define WM_HITTEST_STOP (WM_APP + 12)
+#define WM_HITTEST_HOVER (WM_APP + 17) // wParam: TRUE if hovered; applied outside the hook callback
+
+struct HitTestHost {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  DWORD threadId;
+  HWND overlay;
+  HHOOK mouseHook;
+  // Hit-test thread only
+  std::vector<RECT> regions; // Overlay client coordinates, physical pixels
+  bool hovered; // Last state seen by the hook
+  bool applied; // Last state applied to the style and reported to JS
+  bool suspended; // Interactive mode: the whole overlay takes input, nothing is flipped
+  bool buttonDown; // A drag keeps the hover state it started with until release
+  Napi::ThreadSafeFunction tsfn;
+};
+
+// The host whose thread is running; low-level hook callbacks carry no context pointer
+static thread_local HitTestHost* t_hitTest = nullptr;
+
+// Flip the overlay between click-through and hit-testable
+void SetOverlayTransparent(HWND overlay, bool transparent) {
+  LONG_PTR exStyle = GetWindowLongPtr(overlay, GWL_EXSTYLE);
+  LONG_PTR updated = transparent ? (exStyle | WS_EX_TRANSPARENT) : (exStyle & ~static_cast<LONG_PTR>(WS_EX_TRANSPARENT));
+  if (updated != exStyle) {
+    SetWindowLongPtr(overlay, GWL_EXSTYLE, updated);
+  }
+}
+
+bool CursorInRegions(HitTestHost* host, POINT cursor) {
+  if (host->regions.empty() || !IsWindowVisible(host->overlay)) {
+    return false;
+  }
+  POINT origin = { 0, 0 };
+  if (!ClientToScreen(host->overlay, &origin)) {
+    return false;
+  }
+
+  LONG x = cursor.x - origin.x;
+  LONG y = cursor.y - origin.y;
+  for (const RECT& region : host->regions) {
+    if (x >= region.left && x < region.right && y >= region.top && y < region.bottom) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Hit-test thread, message loop only: apply a hover change to the overlay style and
+// tell JS. The style change is sent to the overlay's (Electron UI) thread and waits
+// for it, which must never happen inside the mouse hook callback.
+void ApplyOverlayHovered(HitTestHost* host, bool hovered) {
+  if (hovered == host->applied) {
+    return;
+  }
+  host->applied = hovered;
+  if (!host->suspended) {
+    SetOverlayTransparent(host->overlay, !hovered);
+  }
+
+  // Fails only while the queue is closing (overlay being torn down)
+  host->tsfn.NonBlockingCall(reinterpret_cast<void*>(static_cast<uintptr_t>(hovered ? 1 : 0)),
+    [](Napi::Env env, Napi::Function jsCallback, void* data) {
+      if (env != nullptr && jsCallback != nullptr) {
+        jsCallback.Call({ Napi::String::New(env, data ? "hoverenter" : "hoverleave") });
+      }
+    });
+}
+
+// Hit-test thread: note a hover change and leave applying it to the message loop,
+// so the hook returns at once however busy the overlay's thread is
+void SetOverlayHovered(HitTestHost* host, bool hovered) {
+  if (hovered == host->hovered) {
+    return;
+  }
+  host->hovered = hovered;
+  PostThreadMessage(host->threadId, WM_HITTEST_HOVER, hovered ? TRUE : FALSE, 0);
+}
+
+// WH_MOUSE_LL callback (hit-test thread). Only records hover changes: the style
+// flip is applied right after from the message loop, ahead of most clicks.
+LRESULT CALLBACK HitTestMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
+  HitTestHost* host = t_hitTest;
+  if (nCode == HC_ACTION && host) {
+    const MSLLHOOKSTRUCT* mouse = reinterpret_cast<const MSLLHOOKSTRUCT*>(lParam);
+    switch (wParam) {
+      case WM_MOUSEMOVE:
+        if (!host->buttonDown) {
+          SetOverlayHovered(host, CursorInRegions(host, mouse->pt));
+        }
+        break;
+      case WM_LBUTTONDOWN:
+      case WM_RBUTTONDOWN:
+      case WM_MBUTTONDOWN:
+        host->buttonDown = true;
+        break;
+      case WM_LBUTTONUP:
+      case WM_RBUTTONUP:
+      case WM_MBUTTONUP:
+        host->buttonDown = false;
+        SetOverlayHovered(host, CursorInRegions(host, mouse->pt));
+        break;
+    }
+  }
+  return CallNextHookEx(NULL, nCode, wParam, lParam);
+}
+
+// Hit-test thread: owns the mouse hook (which needs a message loop on this thread)
+void HitTestThreadMain(HitTestHost* host, std::promise<DWORD> ready) {
+  MSG msg;
+  PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+  host->threadId = GetCurrentThreadId();
+  t_hitTest = host;
+
+  host->mouseHook = SetWindowsHookExW(WH_MOUSE_LL, HitTestMouseProc, GetModuleHandleW(NULL), 0);
+  if (!host->mouseHook) {
+    DWORD error = GetLastError();
+    ready.set_value(error ? error : ERROR_GEN_FAILURE);
+    return;
+  }
+  SetOverlayTransparent(host->overlay, true); // Click-through until the cursor reaches a region
+  ready.set_value(0);
+
+  while (GetMessage(&msg, NULL, 0, 0) > 0) {
+    if (msg.message == WM_HITTEST_STOP) {
+      break;
+    }
+    if (msg.message == WM_HITTEST_SET_REGIONS) {
+      std::vector<RECT>* regions = reinterpret_cast<std::vector<RECT>*>(msg.lParam);
+      host->regions.swap(*regions);
+      delete regions;
+      // A region may have appeared under (or vanished from under) a resting cursor
+      POINT cursor;
+      if (!host->buttonDown && GetCursorPos(&cursor)) {
+        SetOverlayHovered(host, CursorInRegions(host, cursor));
+      }
+      continue;
+    }
+    if (msg.message == WM_HITTEST_HOVER) {
+      ApplyOverlayHovered(host, msg.wParam != FALSE);
+      continue;
+    }
+    if (msg.message == WM_HITTEST_SUSPEND) {
+      // Interactive mode: the whole overlay takes input; afterwards, back to the hover state
+      host->suspended = msg.wParam != FALSE;
+      SetOverlayTransparent(host->overlay, !host->suspended && !host->applied);
+      continue;
+    }
+    TranslateMessage(&msg);
+    DispatchMessage(&msg);
+  }
+
+  UnhookWindowsHookEx(host->mouseHook);
+  t_hitTest = nullptr;
+  // Drop regions that were posted but never picked up
+  while (PeekMessage(&msg, NULL, WM_HITTEST_SET_REGIONS, WM_HITTEST_SET_REGIONS, PM_REMOVE)) {
+    delete reinterpret_cast<std::vector<RECT>*>(msg.lParam);
+  }
 }
 
-// isMinimized(hwnd: bigint): boolean
-Napi::Value IsMinimized(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 1 || !info[0].IsBigInt()) {
-    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
-    return env.Null();
+void JoinHitTestThread(HitTestHost* host) {
+  PostThreadMessage(host->threadId, WM_HITTEST_STOP, 0, 0);
+  host->thread.join();
+  host->addon->hitTest = nullptr;
+}
+
+// Stop the hit test (JS thread); its thread-safe function's finalizer frees the host.
+// The overlay keeps its current style: callers restore click-through with setIgnoreMouseEvents.
+void StopHitTestHost(Cs2WindowTracker* addon) {
+  HitTestHost* host = addon->hitTest;
+  if (!host) {
+    return;
   }
-  
-  bool lossless;
-  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
-  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
-  
-  return Napi::Boolean::New(env, IsIconic(hwnd) != FALSE);
+  JoinHitTestThread(host);
+  host->tsfn.Release();
 }
 
-// getDpiScaleForHwnd(hwnd: bigint): number
-Napi::Value GetDpiScaleForHwnd(const Napi::CallbackInfo& info) {
+// startOverlayHitTest(overlayHandle: Buffer | bigint, cb: (type: 'hoverenter' | 'hoverleave') => void): boolean
+// Takes over click-through toggling for the overlay window: it is made click-through
+// now and becomes hit-testable only while the cursor is over a setOverlayHitRegions()
+// rectangle. Replaces a previous hit test. Throws if the mouse hook could not be set.
+Napi::Value StartOverlayHitTest(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  
-  if (info.Length() < 1 || !info[0].IsBigInt()) {
-    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+
+  HWND overlay = NULL;
+  if (info.Length() < 2 || !ParseWindowHandle(info[0], &overlay) || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (Buffer | bigint overlayHandle, function callback)").ThrowAsJavaScriptException();
     return env.Null();
   }
-  
-  bool lossless;
-  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
-  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
-  
-  // GetDpiForWindow is available on Windows 10 1607+
-  typedef UINT (WINAPI *GetDpiForWindowProc)(HWND);
-  HMODULE user32 = GetModuleHandleW(L"user32.dll");
-  if (!user32) {
-    return Napi::Number::New(env, 1.0); // Fallback to 100% scale
+  if (!IsWindow(overlay)) {
+    return Napi::Boolean::New(env, false);
   }
-  
-  GetDpiForWindowProc GetDpiForWindow = 
-    reinterpret_cast<GetDpiForWindowProc>(GetProcAddress(user32, "GetDpiForWindow"));
-  
-  if (GetDpiForWindow) {
-    UINT dpi = GetDpiForWindow(hwnd);
-    return Napi::Number::New(env, dpi / 96.0);
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  StopHitTestHost(addon);
+
+  HitTestHost* host = new HitTestHost();
+  host->addon = addon;
+  host->threadId = 0;
+  host->overlay = overlay;
+  host->mouseHook = NULL;
+  host->hovered = false;
+  host->applied = false;
+  host->suspended = false;
+  host->buttonDown = false;
+  host->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2OverlayHitTest",
+    0,
+    1,
+    [](Napi::Env, HitTestHost* finalized) {
+      // Environment teardown without stopOverlayHitTest(): the thread is still running
+      if (finalized->addon->hitTest == finalized) {
+        JoinHitTestThread(finalized);
+      }
+      delete finalized;
+    },
+    host
+  );
+  addon->hitTest = host;
+
+  std::promise<DWORD> ready;
+  std::future<DWORD> readyResult = ready.get_future();
+  host->thread = std::thread(HitTestThreadMain, host, std::move(ready));
+  DWORD error = readyResult.get();
+  if (error) {
+    host->thread.join();
+    addon->hitTest = nullptr;
+    host->tsfn.Release();
+    std::string errorMsg = "Failed to set mouse hook. Error code: " + std::to_string(error);
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
   }
-  
-  // Fallback: use system DPI
-  HDC hdc = GetDC(hwnd);
-  int dpi = GetDeviceCaps(hdc, LOGPIXELSX);
-  ReleaseDC(hwnd, hdc);
-  return Napi::Number::New(env, dpi / 96.0);
+
+  return Napi::Boolean::New(env, true);
 }
 
-// getForegroundPid(): number
-Napi::Value GetForegroundPid(const Napi::CallbackInfo& info) {
+// setOverlayHitRegions(regions: Int32Array | number[]): boolean
+// Replaces the interactive rectangles, flattened as [x, y, width, height, ...] in
+// overlay client coordinates (physical pixels). Returns false without a hit test.
+Napi::Value SetOverlayHitRegions(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  
-  HWND fgHwnd = GetForegroundWindow();
-  if (!fgHwnd) {
+
+  bool isInt32Array = info.Length() >= 1 && info[0].IsTypedArray() &&
+    info[0].As<Napi::TypedArray>().TypedArrayType() == napi_int32_array;
+  if (!isInt32Array && !(info.Length() >= 1 && info[0].IsArray())) {
+    Napi::TypeError::New(env, "Expected Int32Array or number[] of [x, y, width, height] rects").ThrowAsJavaScriptException();
     return env.Null();
   }
-  
-  DWORD pid;
-  GetWindowThreadProcessId(fgHwnd, &pid);
-  
-  return Napi::Number::New(env, pid);
-}
 
-// forceActivateWindow(hwnd: bigint): boolean
-Napi::Value ForceActivateWindow(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 1 || !info[0].IsBigInt()) {
-    Napi::TypeError::New(env, "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+  std::vector<int32_t> values;
+  if (isInt32Array) {
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    const int32_t* data = reinterpret_cast<const int32_t*>(
+      static_cast<uint8_t*>(array.ArrayBuffer().Data()) + array.ByteOffset());
+    values.assign(data, data + array.ElementLength());
+  } else {
+    Napi::Array array = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value value = array.Get(i);
+      values.push_back(value.IsNumber() ? value.As<Napi::Number>().Int32Value() : 0);
+    }
+  }
+
+  HitTestHost* host = AddonFor(env)->hitTest;
+  if (!host) {
     return Napi::Boolean::New(env, false);
   }
-  
-  bool lossless;
-  int64_t hwndValue = info[0].As<Napi::BigInt>().Int64Value(&lossless);
-  HWND hwnd = reinterpret_cast<HWND>(hwndValue);
-  
-  if (!IsWindow(hwnd)) {
+
+  std::vector<RECT>* regions = new std::vector<RECT>();
+  for (size_t i = 0; i + 3 < values.size(); i += 4) {
+    if (values[i + 2] <= 0 || values[i + 3] <= 0) {
+      continue;
+    }
+    regions->push_back({ values[i], values[i + 1], values[i] + values[i + 2], values[i + 1] + values[i + 3] });
+  }
+  if (!PostThreadMessage(host->threadId, WM_HITTEST_SET_REGIONS, 0, reinterpret_cast<LPARAM>(regions))) {
+    delete regions;
     return Napi::Boolean::New(env, false);
   }
-  
-  // Get current foreground window and its thread
-  HWND fgHwnd = GetForegroundWindow();
-  DWORD fgThreadId = 0;
-  if (fgHwnd) {
-    fgThreadId = GetWindowThreadProcessId(fgHwnd, NULL);
+  return Napi::Boolean::New(env, true);
+}
+
+// setOverlayHitTestSuspended(suspended: boolean): void
+// While suspended (overlay in interactive mode) the whole overlay takes input and hover
+// notifications continue; resuming re-applies click-through from the hover state.
+// With a hit test running this is the only way to change the overlay's click-through:
+// setIgnoreMouseEvents() would fight the hit-test thread over WS_EX_TRANSPARENT.
+Napi::Value SetOverlayHitTestSuspended(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected boolean").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
-  
-  // Get target window's thread
-  DWORD targetThreadId = GetWindowThreadProcessId(hwnd, NULL);
-  DWORD currentThreadId = GetCurrentThreadId();
-  
-  // Attach to foreground thread if different from current thread
-  bool attached = false;
-  if (fgThreadId != 0 && fgThreadId != currentThreadId) {
-    attached = AttachThreadInput(currentThreadId, fgThreadId, TRUE) != FALSE;
+  HitTestHost* host = AddonFor(env)->hitTest;
+  if (host) {
+    PostThreadMessage(host->threadId, WM_HITTEST_SUSPEND, info[0].As<Napi::Boolean>().Value() ? TRUE : FALSE, 0);
   }
-  
-  // Restore window if minimized
-  if (IsIconic(hwnd)) {
-    ShowWindow(hwnd, SW_RESTORE);
+  return env.Undefined();
+}
+
+// stopOverlayHitTest(): void
+Napi::Value StopOverlayHitTest(const Napi::CallbackInfo& info) {
+  StopHitTestHost(AddonFor(info.Env()));
+  return info.Env().Undefined();
+}
+
+// Overlay hotkeys: a low-level keyboard hook on its own thread matches the
+// configured chords itself, so a toggle neither waits for the main event loop
+// nor depends on RegisterHotKey, which fullscreen CS2 can starve. With an overlay
+// window set, a toggle chord shows (click-through) or hides it right there; JS is
+// only told afterwards. Native follow keeps a hidden overlay in place, so showing
+// it needs no move.
+#define WM_HOTKEY_SET_CHORDS (WM_APP + 13) // lParam: std::vector<HotkeyChord>*, owned by the hotkey thread
+#define WM_HOTKEY_SET_OVERLAY (WM_APP + 14) // lParam: HWND (NULL: notify only)
+#define WM_HOTKEY_MATCHED (WM_APP + 15) // wParam: index into chords; acted on outside the hook callback
+#define WM_HOTKEY_STOP (WM_APP + 16)
+#define HOTKEY_MOD_CTRL 1
+#define HOTKEY_MOD_ALT 2
+#define HOTKEY_MOD_SHIFT 4
+#define HOTKEY_MOD_WIN 8
+
+struct HotkeyChord {
+  uint32_t id;
+  UINT vk;
+  UINT modifiers; // HOTKEY_MOD_*; must match exactly
+  bool toggleOverlay;
+};
+
+struct HotkeyHost {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  DWORD threadId;
+  HHOOK keyboardHook;
+  // Hotkey thread only
+  std::vector<HotkeyChord> chords;
+  HWND overlay;
+  UINT heldModifiers; // Left and right keys tracked separately (bit << 4 for right)
+  UINT swallowedVk; // Key of the last matched chord: its repeats and release are swallowed too
+  Napi::ThreadSafeFunction tsfn;
+};
+
+static thread_local HotkeyHost* t_hotkeys = nullptr;
+
+// HOTKEY_MOD_* of a modifier key (left side; right side is the same << 4), or 0
+UINT HotkeyModifierBit(DWORD vk) {
+  switch (vk) {
+    case VK_LCONTROL: return HOTKEY_MOD_CTRL;
+    case VK_RCONTROL: return HOTKEY_MOD_CTRL << 4;
+    case VK_LMENU: return HOTKEY_MOD_ALT;
+    case VK_RMENU: return HOTKEY_MOD_ALT << 4;
+    case VK_LSHIFT: return HOTKEY_MOD_SHIFT;
+    case VK_RSHIFT: return HOTKEY_MOD_SHIFT << 4;
+    case VK_LWIN: return HOTKEY_MOD_WIN;
+    case VK_RWIN: return HOTKEY_MOD_WIN << 4;
+    default: return 0;
   }
-  
-  // Bring window to foreground
-  SetForegroundWindow(hwnd);
-  BringWindowToTop(hwnd);
-  SetFocus(hwnd);
-  
-  // Detach if we attached
-  if (attached) {
-    AttachThreadInput(currentThreadId, fgThreadId, FALSE);
+}
+
+// Modifiers already held when the hook starts
+UINT ReadHeldModifiers() {
+  static const DWORD keys[] = { VK_LCONTROL, VK_RCONTROL, VK_LMENU, VK_RMENU, VK_LSHIFT, VK_RSHIFT, VK_LWIN, VK_RWIN };
+  UINT held = 0;
+  for (DWORD vk : keys) {
+    if (GetAsyncKeyState(static_cast<int>(vk)) & 0x8000) {
+      held |= HotkeyModifierBit(vk);
+    }
   }
-  
-  // Verify it worked
-  HWND newFgHwnd = GetForegroundWindow();
-  bool success = (newFgHwnd == hwnd);
-  
-  return Napi::Boolean::New(env, success);
+  return held;
 }
 
-// startWinEventHook(targetPid: number, cb: function): void
-Napi::Value StartWinEventHook(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  
-  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsFunction()) {
-    Napi::TypeError::New(env, "Expected (number pid, function callback)").ThrowAsJavaScriptException();
-    return env.Undefined();
+// WH_KEYBOARD_LL callback (hotkey thread). Only matches and posts: anything that
+// could wait on another thread runs in the message loop, clear of the hook timeout.
+LRESULT CALLBACK HotkeyKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+  HotkeyHost* host = t_hotkeys;
+  if (nCode == HC_ACTION && host) {
+    const KBDLLHOOKSTRUCT* key = reinterpret_cast<const KBDLLHOOKSTRUCT*>(lParam);
+    bool down = wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN;
+    UINT modifierBit = HotkeyModifierBit(key->vkCode);
+    if (modifierBit) {
+      host->heldModifiers = down ? (host->heldModifiers | modifierBit) : (host->heldModifiers & ~modifierBit);
+    } else if (key->vkCode == host->swallowedVk) {
+      if (!down) {
+        host->swallowedVk = 0;
+      }
+      return 1; // Auto-repeat or release of a matched chord
+    } else if (down) {
+      UINT modifiers = (host->heldModifiers | (host->heldModifiers >> 4)) & 0xF;
+      for (size_t i = 0; i < host->chords.size(); i++) {
+        const HotkeyChord& chord = host->chords[i];
+        if (chord.vk == key->vkCode && chord.modifiers == modifiers) {
+          host->swallowedVk = key->vkCode;
+          PostThreadMessage(host->threadId, WM_HOTKEY_MATCHED, static_cast<WPARAM>(i), 0);
+          return 1; // Like RegisterHotKey, the focused window (CS2) never sees the chord
+        }
+      }
+    }
   }
-  
-  // Stop existing hook if any
-  if (g_hookState) {
-    if (g_hookState->hookHandle1) {
-      UnhookWinEvent(g_hookState->hookHandle1);
+  return CallNextHookEx(NULL, nCode, wParam, lParam);
+}
+
+// Hotkey thread: act on a matched chord, then tell JS. `shown` is -1 when the overlay was not touched.
+void HandleHotkeyMatch(HotkeyHost* host, const HotkeyChord& chord) {
+  int shown = -1;
+  if (chord.toggleOverlay && host->overlay && IsWindow(host->overlay)) {
+    shown = IsWindowVisible(host->overlay) ? 0 : 1;
+    if (shown) {
+      SetOverlayTransparent(host->overlay, true); // A hit test, if running, takes it from here
+    }
+    // Async: the overlay's (Electron UI) thread may be busy
+    ShowWindowAsync(host->overlay, shown ? SW_SHOWNOACTIVATE : SW_HIDE);
+  }
+
+  uintptr_t packed = (static_cast<uintptr_t>(chord.id) << 2) | static_cast<uintptr_t>(shown + 1);
+  host->tsfn.NonBlockingCall(reinterpret_cast<void*>(packed), [](Napi::Env env, Napi::Function jsCallback, void* data) {
+    if (env != nullptr && jsCallback != nullptr) {
+      uintptr_t value = reinterpret_cast<uintptr_t>(data);
+      Napi::Object event = Napi::Object::New(env);
+      event.Set("id", Napi::Number::New(env, static_cast<double>(value >> 2)));
+      if ((value & 3) != 0) {
+        event.Set("shown", Napi::Boolean::New(env, (value & 3) == 2));
+      }
+      jsCallback.Call({ event });
+    }
+  });
+}
+
+// Hotkey thread: owns the keyboard hook (which needs a message loop on this thread)
+void HotkeyThreadMain(HotkeyHost* host, std::promise<DWORD> ready) {
+  MSG msg;
+  PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+  host->threadId = GetCurrentThreadId();
+  t_hotkeys = host;
+
+  host->heldModifiers = ReadHeldModifiers();
+  host->keyboardHook = SetWindowsHookExW(WH_KEYBOARD_LL, HotkeyKeyboardProc, GetModuleHandleW(NULL), 0);
+  if (!host->keyboardHook) {
+    DWORD error = GetLastError();
+    ready.set_value(error ? error : ERROR_GEN_FAILURE);
+    return;
+  }
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL); // Toggles land even when the CPU is busy
+  ready.set_value(0);
+
+  while (GetMessage(&msg, NULL, 0, 0) > 0) {
+    if (msg.message == WM_HOTKEY_STOP) {
+      break;
     }
-    if (g_hookState->hookHandle2) {
-      UnhookWinEvent(g_hookState->hookHandle2);
+    if (msg.message == WM_HOTKEY_SET_CHORDS) {
+      std::vector<HotkeyChord>* chords = reinterpret_cast<std::vector<HotkeyChord>*>(msg.lParam);
+      host->chords.swap(*chords);
+      delete chords;
+      continue;
     }
-    if (g_hookState->hookHandle3) {
-      UnhookWinEvent(g_hookState->hookHandle3);
+    if (msg.message == WM_HOTKEY_SET_OVERLAY) {
+      host->overlay = reinterpret_cast<HWND>(msg.lParam);
+      continue;
     }
-    if (g_hookState->hookHandle4) {
-      UnhookWinEvent(g_hookState->hookHandle4);
+    if (msg.message == WM_HOTKEY_MATCHED) {
+      // Chords replaced since the match leave a stale index behind
+      if (msg.wParam < host->chords.size()) {
+        HandleHotkeyMatch(host, host->chords[msg.wParam]);
+      }
+      continue;
     }
-    g_hookState->jsCallback.Reset();
-    delete g_hookState;
-    g_hookState = nullptr;
+    TranslateMessage(&msg);
+    DispatchMessage(&msg);
   }
-  
-  // Create new hook state
-  g_hookState = new HookState();
-  g_hookState->targetPid = info[0].As<Napi::Number>().Uint32Value();
-  g_hookState->jsCallback = Napi::Persistent(info[1].As<Napi::Function>());
-  g_hookState->hookHandle1 = NULL;
-  g_hookState->hookHandle2 = NULL;
-  g_hookState->hookHandle3 = NULL;
-  g_hookState->hookHandle4 = NULL;
-  
-  // Set up WinEvent hooks for all events we care about
-  // Hook 1: Location changes and destroy
-  g_hookState->hookHandle1 = SetWinEventHook(
-    EVENT_OBJECT_LOCATIONCHANGE,
-    EVENT_OBJECT_DESTROY,
-    NULL,
-    WinEventProc,
-    0,
-    0,
-    WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS
-  );
-  
-  // Hook 2: Move/resize events
-  g_hookState->hookHandle2 = SetWinEventHook(
-    EVENT_SYSTEM_MOVESIZESTART,
-    EVENT_SYSTEM_MOVESIZEEND,
-    NULL,
-    WinEventProc,
-    0,
-    0,
-    WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS
-  );
-  
-  // Hook 3: Minimize events
-  g_hookState->hookHandle3 = SetWinEventHook(
-    EVENT_SYSTEM_MINIMIZESTART,
-    EVENT_SYSTEM_MINIMIZEEND,
-    NULL,
-    WinEventProc,
-    0,
-    0,
-    WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS
-  );
 
-  // Hook 4: Foreground events (focus)
-  g_hookState->hookHandle4 = SetWinEventHook(
-    EVENT_SYSTEM_FOREGROUND,
-    EVENT_SYSTEM_FOREGROUND,
-    NULL,
-    WinEventProc,
-    0,
+  UnhookWindowsHookEx(host->keyboardHook);
+  t_hotkeys = nullptr;
+  // Drop chords that were posted but never picked up
+  while (PeekMessage(&msg, NULL, WM_HOTKEY_SET_CHORDS, WM_HOTKEY_SET_CHORDS, PM_REMOVE)) {
+    delete reinterpret_cast<std::vector<HotkeyChord>*>(msg.lParam);
+  }
+}
+
+void JoinHotkeyThread(HotkeyHost* host) {
+  PostThreadMessage(host->threadId, WM_HOTKEY_STOP, 0, 0);
+  host->thread.join();
+  host->addon->hotkeys = nullptr;
+}
+
+// Stop listening (JS thread); the thread-safe function's finalizer frees the host
+void StopHotkeyHost(Cs2WindowTracker* addon) {
+  HotkeyHost* host = addon->hotkeys;
+  if (!host) {
+    return;
+  }
+  JoinHotkeyThread(host);
+  host->tsfn.Release();
+}
+
+// [{ id, key, ctrl?, alt?, shift?, win?, toggleOverlay? }] -> chords; key is a Windows virtual-key code
+bool ParseHotkeyChords(Napi::Value value, std::vector<HotkeyChord>* chords) {
+  if (!value.IsArray()) {
+    return false;
+  }
+  Napi::Array array = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value entry = array.Get(i);
+    if (!entry.IsObject()) {
+      return false;
+    }
+    Napi::Object object = entry.As<Napi::Object>();
+    Napi::Value id = object.Get("id");
+    Napi::Value key = object.Get("key");
+    if (!id.IsNumber() || !key.IsNumber()) {
+      return false;
+    }
+    auto flag = [&object](const char* name) {
+      Napi::Value flagValue = object.Get(name);
+      return flagValue.IsBoolean() && flagValue.As<Napi::Boolean>().Value();
+    };
+    HotkeyChord chord;
+    chord.id = id.As<Napi::Number>().Uint32Value();
+    chord.vk = key.As<Napi::Number>().Uint32Value() & 0xFF;
+    chord.modifiers = (flag("ctrl") ? HOTKEY_MOD_CTRL : 0) | (flag("alt") ? HOTKEY_MOD_ALT : 0) |
+      (flag("shift") ? HOTKEY_MOD_SHIFT : 0) | (flag("win") ? HOTKEY_MOD_WIN : 0);
+    chord.toggleOverlay = flag("toggleOverlay");
+    chords->push_back(chord);
+  }
+  return true;
+}
+
+// startOverlayHotkeys(chords: Array<{ id, key, ctrl?, alt?, shift?, win?, toggleOverlay? }>,
+//   cb: (event: { id, shown? }) => void): boolean
+// Listens for the chords system-wide (also while fullscreen CS2 has focus) and
+// swallows them. A toggleOverlay chord shows/hides the setOverlayHotkeyWindow()
+// window natively and reports the result as `shown`; without a window only the
+// id is reported. Replaces previous chords. Throws if the keyboard hook could not be set.
+Napi::Value StartOverlayHotkeys(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  std::vector<HotkeyChord>* chords = new std::vector<HotkeyChord>();
+  if (info.Length() < 2 || !ParseHotkeyChords(info[0], chords) || !info[1].IsFunction()) {
+    delete chords;
+    Napi::TypeError::New(env, "Expected (chords array, function callback)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  StopHotkeyHost(addon);
+
+  HotkeyHost* host = new HotkeyHost();
+  host->addon = addon;
+  host->threadId = 0;
+  host->keyboardHook = NULL;
+  host->chords.swap(*chords);
+  delete chords;
+  host->overlay = addon->hotkeyOverlay;
+  host->heldModifiers = 0;
+  host->swallowedVk = 0;
+  host->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2OverlayHotkeys",
     0,
-    WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS
+    1,
+    [](Napi::Env, HotkeyHost* finalized) {
+      // Environment teardown without stopOverlayHotkeys(): the thread is still running
+      if (finalized->addon->hotkeys == finalized) {
+        JoinHotkeyThread(finalized);
+      }
+      delete finalized;
+    },
+    host
   );
+  addon->hotkeys = host;
 
-  // Check if at least one hook was set successfully
-  // Note: SetWinEventHook returns NULL on failure, but GetLastError() might have more info
-  if (!g_hookState->hookHandle1 && !g_hookState->hookHandle2 && !g_hookState->hookHandle3 && !g_hookState->hookHandle4) {
-    DWORD error = GetLastError();
-    g_hookState->jsCallback.Reset();
-    delete g_hookState;
-    g_hookState = nullptr;
-    std::string errorMsg = "Failed to set WinEvent hooks. Error code: " + std::to_string(error);
+  std::promise<DWORD> ready;
+  std::future<DWORD> readyResult = ready.get_future();
+  host->thread = std::thread(HotkeyThreadMain, host, std::move(ready));
+  DWORD error = readyResult.get();
+  if (error) {
+    host->thread.join();
+    addon->hotkeys = nullptr;
+    host->tsfn.Release();
+    std::string errorMsg = "Failed to set keyboard hook. Error code: " + std::to_string(error);
     Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
-    return env.Undefined();
+    return env.Null();
   }
-  
-  // Log which hooks were successfully set
-  // (We can't easily log from C++, but at least we know it succeeded if we get here)
-  
-  return env.Undefined();
+
+  return Napi::Boolean::New(env, true);
 }
 
-// stopWinEventHook(): void
-Napi::Value StopWinEventHook(const Napi::CallbackInfo& info) {
+// setOverlayHotkeyWindow(overlayHandle: Buffer | bigint | null): boolean
+// The window toggleOverlay chords show and hide, now and for later
+// startOverlayHotkeys() calls; null makes them notify only.
+Napi::Value SetOverlayHotkeyWindow(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  
-  if (g_hookState) {
-    if (g_hookState->hookHandle1) {
-      UnhookWinEvent(g_hookState->hookHandle1);
-      g_hookState->hookHandle1 = NULL;
-    }
-    if (g_hookState->hookHandle2) {
-      UnhookWinEvent(g_hookState->hookHandle2);
-      g_hookState->hookHandle2 = NULL;
-    }
-    if (g_hookState->hookHandle3) {
-      UnhookWinEvent(g_hookState->hookHandle3);
-      g_hookState->hookHandle3 = NULL;
-    }
-    if (g_hookState->hookHandle4) {
-      UnhookWinEvent(g_hookState->hookHandle4);
-      g_hookState->hookHandle4 = NULL;
+
+  HWND overlay = NULL;
+  bool parsed = info.Length() >= 1 && ParseWindowHandle(info[0], &overlay);
+  if (!parsed && (info.Length() < 1 || !(info[0].IsNull() || info[0].IsUndefined()))) {
+    Napi::TypeError::New(env, "Expected Buffer or bigint overlay handle, or null").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Cs2WindowTracker* addon = AddonFor(env);
+  addon->hotkeyOverlay = overlay;
+  if (addon->hotkeys) {
+    PostThreadMessage(addon->hotkeys->threadId, WM_HOTKEY_SET_OVERLAY, 0, reinterpret_cast<LPARAM>(overlay));
+  }
+  return Napi::Boolean::New(env, true);
+}
+
+// stopOverlayHotkeys(): void
+Napi::Value StopOverlayHotkeys(const Napi::CallbackInfo& info) {
+  StopHotkeyHost(AddonFor(info.Env()));
+  return info.Env().Undefined();
+}
+
+// drainEvents(buffer: BigInt64Array | Uint32Array, id?: number): number
+// Copies pending batch-mode records into the caller's buffer without allocating.
+// Returns the number of records written; call again if it filled the buffer.
+Napi::Value DrainEvents(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Napi::TypedArray array;
+  if (!ReadDrainBuffer(info, &array)) {
+    return env.Null();
+  }
+
+  // Optional second argument: a trackWindow() id (default: the startWinEventHook target)
+  Cs2WindowTracker* addon = AddonFor(env);
+  HookTarget* target = addon->primaryTarget;
+  if (info.Length() >= 2 && info[1].IsNumber()) {
+    auto found = addon->targets.find(info[1].As<Napi::Number>().Uint32Value());
+    target = found == addon->targets.end() ? nullptr : found->second;
+  }
+  if (!target || !target->ring) {
+    return Napi::Number::New(env, 0);
+  }
+
+  size_t count = DrainEventRing(target->ring, array, addon->hookCounters);
+  return Napi::Number::New(env, static_cast<double>(count));
+}
+
+// getHookStats(): { raw, filtered, delivered, coalesced, dropped, maxQueueDepth, byType, latency }
+// byType is keyed by event type; latency holds { delivery, bounds } histograms where
+// buckets[i] counts latencies below 2^(i+1) us
+Napi::Value GetHookStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  uint64_t dropped = 0;
+  for (const auto& entry : addon->targets) {
+    dropped += entry.second->ring ? entry.second->ring->dropped.load(std::memory_order_relaxed) : 0;
+  }
+  return HookCountersToObject(env, addon->hookCounters, dropped);
+}
+
+// resetHookStats(): void
+// Zeroes all counters and histograms (also done when the first hook target starts)
+Napi::Value ResetHookStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  ResetHookCounters(addon->hookCounters);
+  for (const auto& entry : addon->targets) {
+    if (entry.second->ring) {
+      entry.second->ring->dropped.store(0, std::memory_order_relaxed);
     }
-    g_hookState->jsCallback.Reset();
-    delete g_hookState;
-    g_hookState = nullptr;
   }
-  
+
   return env.Undefined();
 }
 
-// Module initialization
-Napi::Object Init(Napi::Env env, Napi::Object exports) {
+// getStateBlock(): ArrayBuffer
+// The same buffer is returned on every call; view it as an Int32Array
+Napi::Value GetStateBlock(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (addon->stateBlockRef.IsEmpty()) {
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, STATE_SLOT_COUNT * sizeof(LONG));
+    memset(buffer.Data(), 0, buffer.ByteLength());
+    addon->stateBlockRef = Napi::Persistent(buffer);
+    addon->stateBlock = static_cast<volatile LONG*>(buffer.Data());
+  }
+
+  return addon->stateBlockRef.Value();
+}
+
+// Module initialization, once per environment
+Cs2WindowTracker::Cs2WindowTracker(Napi::Env env, Napi::Object exports)
+  : hookHost(nullptr), nextTargetId(1), primaryTarget(nullptr), hookCounters(), stateBlock(nullptr),
+    published(), hitTest(nullptr), hotkeys(nullptr), hotkeyOverlay(NULL), followPacer(nullptr), nextCaptureId(1), nextFrameStreamId(1), demoWatch(nullptr),
+    netcon(nullptr), nextNdjsonReaderId(1), governor(new ResourceGovernor()), sampler(nullptr),
+    matchDbs(CreateMatchDbPool()) {
+  governor->job = NULL;
+  governor->gamePid = 0;
+  governor->overlayPid = 0;
+  governor->cpuRatePercent = GOVERNOR_DEFAULT_CPU_RATE_PERCENT;
+  governor->throttled = false;
+  governor->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+  // Process-wide and idempotent, so every environment may do it
+  LARGE_INTEGER frequency;
+  if (QueryPerformanceFrequency(&frequency) && frequency.QuadPart > 0) {
+    g_qpcFrequency = frequency.QuadPart;
+  }
+  ResolveDpiApis();
+
   exports.Set(Napi::String::New(env, "findWindowByPid"),
               Napi::Function::New(env, FindWindowByPid));
   exports.Set(Napi::String::New(env, "findProcessIdByName"),
               Napi::Function::New(env, FindProcessIdByName));
+  exports.Set(Napi::String::New(env, "findProcessIdByNameAsync"),
+              Napi::Function::New(env, FindProcessIdByNameAsync));
+  exports.Set(Napi::String::New(env, "findWindowByPidAsync"),
+              Napi::Function::New(env, FindWindowByPidAsync));
+  exports.Set(Napi::String::New(env, "waitForWindow"),
+              Napi::Function::New(env, WaitForWindow));
   exports.Set(Napi::String::New(env, "getClientBoundsOnScreen"),
               Napi::Function::New(env, GetClientBoundsOnScreen));
   exports.Set(Napi::String::New(env, "isMinimized"),
@@ -545,12 +2889,113 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
               Napi::Function::New(env, GetForegroundPid));
   exports.Set(Napi::String::New(env, "forceActivateWindow"),
               Napi::Function::New(env, ForceActivateWindow));
+  exports.Set(Napi::String::New(env, "setWindowExcludedFromCapture"),
+              Napi::Function::New(env, SetWindowExcludedFromCapture));
   exports.Set(Napi::String::New(env, "startWinEventHook"),
               Napi::Function::New(env, StartWinEventHook));
+  exports.Set(Napi::String::New(env, "setOverlayFollow"),
+              Napi::Function::New(env, SetOverlayFollow));
+  exports.Set(Napi::String::New(env, "startOverlayHitTest"),
+              Napi::Function::New(env, StartOverlayHitTest));
+  exports.Set(Napi::String::New(env, "setOverlayHitRegions"),
+              Napi::Function::New(env, SetOverlayHitRegions));
+  exports.Set(Napi::String::New(env, "setOverlayHitTestSuspended"),
+              Napi::Function::New(env, SetOverlayHitTestSuspended));
+  exports.Set(Napi::String::New(env, "stopOverlayHitTest"),
+              Napi::Function::New(env, StopOverlayHitTest));
+  exports.Set(Napi::String::New(env, "startOverlayHotkeys"),
+              Napi::Function::New(env, StartOverlayHotkeys));
+  exports.Set(Napi::String::New(env, "setOverlayHotkeyWindow"),
+              Napi::Function::New(env, SetOverlayHotkeyWindow));
+  exports.Set(Napi::String::New(env, "stopOverlayHotkeys"),
+              Napi::Function::New(env, StopOverlayHotkeys));
+  exports.Set(Napi::String::New(env, "startCapture"),
+              Napi::Function::New(env, StartCapture));
+  exports.Set(Napi::String::New(env, "stopCapture"),
+              Napi::Function::New(env, StopCapture));
+  exports.Set(Napi::String::New(env, "startFrameStream"),
+              Napi::Function::New(env, StartFrameStream));
+  exports.Set(Napi::String::New(env, "finishFrameStream"),
+              Napi::Function::New(env, FinishFrameStream));
+  exports.Set(Napi::String::New(env, "stopFrameStream"),
+              Napi::Function::New(env, StopFrameStream));
+  exports.Set(Napi::String::New(env, "computeWaveformPeaks"),
+              Napi::Function::New(env, ComputeWaveformPeaks));
+  exports.Set(Napi::String::New(env, "scanDemos"),
+              Napi::Function::New(env, ScanDemos));
+  exports.Set(Napi::String::New(env, "extractVoice"),
+              Napi::Function::New(env, ExtractVoice));
+  exports.Set(Napi::String::New(env, "startDemoWatcher"),
+              Napi::Function::New(env, StartDemoWatcher));
+  exports.Set(Napi::String::New(env, "stopDemoWatcher"),
+              Napi::Function::New(env, StopDemoWatcher));
+  exports.Set(Napi::String::New(env, "startNetconClient"),
+              Napi::Function::New(env, StartNetconClient));
+  exports.Set(Napi::String::New(env, "netconSend"),
+              Napi::Function::New(env, NetconSend));
+  exports.Set(Napi::String::New(env, "setNetconTickInterval"),
+              Napi::Function::New(env, SetNetconTickInterval));
+  exports.Set(Napi::String::New(env, "isNetconConnected"),
+              Napi::Function::New(env, IsNetconConnected));
+  exports.Set(Napi::String::New(env, "stopNetconClient"),
+              Napi::Function::New(env, StopNetconClient));
+  exports.Set(Napi::String::New(env, "setResourceGovernor"),
+              Napi::Function::New(env, SetResourceGovernor));
+  exports.Set(Napi::String::New(env, "governProcess"),
+              Napi::Function::New(env, GovernProcess));
+  exports.Set(Napi::String::New(env, "addSampledProcess"),
+              Napi::Function::New(env, AddSampledProcess));
+  exports.Set(Napi::String::New(env, "removeSampledProcess"),
+              Napi::Function::New(env, RemoveSampledProcess));
+  exports.Set(Napi::String::New(env, "drainResourceSamples"),
+              Napi::Function::New(env, DrainResourceSamples));
+  exports.Set(Napi::String::New(env, "startNdjsonReader"),
+              Napi::Function::New(env, StartNdjsonReader));
+  exports.Set(Napi::String::New(env, "stopNdjsonReader"),
+              Napi::Function::New(env, StopNdjsonReader));
+  exports.Set(Napi::String::New(env, "queryMatchDb"),
+              Napi::Function::New(env, QueryMatchDb));
+  exports.Set(Napi::String::New(env, "queryMatchDbs"),
+              Napi::Function::New(env, QueryMatchDbs));
+  exports.Set(Napi::String::New(env, "closeMatchDbs"),
+              Napi::Function::New(env, CloseMatchDbs));
+  exports.Set(Napi::String::New(env, "holdMatchDbs"),
+              Napi::Function::New(env, HoldMatchDbs));
+  exports.Set(Napi::String::New(env, "releaseMatchDbs"),
+              Napi::Function::New(env, ReleaseMatchDbs));
+  exports.Set(Napi::String::New(env, "trackWindow"),
+              Napi::Function::New(env, TrackWindow));
+  exports.Set(Napi::String::New(env, "untrack"),
+              Napi::Function::New(env, Untrack));
   exports.Set(Napi::String::New(env, "stopWinEventHook"),
               Napi::Function::New(env, StopWinEventHook));
-  
-  return exports;
+  exports.Set(Napi::String::New(env, "getStateBlock"),
+              Napi::Function::New(env, GetStateBlock));
+  exports.Set(Napi::String::New(env, "drainEvents"),
+              Napi::Function::New(env, DrainEvents));
+  exports.Set(Napi::String::New(env, "getHookStats"),
+              Napi::Function::New(env, GetHookStats));
+  exports.Set(Napi::String::New(env, "resetHookStats"),
+              Napi::Function::New(env, ResetHookStats));
+}
+
+// Environment exit. Thread-safe function finalizers have already stopped every
+// target, hit test, capture, watcher, netcon client, NDJSON reader and
+// waitForWindow() waiter (each holds the environment open until then), so no
+// thread still points at this instance.
+Cs2WindowTracker::~Cs2WindowTracker() {
+  if (hookHost) {
+    StopHookHost(this);
+  }
+  if (followPacer) {
+    StopFollowPacer(this);
+  }
+  CloseResourceGovernor(governor);
+  delete governor;
+  if (sampler) {
+    StopResourceSampler(this);
+  }
+  CloseMatchDbConnections(matchDbs.get(), nullptr, false);
 }
 
-NODE_API_MODULE(cs2_window_tracker, Init)
+NODE_API_ADDON(Cs2WindowTracker)
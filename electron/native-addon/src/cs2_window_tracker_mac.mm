@@ -0,0 +1,1339 @@
+// macOS backend for the window tracker: the same exports, events and state
+// block as cs2_window_tracker.cpp, built on Accessibility (AXObserver)
+// notifications for the target window, NSWorkspace activation notifications
+// for the foreground app and a dispatch process source for exit. Windows are
+// identified by their CGWindowID, which is what "hwnd" carries on this platform.
+//
+// Coordinates are global display points (top-left origin), which is what
+// Electron's BrowserWindow bounds use, so the reported DPI is always 96 and
+// JS applies no scaling.
+#include <napi.h>
+#import <AppKit/AppKit.h>
+#import <ApplicationServices/ApplicationServices.h>
+#include <dispatch/dispatch.h>
+#include <libproc.h>
+#include <signal.h>
+#include <cerrno>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include <thread>
+#include <future>
+#include <atomic>
+#include "hook_dispatch.h"
+
+// Not in the public headers, but stable since 10.6 and the only way to map an
+// AX window to its CGWindowID
+extern "C" AXError _AXUIElementGetWindow(AXUIElementRef element, CGWindowID* out);
+
+#define MAC_DEFAULT_DPI 96 // Bounds are already in points
+#define BOUNDS_POLL_INTERVAL_S 0.05 // Without Accessibility access the target window is polled instead
+#define WINDOW_WAIT_RECHECK_S 0.25 // waitForWindow: re-check while the window has not shown up
+
+// Milliseconds since boot, the macOS stand-in for GetTickCount() event timestamps
+uint32_t TickCountMs() {
+  return static_cast<uint32_t>(clock_gettime_nsec_np(CLOCK_UPTIME_RAW) / 1000000);
+}
+
+uint64_t NowUs() {
+  return clock_gettime_nsec_np(CLOCK_UPTIME_RAW) / 1000;
+}
+
+HookClockTicks HookClockNow() {
+  return NowUs();
+}
+
+uint64_t HookElapsedUs(uint64_t originUs, uint64_t nowUs) {
+  return nowUs > originUs ? nowUs - originUs : 0;
+}
+
+bool EqualIntRect(const IntRect& a, const IntRect& b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+IntRect ToIntRect(CGRect rect) {
+  return {
+    static_cast<int32_t>(lround(rect.origin.x)),
+    static_cast<int32_t>(lround(rect.origin.y)),
+    static_cast<int32_t>(lround(rect.size.width)),
+    static_cast<int32_t>(lround(rect.size.height)),
+  };
+}
+
+class Cs2WindowTracker;
+
+// The startWinEventHook() subscription and the hook thread serving it. The
+// thread runs its own CFRunLoop: AX notifications are delivered there, and
+// workspace/exit notifications are forwarded to it, so all the state below
+// the tsfn is touched by the hook thread only.
+struct HookHost {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  CFRunLoopRef runLoop;
+  CFRunLoopSourceRef keepAlive; // Keeps the run loop waiting when no AX source is attached
+  pid_t pid;
+  CGWindowID windowId; // Optional: when set, only this window's events match and moves are coalesced
+  bool batchDelivery; // true: events go to `ring`, callback is only a "pending" signal
+  EventRing* ring; // Batch mode only
+  std::atomic<bool> wakeupPending; // Batch mode: a pending signal has been queued but not run
+  Napi::ThreadSafeFunction tsfn; // Its finalizer deletes the host once queued calls have run
+  AXUIElementRef appElement;
+  AXUIElementRef windowElement; // NULL until the target window is resolved
+  AXObserverRef observer; // NULL without Accessibility access
+  CFRunLoopTimerRef pollTimer; // Bounds polling fallback when there is no observer
+  id activationObserver; // NSWorkspace activation observer (retained)
+  dispatch_source_t exitSource; // NULL if the process could not be watched
+  IntRect lastBounds; // Last bounds emitted via boundschanged
+  bool hasLastBounds;
+  CGDirectDisplayID display; // Display last seen for windowId (0 until recorded)
+  // Focus state machine, see WinEventHookOptions.overlayPid
+  bool trackFocus;
+  pid_t overlayPid;
+  HookEventCode focusState;
+  bool minimized;
+};
+
+struct WindowStateFields {
+  bool valid;
+  IntRect bounds;
+  bool minimized;
+  uint32_t foregroundPid;
+};
+
+// Per-environment addon state, as in the Windows backend
+class Cs2WindowTracker : public Napi::Addon<Cs2WindowTracker> {
+public:
+  Cs2WindowTracker(Napi::Env env, Napi::Object exports);
+  ~Cs2WindowTracker();
+
+  HookHost* hookHost; // startWinEventHook's subscription (JS thread only)
+  HookCounters hookCounters;
+  volatile int32_t* stateBlock;
+  Napi::Reference<Napi::ArrayBuffer> stateBlockRef;
+  WindowStateFields published; // Last values written to the state block (hook thread)
+};
+
+Cs2WindowTracker* AddonFor(Napi::Env env) {
+  return env.GetInstanceData<Cs2WindowTracker>();
+}
+
+void WriteStateBlock(Cs2WindowTracker* addon) {
+  const WindowStateFields& fields = addon->published;
+  volatile int32_t* slots = addon->stateBlock;
+  if (!slots) {
+    return;
+  }
+
+  int32_t sequence = slots[STATE_SLOT_SEQUENCE];
+  __atomic_store_n(&slots[STATE_SLOT_SEQUENCE], sequence + 1, __ATOMIC_SEQ_CST); // Odd: write in progress
+  slots[STATE_SLOT_VALID] = fields.valid ? 1 : 0;
+  slots[STATE_SLOT_X] = fields.bounds.x;
+  slots[STATE_SLOT_Y] = fields.bounds.y;
+  slots[STATE_SLOT_WIDTH] = fields.bounds.width;
+  slots[STATE_SLOT_HEIGHT] = fields.bounds.height;
+  slots[STATE_SLOT_MINIMIZED] = fields.minimized ? 1 : 0;
+  slots[STATE_SLOT_FOREGROUND_PID] = static_cast<int32_t>(fields.foregroundPid);
+  slots[STATE_SLOT_DPI] = MAC_DEFAULT_DPI;
+  slots[STATE_SLOT_CLOAKED] = 0;
+  __atomic_store_n(&slots[STATE_SLOT_SEQUENCE], sequence + 2, __ATOMIC_SEQ_CST); // Even: stable
+}
+
+// Window lookups
+
+// Info dictionary of one window, or NULL if it no longer exists (caller releases)
+CFDictionaryRef CopyWindowInfo(CGWindowID windowId) {
+  CFArrayRef list = CGWindowListCopyWindowInfo(kCGWindowListOptionIncludingWindow, windowId);
+  if (!list) {
+    return NULL;
+  }
+  CFDictionaryRef info = NULL;
+  if (CFArrayGetCount(list) > 0) {
+    info = static_cast<CFDictionaryRef>(CFRetain(CFArrayGetValueAtIndex(list, 0)));
+  }
+  CFRelease(list);
+  return info;
+}
+
+int64_t WindowInfoNumber(CFDictionaryRef info, CFStringRef key) {
+  CFNumberRef number = static_cast<CFNumberRef>(CFDictionaryGetValue(info, key));
+  int64_t value = 0;
+  if (number) {
+    CFNumberGetValue(number, kCFNumberSInt64Type, &value);
+  }
+  return value;
+}
+
+bool WindowInfoBounds(CFDictionaryRef info, IntRect* out) {
+  CFDictionaryRef boundsDict = static_cast<CFDictionaryRef>(CFDictionaryGetValue(info, kCGWindowBounds));
+  CGRect rect;
+  if (!boundsDict || !CGRectMakeWithDictionaryRepresentation(boundsDict, &rect)) {
+    return false;
+  }
+  *out = ToIntRect(rect);
+  return true;
+}
+
+std::string WindowInfoTitle(CFDictionaryRef info) {
+  // Titles are only visible with Screen Recording access; empty otherwise
+  CFStringRef title = static_cast<CFStringRef>(CFDictionaryGetValue(info, kCGWindowName));
+  if (!title) {
+    return std::string();
+  }
+  char buffer[512];
+  if (!CFStringGetCString(title, buffer, sizeof(buffer), kCFStringEncodingUTF8)) {
+    return std::string();
+  }
+  return buffer;
+}
+
+// Window frame on screen. macOS reports no separate client rect across
+// processes; CS2 runs borderless or fullscreen, where the two are the same.
+bool GetWindowBoundsOnScreen(CGWindowID windowId, IntRect* out) {
+  CFDictionaryRef info = CopyWindowInfo(windowId);
+  if (!info) {
+    return false;
+  }
+  bool ok = WindowInfoBounds(info, out);
+  CFRelease(info);
+  return ok;
+}
+
+pid_t WindowOwnerPid(CGWindowID windowId) {
+  CFDictionaryRef info = CopyWindowInfo(windowId);
+  if (!info) {
+    return 0;
+  }
+  pid_t pid = static_cast<pid_t>(WindowInfoNumber(info, kCGWindowOwnerPID));
+  CFRelease(info);
+  return pid;
+}
+
+// A window that passed the filters (reported by findWindowByPidAsync)
+struct WindowCandidate {
+  CGWindowID windowId;
+  int64_t area;
+  std::string title;
+};
+
+// Every normal-layer window of a process, largest first. One window list
+// copy per call; nothing calls this per frame.
+std::vector<WindowCandidate> FindWindowsForPid(pid_t pid) {
+  std::vector<WindowCandidate> candidates;
+  CFArrayRef list = CGWindowListCopyWindowInfo(kCGWindowListOptionAll | kCGWindowListExcludeDesktopElements, kCGNullWindowID);
+  if (!list) {
+    return candidates;
+  }
+
+  CFIndex count = CFArrayGetCount(list);
+  for (CFIndex i = 0; i < count; i++) {
+    CFDictionaryRef info = static_cast<CFDictionaryRef>(CFArrayGetValueAtIndex(list, i));
+    // Layer 0 holds document windows; menus, panels and the like sit above it
+    if (WindowInfoNumber(info, kCGWindowOwnerPID) != pid || WindowInfoNumber(info, kCGWindowLayer) != 0) {
+      continue;
+    }
+    IntRect bounds;
+    if (!WindowInfoBounds(info, &bounds) || bounds.width <= 0 || bounds.height <= 0) {
+      continue;
+    }
+    candidates.push_back({
+      static_cast<CGWindowID>(WindowInfoNumber(info, kCGWindowNumber)),
+      static_cast<int64_t>(bounds.width) * bounds.height,
+      WindowInfoTitle(info),
+    });
+  }
+  CFRelease(list);
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+    [](const WindowCandidate& a, const WindowCandidate& b) { return a.area > b.area; });
+  return candidates;
+}
+
+CGWindowID FindBestWindowForPid(pid_t pid) {
+  std::vector<WindowCandidate> candidates = FindWindowsForPid(pid);
+  return candidates.empty() ? 0 : candidates[0].windowId;
+}
+
+std::string ToLower(const std::string& value) {
+  std::string lower = value;
+  for (char& c : lower) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return lower;
+}
+
+// Does the process' executable file name (without directory) equal lowerName?
+bool ProcessExeNameMatches(pid_t pid, const std::string& lowerName) {
+  char path[PROC_PIDPATHINFO_MAXSIZE];
+  if (proc_pidpath(pid, path, sizeof(path)) <= 0) {
+    return false;
+  }
+  const char* fileName = strrchr(path, '/');
+  return ToLower(fileName ? fileName + 1 : path) == lowerName;
+}
+
+// Collect the PIDs of every running process whose exe name equals lowerName
+bool FindProcessIdsByName(const std::string& lowerName, std::vector<pid_t>* pids) {
+  int bytes = proc_listallpids(NULL, 0);
+  if (bytes <= 0) {
+    return false;
+  }
+  std::vector<pid_t> all(static_cast<size_t>(bytes) / sizeof(pid_t) + 16);
+  int count = proc_listallpids(all.data(), static_cast<int>(all.size() * sizeof(pid_t)));
+  if (count <= 0) {
+    return false;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (all[i] > 0 && ProcessExeNameMatches(all[i], lowerName)) {
+      pids->push_back(all[i]);
+    }
+  }
+  return true;
+}
+
+// The AX element for one of a process' windows (caller releases), or NULL
+AXUIElementRef CopyAXWindow(AXUIElementRef appElement, CGWindowID windowId) {
+  CFArrayRef windows = NULL;
+  if (AXUIElementCopyAttributeValue(appElement, kAXWindowsAttribute, reinterpret_cast<CFTypeRef*>(&windows)) != kAXErrorSuccess || !windows) {
+    return NULL;
+  }
+
+  AXUIElementRef found = NULL;
+  CFIndex count = CFArrayGetCount(windows);
+  for (CFIndex i = 0; i < count && !found; i++) {
+    AXUIElementRef window = static_cast<AXUIElementRef>(CFArrayGetValueAtIndex(windows, i));
+    CGWindowID id = 0;
+    if (_AXUIElementGetWindow(window, &id) == kAXErrorSuccess && id == windowId) {
+      found = static_cast<AXUIElementRef>(CFRetain(window));
+    }
+  }
+  CFRelease(windows);
+  return found;
+}
+
+// Minimized state from AX, falling back to "exists but not on screen"
+// (also true on another Space) when Accessibility access is missing
+bool IsWindowMinimized(AXUIElementRef windowElement, CGWindowID windowId) {
+  if (windowElement) {
+    CFBooleanRef minimized = NULL;
+    if (AXUIElementCopyAttributeValue(windowElement, kAXMinimizedAttribute, reinterpret_cast<CFTypeRef*>(&minimized)) == kAXErrorSuccess && minimized) {
+      bool result = CFBooleanGetValue(minimized);
+      CFRelease(minimized);
+      return result;
+    }
+  }
+
+  CFDictionaryRef info = CopyWindowInfo(windowId);
+  if (!info) {
+    return false;
+  }
+  CFBooleanRef onScreen = static_cast<CFBooleanRef>(CFDictionaryGetValue(info, kCGWindowIsOnscreen));
+  bool result = !onScreen || !CFBooleanGetValue(onScreen);
+  CFRelease(info);
+  return result;
+}
+
+uint32_t ForegroundPid() {
+  @autoreleasepool {
+    NSRunningApplication* app = [[NSWorkspace sharedWorkspace] frontmostApplication];
+    return app ? static_cast<uint32_t>([app processIdentifier]) : 0;
+  }
+}
+
+// Hook thread
+
+// Refresh the state block. Bounds keep their last value while minimized.
+void PublishWindowState(HookHost* host) {
+  WindowStateFields& fields = host->addon->published;
+  fields.foregroundPid = ForegroundPid();
+
+  IntRect bounds;
+  fields.valid = host->windowId != 0 && GetWindowBoundsOnScreen(host->windowId, &bounds);
+  if (fields.valid) {
+    fields.minimized = IsWindowMinimized(host->windowElement, host->windowId);
+    if (!fields.minimized) {
+      fields.bounds = bounds;
+    }
+  }
+
+  WriteStateBlock(host->addon);
+}
+
+// Emit monitorchanged with the new display's bounds if the window moved to
+// another display. The first call only records the current display.
+bool EmitMonitorIfChanged(HookHost* host, const IntRect& bounds, uint32_t timestamp, uint64_t originUs) {
+  CGPoint center = CGPointMake(bounds.x + bounds.width / 2.0, bounds.y + bounds.height / 2.0);
+  CGDirectDisplayID display = 0;
+  uint32_t displayCount = 0;
+  if (CGGetDisplaysWithPoint(center, 1, &display, &displayCount) != kCGErrorSuccess || displayCount == 0) {
+    return false;
+  }
+  if (display == host->display) {
+    return false;
+  }
+
+  bool first = host->display == 0;
+  host->display = display;
+  if (first) {
+    return false;
+  }
+
+  // Whole display bounds: the menu bar/Dock visible frame is only available from AppKit on the main thread
+  DispatchHookEvent(host, { HOOK_EVENT_MONITORCHANGED, host->windowId, MAC_DEFAULT_DPI, timestamp, ToIntRect(CGDisplayBounds(display)), originUs });
+  return true;
+}
+
+// Re-read the tracked window's bounds and emit boundschanged only if they
+// differ from what was last emitted. Returns true if emitted.
+bool EmitBoundsIfChanged(HookHost* host, uint32_t timestamp, uint64_t originUs) {
+  IntRect bounds;
+  if (!GetWindowBoundsOnScreen(host->windowId, &bounds)) {
+    return false;
+  }
+  if (host->hasLastBounds && EqualIntRect(bounds, host->lastBounds)) {
+    return false;
+  }
+
+  host->lastBounds = bounds;
+  host->hasLastBounds = true;
+
+  // A new rect may be on another display; JS hears about it first
+  EmitMonitorIfChanged(host, bounds, timestamp, originUs);
+
+  DispatchHookEvent(host, { HOOK_EVENT_BOUNDSCHANGED, host->windowId, static_cast<uint32_t>(host->pid), timestamp, bounds, originUs });
+  return true;
+}
+
+// Focus state machine: fold an activation into the focus owner
+bool UpdateFocusOwner(HookHost* host, uint32_t fgPid, uint32_t timestamp, uint64_t originUs) {
+  HookEventCode state = HOOK_EVENT_LOSTFOCUS;
+  if (fgPid == static_cast<uint32_t>(host->pid)) {
+    state = HOOK_EVENT_CS2FOCUSED;
+  } else if (host->overlayPid != 0 && fgPid == static_cast<uint32_t>(host->overlayPid)) {
+    state = HOOK_EVENT_OVERLAYFOCUSED;
+  }
+  if (state == host->focusState) {
+    return false;
+  }
+
+  host->focusState = state;
+  DispatchHookEvent(host, { state, host->windowId, fgPid, timestamp, {}, originUs });
+  return true;
+}
+
+bool UpdateMinimized(HookHost* host, bool minimized, uint32_t timestamp, uint64_t originUs) {
+  if (minimized == host->minimized) {
+    return false;
+  }
+
+  host->minimized = minimized;
+  DispatchHookEvent(host, { minimized ? HOOK_EVENT_MINIMIZED : HOOK_EVENT_RESTORED, host->windowId, static_cast<uint32_t>(host->pid), timestamp, {}, originUs });
+  return true;
+}
+
+// Focus state machine: deliver the current state once the hook is live
+void SeedFocusState(HookHost* host) {
+  uint32_t timestamp = TickCountMs();
+  uint64_t originUs = NowUs();
+  UpdateFocusOwner(host, ForegroundPid(), timestamp, originUs);
+
+  if (host->windowId) {
+    host->minimized = IsWindowMinimized(host->windowElement, host->windowId);
+    HookEventCode code = host->minimized ? HOOK_EVENT_MINIMIZED : HOOK_EVENT_RESTORED;
+    DispatchHookEvent(host, { code, host->windowId, static_cast<uint32_t>(host->pid), timestamp, {}, originUs });
+  }
+}
+
+// Route a window event (already counted as raw). Mirrors RouteToTarget on Windows.
+void RouteWindowEvent(HookHost* host, HookEventCode code, CGWindowID windowId) {
+  HookCounters& counters = host->addon->hookCounters;
+  uint32_t timestamp = TickCountMs();
+  uint64_t originUs = NowUs();
+
+  if (host->windowId != 0 && windowId != host->windowId) {
+    CountFiltered(counters, code);
+    return;
+  }
+
+  if (host->windowId != 0 && code == HOOK_EVENT_LOCATIONCHANGE) {
+    if (EmitBoundsIfChanged(host, timestamp, originUs)) {
+      PublishWindowState(host);
+    } else {
+      CountCoalesced(counters, code);
+    }
+    return;
+  }
+
+  PublishWindowState(host);
+
+  bool emitted = true;
+  if (host->trackFocus && (code == HOOK_EVENT_MINIMIZESTART || code == HOOK_EVENT_MINIMIZEEND)) {
+    emitted = UpdateMinimized(host, code == HOOK_EVENT_MINIMIZESTART, timestamp, originUs);
+  } else {
+    DispatchHookEvent(host, { code, windowId, static_cast<uint32_t>(host->pid), timestamp, {}, originUs });
+  }
+  if (!emitted) {
+    CountCoalesced(counters, code);
+  }
+
+  // A restored window may come back somewhere else
+  if (host->windowId != 0 && code == HOOK_EVENT_MINIMIZEEND && EmitBoundsIfChanged(host, timestamp, originUs)) {
+    PublishWindowState(host);
+  }
+}
+
+HookEventCode HookEventCodeForNotification(CFStringRef notification) {
+  if (CFEqual(notification, kAXWindowMovedNotification) || CFEqual(notification, kAXWindowResizedNotification)) {
+    return HOOK_EVENT_LOCATIONCHANGE;
+  }
+  if (CFEqual(notification, kAXWindowMiniaturizedNotification)) {
+    return HOOK_EVENT_MINIMIZESTART;
+  }
+  if (CFEqual(notification, kAXWindowDeminiaturizedNotification)) {
+    return HOOK_EVENT_MINIMIZEEND;
+  }
+  if (CFEqual(notification, kAXUIElementDestroyedNotification)) {
+    return HOOK_EVENT_DESTROY;
+  }
+  return HOOK_EVENT_NONE;
+}
+
+// AXObserver callback (hook thread)
+void AXNotificationProc(AXObserverRef observer, AXUIElementRef element, CFStringRef notification, void* refcon) {
+  HookHost* host = static_cast<HookHost*>(refcon);
+  HookCounters& counters = host->addon->hookCounters;
+  HookEventCode code = HookEventCodeForNotification(notification);
+  CountRaw(counters, code);
+  if (code == HOOK_EVENT_NONE) {
+    CountFiltered(counters, code);
+    return;
+  }
+
+  // Destroyed elements can no longer be asked for their window; that
+  // notification is only registered on the target window itself
+  CGWindowID windowId = host->windowId;
+  if (code != HOOK_EVENT_DESTROY && _AXUIElementGetWindow(element, &windowId) != kAXErrorSuccess) {
+    CountFiltered(counters, code);
+    return;
+  }
+  RouteWindowEvent(host, code, windowId);
+}
+
+// Hook thread: the frontmost application changed
+void HandleActivation(HookHost* host, uint32_t fgPid) {
+  HookCounters& counters = host->addon->hookCounters;
+  CountRaw(counters, HOOK_EVENT_FOREGROUND);
+  host->addon->published.foregroundPid = fgPid;
+  WriteStateBlock(host->addon);
+
+  uint32_t timestamp = TickCountMs();
+  uint64_t originUs = NowUs();
+  if (host->trackFocus) {
+    if (!UpdateFocusOwner(host, fgPid, timestamp, originUs)) {
+      CountCoalesced(counters, HOOK_EVENT_FOREGROUND);
+    }
+    return;
+  }
+  DispatchHookEvent(host, { HOOK_EVENT_FOREGROUND, 0, fgPid, timestamp, {}, originUs });
+}
+
+// Hook thread: the target process exited
+void HandleProcessExit(HookHost* host) {
+  CountRaw(host->addon->hookCounters, HOOK_EVENT_PROCESSEXIT);
+  PublishWindowState(host);
+  DispatchHookEvent(host, { HOOK_EVENT_PROCESSEXIT, host->windowId, static_cast<uint32_t>(host->pid), TickCountMs(), {}, NowUs() });
+}
+
+// Run a block on the hook thread's run loop
+void PerformOnHookThread(HookHost* host, void (^block)(void)) {
+  CFRunLoopPerformBlock(host->runLoop, kCFRunLoopDefaultMode, block);
+  CFRunLoopWakeUp(host->runLoop);
+}
+
+void BoundsPollTimerProc(CFRunLoopTimerRef timer, void* info) {
+  HookHost* host = static_cast<HookHost*>(info);
+  CountRaw(host->addon->hookCounters, HOOK_EVENT_LOCATIONCHANGE);
+  RouteWindowEvent(host, HOOK_EVENT_LOCATIONCHANGE, host->windowId);
+}
+
+// Observe the target on the calling (hook) thread. Without Accessibility
+// access there is no observer: the target window's bounds are polled instead
+// (one window looked up per tick, never the whole list). Never fails.
+void InstallObservers(HookHost* host) {
+  host->appElement = AXUIElementCreateApplication(host->pid);
+  if (host->windowId) {
+    host->windowElement = CopyAXWindow(host->appElement, host->windowId);
+  }
+
+  if (AXIsProcessTrusted() && AXObserverCreate(host->pid, AXNotificationProc, &host->observer) == kAXErrorSuccess) {
+    // App-level registrations cover every window of the process
+    const CFStringRef appNotifications[] = {
+      kAXWindowMovedNotification,
+      kAXWindowResizedNotification,
+      kAXWindowMiniaturizedNotification,
+      kAXWindowDeminiaturizedNotification,
+    };
+    bool anyAdded = false;
+    for (CFStringRef notification : appNotifications) {
+      anyAdded = AXObserverAddNotification(host->observer, host->appElement, notification, host) == kAXErrorSuccess || anyAdded;
+    }
+    if (host->windowElement) {
+      AXObserverAddNotification(host->observer, host->windowElement, kAXUIElementDestroyedNotification, host);
+    }
+    if (anyAdded) {
+      CFRunLoopAddSource(host->runLoop, AXObserverGetRunLoopSource(host->observer), kCFRunLoopDefaultMode);
+    } else {
+      CFRelease(host->observer);
+      host->observer = NULL;
+    }
+  }
+
+  if (!host->observer && host->windowId) {
+    CFRunLoopTimerContext context = { 0, host, NULL, NULL, NULL };
+    host->pollTimer = CFRunLoopTimerCreate(NULL, CFAbsoluteTimeGetCurrent() + BOUNDS_POLL_INTERVAL_S,
+      BOUNDS_POLL_INTERVAL_S, 0, 0, BoundsPollTimerProc, &context);
+    CFRunLoopAddTimer(host->runLoop, host->pollTimer, kCFRunLoopDefaultMode);
+  }
+
+  @autoreleasepool {
+    // Posted on the main thread; forwarded to the hook thread like WinEvents are queued to it
+    host->activationObserver = [[[[NSWorkspace sharedWorkspace] notificationCenter]
+      addObserverForName:NSWorkspaceDidActivateApplicationNotification
+                  object:nil
+                   queue:nil
+              usingBlock:^(NSNotification* note) {
+                NSRunningApplication* app = [[note userInfo] objectForKey:NSWorkspaceApplicationKey];
+                uint32_t fgPid = app ? static_cast<uint32_t>([app processIdentifier]) : 0;
+                PerformOnHookThread(host, ^{ HandleActivation(host, fgPid); });
+              }] retain];
+  }
+
+  // kill(pid, 0) fails if the process is already gone, which the source would never report
+  if (kill(host->pid, 0) == 0 || errno == EPERM) {
+    host->exitSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_PROC, static_cast<uintptr_t>(host->pid),
+      DISPATCH_PROC_EXIT, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0));
+    if (host->exitSource) {
+      dispatch_source_set_event_handler(host->exitSource, ^{
+        PerformOnHookThread(host, ^{ HandleProcessExit(host); });
+        dispatch_source_cancel(host->exitSource);
+      });
+      dispatch_resume(host->exitSource);
+    }
+  }
+}
+
+// Undo InstallObservers; must run on the hook thread
+void RemoveObservers(HookHost* host) {
+  if (host->exitSource) {
+    dispatch_source_cancel(host->exitSource);
+    dispatch_release(host->exitSource);
+    host->exitSource = NULL;
+  }
+  if (host->activationObserver) {
+    [[[NSWorkspace sharedWorkspace] notificationCenter] removeObserver:host->activationObserver];
+    [host->activationObserver release];
+    host->activationObserver = nil;
+  }
+  if (host->pollTimer) {
+    CFRunLoopTimerInvalidate(host->pollTimer);
+    CFRelease(host->pollTimer);
+    host->pollTimer = NULL;
+  }
+  if (host->observer) {
+    CFRunLoopRemoveSource(host->runLoop, AXObserverGetRunLoopSource(host->observer), kCFRunLoopDefaultMode);
+    CFRelease(host->observer);
+    host->observer = NULL;
+  }
+  if (host->windowElement) {
+    CFRelease(host->windowElement);
+    host->windowElement = NULL;
+  }
+  if (host->appElement) {
+    CFRelease(host->appElement);
+    host->appElement = NULL;
+  }
+}
+
+// Hook thread: owns the observers and a run loop independent of the Electron
+// main loop. Reports whether process exit is being watched through `ready`.
+void HookThreadMain(HookHost* host, std::promise<bool> ready) {
+  @autoreleasepool {
+    host->runLoop = static_cast<CFRunLoopRef>(CFRetain(CFRunLoopGetCurrent()));
+    CFRunLoopSourceContext context = {};
+    host->keepAlive = CFRunLoopSourceCreate(NULL, 0, &context);
+    CFRunLoopAddSource(host->runLoop, host->keepAlive, kCFRunLoopDefaultMode);
+
+    InstallObservers(host);
+    PublishWindowState(host);
+    if (host->trackFocus) {
+      SeedFocusState(host);
+    }
+    IntRect bounds;
+    if (host->windowId && GetWindowBoundsOnScreen(host->windowId, &bounds)) {
+      EmitMonitorIfChanged(host, bounds, 0, 0); // Record the starting display
+    }
+    ready.set_value(host->exitSource != NULL);
+  }
+
+  CFRunLoopRun(); // Until StopHookHost stops it
+
+  @autoreleasepool {
+    RemoveObservers(host);
+  }
+  CFRunLoopRemoveSource(host->runLoop, host->keepAlive, kCFRunLoopDefaultMode);
+  CFRelease(host->keepAlive);
+}
+
+void JoinHookThread(HookHost* host) {
+  CFRunLoopStop(host->runLoop);
+  CFRunLoopWakeUp(host->runLoop);
+  host->thread.join();
+  CFRelease(host->runLoop);
+  host->addon->published.valid = false;
+  WriteStateBlock(host->addon);
+  host->addon->hookHost = nullptr;
+}
+
+// Stop the hook (JS thread); its thread-safe function's finalizer frees the host
+void StopHookHost(Cs2WindowTracker* addon) {
+  HookHost* host = addon->hookHost;
+  if (!host) {
+    return;
+  }
+  JoinHookThread(host);
+  host->tsfn.Release();
+}
+
+// Exports
+
+bool ReadWindowId(const Napi::CallbackInfo& info, CGWindowID* out) {
+  if (info.Length() < 1 || !info[0].IsBigInt()) {
+    Napi::TypeError::New(info.Env(), "Expected BigInt (hwnd)").ThrowAsJavaScriptException();
+    return false;
+  }
+  bool lossless;
+  *out = static_cast<CGWindowID>(info[0].As<Napi::BigInt>().Uint64Value(&lossless));
+  return true;
+}
+
+// findWindowByPid(pid: number): bigint | null
+Napi::Value FindWindowByPid(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number (pid)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  CGWindowID windowId = FindBestWindowForPid(static_cast<pid_t>(info[0].As<Napi::Number>().Int32Value()));
+  if (windowId) {
+    return Napi::BigInt::New(env, static_cast<int64_t>(windowId));
+  }
+  return env.Null();
+}
+
+// findProcessIdByName(processName: string): number | null
+Napi::Value FindProcessIdByName(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected string (processName)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<pid_t> pids;
+  FindProcessIdsByName(ToLower(info[0].As<Napi::String>().Utf8Value()), &pids);
+  if (pids.empty()) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, pids[0]);
+}
+
+// Process list off the JS thread; resolves every matching PID
+class FindProcessIdsWorker : public Napi::AsyncWorker {
+public:
+  FindProcessIdsWorker(Napi::Env env, const std::string& lowerName)
+    : Napi::AsyncWorker(env, "cs2FindProcessIds"), lowerName(lowerName), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    if (!FindProcessIdsByName(lowerName, &pids)) {
+      SetError("Failed to list processes. Error code: " + std::to_string(errno));
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, pids.size());
+    for (size_t i = 0; i < pids.size(); i++) {
+      result.Set(static_cast<uint32_t>(i), Napi::Number::New(env, pids[i]));
+    }
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  std::string lowerName;
+  std::vector<pid_t> pids;
+  Napi::Promise::Deferred deferred;
+};
+
+// Window list off the JS thread; resolves every candidate window, largest first
+class FindWindowsWorker : public Napi::AsyncWorker {
+public:
+  FindWindowsWorker(Napi::Env env, pid_t pid)
+    : Napi::AsyncWorker(env, "cs2FindWindows"), pid(pid), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    candidates = FindWindowsForPid(pid);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array result = Napi::Array::New(env, candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+      Napi::Object window = Napi::Object::New(env);
+      window.Set("hwnd", Napi::BigInt::New(env, static_cast<int64_t>(candidates[i].windowId)));
+      window.Set("area", Napi::Number::New(env, static_cast<double>(candidates[i].area)));
+      window.Set("title", Napi::String::New(env, candidates[i].title));
+      result.Set(static_cast<uint32_t>(i), window);
+    }
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  pid_t pid;
+  std::vector<WindowCandidate> candidates;
+  Napi::Promise::Deferred deferred;
+};
+
+// findProcessIdByNameAsync(processName: string): Promise<number[]>
+Napi::Value FindProcessIdByNameAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected string processName").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  FindProcessIdsWorker* worker = new FindProcessIdsWorker(env, ToLower(info[0].As<Napi::String>().Utf8Value()));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+// findWindowByPidAsync(pid: number): Promise<Array<{ hwnd, area, title }>>
+Napi::Value FindWindowByPidAsync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number pid").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  FindWindowsWorker* worker = new FindWindowsWorker(env, static_cast<pid_t>(info[0].As<Napi::Number>().Int32Value()));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+// A pending waitForWindow() call. Owned by its waiter thread until resolved.
+struct WindowWaitRequest {
+  pid_t pid; // Target PID, or 0 to match any process named processName
+  std::string processName; // Lowercase exe name (when pid == 0)
+  uint32_t timeoutMs;
+  pid_t foundPid;
+  CGWindowID foundWindow;
+  CFRunLoopRef runLoop;
+  Napi::Promise::Deferred deferred;
+  Napi::ThreadSafeFunction tsfn;
+
+  explicit WindowWaitRequest(Napi::Env env) : pid(0), timeoutMs(0), foundPid(0), foundWindow(0), runLoop(NULL), deferred(env) {}
+};
+
+bool FindExistingWaitTarget(WindowWaitRequest* request) {
+  if (request->pid) {
+    request->foundWindow = FindBestWindowForPid(request->pid);
+    request->foundPid = request->pid;
+    return request->foundWindow != 0;
+  }
+
+  std::vector<pid_t> pids;
+  FindProcessIdsByName(request->processName, &pids);
+  for (pid_t pid : pids) {
+    CGWindowID windowId = FindBestWindowForPid(pid);
+    if (windowId) {
+      request->foundPid = pid;
+      request->foundWindow = windowId;
+      break;
+    }
+  }
+  return request->foundWindow != 0;
+}
+
+void WindowWaitCheck(WindowWaitRequest* request) {
+  if (!request->foundWindow && FindExistingWaitTarget(request)) {
+    CFRunLoopStop(request->runLoop);
+  }
+}
+
+void WindowWaitTimerProc(CFRunLoopTimerRef timer, void* info) {
+  WindowWaitCheck(static_cast<WindowWaitRequest*>(info));
+}
+
+void WindowWaitAXProc(AXObserverRef observer, AXUIElementRef element, CFStringRef notification, void* refcon) {
+  WindowWaitCheck(static_cast<WindowWaitRequest*>(refcon));
+}
+
+// Waits on the waiter thread's run loop: window-created notifications when the
+// PID is known and Accessibility access is granted, app launches otherwise,
+// with a slow re-check for windows neither of those reports.
+void WindowWaitThreadMain(WindowWaitRequest* request) {
+  request->runLoop = CFRunLoopGetCurrent();
+  AXUIElementRef appElement = NULL;
+  AXObserverRef observer = NULL;
+  id launchObserver = nil;
+
+  @autoreleasepool {
+    // Observe first, then scan, so a window appearing in between is not missed
+    if (request->pid && AXIsProcessTrusted() && AXObserverCreate(request->pid, WindowWaitAXProc, &observer) == kAXErrorSuccess) {
+      appElement = AXUIElementCreateApplication(request->pid);
+      AXObserverAddNotification(observer, appElement, kAXWindowCreatedNotification, request);
+      CFRunLoopAddSource(request->runLoop, AXObserverGetRunLoopSource(observer), kCFRunLoopDefaultMode);
+    }
+    CFRunLoopRef runLoop = request->runLoop;
+    launchObserver = [[[[NSWorkspace sharedWorkspace] notificationCenter]
+      addObserverForName:NSWorkspaceDidLaunchApplicationNotification
+                  object:nil
+                   queue:nil
+              usingBlock:^(NSNotification*) {
+                CFRunLoopPerformBlock(runLoop, kCFRunLoopDefaultMode, ^{ WindowWaitCheck(request); });
+                CFRunLoopWakeUp(runLoop);
+              }] retain];
+  }
+
+  CFRunLoopTimerContext context = { 0, request, NULL, NULL, NULL };
+  CFRunLoopTimerRef recheck = CFRunLoopTimerCreate(NULL, CFAbsoluteTimeGetCurrent() + WINDOW_WAIT_RECHECK_S,
+    WINDOW_WAIT_RECHECK_S, 0, 0, WindowWaitTimerProc, &context);
+  CFRunLoopAddTimer(request->runLoop, recheck, kCFRunLoopDefaultMode);
+
+  if (!FindExistingWaitTarget(request)) {
+    CFAbsoluteTime deadline = CFAbsoluteTimeGetCurrent() + request->timeoutMs / 1000.0;
+    while (!request->foundWindow) {
+      CFTimeInterval remaining = deadline - CFAbsoluteTimeGetCurrent();
+      if (remaining <= 0) {
+        break;
+      }
+      CFRunLoopRunInMode(kCFRunLoopDefaultMode, remaining, false);
+    }
+  }
+
+  CFRunLoopTimerInvalidate(recheck);
+  CFRelease(recheck);
+  @autoreleasepool {
+    [[[NSWorkspace sharedWorkspace] notificationCenter] removeObserver:launchObserver];
+    [launchObserver release];
+  }
+  if (observer) {
+    CFRunLoopRemoveSource(request->runLoop, AXObserverGetRunLoopSource(observer), kCFRunLoopDefaultMode);
+    CFRelease(observer);
+  }
+  if (appElement) {
+    CFRelease(appElement);
+  }
+
+  // Settle the promise on the JS thread; the request is freed there
+  request->tsfn.BlockingCall(request, [](Napi::Env env, Napi::Function, WindowWaitRequest* data) {
+    if (env != nullptr) {
+      if (data->foundWindow) {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("pid", Napi::Number::New(env, data->foundPid));
+        result.Set("hwnd", Napi::BigInt::New(env, static_cast<int64_t>(data->foundWindow)));
+        data->deferred.Resolve(result);
+      } else {
+        data->deferred.Resolve(env.Null());
+      }
+    }
+    delete data;
+  });
+  request->tsfn.Release();
+}
+
+// waitForWindow(target: string | number, timeoutMs: number): Promise<{ pid, hwnd } | null>
+Napi::Value WaitForWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !(info[0].IsString() || info[0].IsNumber()) || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (string processName | number pid, number timeoutMs)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  WindowWaitRequest* request = new WindowWaitRequest(env);
+  if (info[0].IsNumber()) {
+    request->pid = static_cast<pid_t>(info[0].As<Napi::Number>().Int32Value());
+  } else {
+    request->processName = ToLower(info[0].As<Napi::String>().Utf8Value());
+  }
+  request->timeoutMs = info[1].As<Napi::Number>().Uint32Value();
+
+  Napi::Promise promise = request->deferred.Promise();
+  request->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+    "cs2WaitForWindow",
+    0,
+    1
+  );
+
+  // The thread settles the promise and releases the function itself
+  std::thread(WindowWaitThreadMain, request).detach();
+
+  return promise;
+}
+
+// getClientBoundsOnScreen(hwnd: bigint): { x, y, width, height }
+Napi::Value GetClientBoundsOnScreen(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  CGWindowID windowId;
+  if (!ReadWindowId(info, &windowId)) {
+    return env.Null();
+  }
+
+  IntRect bounds;
+  if (!GetWindowBoundsOnScreen(windowId, &bounds)) {
+    return env.Null();
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("x", Napi::Number::New(env, bounds.x));
+  result.Set("y", Napi::Number::New(env, bounds.y));
+  result.Set("width", Napi::Number::New(env, bounds.width));
+  result.Set("height", Napi::Number::New(env, bounds.height));
+  return result;
+}
+
+// isMinimized(hwnd: bigint): boolean
+Napi::Value IsMinimized(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  CGWindowID windowId;
+  if (!ReadWindowId(info, &windowId)) {
+    return env.Null();
+  }
+
+  pid_t pid = WindowOwnerPid(windowId);
+  if (!pid) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  AXUIElementRef appElement = AXUIElementCreateApplication(pid);
+  AXUIElementRef windowElement = AXIsProcessTrusted() ? CopyAXWindow(appElement, windowId) : NULL;
+  bool minimized = IsWindowMinimized(windowElement, windowId);
+  if (windowElement) {
+    CFRelease(windowElement);
+  }
+  CFRelease(appElement);
+  return Napi::Boolean::New(env, minimized);
+}
+
+// getDpiScaleForHwnd(hwnd: bigint): number
+// Always 1: bounds are reported in points, the unit Electron positions windows in
+Napi::Value GetDpiScaleForHwnd(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  CGWindowID windowId;
+  if (!ReadWindowId(info, &windowId)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, 1.0);
+}
+
+// getForegroundPid(): number
+Napi::Value GetForegroundPid(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  uint32_t pid = ForegroundPid();
+  if (!pid) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, pid);
+}
+
+// forceActivateWindow(hwnd: bigint): boolean
+// Un-minimizes and raises the window (with Accessibility access) and activates its app
+Napi::Value ForceActivateWindow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  CGWindowID windowId;
+  if (!ReadWindowId(info, &windowId)) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  pid_t pid = WindowOwnerPid(windowId);
+  if (!pid) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  if (AXIsProcessTrusted()) {
+    AXUIElementRef appElement = AXUIElementCreateApplication(pid);
+    AXUIElementRef windowElement = CopyAXWindow(appElement, windowId);
+    if (windowElement) {
+      AXUIElementSetAttributeValue(windowElement, kAXMinimizedAttribute, kCFBooleanFalse);
+      AXUIElementPerformAction(windowElement, kAXRaiseAction);
+      CFRelease(windowElement);
+    }
+    CFRelease(appElement);
+  }
+
+  bool success = false;
+  @autoreleasepool {
+    NSRunningApplication* app = [NSRunningApplication runningApplicationWithProcessIdentifier:pid];
+    success = app && [app activateWithOptions:NSApplicationActivateIgnoringOtherApps];
+  }
+  return Napi::Boolean::New(env, success);
+}
+
+// Shared option parsing, as on Windows
+bool ParseBatchDelivery(const Napi::CallbackInfo& info, size_t index) {
+  if (info.Length() > index && info[index].IsObject()) {
+    Napi::Value deliveryOpt = info[index].As<Napi::Object>().Get("delivery");
+    if (deliveryOpt.IsString()) {
+      return deliveryOpt.As<Napi::String>().Utf8Value() == "batch";
+    }
+  }
+  return false;
+}
+
+void ParseFocusOptions(const Napi::CallbackInfo& info, size_t index, HookHost* host) {
+  if (info.Length() > index && info[index].IsObject()) {
+    Napi::Value overlayPidOpt = info[index].As<Napi::Object>().Get("overlayPid");
+    if (overlayPidOpt.IsNumber()) {
+      host->trackFocus = true;
+      host->overlayPid = static_cast<pid_t>(overlayPidOpt.As<Napi::Number>().Int32Value());
+    }
+  }
+}
+
+// startWinEventHook(targetPid: number, cb: function,
+//                   options?: { hwnd?: bigint, delivery?: 'callback' | 'batch', overlayPid?: number }): boolean
+// Same events as on Windows, except movestart/moveend and cloaked/uncloaked,
+// which macOS does not report. Returns true when a processexit event will be
+// emitted when the target exits.
+Napi::Value StartWinEventHook(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (number pid, function callback)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  CGWindowID windowId = 0;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Value hwndOpt = info[2].As<Napi::Object>().Get("hwnd");
+    if (hwndOpt.IsBigInt()) {
+      bool lossless;
+      windowId = static_cast<CGWindowID>(hwndOpt.As<Napi::BigInt>().Uint64Value(&lossless));
+    }
+  }
+
+  // Replace the existing hook if any
+  Cs2WindowTracker* addon = AddonFor(env);
+  StopHookHost(addon);
+
+  // Counters describe the current hook session
+  ResetHookCounters(addon->hookCounters);
+
+  HookHost* host = new HookHost();
+  host->addon = addon;
+  host->runLoop = NULL;
+  host->keepAlive = NULL;
+  host->pid = static_cast<pid_t>(info[0].As<Napi::Number>().Int32Value());
+  host->windowId = windowId;
+  host->batchDelivery = ParseBatchDelivery(info, 2);
+  host->ring = nullptr;
+  if (host->batchDelivery) {
+    host->ring = new EventRing();
+    host->ring->head.store(0, std::memory_order_relaxed);
+    host->ring->tail.store(0, std::memory_order_relaxed);
+    host->ring->dropped.store(0, std::memory_order_relaxed);
+  }
+  host->wakeupPending.store(false, std::memory_order_relaxed);
+  host->appElement = NULL;
+  host->windowElement = NULL;
+  host->observer = NULL;
+  host->pollTimer = NULL;
+  host->activationObserver = nil;
+  host->exitSource = NULL;
+  host->hasLastBounds = false;
+  host->display = 0;
+  host->trackFocus = false;
+  host->overlayPid = 0;
+  host->focusState = HOOK_EVENT_NONE;
+  host->minimized = false;
+  ParseFocusOptions(info, 2, host);
+  host->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2WinEventHook",
+    0, // Unlimited queue; notification callbacks must never block
+    1,
+    [](Napi::Env, HookHost* finalized) {
+      // Environment teardown finalizes a hook that was never stopped
+      if (finalized->addon->hookHost == finalized) {
+        JoinHookThread(finalized);
+      }
+      delete finalized->ring;
+      delete finalized;
+    },
+    host
+  );
+
+  addon->published = {};
+  addon->hookHost = host;
+  std::promise<bool> ready;
+  std::future<bool> readyResult = ready.get_future();
+  host->thread = std::thread(HookThreadMain, host, std::move(ready));
+  bool watchingExit = readyResult.get();
+
+  return Napi::Boolean::New(env, watchingExit);
+}
+
+// stopWinEventHook(): void
+Napi::Value StopWinEventHook(const Napi::CallbackInfo& info) {
+  StopHookHost(AddonFor(info.Env()));
+  return info.Env().Undefined();
+}
+
+// setOverlayFollow(overlayHandle: Buffer | bigint | null): boolean
+// Not available on macOS (another app's window moves cannot be mirrored
+// synchronously); only turning it off succeeds, so JS keeps positioning the overlay.
+Napi::Value SetOverlayFollow(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  bool disable = info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined();
+  return Napi::Boolean::New(env, disable);
+}
+
+// drainEvents(buffer: BigInt64Array | Uint32Array): number
+// Same record layout as on Windows, with the CGWindowID in the hwnd slot(s)
+Napi::Value DrainEvents(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Napi::TypedArray array;
+  if (!ReadDrainBuffer(info, &array)) {
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  HookHost* host = addon->hookHost;
+  if (!host || !host->ring) {
+    return Napi::Number::New(env, 0);
+  }
+
+  size_t count = DrainEventRing(host->ring, array, addon->hookCounters);
+  return Napi::Number::New(env, static_cast<double>(count));
+}
+
+// getHookStats(): same shape as on Windows
+Napi::Value GetHookStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  HookHost* host = addon->hookHost;
+  uint64_t dropped = host && host->ring ? host->ring->dropped.load(std::memory_order_relaxed) : 0;
+  return HookCountersToObject(env, addon->hookCounters, dropped);
+}
+
+// resetHookStats(): void
+Napi::Value ResetHookStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  ResetHookCounters(addon->hookCounters);
+  if (addon->hookHost && addon->hookHost->ring) {
+    addon->hookHost->ring->dropped.store(0, std::memory_order_relaxed);
+  }
+  return env.Undefined();
+}
+
+// getStateBlock(): ArrayBuffer
+// The same buffer is returned on every call; view it as an Int32Array
+Napi::Value GetStateBlock(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (addon->stateBlockRef.IsEmpty()) {
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, STATE_SLOT_COUNT * sizeof(int32_t));
+    memset(buffer.Data(), 0, buffer.ByteLength());
+    addon->stateBlockRef = Napi::Persistent(buffer);
+    addon->stateBlock = static_cast<volatile int32_t*>(buffer.Data());
+  }
+
+  return addon->stateBlockRef.Value();
+}
+
+// Module initialization, once per environment. Exports the window tracking
+// subset; capture, hit testing, trackWindow, demo and netcon helpers are
+// Windows-only and index.ts treats them as unavailable here.
+Cs2WindowTracker::Cs2WindowTracker(Napi::Env env, Napi::Object exports)
+  : hookHost(nullptr), hookCounters(), stateBlock(nullptr), published() {
+  exports.Set(Napi::String::New(env, "findWindowByPid"),
+              Napi::Function::New(env, FindWindowByPid));
+  exports.Set(Napi::String::New(env, "findProcessIdByName"),
+              Napi::Function::New(env, FindProcessIdByName));
+  exports.Set(Napi::String::New(env, "findProcessIdByNameAsync"),
+              Napi::Function::New(env, FindProcessIdByNameAsync));
+  exports.Set(Napi::String::New(env, "findWindowByPidAsync"),
+              Napi::Function::New(env, FindWindowByPidAsync));
+  exports.Set(Napi::String::New(env, "waitForWindow"),
+              Napi::Function::New(env, WaitForWindow));
+  exports.Set(Napi::String::New(env, "getClientBoundsOnScreen"),
+              Napi::Function::New(env, GetClientBoundsOnScreen));
+  exports.Set(Napi::String::New(env, "isMinimized"),
+              Napi::Function::New(env, IsMinimized));
+  exports.Set(Napi::String::New(env, "getDpiScaleForHwnd"),
+              Napi::Function::New(env, GetDpiScaleForHwnd));
+  exports.Set(Napi::String::New(env, "getForegroundPid"),
+              Napi::Function::New(env, GetForegroundPid));
+  exports.Set(Napi::String::New(env, "forceActivateWindow"),
+              Napi::Function::New(env, ForceActivateWindow));
+  exports.Set(Napi::String::New(env, "startWinEventHook"),
+              Napi::Function::New(env, StartWinEventHook));
+  exports.Set(Napi::String::New(env, "setOverlayFollow"),
+              Napi::Function::New(env, SetOverlayFollow));
+  exports.Set(Napi::String::New(env, "stopWinEventHook"),
+              Napi::Function::New(env, StopWinEventHook));
+  exports.Set(Napi::String::New(env, "getStateBlock"),
+              Napi::Function::New(env, GetStateBlock));
+  exports.Set(Napi::String::New(env, "drainEvents"),
+              Napi::Function::New(env, DrainEvents));
+  exports.Set(Napi::String::New(env, "getHookStats"),
+              Napi::Function::New(env, GetHookStats));
+  exports.Set(Napi::String::New(env, "resetHookStats"),
+              Napi::Function::New(env, ResetHookStats));
+}
+
+// Environment exit: stop a hook JS never stopped
+Cs2WindowTracker::~Cs2WindowTracker() {
+  if (hookHost) {
+    StopHookHost(this);
+  }
+}
+
+NODE_API_ADDON(Cs2WindowTracker)
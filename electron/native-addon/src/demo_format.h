@@ -0,0 +1,55 @@
+// PBDEMS2 demo decoding shared by the header scanner (demo_scan.cpp) and voice
+// extraction (voice_extract.cpp): varints, protobuf fields and demo frames.
+#pragma once
+
+#include "addon.h"
+
+#define DEMO_SCAN_MAX_THREADS 8
+#define DEMO_MAX_FRAME_BYTES (16 * 1024 * 1024) // Header/file info frames are a few KB
+#define DEMO_CMD_FILE_HEADER 1 // EDemoCommands::DEM_FileHeader
+#define DEMO_CMD_FILE_INFO 2 // EDemoCommands::DEM_FileInfo
+#define DEMO_CMD_COMPRESSED 64 // EDemoCommands::DEM_IsCompressed (payload is raw Snappy)
+#define DEMO_FRAME_PREFIX_BYTES 30 // Command, tick and size varints, at most 10 bytes each
+
+struct DemoScanResult {
+  std::wstring path;
+  uint64_t size;
+  double mtimeMs; // Unix epoch milliseconds
+  std::string error; // Empty on success
+  // CDemoFileHeader
+  std::string mapName;
+  std::string serverName;
+  std::string clientName;
+  std::string gameDirectory;
+  std::string demoVersionName;
+  int32_t networkProtocol;
+  int32_t buildNum;
+  // CDemoFileInfo (absent while a demo is still being recorded or was cut off)
+  bool hasFileInfo;
+  float playbackTime;
+  int32_t playbackTicks;
+  int32_t playbackFrames;
+  uint32_t rounds; // CCSGameInfo.round_start_ticks entries
+};
+
+// One protobuf field: varint/fixed values land in `value`, length-delimited ones in data/length
+struct ProtoField {
+  uint32_t number;
+  uint32_t wireType;
+  uint64_t value;
+  const uint8_t* data;
+  size_t length;
+};
+
+// Read one base-128 varint; false if it runs past `end` or past 64 bits
+bool ReadVarint(const uint8_t** cursor, const uint8_t* end, uint64_t* value);
+bool NextProtoField(const uint8_t** cursor, const uint8_t* end, ProtoField* field);
+
+// Decode the frame at `*offset`: [varint cmd][varint tick][varint size][payload],
+// moving `*offset` past it. Compressed payloads are inflated into `scratch`.
+bool NextDemoFrame(const uint8_t* base, uint64_t fileSize, uint64_t* offset, uint32_t* command, uint32_t* tick,
+                   std::vector<uint8_t>* scratch, const uint8_t** payload, size_t* payloadLength);
+
+// Decode the file header and file info frames of an open demo into `result`
+// (whose size must be set); `result->error` says why when that fails
+void ParseDemoHeaders(HANDLE file, DemoScanResult* result);
@@ -0,0 +1,427 @@
+#include "addon.h"
+#include "demo_format.h"
+
+// Demo header scanner: reads just the PBDEMS2 file header frame and the file
+// info frame the header points to from each .dem, so the demo list can show
+// map/server/duration/build without a full parse. Files are spread over a small
+// pool of threads. Frames are read with ReadFile rather than through a mapped
+// view: CS2 may still be writing (or truncating) a demo, and a mapped page that
+// vanishes faults the whole process instead of failing the read.
+
+bool ReadVarint(const uint8_t** cursor, const uint8_t* end, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *cursor < end; shift += 7) {
+    uint8_t byte = *(*cursor)++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool NextProtoField(const uint8_t** cursor, const uint8_t* end, ProtoField* field) {
+  uint64_t key;
+  if (*cursor >= end || !ReadVarint(cursor, end, &key)) {
+    return false;
+  }
+  field->number = static_cast<uint32_t>(key >> 3);
+  field->wireType = static_cast<uint32_t>(key & 7);
+  field->value = 0;
+  field->data = nullptr;
+  field->length = 0;
+  switch (field->wireType) {
+    case 0:
+      return ReadVarint(cursor, end, &field->value);
+    case 1:
+    case 5: {
+      size_t width = field->wireType == 1 ? 8 : 4;
+      if (static_cast<size_t>(end - *cursor) < width) {
+        return false;
+      }
+      memcpy(&field->value, *cursor, width);
+      *cursor += width;
+      return true;
+    }
+    case 2:
+      if (!ReadVarint(cursor, end, &field->value) || field->value > static_cast<uint64_t>(end - *cursor)) {
+        return false;
+      }
+      field->data = *cursor;
+      field->length = static_cast<size_t>(field->value);
+      *cursor += field->length;
+      return true;
+    default:
+      return false; // Groups are not used by demo messages
+  }
+}
+
+// Raw Snappy block decompression (demo frames flagged DEM_IsCompressed)
+bool SnappyDecompress(const uint8_t* input, size_t length, size_t maxOutput, std::vector<uint8_t>* out) {
+  const uint8_t* cursor = input;
+  const uint8_t* end = input + length;
+  uint64_t expected;
+  if (!ReadVarint(&cursor, end, &expected) || expected > maxOutput) {
+    return false;
+  }
+  out->resize(static_cast<size_t>(expected));
+  uint8_t* output = out->data();
+  size_t written = 0;
+
+  while (cursor < end) {
+    uint8_t tag = *cursor++;
+    size_t runLength;
+    size_t offset = 0;
+    if ((tag & 3) == 0) {
+      runLength = (tag >> 2) + 1;
+      if (runLength > 60) {
+        size_t lengthBytes = runLength - 60;
+        if (static_cast<size_t>(end - cursor) < lengthBytes) {
+          return false;
+        }
+        runLength = 0;
+        for (size_t i = 0; i < lengthBytes; i++) {
+          runLength |= static_cast<size_t>(cursor[i]) << (8 * i);
+        }
+        runLength += 1;
+        cursor += lengthBytes;
+      }
+      if (static_cast<size_t>(end - cursor) < runLength || expected - written < runLength) {
+        return false;
+      }
+      memcpy(output + written, cursor, runLength);
+      cursor += runLength;
+      written += runLength;
+      continue;
+    }
+
+    size_t offsetBytes = (tag & 3) == 1 ? 1 : ((tag & 3) == 2 ? 2 : 4);
+    if (static_cast<size_t>(end - cursor) < offsetBytes) {
+      return false;
+    }
+    if ((tag & 3) == 1) {
+      runLength = ((tag >> 2) & 7) + 4;
+      offset = (static_cast<size_t>(tag >> 5) << 8) | cursor[0];
+    } else {
+      runLength = (tag >> 2) + 1;
+      for (size_t i = 0; i < offsetBytes; i++) {
+        offset |= static_cast<size_t>(cursor[i]) << (8 * i);
+      }
+    }
+    cursor += offsetBytes;
+    if (offset == 0 || offset > written || expected - written < runLength) {
+      return false;
+    }
+    // Byte by byte: a copy may overlap the bytes it is producing
+    for (size_t i = 0; i < runLength; i++) {
+      output[written + i] = output[written - offset + i];
+    }
+    written += runLength;
+  }
+  return written == expected;
+}
+
+// Decode the frame at `*offset`: [varint cmd][varint tick][varint size][payload],
+// moving `*offset` past it. Compressed payloads are inflated into `scratch`.
+bool NextDemoFrame(const uint8_t* base, uint64_t fileSize, uint64_t* offset, uint32_t* command, uint32_t* tick,
+                   std::vector<uint8_t>* scratch, const uint8_t** payload, size_t* payloadLength) {
+  if (*offset >= fileSize) {
+    return false;
+  }
+  const uint8_t* cursor = base + *offset;
+  const uint8_t* end = base + fileSize;
+  uint64_t rawCommand;
+  uint64_t rawTick;
+  uint64_t size;
+  if (!ReadVarint(&cursor, end, &rawCommand) || !ReadVarint(&cursor, end, &rawTick) ||
+      !ReadVarint(&cursor, end, &size) || size > DEMO_MAX_FRAME_BYTES || size > static_cast<uint64_t>(end - cursor)) {
+    return false;
+  }
+
+  *offset = static_cast<uint64_t>(cursor - base) + size;
+  *tick = static_cast<uint32_t>(rawTick);
+  *command = static_cast<uint32_t>(rawCommand & ~static_cast<uint64_t>(DEMO_CMD_COMPRESSED));
+  if (rawCommand & DEMO_CMD_COMPRESSED) {
+    if (!SnappyDecompress(cursor, static_cast<size_t>(size), DEMO_MAX_FRAME_BYTES, scratch)) {
+      return false;
+    }
+    *payload = scratch->data();
+    *payloadLength = scratch->size();
+  } else {
+    *payload = cursor;
+    *payloadLength = static_cast<size_t>(size);
+  }
+  return true;
+}
+
+bool ReadDemoFrame(const uint8_t* base, uint64_t fileSize, uint64_t offset, uint32_t* command,
+                   std::vector<uint8_t>* scratch, const uint8_t** payload, size_t* payloadLength) {
+  uint32_t tick;
+  return NextDemoFrame(base, fileSize, &offset, command, &tick, scratch, payload, payloadLength);
+}
+
+void ParseDemoFileHeader(const uint8_t* data, size_t length, DemoScanResult* result) {
+  const uint8_t* cursor = data;
+  ProtoField field;
+  while (NextProtoField(&cursor, data + length, &field)) {
+    std::string text = field.wireType == 2 ? std::string(reinterpret_cast<const char*>(field.data), field.length) : std::string();
+    switch (field.number) {
+      case 2: result->networkProtocol = static_cast<int32_t>(field.value); break;
+      case 3: result->serverName = text; break;
+      case 4: result->clientName = text; break;
+      case 5: result->mapName = text; break;
+      case 6: result->gameDirectory = text; break;
+      case 11: result->demoVersionName = text; break;
+      case 13: result->buildNum = static_cast<int32_t>(field.value); break;
+    }
+  }
+}
+
+void ParseDemoFileInfo(const uint8_t* data, size_t length, DemoScanResult* result) {
+  const uint8_t* cursor = data;
+  ProtoField field;
+  while (NextProtoField(&cursor, data + length, &field)) {
+    if (field.number == 1 && field.wireType == 5) {
+      uint32_t bits = static_cast<uint32_t>(field.value);
+      memcpy(&result->playbackTime, &bits, sizeof(float));
+    } else if (field.number == 2) {
+      result->playbackTicks = static_cast<int32_t>(field.value);
+    } else if (field.number == 3) {
+      result->playbackFrames = static_cast<int32_t>(field.value);
+    } else if (field.number == 4 && field.wireType == 2) {
+      // CGameInfo.cs (5) -> CCSGameInfo.round_start_ticks (1, packed or not)
+      const uint8_t* gameCursor = field.data;
+      ProtoField gameField;
+      while (NextProtoField(&gameCursor, field.data + field.length, &gameField)) {
+        if (gameField.number != 5 || gameField.wireType != 2) {
+          continue;
+        }
+        const uint8_t* csCursor = gameField.data;
+        ProtoField csField;
+        while (NextProtoField(&csCursor, gameField.data + gameField.length, &csField)) {
+          if (csField.number != 1) {
+            continue;
+          }
+          if (csField.wireType == 0) {
+            result->rounds++;
+          } else if (csField.wireType == 2) {
+            const uint8_t* packed = csField.data;
+            uint64_t tick;
+            while (packed < csField.data + csField.length && ReadVarint(&packed, csField.data + csField.length, &tick)) {
+              result->rounds++;
+            }
+          }
+        }
+      }
+    }
+  }
+  result->hasFileInfo = true;
+}
+
+// Scanner thread: read up to `length` bytes at `offset`; `out` holds what was
+// there (less near the end of the file). False on a read error.
+bool ReadDemoRange(HANDLE file, uint64_t offset, size_t length, std::vector<uint8_t>* out) {
+  out->resize(length);
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  DWORD read = 0;
+  if (!ReadFile(file, out->data(), static_cast<DWORD>(length), &read, &overlapped) && GetLastError() != ERROR_HANDLE_EOF) {
+    out->clear();
+    return false;
+  }
+  out->resize(read);
+  return true;
+}
+
+// Scanner thread: read the frame at `offset` into `frame` and decode it. The
+// size varint is read first, so only the frame's own bytes are fetched.
+bool ReadDemoFrameFromFile(HANDLE file, uint64_t offset, std::vector<uint8_t>* frame, uint32_t* command,
+                           std::vector<uint8_t>* scratch, const uint8_t** payload, size_t* payloadLength) {
+  if (!ReadDemoRange(file, offset, DEMO_FRAME_PREFIX_BYTES, frame)) {
+    return false;
+  }
+  const uint8_t* cursor = frame->data();
+  const uint8_t* end = cursor + frame->size();
+  uint64_t rawCommand;
+  uint64_t rawTick;
+  uint64_t size;
+  if (!ReadVarint(&cursor, end, &rawCommand) || !ReadVarint(&cursor, end, &rawTick) ||
+      !ReadVarint(&cursor, end, &size) || size > DEMO_MAX_FRAME_BYTES) {
+    return false;
+  }
+  size_t frameLength = static_cast<size_t>(cursor - frame->data()) + static_cast<size_t>(size);
+  if (frameLength > frame->size() && !ReadDemoRange(file, offset, frameLength, frame)) {
+    return false;
+  }
+  return ReadDemoFrame(frame->data(), frame->size(), 0, command, scratch, payload, payloadLength);
+}
+
+void ParseDemoHeaders(HANDLE file, DemoScanResult* result) {
+  std::vector<uint8_t> frame;
+  if (!ReadDemoRange(file, 0, 16, &frame)) {
+    result->error = "Failed to read demo. Error code: " + std::to_string(GetLastError());
+    return;
+  }
+  if (frame.size() < 16 || memcmp(frame.data(), "PBDEMS2\0", 8) != 0) {
+    result->error = "Not a CS2 (PBDEMS2) demo";
+    return;
+  }
+  uint32_t fileInfoOffset;
+  memcpy(&fileInfoOffset, frame.data() + 8, sizeof(fileInfoOffset));
+
+  std::vector<uint8_t> scratch;
+  uint32_t command;
+  const uint8_t* payload;
+  size_t payloadLength;
+  if (!ReadDemoFrameFromFile(file, 16, &frame, &command, &scratch, &payload, &payloadLength) ||
+      command != DEMO_CMD_FILE_HEADER) {
+    result->error = "Missing demo file header";
+    return;
+  }
+  ParseDemoFileHeader(payload, payloadLength, result);
+
+  if (fileInfoOffset >= 16 && fileInfoOffset < result->size &&
+      ReadDemoFrameFromFile(file, fileInfoOffset, &frame, &command, &scratch, &payload, &payloadLength) &&
+      command == DEMO_CMD_FILE_INFO) {
+    ParseDemoFileInfo(payload, payloadLength, result);
+  }
+}
+
+// Scanner thread: stat, read and decode one demo
+void ScanDemoFile(DemoScanResult* result) {
+  HANDLE file = CreateFileW(result->path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    result->error = "Failed to open demo. Error code: " + std::to_string(GetLastError());
+    return;
+  }
+
+  BY_HANDLE_FILE_INFORMATION fileInfo;
+  if (!GetFileInformationByHandle(file, &fileInfo)) {
+    result->error = "Failed to stat demo. Error code: " + std::to_string(GetLastError());
+    CloseHandle(file);
+    return;
+  }
+  result->size = (static_cast<uint64_t>(fileInfo.nFileSizeHigh) << 32) | fileInfo.nFileSizeLow;
+  ULARGE_INTEGER modified;
+  modified.LowPart = fileInfo.ftLastWriteTime.dwLowDateTime;
+  modified.HighPart = fileInfo.ftLastWriteTime.dwHighDateTime;
+  result->mtimeMs = (static_cast<double>(modified.QuadPart) - 116444736000000000.0) / 10000.0; // FILETIME epoch is 1601
+
+  if (result->size) {
+    ParseDemoHeaders(file, result);
+  } else {
+    result->error = "Empty demo file";
+  }
+  CloseHandle(file);
+}
+
+// Scans every path on up to DEMO_SCAN_MAX_THREADS threads; results keep the input order
+class ScanDemosWorker : public Napi::AsyncWorker {
+public:
+  ScanDemosWorker(Napi::Env env)
+    : Napi::AsyncWorker(env, "cs2ScanDemos"), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+  std::vector<DemoScanResult> results;
+
+protected:
+  void Execute() override {
+    std::atomic<size_t> next(0);
+    size_t threadCount = std::min<size_t>(results.size(),
+      std::max<size_t>(1, std::min<size_t>(DEMO_SCAN_MAX_THREADS, std::thread::hardware_concurrency())));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++) {
+      threads.emplace_back([this, &next]() {
+        for (size_t i = next.fetch_add(1); i < results.size(); i = next.fetch_add(1)) {
+          ScanDemoFile(&results[i]);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array array = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); i++) {
+      const DemoScanResult& result = results[i];
+      Napi::Object demo = Napi::Object::New(env);
+      demo.Set("path", Napi::String::New(env, WideToUtf8(result.path)));
+      demo.Set("size", Napi::Number::New(env, static_cast<double>(result.size)));
+      demo.Set("mtimeMs", Napi::Number::New(env, result.mtimeMs));
+      if (!result.error.empty()) {
+        demo.Set("error", Napi::String::New(env, result.error));
+        array.Set(static_cast<uint32_t>(i), demo);
+        continue;
+      }
+      demo.Set("mapName", Napi::String::New(env, result.mapName));
+      demo.Set("serverName", Napi::String::New(env, result.serverName));
+      demo.Set("clientName", Napi::String::New(env, result.clientName));
+      demo.Set("gameDirectory", Napi::String::New(env, result.gameDirectory));
+      demo.Set("demoVersionName", Napi::String::New(env, result.demoVersionName));
+      demo.Set("networkProtocol", Napi::Number::New(env, result.networkProtocol));
+      demo.Set("buildNum", Napi::Number::New(env, result.buildNum));
+      if (result.hasFileInfo) {
+        demo.Set("playbackTime", Napi::Number::New(env, result.playbackTime));
+        demo.Set("playbackTicks", Napi::Number::New(env, result.playbackTicks));
+        demo.Set("playbackFrames", Napi::Number::New(env, result.playbackFrames));
+        demo.Set("rounds", Napi::Number::New(env, result.rounds));
+      }
+      array.Set(static_cast<uint32_t>(i), demo);
+    }
+    deferred.Resolve(array);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred;
+};
+
+// scanDemos(paths: string[]): Promise<Array<{ path, size, mtimeMs, error?, mapName?, serverName?,
+//   clientName?, gameDirectory?, demoVersionName?, networkProtocol?, buildNum?,
+//   playbackTime?, playbackTicks?, playbackFrames?, rounds? }>>
+// Header metadata for each demo, in input order. A demo that cannot be read has
+// `error` set instead; playback fields are missing when the demo has no file info
+// frame (still recording or truncated).
+Napi::Value ScanDemos(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected string[] paths").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array paths = info[0].As<Napi::Array>();
+  ScanDemosWorker* worker = new ScanDemosWorker(env);
+  worker->results.resize(paths.Length());
+  for (uint32_t i = 0; i < paths.Length(); i++) {
+    DemoScanResult& result = worker->results[i];
+    Napi::Value path = paths.Get(i);
+    if (path.IsString()) {
+      std::u16string utf16 = path.As<Napi::String>().Utf16Value();
+      result.path.assign(utf16.begin(), utf16.end());
+    }
+    result.size = 0;
+    result.mtimeMs = 0;
+    result.networkProtocol = 0;
+    result.buildNum = 0;
+    result.hasFileInfo = false;
+    result.playbackTime = 0;
+    result.playbackTicks = 0;
+    result.playbackFrames = 0;
+    result.rounds = 0;
+  }
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
@@ -0,0 +1,352 @@
+#include "addon.h"
+#include <cwctype>
+
+// Demo folder watcher: one overlapped ReadDirectoryChangesW per folder, all on a
+// single completion port serviced by one thread. A changed .dem is only reported
+// once nobody holds it open for writing and its size has held for the settle
+// time, so JS never sees a demo CS2 or Steam is still writing.
+#define DEMO_WATCH_STOP_KEY 0 // Completion key posted by stopDemoWatcher; folders use index + 1
+#define DEMO_WATCH_BUFFER_BYTES (64 * 1024) // Largest notification buffer network shares accept
+#define DEMO_WATCH_POLL_MS 500 // How often pending demos are re-checked while any exist
+#define DEMO_WATCH_DEFAULT_SETTLE_MS 1000 // Quiet time after the last change before a demo is checked
+
+struct DemoWatchFolder {
+  std::wstring path;
+  HANDLE directory;
+  OVERLAPPED overlapped;
+  std::vector<DWORD> buffer; // DWORD-aligned, as ReadDirectoryChangesW requires
+  bool reading; // A read is outstanding on the port
+};
+
+struct PendingDemo {
+  ULONGLONG lastChange; // GetTickCount64 of the last notification or size change
+  LONGLONG lastSize; // -1 until the file could be opened once
+};
+
+struct DemoWatchHost {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  HANDLE port;
+  bool recursive;
+  DWORD settleMs;
+  std::vector<DemoWatchFolder*> folders;
+  std::map<std::wstring, PendingDemo> pending; // Watcher thread only
+  Napi::ThreadSafeFunction tsfn;
+};
+
+// One event for JS; freed by the TSFN callback
+struct DemoWatchEvent {
+  const char* type;
+  std::wstring path;
+  LONGLONG size;
+  DWORD error;
+};
+
+bool IsDemoFileName(const std::wstring& name) {
+  if (name.size() < 4) {
+    return false;
+  }
+  const wchar_t* extension = name.c_str() + name.size() - 4;
+  return extension[0] == L'.' && towlower(extension[1]) == L'd' &&
+    towlower(extension[2]) == L'e' && towlower(extension[3]) == L'm';
+}
+
+// Watcher thread: hand one event to JS
+void EmitDemoWatchEvent(DemoWatchHost* host, const char* type, const std::wstring& path, LONGLONG size, DWORD error) {
+  DemoWatchEvent* event = new DemoWatchEvent{ type, path, size, error };
+  napi_status status = host->tsfn.NonBlockingCall(event,
+    [](Napi::Env env, Napi::Function jsCallback, DemoWatchEvent* event) {
+      if (env != nullptr && jsCallback != nullptr) {
+        Napi::Object payload = Napi::Object::New(env);
+        payload.Set("type", Napi::String::New(env, event->type));
+        payload.Set("path", Napi::String::New(env, WideToUtf8(event->path)));
+        if (event->size >= 0) {
+          payload.Set("size", Napi::Number::New(env, static_cast<double>(event->size)));
+        }
+        if (event->error) {
+          payload.Set("error", Napi::Number::New(env, event->error));
+        }
+        jsCallback.Call({ payload });
+      }
+      delete event;
+    });
+  if (status != napi_ok) {
+    delete event; // Queue closing (watcher being torn down)
+  }
+}
+
+bool QueueDirectoryRead(DemoWatchHost* host, DemoWatchFolder* folder) {
+  memset(&folder->overlapped, 0, sizeof(folder->overlapped));
+  folder->reading = ReadDirectoryChangesW(folder->directory, folder->buffer.data(),
+    static_cast<DWORD>(folder->buffer.size() * sizeof(DWORD)), host->recursive ? TRUE : FALSE,
+    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+    NULL, &folder->overlapped, NULL) != FALSE;
+  return folder->reading;
+}
+
+// Watcher thread: fold one completed notification buffer into the pending set
+void HandleDirectoryChanges(DemoWatchHost* host, DemoWatchFolder* folder, DWORD bytes) {
+  ULONGLONG now = GetTickCount64();
+  const uint8_t* cursor = reinterpret_cast<const uint8_t*>(folder->buffer.data());
+  for (;;) {
+    const FILE_NOTIFY_INFORMATION* entry = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+    std::wstring name(entry->FileName, entry->FileNameLength / sizeof(WCHAR));
+    if (IsDemoFileName(name)) {
+      std::wstring path = folder->path + L"\\" + name;
+      switch (entry->Action) {
+        case FILE_ACTION_ADDED:
+        case FILE_ACTION_MODIFIED:
+        case FILE_ACTION_RENAMED_NEW_NAME: {
+          auto it = host->pending.find(path);
+          if (it == host->pending.end()) {
+            host->pending[path] = { now, -1 };
+          } else {
+            it->second.lastChange = now;
+          }
+          break;
+        }
+        case FILE_ACTION_REMOVED:
+        case FILE_ACTION_RENAMED_OLD_NAME:
+          host->pending.erase(path);
+          EmitDemoWatchEvent(host, "demoremoved", path, -1, 0);
+          break;
+      }
+    }
+    if (entry->NextEntryOffset == 0 || entry->NextEntryOffset >= bytes) {
+      break;
+    }
+    bytes -= entry->NextEntryOffset;
+    cursor += entry->NextEntryOffset;
+  }
+}
+
+// Watcher thread: report pending demos that are closed and have stopped growing.
+// Opening without FILE_SHARE_WRITE fails while any writer still has the file open.
+void CheckPendingDemos(DemoWatchHost* host) {
+  ULONGLONG now = GetTickCount64();
+  for (auto it = host->pending.begin(); it != host->pending.end();) {
+    PendingDemo& demo = it->second;
+    if (now - demo.lastChange < host->settleMs) {
+      ++it;
+      continue;
+    }
+
+    HANDLE file = CreateFileW(it->first.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      DWORD error = GetLastError();
+      if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) {
+        it = host->pending.erase(it); // Gone again before it was ever ready
+      } else {
+        ++it; // Sharing violation: still being written
+      }
+      continue;
+    }
+    LARGE_INTEGER size;
+    BOOL sized = GetFileSizeEx(file, &size);
+    CloseHandle(file);
+
+    if (sized && size.QuadPart > 0 && size.QuadPart == demo.lastSize) {
+      EmitDemoWatchEvent(host, "demoready", it->first, size.QuadPart, 0);
+      it = host->pending.erase(it);
+      continue;
+    }
+    demo.lastSize = sized ? size.QuadPart : -1;
+    demo.lastChange = now;
+    ++it;
+  }
+}
+
+// Watcher thread: services every folder's completions and the pending checks
+void DemoWatchThreadMain(DemoWatchHost* host) {
+  ULONGLONG lastCheck = GetTickCount64();
+  for (;;) {
+    DWORD timeout = host->pending.empty() ? INFINITE : DEMO_WATCH_POLL_MS;
+    DWORD bytes = 0;
+    ULONG_PTR key = DEMO_WATCH_STOP_KEY;
+    OVERLAPPED* overlapped = nullptr;
+    BOOL ok = GetQueuedCompletionStatus(host->port, &bytes, &key, &overlapped, timeout);
+    DWORD error = ok ? 0 : GetLastError();
+
+    if (overlapped) {
+      DemoWatchFolder* folder = host->folders[key - 1];
+      folder->reading = false;
+      if (!ok) {
+        // Folder deleted, renamed or unmounted; it stays unwatched until the next start
+        EmitDemoWatchEvent(host, "error", folder->path, -1, error);
+      } else {
+        if (bytes == 0) {
+          // Notification buffer overflowed: changes were lost, JS rescans the folder
+          EmitDemoWatchEvent(host, "overflow", folder->path, -1, 0);
+        } else {
+          HandleDirectoryChanges(host, folder, bytes);
+        }
+        if (!QueueDirectoryRead(host, folder)) {
+          EmitDemoWatchEvent(host, "error", folder->path, -1, GetLastError());
+        }
+      }
+    } else if (ok && key == DEMO_WATCH_STOP_KEY) {
+      break;
+    } else if (!ok && error != WAIT_TIMEOUT) {
+      break; // Port closed
+    }
+
+    ULONGLONG now = GetTickCount64();
+    if (!host->pending.empty() && now - lastCheck >= DEMO_WATCH_POLL_MS) {
+      lastCheck = now;
+      CheckPendingDemos(host);
+    }
+  }
+
+  // Cancel outstanding reads and wait for them so no completion targets freed buffers
+  for (DemoWatchFolder* folder : host->folders) {
+    if (folder->reading) {
+      DWORD ignored;
+      CancelIoEx(folder->directory, &folder->overlapped);
+      GetOverlappedResult(folder->directory, &folder->overlapped, &ignored, TRUE);
+    }
+  }
+}
+
+void CloseDemoWatchHandles(DemoWatchHost* host) {
+  for (DemoWatchFolder* folder : host->folders) {
+    CloseHandle(folder->directory);
+    delete folder;
+  }
+  host->folders.clear();
+  if (host->port) {
+    CloseHandle(host->port);
+    host->port = NULL;
+  }
+}
+
+void JoinDemoWatchThread(DemoWatchHost* host) {
+  PostQueuedCompletionStatus(host->port, 0, DEMO_WATCH_STOP_KEY, NULL);
+  host->thread.join();
+  CloseDemoWatchHandles(host);
+  host->addon->demoWatch = nullptr;
+}
+
+// Stop the watcher (JS thread); its thread-safe function's finalizer frees the host
+void StopDemoWatchHost(Cs2WindowTracker* addon) {
+  DemoWatchHost* host = addon->demoWatch;
+  if (!host) {
+    return;
+  }
+  JoinDemoWatchThread(host);
+  host->tsfn.Release();
+}
+
+// startDemoWatcher(folders: string[], cb: (event: { type, path, size?, error? }) => void,
+//   options?: { recursive?: boolean, settleMs?: number }): number
+// Watches the folders for .dem files and replaces a previous watcher. Event types:
+//   'demoready'   a demo was created or changed, is closed and its size is stable (size set)
+//   'demoremoved' a demo was deleted or renamed away
+//   'overflow'    too many changes at once in folder `path`; rescan it
+//   'error'       folder `path` can no longer be watched (Win32 `error`)
+// Demos already present at start are not reported. Returns how many folders are
+// being watched; folders that cannot be opened are skipped.
+Napi::Value StartDemoWatcher(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (string[] folders, function callback)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bool recursive = false;
+  DWORD settleMs = DEMO_WATCH_DEFAULT_SETTLE_MS;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Get("recursive").IsBoolean()) {
+      recursive = options.Get("recursive").As<Napi::Boolean>().Value();
+    }
+    if (options.Get("settleMs").IsNumber()) {
+      settleMs = static_cast<DWORD>(std::max(0, options.Get("settleMs").As<Napi::Number>().Int32Value()));
+    }
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  StopDemoWatchHost(addon);
+
+  HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+  if (!port) {
+    std::string errorMsg = "Failed to create completion port. Error code: " + std::to_string(GetLastError());
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  DemoWatchHost* host = new DemoWatchHost();
+  host->addon = addon;
+  host->port = port;
+  host->recursive = recursive;
+  host->settleMs = settleMs;
+
+  Napi::Array folders = info[0].As<Napi::Array>();
+  for (uint32_t i = 0; i < folders.Length(); i++) {
+    Napi::Value value = folders.Get(i);
+    if (!value.IsString()) {
+      continue;
+    }
+    std::u16string utf16 = value.As<Napi::String>().Utf16Value();
+    std::wstring path(utf16.begin(), utf16.end());
+    while (path.size() > 3 && (path.back() == L'\\' || path.back() == L'/')) {
+      path.pop_back();
+    }
+
+    HANDLE directory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (directory == INVALID_HANDLE_VALUE) {
+      continue;
+    }
+    ULONG_PTR key = host->folders.size() + 1;
+    if (!CreateIoCompletionPort(directory, port, key, 0)) {
+      CloseHandle(directory);
+      continue;
+    }
+
+    DemoWatchFolder* folder = new DemoWatchFolder();
+    folder->path = path;
+    folder->directory = directory;
+    folder->buffer.resize(DEMO_WATCH_BUFFER_BYTES / sizeof(DWORD));
+    folder->reading = false;
+    host->folders.push_back(folder);
+    if (!QueueDirectoryRead(host, folder)) {
+      host->folders.pop_back();
+      CloseHandle(directory);
+      delete folder;
+    }
+  }
+
+  if (host->folders.empty()) {
+    CloseDemoWatchHandles(host);
+    delete host;
+    return Napi::Number::New(env, 0);
+  }
+
+  host->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2DemoWatcher",
+    0,
+    1,
+    [](Napi::Env, DemoWatchHost* finalized) {
+      // Environment teardown without stopDemoWatcher(): the thread is still running
+      if (finalized->addon->demoWatch == finalized) {
+        JoinDemoWatchThread(finalized);
+      }
+      delete finalized;
+    },
+    host
+  );
+  addon->demoWatch = host;
+  host->thread = std::thread(DemoWatchThreadMain, host);
+
+  return Napi::Number::New(env, static_cast<double>(host->folders.size()));
+}
+
+// stopDemoWatcher(): void
+Napi::Value StopDemoWatcher(const Napi::CallbackInfo& info) {
+  StopDemoWatchHost(AddonFor(info.Env()));
+  return info.Env().Undefined();
+}
@@ -0,0 +1,240 @@
+// Event records, the batch-mode ring and delivery to JS. Shared by the Windows
+// (cs2_window_tracker.cpp) and macOS (cs2_window_tracker_mac.mm) backends; the
+// platform types below are the only difference between them. Each backend
+// defines HookClockNow() and HookElapsedUs() for its event clock, and its
+// subscriber type (HookTarget / HookHost) provides addon, batchDelivery, ring,
+// wakeupPending and tsfn for DispatchHookEvent().
+#pragma once
+
+#include "hook_events.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HWND HookWindow;
+typedef DWORD HookPid;
+typedef DWORD HookTimestamp; // GetTickCount clock
+typedef RECT HookRect; // Left/top/right/bottom
+typedef LONGLONG HookClockTicks; // QueryPerformanceCounter
+
+inline uint64_t HookWindowBits(HookWindow window) {
+  return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(window));
+}
+inline int32_t HookRectX(const HookRect& rect) { return rect.left; }
+inline int32_t HookRectY(const HookRect& rect) { return rect.top; }
+inline int32_t HookRectWidth(const HookRect& rect) { return rect.right - rect.left; }
+inline int32_t HookRectHeight(const HookRect& rect) { return rect.bottom - rect.top; }
+#else
+#include <CoreGraphics/CoreGraphics.h>
+struct IntRect {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+};
+
+typedef CGWindowID HookWindow;
+typedef uint32_t HookPid;
+typedef uint32_t HookTimestamp; // Uptime in ms
+typedef IntRect HookRect;
+typedef uint64_t HookClockTicks; // Microseconds, CLOCK_UPTIME_RAW
+
+inline uint64_t HookWindowBits(HookWindow window) {
+  return window;
+}
+inline int32_t HookRectX(const HookRect& rect) { return rect.x; }
+inline int32_t HookRectY(const HookRect& rect) { return rect.y; }
+inline int32_t HookRectWidth(const HookRect& rect) { return rect.width; }
+inline int32_t HookRectHeight(const HookRect& rect) { return rect.height; }
+#endif
+
+// Event clock of the backend; HookEvent.origin is a reading of it
+HookClockTicks HookClockNow();
+uint64_t HookElapsedUs(HookClockTicks origin, HookClockTicks now);
+
+// Compact event record. Plain data so it can be copied across threads and
+// stored in the event ring.
+struct HookEvent {
+  HookEventCode code;
+  HookWindow hwnd; // HWND, or CGWindowID on macOS
+  HookPid pid; // Foreground PID (foreground/focus), new DPI (monitorchanged) or the target PID
+  HookTimestamp timestamp; // OS event time in ms
+  HookRect bounds; // Client rect on screen (boundschanged) or monitor work area (monitorchanged)
+  HookClockTicks origin; // HookClockNow() when the source event was raised, for latency stats
+};
+
+// Fixed-size single-producer/single-consumer ring of event records.
+// The hook thread pushes, the JS thread drains; neither side takes a lock.
+#define EVENT_RING_CAPACITY 1024 // Must be a power of two
+
+struct EventRing {
+  HookEvent records[EVENT_RING_CAPACITY];
+  std::atomic<uint32_t> head; // Next slot to write (producer only)
+  std::atomic<uint32_t> tail; // Next slot to read (consumer only)
+  std::atomic<uint64_t> dropped; // Records discarded because the ring was full
+};
+
+// Push from the producer thread. Drops the record if the consumer has fallen
+// a full ring behind rather than blocking the hook thread.
+inline bool EventRingPush(EventRing* ring, const HookEvent& event, HookCounters& counters) {
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  if (head - tail >= EVENT_RING_CAPACITY) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  ring->records[head & (EVENT_RING_CAPACITY - 1)] = event;
+  ring->head.store(head + 1, std::memory_order_release);
+  AtomicStoreMax(counters.maxQueueDepth, head + 1 - tail);
+  return true;
+}
+
+// Build the JS object handed to the callback
+inline Napi::Object HookEventToObject(Napi::Env env, const HookEvent& event) {
+  Napi::Object eventObj = Napi::Object::New(env);
+  eventObj.Set("type", Napi::String::New(env, kHookEventNames[event.code]));
+  eventObj.Set("hwnd", Napi::BigInt::New(env, static_cast<int64_t>(HookWindowBits(event.hwnd))));
+  eventObj.Set("timestamp", Napi::Number::New(env, event.timestamp));
+  if (event.code == HOOK_EVENT_FOREGROUND || IsFocusTransition(event.code)) {
+    eventObj.Set("pid", Napi::Number::New(env, event.pid));
+  }
+  if (event.code == HOOK_EVENT_MONITORCHANGED) {
+    Napi::Object workArea = Napi::Object::New(env);
+    workArea.Set("x", Napi::Number::New(env, HookRectX(event.bounds)));
+    workArea.Set("y", Napi::Number::New(env, HookRectY(event.bounds)));
+    workArea.Set("width", Napi::Number::New(env, HookRectWidth(event.bounds)));
+    workArea.Set("height", Napi::Number::New(env, HookRectHeight(event.bounds)));
+    eventObj.Set("dpi", Napi::Number::New(env, event.pid));
+    eventObj.Set("workArea", workArea);
+  }
+  if (event.code == HOOK_EVENT_BOUNDSCHANGED) {
+    eventObj.Set("x", Napi::Number::New(env, HookRectX(event.bounds)));
+    eventObj.Set("y", Napi::Number::New(env, HookRectY(event.bounds)));
+    eventObj.Set("width", Napi::Number::New(env, HookRectWidth(event.bounds)));
+    eventObj.Set("height", Napi::Number::New(env, HookRectHeight(event.bounds)));
+  }
+  return eventObj;
+}
+
+// An event reached JS: record how long it took since the OS raised it
+inline void RecordDeliveryLatency(HookCounters& counters, const HookEvent& event, HookClockTicks now) {
+  uint64_t us = HookElapsedUs(event.origin, now);
+  RecordLatencyUs(counters.deliveryLatency, us);
+  if (event.code == HOOK_EVENT_BOUNDSCHANGED) {
+    RecordLatencyUs(counters.boundsLatency, us);
+  }
+}
+
+// Batch mode: tell JS that records are waiting. At most one signal is in
+// flight; it is re-armed right before the callback runs, so records pushed
+// while JS drains always produce a new signal.
+template <typename Subscriber>
+void SignalEventsPending(Subscriber* subscriber) {
+  if (subscriber->wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  napi_status status = subscriber->tsfn.NonBlockingCall(subscriber,
+    [](Napi::Env env, Napi::Function jsCallback, Subscriber* data) {
+      data->wakeupPending.store(false, std::memory_order_release);
+      if (env != nullptr && jsCallback != nullptr) {
+        jsCallback.Call({});
+      }
+    });
+  if (status != napi_ok) {
+    subscriber->wakeupPending.store(false, std::memory_order_release);
+  }
+}
+
+// Deliver an event to a subscriber's JS side: pushed to its ring (batch mode) or
+// queued via its thread-safe function, so the hook thread never waits on the JS thread
+template <typename Subscriber>
+void DispatchHookEvent(Subscriber* subscriber, const HookEvent& event) {
+  HookCounters* counters = &subscriber->addon->hookCounters;
+
+  // Delivered counts only events that were queued; a full ring counts as dropped
+  if (subscriber->batchDelivery) {
+    if (EventRingPush(subscriber->ring, event, *counters)) {
+      CountDelivered(*counters, event.code);
+      SignalEventsPending(subscriber);
+    }
+    return;
+  }
+
+  HookEvent* queued = new HookEvent(event);
+  AtomicStoreMax(counters->maxQueueDepth, counters->queueDepth.fetch_add(1, std::memory_order_relaxed) + 1);
+  napi_status status = subscriber->tsfn.NonBlockingCall(queued,
+    [counters](Napi::Env env, Napi::Function jsCallback, HookEvent* data) {
+      counters->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+      if (env != nullptr && jsCallback != nullptr) {
+        RecordDeliveryLatency(*counters, *data, HookClockNow());
+        jsCallback.Call({ HookEventToObject(env, *data) });
+      }
+      delete data;
+    });
+  if (status != napi_ok) {
+    counters->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    delete queued; // Queue closing (subscription being stopped)
+    return;
+  }
+  CountDelivered(*counters, event.code);
+}
+
+// drainEvents() argument: a BigInt64Array or Uint32Array. Throws and returns
+// false for anything else.
+inline bool ReadDrainBuffer(const Napi::CallbackInfo& info, Napi::TypedArray* out) {
+  if (info.Length() >= 1 && info[0].IsTypedArray()) {
+    *out = info[0].As<Napi::TypedArray>();
+    napi_typedarray_type arrayType = out->TypedArrayType();
+    if (arrayType == napi_bigint64_array || arrayType == napi_uint32_array) {
+      return true;
+    }
+  }
+  Napi::TypeError::New(info.Env(), "Expected BigInt64Array or Uint32Array").ThrowAsJavaScriptException();
+  return false;
+}
+
+// Copy pending records into a drainEvents() buffer without allocating and
+// return how many were written (EVENT_RECORD_STRIDE_* slots each)
+inline size_t DrainEventRing(EventRing* ring, Napi::TypedArray array, HookCounters& counters) {
+  napi_typedarray_type arrayType = array.TypedArrayType();
+  size_t stride = arrayType == napi_bigint64_array ? EVENT_RECORD_STRIDE_BIGINT64 : EVENT_RECORD_STRIDE_UINT32;
+  size_t capacity = array.ElementLength() / stride;
+
+  uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  uint32_t head = ring->head.load(std::memory_order_acquire);
+  size_t count = std::min<size_t>(head - tail, capacity);
+
+  uint8_t* base = static_cast<uint8_t*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+  HookClockTicks now = HookClockNow();
+  for (size_t i = 0; i < count; i++) {
+    const HookEvent& event = ring->records[(tail + i) & (EVENT_RING_CAPACITY - 1)];
+    RecordDeliveryLatency(counters, event, now);
+    uint64_t hwndBits = HookWindowBits(event.hwnd);
+    if (arrayType == napi_bigint64_array) {
+      int64_t* out = reinterpret_cast<int64_t*>(base) + i * stride;
+      out[0] = event.code;
+      out[1] = static_cast<int64_t>(hwndBits);
+      out[2] = event.pid;
+      out[3] = event.timestamp;
+      out[4] = HookRectX(event.bounds);
+      out[5] = HookRectY(event.bounds);
+      out[6] = HookRectWidth(event.bounds);
+      out[7] = HookRectHeight(event.bounds);
+    } else {
+      uint32_t* out = reinterpret_cast<uint32_t*>(base) + i * stride;
+      out[0] = event.code;
+      out[1] = static_cast<uint32_t>(hwndBits);
+      out[2] = static_cast<uint32_t>(hwndBits >> 32);
+      out[3] = event.pid;
+      out[4] = event.timestamp;
+      out[5] = static_cast<uint32_t>(HookRectX(event.bounds));
+      out[6] = static_cast<uint32_t>(HookRectY(event.bounds));
+      out[7] = static_cast<uint32_t>(HookRectWidth(event.bounds));
+      out[8] = static_cast<uint32_t>(HookRectHeight(event.bounds));
+    }
+  }
+
+  ring->tail.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+  return count;
+}
@@ -0,0 +1,246 @@
+// Hook event codes, counters and the window state block layout. Shared by the
+// Windows (cs2_window_tracker.cpp) and macOS (cs2_window_tracker_mac.mm)
+// backends so both deliver identical events, records and stats to index.ts.
+#pragma once
+
+#include <napi.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Event codes shared with the JS side (WinEventCode in index.ts)
+enum HookEventCode : uint32_t {
+  HOOK_EVENT_NONE = 0, // Unmapped OS event (stats only, never delivered)
+  HOOK_EVENT_LOCATIONCHANGE = 1,
+  HOOK_EVENT_BOUNDSCHANGED = 2,
+  HOOK_EVENT_MOVESTART = 3,
+  HOOK_EVENT_MOVEEND = 4,
+  HOOK_EVENT_MINIMIZESTART = 5,
+  HOOK_EVENT_MINIMIZEEND = 6,
+  HOOK_EVENT_DESTROY = 7,
+  HOOK_EVENT_FOREGROUND = 8,
+  HOOK_EVENT_PROCESSEXIT = 9,
+  // Focus state machine transitions (targets started with an overlayPid)
+  HOOK_EVENT_CS2FOCUSED = 10,
+  HOOK_EVENT_OVERLAYFOCUSED = 11,
+  HOOK_EVENT_LOSTFOCUS = 12,
+  HOOK_EVENT_MINIMIZED = 13,
+  HOOK_EVENT_RESTORED = 14,
+  HOOK_EVENT_MONITORCHANGED = 15,
+  HOOK_EVENT_CLOAKED = 16,
+  HOOK_EVENT_UNCLOAKED = 17,
+};
+
+// Event type strings for callback delivery, indexed by HookEventCode
+static const char* const kHookEventNames[] = {
+  "",
+  "locationchange",
+  "boundschanged",
+  "movestart",
+  "moveend",
+  "minimizestart",
+  "minimizeend",
+  "destroy",
+  "foreground",
+  "processexit",
+  "cs2-focused",
+  "overlay-focused",
+  "lost-focus",
+  "minimized",
+  "restored",
+  "monitorchanged",
+  "cloaked",
+  "uncloaked",
+};
+
+#define HOOK_EVENT_CODE_COUNT (sizeof(kHookEventNames) / sizeof(kHookEventNames[0]))
+#define LATENCY_BUCKET_COUNT 24 // Bucket i counts latencies below 2^(i+1) us (and at least 2^i, except bucket 0)
+
+// Slots per record written by drainEvents
+#define EVENT_RECORD_STRIDE_BIGINT64 8 // [code, hwnd, pid, timestamp, x, y, width, height]
+#define EVENT_RECORD_STRIDE_UINT32 9 // [code, hwndLo, hwndHi, pid, timestamp, x, y, width, height]
+
+// Window state block: an ArrayBuffer of Int32 slots that the hook thread keeps
+// current so JS can read bounds/minimized/foreground/DPI/cloak state as plain
+// memory instead of one native call per query. Slot layout is mirrored in
+// index.ts (WindowStateSlot).
+//
+// Consistency uses a sequence lock: the writer makes the sequence odd, writes
+// the fields, then makes it even again. Readers retry if the sequence was odd
+// or changed while they read.
+//
+// Electron runs V8 with the memory cage, which rejects external ArrayBuffers,
+// so the buffer is allocated by V8 and kept alive by a persistent reference;
+// its backing store never moves, so the raw pointer stays valid.
+enum WindowStateSlot {
+  STATE_SLOT_SEQUENCE = 0,
+  STATE_SLOT_VALID = 1, // 1 while a target window is tracked and exists
+  STATE_SLOT_X = 2, // Client rect on screen (physical pixels)
+  STATE_SLOT_Y = 3,
+  STATE_SLOT_WIDTH = 4,
+  STATE_SLOT_HEIGHT = 5,
+  STATE_SLOT_MINIMIZED = 6,
+  STATE_SLOT_FOREGROUND_PID = 7,
+  STATE_SLOT_DPI = 8, // Raw DPI (96 = 100%)
+  STATE_SLOT_CLOAKED = 9, // DWMWA_CLOAKED != 0 (e.g. on another virtual desktop)
+  STATE_SLOT_COUNT = 10,
+};
+
+// Log2 histogram of event latencies in microseconds. Updated from the hook
+// and JS threads with relaxed atomics; readers only need a rough snapshot.
+struct LatencyHistogram {
+  std::atomic<uint32_t> buckets[LATENCY_BUCKET_COUNT];
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> totalUs;
+  std::atomic<uint64_t> maxUs;
+};
+
+struct HookTypeCounters {
+  std::atomic<uint64_t> raw;
+  std::atomic<uint64_t> filtered;
+  std::atomic<uint64_t> delivered;
+  std::atomic<uint64_t> coalesced;
+};
+
+// Callback counters and latencies, written by the hook thread and read by getHookStats()
+struct HookCounters {
+  std::atomic<uint64_t> raw; // Every OS hook/notification callback
+  std::atomic<uint64_t> filtered; // Dropped natively (wrong object/process/window, unhandled event)
+  std::atomic<uint64_t> delivered; // Events queued for JS; a full ring counts in dropped instead
+  std::atomic<uint64_t> coalesced; // Location changes absorbed because the client rect did not change
+  HookTypeCounters byType[HOOK_EVENT_CODE_COUNT]; // Raw/filtered/coalesced by source event, delivered by emitted event
+  std::atomic<uint32_t> queueDepth; // Hook-thread callback mode: queued calls not yet run on the JS thread
+  std::atomic<uint32_t> maxQueueDepth; // Deepest ring / thread-safe function queue seen
+  LatencyHistogram deliveryLatency; // OS event time -> event handed to JS
+  LatencyHistogram boundsLatency; // OS event time -> overlay repositioned (follow mode) or boundschanged handed to JS
+};
+
+template <typename T>
+void AtomicStoreMax(std::atomic<T>& target, T value) {
+  T current = target.load(std::memory_order_relaxed);
+  while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+inline void RecordLatencyUs(LatencyHistogram& histogram, uint64_t us) {
+  size_t bucket = 0;
+  while (bucket + 1 < LATENCY_BUCKET_COUNT && (us >> (bucket + 1)) != 0) {
+    bucket++;
+  }
+
+  histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+  histogram.totalUs.fetch_add(us, std::memory_order_relaxed);
+  AtomicStoreMax(histogram.maxUs, us);
+}
+
+inline void ResetLatencyHistogram(LatencyHistogram& histogram) {
+  for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+    histogram.buckets[i].store(0, std::memory_order_relaxed);
+  }
+  histogram.count.store(0, std::memory_order_relaxed);
+  histogram.totalUs.store(0, std::memory_order_relaxed);
+  histogram.maxUs.store(0, std::memory_order_relaxed);
+}
+
+inline void ResetHookCounters(HookCounters& counters) {
+  counters.raw.store(0, std::memory_order_relaxed);
+  counters.filtered.store(0, std::memory_order_relaxed);
+  counters.delivered.store(0, std::memory_order_relaxed);
+  counters.coalesced.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < HOOK_EVENT_CODE_COUNT; i++) {
+    counters.byType[i].raw.store(0, std::memory_order_relaxed);
+    counters.byType[i].filtered.store(0, std::memory_order_relaxed);
+    counters.byType[i].delivered.store(0, std::memory_order_relaxed);
+    counters.byType[i].coalesced.store(0, std::memory_order_relaxed);
+  }
+  counters.maxQueueDepth.store(counters.queueDepth.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  ResetLatencyHistogram(counters.deliveryLatency);
+  ResetLatencyHistogram(counters.boundsLatency);
+}
+
+inline void CountRaw(HookCounters& counters, HookEventCode code) {
+  counters.raw.fetch_add(1, std::memory_order_relaxed);
+  counters.byType[code].raw.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void CountFiltered(HookCounters& counters, HookEventCode code) {
+  counters.filtered.fetch_add(1, std::memory_order_relaxed);
+  counters.byType[code].filtered.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void CountCoalesced(HookCounters& counters, HookEventCode code) {
+  counters.coalesced.fetch_add(1, std::memory_order_relaxed);
+  counters.byType[code].coalesced.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void CountDelivered(HookCounters& counters, HookEventCode code) {
+  counters.delivered.fetch_add(1, std::memory_order_relaxed);
+  counters.byType[code].delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline bool IsFocusTransition(uint32_t code) {
+  return code == HOOK_EVENT_CS2FOCUSED || code == HOOK_EVENT_OVERLAYFOCUSED || code == HOOK_EVENT_LOSTFOCUS;
+}
+
+inline Napi::Object LatencyHistogramToObject(Napi::Env env, const LatencyHistogram& histogram) {
+  Napi::Object result = Napi::Object::New(env);
+  uint64_t count = histogram.count.load(std::memory_order_relaxed);
+  uint64_t totalUs = histogram.totalUs.load(std::memory_order_relaxed);
+  result.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+  result.Set("meanUs", Napi::Number::New(env, count ? static_cast<double>(totalUs) / count : 0));
+  result.Set("maxUs", Napi::Number::New(env, static_cast<double>(histogram.maxUs.load(std::memory_order_relaxed))));
+
+  // Percentiles resolve to the upper bound of the bucket they fall in
+  Napi::Array buckets = Napi::Array::New(env, LATENCY_BUCKET_COUNT);
+  const double percentiles[] = { 0.5, 0.95, 0.99 };
+  const char* const percentileNames[] = { "p50Us", "p95Us", "p99Us" };
+  double percentileValues[] = { 0, 0, 0 };
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+    uint32_t bucketCount = histogram.buckets[i].load(std::memory_order_relaxed);
+    buckets.Set(static_cast<uint32_t>(i), Napi::Number::New(env, bucketCount));
+    uint64_t before = seen;
+    seen += bucketCount;
+    for (size_t p = 0; p < 3; p++) {
+      double rank = percentiles[p] * count;
+      if (bucketCount && before < rank && seen >= rank) {
+        percentileValues[p] = static_cast<double>(1ull << (i + 1));
+      }
+    }
+  }
+  for (size_t p = 0; p < 3; p++) {
+    result.Set(percentileNames[p], Napi::Number::New(env, percentileValues[p]));
+  }
+  result.Set("buckets", buckets);
+  return result;
+}
+
+// getHookStats() result: { raw, filtered, delivered, coalesced, dropped, maxQueueDepth, byType, latency }
+inline Napi::Object HookCountersToObject(Napi::Env env, const HookCounters& hookCounters, uint64_t dropped) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("raw", Napi::Number::New(env, static_cast<double>(hookCounters.raw.load(std::memory_order_relaxed))));
+  result.Set("filtered", Napi::Number::New(env, static_cast<double>(hookCounters.filtered.load(std::memory_order_relaxed))));
+  result.Set("delivered", Napi::Number::New(env, static_cast<double>(hookCounters.delivered.load(std::memory_order_relaxed))));
+  result.Set("coalesced", Napi::Number::New(env, static_cast<double>(hookCounters.coalesced.load(std::memory_order_relaxed))));
+  result.Set("dropped", Napi::Number::New(env, static_cast<double>(dropped)));
+  result.Set("maxQueueDepth", Napi::Number::New(env, hookCounters.maxQueueDepth.load(std::memory_order_relaxed)));
+
+  Napi::Object byType = Napi::Object::New(env);
+  for (size_t code = HOOK_EVENT_LOCATIONCHANGE; code < HOOK_EVENT_CODE_COUNT; code++) {
+    const HookTypeCounters& counters = hookCounters.byType[code];
+    Napi::Object typeStats = Napi::Object::New(env);
+    typeStats.Set("raw", Napi::Number::New(env, static_cast<double>(counters.raw.load(std::memory_order_relaxed))));
+    typeStats.Set("filtered", Napi::Number::New(env, static_cast<double>(counters.filtered.load(std::memory_order_relaxed))));
+    typeStats.Set("delivered", Napi::Number::New(env, static_cast<double>(counters.delivered.load(std::memory_order_relaxed))));
+    typeStats.Set("coalesced", Napi::Number::New(env, static_cast<double>(counters.coalesced.load(std::memory_order_relaxed))));
+    byType.Set(kHookEventNames[code], typeStats);
+  }
+  result.Set("byType", byType);
+
+  Napi::Object latency = Napi::Object::New(env);
+  latency.Set("delivery", LatencyHistogramToObject(env, hookCounters.deliveryLatency));
+  latency.Set("bounds", LatencyHistogramToObject(env, hookCounters.boundsLatency));
+  result.Set("latency", latency);
+  return result;
+}
@@ -0,0 +1,729 @@
+#include "addon.h"
+#include <winsqlite/winsqlite3.h>
+
+// Match database reader: read-only SQLite connections to the parser's match
+// databases through the system's winsqlite3, so JS never copies a whole
+// .sqlite into memory to query it. Pages are read through a memory map with a
+// small page cache on top. Connections stay open in a small LRU pool, each
+// with its prepared statements, until closeMatchDbs() closes them; Windows
+// cannot delete or truncate a file SQLite holds open or mapped. holdMatchDbs()
+// also keeps workers from reopening a path until releaseMatchDbs(), so a
+// query queued meanwhile cannot map the file again before JS rewrites it.
+#define MATCH_DB_MAX_IDLE 8 // Idle connections kept open, least recently used closed first
+#define MATCH_DB_MAX_STATEMENTS 32 // Prepared statements cached per connection
+#define MATCH_DB_MMAP_BYTES (256LL * 1024 * 1024) // Larger than any match database
+#define MATCH_DB_CACHE_KIB 512 // Page cache per connection
+#define MATCH_DB_BUSY_TIMEOUT_MS 2000 // How long a read waits out a writer's lock
+#define MATCH_DB_BUSY_SLEEP_MS 5 // Between lock attempts, so an interrupt is seen quickly
+#define MATCH_DB_HOLD_TIMEOUT_MS 200 // How long holdMatchDbs() waits for interrupted queries
+#define MATCH_DB_MAX_THREADS 8
+#define MATCH_DB_MAX_SAFE_INTEGER 9007199254740991LL // Number.MAX_SAFE_INTEGER; larger INTEGERs come back as BigInt
+
+struct MatchDbConnection {
+  std::string path; // UTF-8, as given by JS
+  sqlite3* db;
+  std::map<std::string, sqlite3_stmt*> statements; // Keyed by SQL text
+  bool discard; // closeMatchDbs() ran while it was in use: close on release
+  std::atomic<bool> interrupted; // holdMatchDbs() wants the file: stop, including waits on locks
+};
+
+struct MatchDbPool {
+  std::mutex mutex;
+  std::condition_variable changed; // A connection was released or opened, or a hold ended
+  std::vector<MatchDbConnection*> idle; // Guarded by mutex; least recently used first
+  std::vector<MatchDbConnection*> busy; // Guarded by mutex; checked out by a worker thread
+  std::vector<std::string> opening; // Guarded by mutex; paths a worker is opening outside the lock
+  std::vector<std::string> held; // Guarded by mutex; one entry per holdMatchDbs() not yet released
+
+  ~MatchDbPool();
+};
+
+// A bound parameter or a result cell
+struct SqlValue {
+  int type; // SQLITE_INTEGER, SQLITE_FLOAT, SQLITE_TEXT, SQLITE_BLOB or SQLITE_NULL
+  int64_t integer;
+  double real;
+  std::string bytes; // TEXT (UTF-8) or BLOB
+};
+
+struct MatchDbQuery {
+  std::string sql;
+  std::vector<SqlValue> params;
+};
+
+// One result column. Stays a plain double array while every value is numeric
+// or NULL (NaN), which is what most match tables hold.
+struct MatchDbColumn {
+  std::string name;
+  bool numeric;
+  std::vector<double> numbers;
+  std::vector<SqlValue> cells; // Once a TEXT or BLOB value shows up
+};
+
+struct MatchDbQueryResult {
+  std::string error;
+  std::vector<MatchDbColumn> columns;
+  size_t rowCount;
+};
+
+// Every query of one request, run on one connection
+struct MatchDbRequest {
+  std::string path;
+  std::vector<MatchDbQuery> queries;
+  std::string error; // The database could not be opened; no results then
+  std::vector<MatchDbQueryResult> results;
+};
+
+void CloseMatchDbConnection(MatchDbConnection* connection) {
+  for (auto& entry : connection->statements) {
+    sqlite3_finalize(entry.second);
+  }
+  sqlite3_close(connection->db);
+  delete connection;
+}
+
+MatchDbPool::~MatchDbPool() {
+  // Busy connections hold a reference to the pool, so none are left here
+  for (MatchDbConnection* connection : idle) {
+    CloseMatchDbConnection(connection);
+  }
+}
+
+std::shared_ptr<MatchDbPool> CreateMatchDbPool() {
+  return std::make_shared<MatchDbPool>();
+}
+
+// sqlite3_busy_timeout in short sleeps, giving up at once on an interrupted
+// connection (sqlite3_interrupt alone does not end a wait on a lock)
+int MatchDbBusyHandler(void* context, int attempts) {
+  MatchDbConnection* connection = static_cast<MatchDbConnection*>(context);
+  if (connection->interrupted.load(std::memory_order_relaxed) ||
+      attempts >= MATCH_DB_BUSY_TIMEOUT_MS / MATCH_DB_BUSY_SLEEP_MS) {
+    return 0;
+  }
+  Sleep(MATCH_DB_BUSY_SLEEP_MS);
+  return 1;
+}
+
+MatchDbConnection* OpenMatchDb(const std::string& path, std::string* error) {
+  sqlite3* db = nullptr;
+  // NOMUTEX: a connection is only ever used by the worker thread that checked it out
+  int rc = sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+  if (rc != SQLITE_OK) {
+    *error = db ? sqlite3_errmsg(db) : sqlite3_errstr(rc);
+    sqlite3_close(db);
+    return nullptr;
+  }
+
+  MatchDbConnection* connection = new MatchDbConnection();
+  connection->path = path;
+  connection->db = db;
+  connection->discard = false;
+  connection->interrupted.store(false, std::memory_order_relaxed);
+
+  sqlite3_busy_handler(db, MatchDbBusyHandler, connection);
+  // query_only also refuses writes a caller's SQL filter let through
+  std::string pragmas = "PRAGMA mmap_size=" + std::to_string(MATCH_DB_MMAP_BYTES) +
+    "; PRAGMA cache_size=-" + std::to_string(MATCH_DB_CACHE_KIB) +
+    "; PRAGMA temp_store=MEMORY; PRAGMA query_only=1";
+  sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, nullptr);
+  return connection;
+}
+
+bool IsMatchDbHeld(MatchDbPool* pool, const std::string& path) {
+  return std::find(pool->held.begin(), pool->held.end(), path) != pool->held.end();
+}
+
+// An idle connection to `path`, or a new one. Waits out a hold for up to
+// MATCH_DB_BUSY_TIMEOUT_MS, like a read waits out a writer's lock. Worker threads only.
+MatchDbConnection* AcquireMatchDb(MatchDbPool* pool, const std::string& path, std::string* error) {
+  std::unique_lock<std::mutex> lock(pool->mutex);
+  for (;;) {
+    if (!pool->changed.wait_for(lock, std::chrono::milliseconds(MATCH_DB_BUSY_TIMEOUT_MS),
+                                [pool, &path]() { return !IsMatchDbHeld(pool, path); })) {
+      *error = "Database is being rewritten";
+      return nullptr;
+    }
+    for (size_t i = pool->idle.size(); i-- > 0;) {
+      if (pool->idle[i]->path == path) {
+        MatchDbConnection* connection = pool->idle[i];
+        pool->idle.erase(pool->idle.begin() + i);
+        pool->busy.push_back(connection);
+        return connection;
+      }
+    }
+
+    // Opening takes a while; holdMatchDbs() waits for it instead of missing it
+    pool->opening.push_back(path);
+    lock.unlock();
+    MatchDbConnection* connection = OpenMatchDb(path, error);
+    lock.lock();
+    pool->opening.erase(std::find(pool->opening.begin(), pool->opening.end(), path));
+    pool->changed.notify_all();
+    if (!connection) {
+      return nullptr;
+    }
+    if (!IsMatchDbHeld(pool, path)) {
+      pool->busy.push_back(connection);
+      return connection;
+    }
+    // Held while opening: the holder expects the file closed once it returns
+    CloseMatchDbConnection(connection);
+  }
+}
+
+void ReleaseMatchDb(MatchDbPool* pool, MatchDbConnection* connection) {
+  MatchDbConnection* evicted = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->busy.erase(std::find(pool->busy.begin(), pool->busy.end(), connection));
+    if (!connection->discard) {
+      pool->idle.push_back(connection);
+      connection = nullptr;
+      if (pool->idle.size() > MATCH_DB_MAX_IDLE) {
+        evicted = pool->idle.front();
+        pool->idle.erase(pool->idle.begin());
+      }
+    } else {
+      // A holder may be waiting for this file to close; do it before waking it
+      CloseMatchDbConnection(connection);
+      pool->changed.notify_all();
+    }
+  }
+
+  // sqlite3_close unmaps and closes the file; keep it outside the lock
+  if (evicted) {
+    CloseMatchDbConnection(evicted);
+  }
+}
+
+// Close the connections to `paths` (every connection when null). One in use
+// by a running query is closed as soon as that query is done. `hold`: keep
+// `paths` closed until ReleaseMatchDbPaths(), interrupt running queries on
+// them and wait (up to MATCH_DB_HOLD_TIMEOUT_MS) for those and for opens to
+// finish. False if that wait timed out.
+bool CloseMatchDbConnections(MatchDbPool* pool, const std::vector<std::string>* paths, bool hold) {
+  std::vector<MatchDbConnection*> closing;
+  bool closed = true;
+  {
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    auto listed = [paths](const std::string& path) {
+      return !paths || std::find(paths->begin(), paths->end(), path) != paths->end();
+    };
+    auto matches = [&listed](MatchDbConnection* connection) {
+      return listed(connection->path);
+    };
+    if (hold) {
+      pool->held.insert(pool->held.end(), paths->begin(), paths->end());
+    }
+    for (size_t i = pool->idle.size(); i-- > 0;) {
+      if (matches(pool->idle[i])) {
+        closing.push_back(pool->idle[i]);
+        pool->idle.erase(pool->idle.begin() + i);
+      }
+    }
+    for (MatchDbConnection* connection : pool->busy) {
+      if (matches(connection)) {
+        connection->discard = true;
+        if (hold) {
+          // Busy connections are closed under the mutex, so db is still open here
+          connection->interrupted.store(true, std::memory_order_relaxed);
+          sqlite3_interrupt(connection->db);
+        }
+      }
+    }
+    if (hold) {
+      closed = pool->changed.wait_for(lock, std::chrono::milliseconds(MATCH_DB_HOLD_TIMEOUT_MS), [&]() {
+        return std::none_of(pool->busy.begin(), pool->busy.end(), matches) &&
+          std::none_of(pool->opening.begin(), pool->opening.end(), listed);
+      });
+    }
+  }
+
+  for (MatchDbConnection* connection : closing) {
+    CloseMatchDbConnection(connection);
+  }
+  return closed;
+}
+
+// End one hold on each of `paths`; workers waiting to open them go ahead
+void ReleaseMatchDbPaths(MatchDbPool* pool, const std::vector<std::string>& paths) {
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  for (const std::string& path : paths) {
+    auto found = std::find(pool->held.begin(), pool->held.end(), path);
+    if (found != pool->held.end()) {
+      pool->held.erase(found);
+    }
+  }
+  pool->changed.notify_all();
+}
+
+// The connection's cached statement for `sql`, prepared on first use
+sqlite3_stmt* PrepareMatchDbStatement(MatchDbConnection* connection, const std::string& sql, std::string* error) {
+  auto found = connection->statements.find(sql);
+  if (found != connection->statements.end()) {
+    return found->second;
+  }
+
+  sqlite3_stmt* statement = nullptr;
+  if (sqlite3_prepare_v3(connection->db, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &statement, nullptr) != SQLITE_OK) {
+    *error = sqlite3_errmsg(connection->db);
+    return nullptr;
+  }
+  if (!statement) {
+    *error = "Empty statement";
+    return nullptr;
+  }
+  if (!sqlite3_stmt_readonly(statement)) {
+    sqlite3_finalize(statement);
+    *error = "Only read-only statements are allowed";
+    return nullptr;
+  }
+
+  // Ad-hoc queries would otherwise grow the cache without bound
+  if (connection->statements.size() >= MATCH_DB_MAX_STATEMENTS) {
+    for (auto& entry : connection->statements) {
+      sqlite3_finalize(entry.second);
+    }
+    connection->statements.clear();
+  }
+  connection->statements[sql] = statement;
+  return statement;
+}
+
+int BindSqlValue(sqlite3_stmt* statement, int index, const SqlValue& value) {
+  switch (value.type) {
+    case SQLITE_INTEGER:
+      return sqlite3_bind_int64(statement, index, value.integer);
+    case SQLITE_FLOAT:
+      return sqlite3_bind_double(statement, index, value.real);
+    case SQLITE_TEXT:
+      return sqlite3_bind_text(statement, index, value.bytes.data(), static_cast<int>(value.bytes.size()), SQLITE_TRANSIENT);
+    case SQLITE_BLOB:
+      return sqlite3_bind_blob(statement, index, value.bytes.data(), static_cast<int>(value.bytes.size()), SQLITE_TRANSIENT);
+    default:
+      return sqlite3_bind_null(statement, index);
+  }
+}
+
+bool IsSafeMatchDbInteger(int64_t value) {
+  return value >= -MATCH_DB_MAX_SAFE_INTEGER && value <= MATCH_DB_MAX_SAFE_INTEGER;
+}
+
+// Append the current row's value of column `index`, leaving the numeric
+// representation once the first TEXT or BLOB value, or an INTEGER a double
+// cannot hold exactly (a Steam ID, say), arrives
+void AppendMatchDbValue(MatchDbColumn* column, sqlite3_stmt* statement, int index) {
+  int type = sqlite3_column_type(statement, index);
+  if (column->numeric) {
+    if (type == SQLITE_FLOAT || type == SQLITE_NULL ||
+        (type == SQLITE_INTEGER && IsSafeMatchDbInteger(sqlite3_column_int64(statement, index)))) {
+      column->numbers.push_back(type == SQLITE_NULL ? NAN : sqlite3_column_double(statement, index));
+      return;
+    }
+
+    column->numeric = false;
+    column->cells.reserve(column->numbers.size() + 1);
+    for (double number : column->numbers) {
+      column->cells.push_back({ std::isnan(number) ? SQLITE_NULL : SQLITE_FLOAT, 0, number, std::string() });
+    }
+    column->numbers.clear();
+    column->numbers.shrink_to_fit();
+  }
+
+  SqlValue cell = { type, 0, 0, std::string() };
+  if (type == SQLITE_INTEGER) {
+    cell.integer = sqlite3_column_int64(statement, index);
+  } else if (type == SQLITE_FLOAT) {
+    cell.real = sqlite3_column_double(statement, index);
+  } else if (type == SQLITE_TEXT || type == SQLITE_BLOB) {
+    const void* data = type == SQLITE_TEXT ? static_cast<const void*>(sqlite3_column_text(statement, index)) : sqlite3_column_blob(statement, index);
+    int length = sqlite3_column_bytes(statement, index);
+    if (data && length > 0) {
+      cell.bytes.assign(static_cast<const char*>(data), static_cast<size_t>(length));
+    }
+  }
+  column->cells.push_back(std::move(cell));
+}
+
+void RunMatchDbQuery(MatchDbConnection* connection, const MatchDbQuery& query, MatchDbQueryResult* result) {
+  result->rowCount = 0;
+  sqlite3_stmt* statement = PrepareMatchDbStatement(connection, query.sql, &result->error);
+  if (!statement) {
+    return;
+  }
+
+  for (size_t i = 0; i < query.params.size(); i++) {
+    if (BindSqlValue(statement, static_cast<int>(i) + 1, query.params[i]) != SQLITE_OK) {
+      result->error = sqlite3_errmsg(connection->db);
+      sqlite3_clear_bindings(statement);
+      return;
+    }
+  }
+
+  int columnCount = sqlite3_column_count(statement);
+  result->columns.resize(columnCount);
+  for (int c = 0; c < columnCount; c++) {
+    const char* name = sqlite3_column_name(statement, c);
+    result->columns[c].name = name ? name : "";
+    result->columns[c].numeric = true;
+  }
+
+  int rc;
+  while ((rc = sqlite3_step(statement)) == SQLITE_ROW) {
+    for (int c = 0; c < columnCount; c++) {
+      AppendMatchDbValue(&result->columns[c], statement, c);
+    }
+    result->rowCount++;
+  }
+  if (rc != SQLITE_DONE) {
+    result->error = sqlite3_errmsg(connection->db);
+    result->columns.clear();
+    result->rowCount = 0;
+  }
+
+  // Cached statements must not keep a read transaction (and its lock) open
+  sqlite3_reset(statement);
+  sqlite3_clear_bindings(statement);
+}
+
+void RunMatchDbRequest(MatchDbPool* pool, MatchDbRequest* request) {
+  MatchDbConnection* connection = AcquireMatchDb(pool, request->path, &request->error);
+  if (!connection) {
+    return;
+  }
+  request->results.resize(request->queries.size());
+  for (size_t i = 0; i < request->queries.size(); i++) {
+    // sqlite3_interrupt only stops statements already running
+    if (connection->interrupted.load(std::memory_order_relaxed)) {
+      request->results[i].error = "Database is being rewritten";
+      request->results[i].rowCount = 0;
+      continue;
+    }
+    RunMatchDbQuery(connection, request->queries[i], &request->results[i]);
+  }
+  ReleaseMatchDb(pool, connection);
+}
+
+Napi::Value SqlValueToJs(Napi::Env env, const SqlValue& value) {
+  switch (value.type) {
+    case SQLITE_INTEGER:
+      if (!IsSafeMatchDbInteger(value.integer)) {
+        return Napi::BigInt::New(env, value.integer);
+      }
+      return Napi::Number::New(env, static_cast<double>(value.integer));
+    case SQLITE_FLOAT:
+      return Napi::Number::New(env, value.real);
+    case SQLITE_TEXT:
+      return Napi::String::New(env, value.bytes);
+    case SQLITE_BLOB:
+      return Napi::Buffer<char>::Copy(env, value.bytes.data(), value.bytes.size());
+    default:
+      return env.Null();
+  }
+}
+
+// { columns: string[], rowCount, values: Array<Float64Array | unknown[]> }, column-major
+Napi::Object MatchDbResultToObject(Napi::Env env, const MatchDbQueryResult& result) {
+  Napi::Object object = Napi::Object::New(env);
+  Napi::Array columns = Napi::Array::New(env, result.columns.size());
+  Napi::Array values = Napi::Array::New(env, result.columns.size());
+  for (size_t c = 0; c < result.columns.size(); c++) {
+    const MatchDbColumn& column = result.columns[c];
+    columns.Set(static_cast<uint32_t>(c), Napi::String::New(env, column.name));
+    if (column.numeric) {
+      Napi::Float64Array numbers = Napi::Float64Array::New(env, column.numbers.size());
+      if (!column.numbers.empty()) {
+        memcpy(numbers.Data(), column.numbers.data(), column.numbers.size() * sizeof(double));
+      }
+      values.Set(static_cast<uint32_t>(c), numbers);
+    } else {
+      Napi::Array cells = Napi::Array::New(env, column.cells.size());
+      for (size_t r = 0; r < column.cells.size(); r++) {
+        cells.Set(static_cast<uint32_t>(r), SqlValueToJs(env, column.cells[r]));
+      }
+      values.Set(static_cast<uint32_t>(c), cells);
+    }
+  }
+  object.Set("columns", columns);
+  object.Set("rowCount", Napi::Number::New(env, static_cast<double>(result.rowCount)));
+  object.Set("values", values);
+  return object;
+}
+
+// Runs every request on up to MATCH_DB_MAX_THREADS threads; results keep the input order.
+// `single`: one request with one query, whose error rejects the promise.
+class MatchDbWorker : public Napi::AsyncWorker {
+public:
+  MatchDbWorker(Napi::Env env, std::shared_ptr<MatchDbPool> pool, bool single)
+    : Napi::AsyncWorker(env, "cs2MatchDbQuery"), pool(std::move(pool)), single(single), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+  std::vector<MatchDbRequest> requests;
+
+protected:
+  void Execute() override {
+    size_t threadCount = std::min<size_t>(requests.size(),
+      std::max<size_t>(1, std::min<size_t>(MATCH_DB_MAX_THREADS, std::thread::hardware_concurrency())));
+    if (threadCount <= 1) {
+      for (MatchDbRequest& request : requests) {
+        RunMatchDbRequest(pool.get(), &request);
+      }
+    } else {
+      std::atomic<size_t> next(0);
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([this, &next]() {
+          for (size_t i = next.fetch_add(1); i < requests.size(); i = next.fetch_add(1)) {
+            RunMatchDbRequest(pool.get(), &requests[i]);
+          }
+        });
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+
+    if (single) {
+      const MatchDbRequest& request = requests[0];
+      if (!request.error.empty()) {
+        SetError(request.error);
+      } else if (!request.results[0].error.empty()) {
+        SetError(request.results[0].error);
+      }
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    if (single) {
+      deferred.Resolve(MatchDbResultToObject(env, requests[0].results[0]));
+      return;
+    }
+
+    Napi::Array array = Napi::Array::New(env, requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      const MatchDbRequest& request = requests[i];
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("path", Napi::String::New(env, request.path));
+      if (!request.error.empty()) {
+        entry.Set("error", Napi::String::New(env, request.error));
+      }
+      Napi::Array results = Napi::Array::New(env, request.results.size());
+      for (size_t q = 0; q < request.results.size(); q++) {
+        const MatchDbQueryResult& result = request.results[q];
+        if (result.error.empty()) {
+          results.Set(static_cast<uint32_t>(q), MatchDbResultToObject(env, result));
+        } else {
+          Napi::Object failed = Napi::Object::New(env);
+          failed.Set("error", Napi::String::New(env, result.error));
+          results.Set(static_cast<uint32_t>(q), failed);
+        }
+      }
+      entry.Set("results", results);
+      array.Set(static_cast<uint32_t>(i), entry);
+    }
+    deferred.Resolve(array);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  std::shared_ptr<MatchDbPool> pool;
+  bool single;
+  Napi::Promise::Deferred deferred;
+};
+
+// Convert JS parameters on the JS thread. Numbers that are safe integers bind as INTEGER.
+bool ReadSqlParams(Napi::Env env, Napi::Value value, std::vector<SqlValue>* params) {
+  if (value.IsUndefined() || value.IsNull()) {
+    return true;
+  }
+  if (!value.IsArray()) {
+    Napi::TypeError::New(env, "Expected params to be an array").ThrowAsJavaScriptException();
+    return false;
+  }
+
+  Napi::Array array = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value param = array.Get(i);
+    SqlValue bound = { SQLITE_NULL, 0, 0, std::string() };
+    if (param.IsNumber()) {
+      double number = param.As<Napi::Number>().DoubleValue();
+      if (std::floor(number) == number && std::fabs(number) <= 9007199254740991.0) {
+        bound.type = SQLITE_INTEGER;
+        bound.integer = static_cast<int64_t>(number);
+      } else {
+        bound.type = SQLITE_FLOAT;
+        bound.real = number;
+      }
+    } else if (param.IsBigInt()) {
+      bool lossless;
+      bound.type = SQLITE_INTEGER;
+      bound.integer = param.As<Napi::BigInt>().Int64Value(&lossless);
+    } else if (param.IsBoolean()) {
+      bound.type = SQLITE_INTEGER;
+      bound.integer = param.As<Napi::Boolean>().Value() ? 1 : 0;
+    } else if (param.IsString()) {
+      bound.type = SQLITE_TEXT;
+      bound.bytes = param.As<Napi::String>().Utf8Value();
+    } else if (param.IsBuffer()) {
+      Napi::Buffer<char> buffer = param.As<Napi::Buffer<char>>();
+      bound.type = SQLITE_BLOB;
+      bound.bytes.assign(buffer.Data(), buffer.Length());
+    } else if (!param.IsNull() && !param.IsUndefined()) {
+      Napi::TypeError::New(env, "Unsupported SQL parameter at index " + std::to_string(i)).ThrowAsJavaScriptException();
+      return false;
+    }
+    params->push_back(std::move(bound));
+  }
+  return true;
+}
+
+// queryMatchDb(path: string, sql: string, params?: unknown[]):
+//   Promise<{ columns: string[], rowCount: number, values: Array<Float64Array | unknown[]> }>
+// Runs one read-only statement on a worker thread. Columns holding only numbers
+// and NULLs come back as Float64Array (NULL is NaN); others as plain arrays,
+// where INTEGERs beyond Number.MAX_SAFE_INTEGER are BigInt.
+// Rejects with SQLite's message if the database cannot be opened or the query fails.
+Napi::Value QueryMatchDb(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "Expected (string path, string sql, params?: array)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  MatchDbQuery query;
+  query.sql = info[1].As<Napi::String>().Utf8Value();
+  if (!ReadSqlParams(env, info.Length() > 2 ? info[2] : env.Undefined(), &query.params)) {
+    return env.Null();
+  }
+
+  MatchDbWorker* worker = new MatchDbWorker(env, AddonFor(env)->matchDbs, true);
+  worker->requests.resize(1);
+  worker->requests[0].path = info[0].As<Napi::String>().Utf8Value();
+  worker->requests[0].queries.push_back(std::move(query));
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+// queryMatchDbs(requests: Array<{ path: string, queries: Array<{ sql: string, params?: unknown[] }> }>):
+//   Promise<Array<{ path, error?, results: Array<result | { error }> }>>
+// Runs each request's queries on one connection, spreading requests over a
+// thread pool. Failures are reported per database and per query, in input order.
+Napi::Value QueryMatchDbs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected array of { path, queries }").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array array = info[0].As<Napi::Array>();
+  std::vector<MatchDbRequest> requests(array.Length());
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value entry = array.Get(i);
+    Napi::Value path = entry.IsObject() ? entry.As<Napi::Object>().Get("path") : env.Undefined();
+    Napi::Value queries = entry.IsObject() ? entry.As<Napi::Object>().Get("queries") : env.Undefined();
+    if (!path.IsString() || !queries.IsArray()) {
+      Napi::TypeError::New(env, "Expected { path: string, queries: array } at index " + std::to_string(i)).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    MatchDbRequest& request = requests[i];
+    request.path = path.As<Napi::String>().Utf8Value();
+    Napi::Array queryArray = queries.As<Napi::Array>();
+    request.queries.resize(queryArray.Length());
+    for (uint32_t q = 0; q < queryArray.Length(); q++) {
+      Napi::Value query = queryArray.Get(q);
+      Napi::Value sql = query.IsObject() ? query.As<Napi::Object>().Get("sql") : env.Undefined();
+      if (!sql.IsString()) {
+        Napi::TypeError::New(env, "Expected { sql: string, params?: array }").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      request.queries[q].sql = sql.As<Napi::String>().Utf8Value();
+      if (!ReadSqlParams(env, query.As<Napi::Object>().Get("params"), &request.queries[q].params)) {
+        return env.Null();
+      }
+    }
+  }
+
+  MatchDbWorker* worker = new MatchDbWorker(env, AddonFor(env)->matchDbs, false);
+  worker->requests = std::move(requests);
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
+
+void ReadMatchDbPaths(Napi::Array array, std::vector<std::string>* paths) {
+  for (uint32_t i = 0; i < array.Length(); i++) {
+    Napi::Value path = array.Get(i);
+    if (path.IsString()) {
+      paths->push_back(path.As<Napi::String>().Utf8Value());
+    }
+  }
+}
+
+// closeMatchDbs(paths?: string[]): void
+// Closes pooled connections to these databases (all when omitted) so they can
+// be deleted or rewritten. One in use by a running query closes when it finishes.
+Napi::Value CloseMatchDbs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) {
+    CloseMatchDbConnections(addon->matchDbs.get(), nullptr, false);
+    return env.Undefined();
+  }
+  if (!info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected string[] paths").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<std::string> paths;
+  ReadMatchDbPaths(info[0].As<Napi::Array>(), &paths);
+  CloseMatchDbConnections(addon->matchDbs.get(), &paths, false);
+  return env.Undefined();
+}
+
+// holdMatchDbs(paths: string[]): boolean
+// Closes pooled connections to these databases and keeps queries from
+// reopening them until releaseMatchDbs(paths); queries meanwhile wait, then fail.
+// Running queries on them are interrupted (and fail), so this blocks for
+// milliseconds at most; false if they still had not stopped after
+// MATCH_DB_HOLD_TIMEOUT_MS.
+Napi::Value HoldMatchDbs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected string[] paths").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<std::string> paths;
+  ReadMatchDbPaths(info[0].As<Napi::Array>(), &paths);
+  return Napi::Boolean::New(env, CloseMatchDbConnections(AddonFor(env)->matchDbs.get(), &paths, true));
+}
+
+// releaseMatchDbs(paths: string[]): void
+// Ends a holdMatchDbs() on these databases
+Napi::Value ReleaseMatchDbs(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected string[] paths").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<std::string> paths;
+  ReadMatchDbPaths(info[0].As<Napi::Array>(), &paths);
+  ReleaseMatchDbPaths(AddonFor(env)->matchDbs.get(), paths);
+  return env.Undefined();
+}
@@ -0,0 +1,815 @@
+#include "addon.h"
+
+// NDJSON reader: decodes a child process' newline-delimited JSON output on its
+// own thread. JS creates the reader, opens its pipe for writing and hands that
+// descriptor to the child as stdout, so the output never reaches the JS thread
+// as chunks to split and parse. Lines are split and each object's top-level
+// scalar fields decoded with an SSE2 scanner; records go to JS in batches with
+// at most one call in flight, so a chatty child costs one callback per JS turn
+// instead of one per line.
+#define NDJSON_CONNECT_TIMEOUT_MS 15000 // How long the pipe waits for its writer
+#define NDJSON_READ_BYTES (64 * 1024)
+#define NDJSON_MAX_LINE_BYTES (1024 * 1024) // Longer lines are reported cut to this length, as invalid
+#define NDJSON_MAX_PENDING_RECORDS 4096 // Reading pauses, and the writer blocks, while JS is this far behind
+#define NDJSON_MAX_DEPTH 64 // Deeper nesting is rejected as invalid
+
+enum NdjsonValueType {
+  NDJSON_VALUE_NULL,
+  NDJSON_VALUE_BOOL,
+  NDJSON_VALUE_NUMBER,
+  NDJSON_VALUE_STRING,
+};
+
+// A top-level scalar field of a record. Nested objects and arrays are
+// validated but not decoded; the line has them when asked for.
+struct NdjsonField {
+  std::string key;
+  NdjsonValueType type;
+  double number; // NUMBER; BOOL as 0/1
+  std::string text; // STRING, unescaped
+};
+
+struct NdjsonRecord {
+  bool valid; // The line was a JSON object; otherwise only `line` is set
+  std::vector<NdjsonField> fields;
+  std::string line; // Only kept when lines are requested, or the line was invalid
+  uint32_t coalesced; // Earlier records of the same type this one replaced before delivery
+};
+
+struct NdjsonReader {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  uint32_t id;
+  HANDLE pipe;
+  HANDLE stopEvent; // Set by stopNdjsonReader()
+  std::atomic<bool> stopping;
+  bool keepLines;
+  std::vector<std::string> coalesceTypes; // A record of these types replaces an undelivered one just before it
+  std::mutex mutex;
+  std::condition_variable drained; // JS took the pending batch, or a stop
+  std::vector<NdjsonRecord> pending; // Guarded by mutex
+  bool deliveryQueued; // Guarded by mutex: a batch call is queued and has not run yet
+  // Reader thread only
+  std::string partial; // Start of a line whose newline has not arrived yet
+  bool partialTruncated;
+  uint64_t bytes;
+  uint64_t lines;
+  uint64_t invalidLines;
+  DWORD error;
+  Napi::ThreadSafeFunction tsfn;
+};
+
+#if NATIVE_SSE2
+unsigned LowestSetBit(int mask) {
+  unsigned long index;
+  _BitScanForward(&index, static_cast<unsigned long>(mask));
+  return index;
+}
+#endif
+
+// First `c` in [cursor, end), or end
+const char* FindNdjsonByte(const char* cursor, const char* end, char c) {
+#if NATIVE_SSE2
+  __m128i needle = _mm_set1_epi8(c);
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+    if (mask) {
+      return cursor + LowestSetBit(mask);
+    }
+  }
+#endif
+  for (; cursor < end; cursor++) {
+    if (*cursor == c) {
+      return cursor;
+    }
+  }
+  return end;
+}
+
+// First byte inside a string that ends the plain run: '"', '\\' or a control
+// character (which JSON forbids unescaped), or end
+const char* FindJsonStringSpecial(const char* cursor, const char* end) {
+#if NATIVE_SSE2
+  __m128i quote = _mm_set1_epi8('"');
+  __m128i backslash = _mm_set1_epi8('\\');
+  __m128i lastControl = _mm_set1_epi8(0x1F);
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+    __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+      _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk)); // chunk <= 0x1F
+    int mask = _mm_movemask_epi8(special);
+    if (mask) {
+      return cursor + LowestSetBit(mask);
+    }
+  }
+#endif
+  for (; cursor < end; cursor++) {
+    unsigned char c = static_cast<unsigned char>(*cursor);
+    if (c == '"' || c == '\\' || c < 0x20) {
+      return cursor;
+    }
+  }
+  return end;
+}
+
+void SkipJsonWhitespace(const char** cursor, const char* end) {
+  while (*cursor < end && (**cursor == ' ' || **cursor == '\t' || **cursor == '\r' || **cursor == '\n')) {
+    (*cursor)++;
+  }
+}
+
+void AppendUtf8(std::string* out, uint32_t codePoint) {
+  if (codePoint < 0x80) {
+    out->push_back(static_cast<char>(codePoint));
+  } else if (codePoint < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else if (codePoint < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+}
+
+bool ReadJsonHex4(const char** cursor, const char* end, uint32_t* value) {
+  if (end - *cursor < 4) {
+    return false;
+  }
+  *value = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = (*cursor)[i];
+    uint32_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    *value = (*value << 4) | digit;
+  }
+  *cursor += 4;
+  return true;
+}
+
+// String starting at the opening quote; unescaped into `out` unless it is null
+bool ReadJsonString(const char** cursor, const char* end, std::string* out) {
+  const char* at = *cursor + 1;
+  for (;;) {
+    const char* stop = FindJsonStringSpecial(at, end);
+    if (out) {
+      out->append(at, stop);
+    }
+    if (stop == end || (*stop != '"' && *stop != '\\')) {
+      return false; // Unterminated, or a raw control character
+    }
+    if (*stop == '"') {
+      *cursor = stop + 1;
+      return true;
+    }
+
+    at = stop + 1;
+    if (at == end) {
+      return false;
+    }
+    char escaped = *at++;
+    char plain;
+    switch (escaped) {
+      case '"': plain = '"'; break;
+      case '\\': plain = '\\'; break;
+      case '/': plain = '/'; break;
+      case 'b': plain = '\b'; break;
+      case 'f': plain = '\f'; break;
+      case 'n': plain = '\n'; break;
+      case 'r': plain = '\r'; break;
+      case 't': plain = '\t'; break;
+      case 'u': {
+        uint32_t codePoint;
+        if (!ReadJsonHex4(&at, end, &codePoint)) {
+          return false;
+        }
+        // A high surrogate followed by a low one is a single code point; a lone one becomes U+FFFD
+        uint32_t low;
+        if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - at >= 6 && at[0] == '\\' && at[1] == 'u') {
+          const char* lowAt = at + 2;
+          if (ReadJsonHex4(&lowAt, end, &low) && low >= 0xDC00 && low < 0xE000) {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            at = lowAt;
+          }
+        }
+        if (out) {
+          AppendUtf8(out, codePoint >= 0xD800 && codePoint < 0xE000 ? 0xFFFD : codePoint);
+        }
+        continue;
+      }
+      default:
+        return false;
+    }
+    if (out) {
+      out->push_back(plain);
+    }
+  }
+}
+
+bool ReadJsonDigits(const char** cursor, const char* end) {
+  const char* start = *cursor;
+  while (*cursor < end && **cursor >= '0' && **cursor <= '9') {
+    (*cursor)++;
+  }
+  return *cursor > start;
+}
+
+// Number per the JSON grammar (no leading zeros, no bare '.', no hex)
+bool ReadJsonNumber(const char** cursor, const char* end, double* out) {
+  const char* start = *cursor;
+  const char* at = start;
+  if (at < end && *at == '-') {
+    at++;
+  }
+  if (at < end && *at == '0') {
+    at++;
+  } else if (!ReadJsonDigits(&at, end)) {
+    return false;
+  }
+  if (at < end && *at == '.') {
+    at++;
+    if (!ReadJsonDigits(&at, end)) {
+      return false;
+    }
+  }
+  if (at < end && (*at == 'e' || *at == 'E')) {
+    at++;
+    if (at < end && (*at == '+' || *at == '-')) {
+      at++;
+    }
+    if (!ReadJsonDigits(&at, end)) {
+      return false;
+    }
+  }
+  if (out) {
+    // The validated text is short; copy it so strtod stops at the number's end
+    char buffer[64];
+    size_t length = std::min<size_t>(static_cast<size_t>(at - start), sizeof(buffer) - 1);
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    *out = strtod(buffer, nullptr);
+  }
+  *cursor = at;
+  return true;
+}
+
+bool ReadJsonLiteral(const char** cursor, const char* end, const char* literal) {
+  size_t length = strlen(literal);
+  if (static_cast<size_t>(end - *cursor) < length || memcmp(*cursor, literal, length) != 0) {
+    return false;
+  }
+  *cursor += length;
+  return true;
+}
+
+// Validate any value without decoding it
+bool SkipJsonValue(const char** cursor, const char* end, int depth) {
+  if (*cursor >= end) {
+    return false;
+  }
+  char c = **cursor;
+  if (c == '"') {
+    return ReadJsonString(cursor, end, nullptr);
+  }
+  if (c == 't') {
+    return ReadJsonLiteral(cursor, end, "true");
+  }
+  if (c == 'f') {
+    return ReadJsonLiteral(cursor, end, "false");
+  }
+  if (c == 'n') {
+    return ReadJsonLiteral(cursor, end, "null");
+  }
+  if (c != '{' && c != '[') {
+    return ReadJsonNumber(cursor, end, nullptr);
+  }
+  if (depth >= NDJSON_MAX_DEPTH) {
+    return false;
+  }
+
+  bool isObject = c == '{';
+  char close = isObject ? '}' : ']';
+  (*cursor)++;
+  SkipJsonWhitespace(cursor, end);
+  if (*cursor < end && **cursor == close) {
+    (*cursor)++;
+    return true;
+  }
+  for (;;) {
+    if (isObject) {
+      if (*cursor >= end || **cursor != '"' || !ReadJsonString(cursor, end, nullptr)) {
+        return false;
+      }
+      SkipJsonWhitespace(cursor, end);
+      if (*cursor >= end || **cursor != ':') {
+        return false;
+      }
+      (*cursor)++;
+      SkipJsonWhitespace(cursor, end);
+    }
+    if (!SkipJsonValue(cursor, end, depth + 1)) {
+      return false;
+    }
+    SkipJsonWhitespace(cursor, end);
+    if (*cursor >= end) {
+      return false;
+    }
+    if (**cursor == close) {
+      (*cursor)++;
+      return true;
+    }
+    if (**cursor != ',') {
+      return false;
+    }
+    (*cursor)++;
+    SkipJsonWhitespace(cursor, end);
+  }
+}
+
+// Decode one line holding a JSON object into its top-level scalar fields. False if it is not one.
+bool DecodeNdjsonObject(const char* begin, const char* end, std::vector<NdjsonField>* fields) {
+  const char* cursor = begin;
+  SkipJsonWhitespace(&cursor, end);
+  if (cursor >= end || *cursor != '{') {
+    return false;
+  }
+  cursor++;
+  SkipJsonWhitespace(&cursor, end);
+  bool closed = cursor < end && *cursor == '}';
+  if (closed) {
+    cursor++;
+  }
+
+  while (!closed) {
+    NdjsonField field = { std::string(), NDJSON_VALUE_NULL, 0, std::string() };
+    if (cursor >= end || *cursor != '"' || !ReadJsonString(&cursor, end, &field.key)) {
+      return false;
+    }
+    SkipJsonWhitespace(&cursor, end);
+    if (cursor >= end || *cursor != ':') {
+      return false;
+    }
+    cursor++;
+    SkipJsonWhitespace(&cursor, end);
+    if (cursor >= end) {
+      return false;
+    }
+
+    bool decoded = true;
+    char c = *cursor;
+    if (c == '"') {
+      field.type = NDJSON_VALUE_STRING;
+      decoded = ReadJsonString(&cursor, end, &field.text);
+    } else if (c == 't' || c == 'f') {
+      field.type = NDJSON_VALUE_BOOL;
+      field.number = c == 't' ? 1 : 0;
+      decoded = ReadJsonLiteral(&cursor, end, c == 't' ? "true" : "false");
+    } else if (c == 'n') {
+      decoded = ReadJsonLiteral(&cursor, end, "null");
+    } else if (c == '{' || c == '[') {
+      if (!SkipJsonValue(&cursor, end, 1)) { // Nested: validated only
+        return false;
+      }
+    } else {
+      field.type = NDJSON_VALUE_NUMBER;
+      decoded = ReadJsonNumber(&cursor, end, &field.number);
+    }
+    if (!decoded) {
+      return false;
+    }
+    if (c != '{' && c != '[') {
+      fields->push_back(std::move(field));
+    }
+
+    SkipJsonWhitespace(&cursor, end);
+    if (cursor >= end) {
+      return false;
+    }
+    if (*cursor == '}') {
+      cursor++;
+      closed = true;
+    } else if (*cursor != ',') {
+      return false;
+    } else {
+      cursor++;
+      SkipJsonWhitespace(&cursor, end);
+    }
+  }
+
+  SkipJsonWhitespace(&cursor, end);
+  return cursor == end;
+}
+
+const std::string* NdjsonRecordType(const NdjsonRecord& record) {
+  for (const NdjsonField& field : record.fields) {
+    if (field.type == NDJSON_VALUE_STRING && field.key == "type") {
+      return &field.text;
+    }
+  }
+  return nullptr;
+}
+
+// Reader thread: decode one complete line (without its newline) into `records`
+void DecodeNdjsonLine(NdjsonReader* reader, const char* begin, const char* end, bool truncated,
+                      std::vector<NdjsonRecord>* records) {
+  while (end > begin && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+    end--;
+  }
+  const char* start = begin;
+  SkipJsonWhitespace(&start, end);
+  if (start == end) {
+    return; // Blank lines carry nothing
+  }
+
+  reader->lines++;
+  NdjsonRecord record;
+  record.coalesced = 0;
+  record.valid = !truncated && DecodeNdjsonObject(start, end, &record.fields);
+  if (!record.valid) {
+    reader->invalidLines++;
+    record.fields.clear();
+  }
+  if (reader->keepLines || !record.valid) {
+    record.line.assign(start, end);
+  }
+  records->push_back(std::move(record));
+}
+
+// Reader thread: split a chunk into lines, carrying an unterminated tail to the next chunk
+void ConsumeNdjsonBytes(NdjsonReader* reader, const char* data, size_t size, std::vector<NdjsonRecord>* records) {
+  reader->bytes += size;
+  const char* cursor = data;
+  const char* end = data + size;
+  while (cursor < end) {
+    const char* newline = FindNdjsonByte(cursor, end, '\n');
+    if (newline == end) {
+      size_t room = NDJSON_MAX_LINE_BYTES - std::min<size_t>(reader->partial.size(), NDJSON_MAX_LINE_BYTES);
+      size_t take = std::min<size_t>(room, static_cast<size_t>(end - cursor));
+      reader->partial.append(cursor, take);
+      reader->partialTruncated = reader->partialTruncated || take < static_cast<size_t>(end - cursor);
+      return;
+    }
+
+    if (reader->partial.empty() && !reader->partialTruncated) {
+      bool truncated = static_cast<size_t>(newline - cursor) > NDJSON_MAX_LINE_BYTES;
+      DecodeNdjsonLine(reader, cursor, truncated ? cursor + NDJSON_MAX_LINE_BYTES : newline, truncated, records);
+    } else {
+      size_t room = NDJSON_MAX_LINE_BYTES - std::min<size_t>(reader->partial.size(), NDJSON_MAX_LINE_BYTES);
+      size_t take = std::min<size_t>(room, static_cast<size_t>(newline - cursor));
+      reader->partial.append(cursor, take);
+      bool truncated = reader->partialTruncated || take < static_cast<size_t>(newline - cursor);
+      DecodeNdjsonLine(reader, reader->partial.data(), reader->partial.data() + reader->partial.size(), truncated, records);
+      reader->partial.clear();
+      reader->partialTruncated = false;
+    }
+    cursor = newline + 1;
+  }
+}
+
+Napi::Array NdjsonRecordsToArray(Napi::Env env, const std::vector<NdjsonRecord>& records) {
+  Napi::Array array = Napi::Array::New(env, records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    const NdjsonRecord& record = records[i];
+    Napi::Object entry = Napi::Object::New(env);
+    if (record.valid) {
+      Napi::Object value = Napi::Object::New(env);
+      for (const NdjsonField& field : record.fields) {
+        switch (field.type) {
+          case NDJSON_VALUE_STRING:
+            value.Set(field.key, Napi::String::New(env, field.text));
+            break;
+          case NDJSON_VALUE_NUMBER:
+            value.Set(field.key, Napi::Number::New(env, field.number));
+            break;
+          case NDJSON_VALUE_BOOL:
+            value.Set(field.key, Napi::Boolean::New(env, field.number != 0));
+            break;
+          default:
+            value.Set(field.key, env.Null());
+            break;
+        }
+      }
+      entry.Set("value", value);
+    } else {
+      entry.Set("value", env.Null());
+    }
+    if (!record.line.empty()) {
+      entry.Set("line", Napi::String::New(env, record.line));
+    }
+    if (record.coalesced) {
+      entry.Set("coalesced", Napi::Number::New(env, record.coalesced));
+    }
+    array.Set(static_cast<uint32_t>(i), entry);
+  }
+  return array;
+}
+
+// JS thread: take the pending batch and let the reader continue
+std::vector<NdjsonRecord> TakeNdjsonBatch(NdjsonReader* reader) {
+  std::vector<NdjsonRecord> batch;
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    batch.swap(reader->pending);
+    reader->deliveryQueued = false;
+  }
+  reader->drained.notify_all();
+  return batch;
+}
+
+// JS thread: stop the reader thread wherever it is blocked. The flag is set
+// under the mutex so a thread between its drained predicate check and the
+// wait cannot miss the notify
+void RequestNdjsonStop(NdjsonReader* reader) {
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    reader->stopping.store(true);
+  }
+  SetEvent(reader->stopEvent);
+  reader->drained.notify_all();
+}
+
+// Reader thread: queue decoded records for JS, folding coalesced types, then
+// wait while JS is too far behind
+void QueueNdjsonRecords(NdjsonReader* reader, std::vector<NdjsonRecord>* records) {
+  if (records->empty()) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(reader->mutex);
+  for (NdjsonRecord& record : *records) {
+    const std::string* type = record.valid && !reader->pending.empty() ? NdjsonRecordType(record) : nullptr;
+    if (type && std::find(reader->coalesceTypes.begin(), reader->coalesceTypes.end(), *type) != reader->coalesceTypes.end()) {
+      NdjsonRecord& previous = reader->pending.back();
+      const std::string* previousType = previous.valid ? NdjsonRecordType(previous) : nullptr;
+      if (previousType && *previousType == *type) {
+        record.coalesced = previous.coalesced + 1;
+        previous = std::move(record);
+        continue;
+      }
+    }
+    reader->pending.push_back(std::move(record));
+  }
+  records->clear();
+
+  bool signal = !reader->deliveryQueued;
+  reader->deliveryQueued = true;
+  lock.unlock();
+
+  if (signal) {
+    napi_status status = reader->tsfn.NonBlockingCall(reader,
+      [](Napi::Env env, Napi::Function jsCallback, NdjsonReader* data) {
+        std::vector<NdjsonRecord> batch = TakeNdjsonBatch(data);
+        if (env != nullptr && jsCallback != nullptr && !batch.empty()) {
+          jsCallback.Call({ NdjsonRecordsToArray(env, batch) });
+        }
+      });
+    if (status != napi_ok) {
+      // Queue closing (environment teardown): nobody will take the batch
+      std::lock_guard<std::mutex> closingLock(reader->mutex);
+      reader->pending.clear();
+      reader->deliveryQueued = false;
+    }
+  }
+
+  lock.lock();
+  reader->drained.wait(lock, [reader]() {
+    return reader->pending.size() < NDJSON_MAX_PENDING_RECORDS || reader->stopping.load();
+  });
+}
+
+// Reader thread: wait for the child to open the pipe (or a stop)
+bool ConnectNdjsonWriter(NdjsonReader* reader, OVERLAPPED* overlapped) {
+  if (!ConnectNamedPipe(reader->pipe, overlapped)) {
+    DWORD error = GetLastError();
+    if (error == ERROR_PIPE_CONNECTED) {
+      return true;
+    }
+    if (error != ERROR_IO_PENDING) {
+      reader->error = error;
+      return false;
+    }
+  }
+
+  HANDLE waits[] = { overlapped->hEvent, reader->stopEvent };
+  DWORD result = WaitForMultipleObjects(2, waits, FALSE, NDJSON_CONNECT_TIMEOUT_MS);
+  DWORD transferred = 0;
+  if (result == WAIT_OBJECT_0) {
+    if (GetOverlappedResult(reader->pipe, overlapped, &transferred, FALSE)) {
+      return true;
+    }
+    reader->error = GetLastError();
+    return false;
+  }
+
+  CancelIoEx(reader->pipe, overlapped);
+  GetOverlappedResult(reader->pipe, overlapped, &transferred, TRUE);
+  if (result == WAIT_TIMEOUT) {
+    reader->error = ERROR_TIMEOUT;
+  }
+  return false;
+}
+
+// Reader thread: read the next chunk. False at EOF (the writer closed), on a stop or an error.
+bool ReadNdjsonChunk(NdjsonReader* reader, OVERLAPPED* overlapped, char* buffer, DWORD* transferred) {
+  ResetEvent(overlapped->hEvent);
+  if (!ReadFile(reader->pipe, buffer, NDJSON_READ_BYTES, NULL, overlapped)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_IO_PENDING) {
+      if (error != ERROR_BROKEN_PIPE) {
+        reader->error = error;
+      }
+      return false;
+    }
+
+    HANDLE waits[] = { overlapped->hEvent, reader->stopEvent };
+    if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+      CancelIoEx(reader->pipe, overlapped);
+      GetOverlappedResult(reader->pipe, overlapped, transferred, TRUE);
+      return false;
+    }
+  }
+
+  if (!GetOverlappedResult(reader->pipe, overlapped, transferred, FALSE)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_BROKEN_PIPE) {
+      reader->error = error;
+    }
+    return false;
+  }
+  return true;
+}
+
+void NdjsonThreadMain(NdjsonReader* reader) {
+  OVERLAPPED overlapped = {};
+  overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  std::vector<NdjsonRecord> records;
+  if (ConnectNdjsonWriter(reader, &overlapped)) {
+    std::vector<char> buffer(NDJSON_READ_BYTES);
+    DWORD transferred = 0;
+    while (!reader->stopping.load() && ReadNdjsonChunk(reader, &overlapped, buffer.data(), &transferred)) {
+      ConsumeNdjsonBytes(reader, buffer.data(), transferred, &records);
+      QueueNdjsonRecords(reader, &records);
+    }
+  }
+  CloseHandle(overlapped.hEvent);
+
+  // A last line without a newline still counts
+  if (!reader->partial.empty()) {
+    DecodeNdjsonLine(reader, reader->partial.data(), reader->partial.data() + reader->partial.size(),
+      reader->partialTruncated, &records);
+    reader->partial.clear();
+  }
+  CloseHandle(reader->pipe);
+  reader->pipe = NULL;
+
+  // Last batch and the end summary in one call, after every earlier batch
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    for (NdjsonRecord& record : records) {
+      reader->pending.push_back(std::move(record));
+    }
+  }
+  Napi::ThreadSafeFunction tsfn = reader->tsfn;
+  tsfn.BlockingCall(reader, [](Napi::Env env, Napi::Function jsCallback, NdjsonReader* ended) {
+    ended->addon->ndjsonReaders.erase(ended->id);
+    std::vector<NdjsonRecord> batch = TakeNdjsonBatch(ended);
+    if (env != nullptr && jsCallback != nullptr) {
+      Napi::Object summary = Napi::Object::New(env);
+      summary.Set("bytes", Napi::Number::New(env, static_cast<double>(ended->bytes)));
+      summary.Set("lines", Napi::Number::New(env, static_cast<double>(ended->lines)));
+      summary.Set("invalidLines", Napi::Number::New(env, static_cast<double>(ended->invalidLines)));
+      summary.Set("error", Napi::Number::New(env, ended->error));
+      jsCallback.Call({ NdjsonRecordsToArray(env, batch), summary });
+    }
+  });
+  tsfn.Release();
+}
+
+// startNdjsonReader(onRecords: (records, end?) => void,
+//   options?: { lines?: boolean, coalesce?: string[] }): { id, pipePath } | null
+// Creates a named pipe at pipePath for a child's stdout: open it for writing
+// (within 15 s), pass the descriptor in the child's stdio and close it. Each
+// record is { value, line?, coalesced? }: value holds the object's top-level
+// strings, numbers, booleans and nulls, or is null if the line was not a JSON
+// object (line is then always set). `lines` keeps every line's text. A record
+// whose "type" is in `coalesce` replaces an undelivered one of the same type
+// right before it. The last call adds end = { bytes, lines, invalidLines, error }
+// once the writer closed the pipe or the reader was stopped.
+Napi::Value StartNdjsonReader(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (function onRecords, options?)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bool keepLines = false;
+  std::vector<std::string> coalesceTypes;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    Napi::Value linesValue = options.Get("lines");
+    keepLines = linesValue.IsBoolean() && linesValue.As<Napi::Boolean>().Value();
+    Napi::Value coalesceValue = options.Get("coalesce");
+    if (coalesceValue.IsArray()) {
+      Napi::Array array = coalesceValue.As<Napi::Array>();
+      for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value type = array.Get(i);
+        if (type.IsString()) {
+          coalesceTypes.push_back(type.As<Napi::String>().Utf8Value());
+        }
+      }
+    }
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  uint32_t id = addon->nextNdjsonReaderId++;
+  std::string pipePath = "\\\\.\\pipe\\cs2-ndjson-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(id);
+  std::wstring widePipePath(pipePath.begin(), pipePath.end());
+  HANDLE pipe = CreateNamedPipeW(widePipePath.c_str(),
+    PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+    PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+    1, 0, NDJSON_READ_BYTES, 0, NULL);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    std::string errorMsg = "Failed to create NDJSON pipe. Error code: " + std::to_string(GetLastError());
+    Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  NdjsonReader* reader = new NdjsonReader();
+  reader->addon = addon;
+  reader->id = id;
+  reader->pipe = pipe;
+  reader->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  reader->stopping.store(false);
+  reader->keepLines = keepLines;
+  reader->coalesceTypes = std::move(coalesceTypes);
+  reader->deliveryQueued = false;
+  reader->partialTruncated = false;
+  reader->bytes = 0;
+  reader->lines = 0;
+  reader->invalidLines = 0;
+  reader->error = 0;
+  reader->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[0].As<Napi::Function>(),
+    "cs2NdjsonReader",
+    0,
+    1,
+    [](Napi::Env, NdjsonReader* finalized) {
+      // The thread has normally released and is exiting; on environment
+      // teardown mid-read it is still running and must be stopped first
+      if (finalized->thread.joinable()) {
+        RequestNdjsonStop(finalized);
+        finalized->thread.join();
+      }
+      finalized->addon->ndjsonReaders.erase(finalized->id);
+      if (finalized->pipe) {
+        CloseHandle(finalized->pipe);
+      }
+      CloseHandle(finalized->stopEvent);
+      delete finalized;
+    },
+    reader
+  );
+  addon->ndjsonReaders[id] = reader;
+  reader->thread = std::thread(NdjsonThreadMain, reader);
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("id", Napi::Number::New(env, id));
+  result.Set("pipePath", Napi::String::New(env, pipePath));
+  return result;
+}
+
+// stopNdjsonReader(id: number): boolean
+// Stops reading; records already decoded and the end summary still follow.
+// Returns false if the id is unknown or the reader already ended.
+Napi::Value StopNdjsonReader(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected reader id").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  auto found = addon->ndjsonReaders.find(info[0].As<Napi::Number>().Uint32Value());
+  if (found == addon->ndjsonReaders.end()) {
+    return Napi::Boolean::New(env, false);
+  }
+  NdjsonReader* reader = found->second;
+  RequestNdjsonStop(reader);
+  return Napi::Boolean::New(env, true);
+}
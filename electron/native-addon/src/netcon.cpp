@@ -0,0 +1,430 @@
+#include <winsock2.h> // Before windows.h, which would pull in the old winsock.h
+#include "addon.h"
+#include <cctype>
+
+// Netcon client: one persistent TCP connection to CS2's -netconport on its own
+// thread. Commands are queued from JS and written back to back without waiting
+// for output; when tick polling is on, the thread sends `demo_goto` itself and
+// parses "Currently playing <tick> of <total> ticks" from the console output,
+// so JS only hears tick changes. Reconnects until stopped, so it can be started
+// before CS2 is up.
+#define NETCON_RECONNECT_MS 1000 // Delay between connection attempts while CS2 is not listening
+#define NETCON_CONNECT_TIMEOUT_MS 3000
+#define NETCON_MAX_LINE_BYTES 4096 // Longer console lines are dropped unparsed
+
+struct NetconClient {
+  Cs2WindowTracker* addon;
+  std::thread thread;
+  uint16_t port;
+  HANDLE wakeEvent; // Auto-reset: commands queued, interval changed or stop requested
+  std::mutex mutex;
+  std::string queued; // Guarded by mutex; newline-terminated commands not yet taken by the thread
+  std::atomic<bool> stopping;
+  std::atomic<bool> connected;
+  std::atomic<uint32_t> tickIntervalMs; // 0: no polling
+  std::atomic<bool> reportNextTick; // Emit the next parsed tick even if unchanged
+  // Netcon thread only
+  std::string incoming; // Partial console line
+  int32_t lastTick;
+  int32_t lastTotalTicks;
+  Napi::ThreadSafeFunction tsfn;
+};
+
+// One event for JS; freed by the TSFN callback
+struct NetconEvent {
+  const char* type;
+  int32_t tick;
+  int32_t totalTicks;
+  int error;
+};
+
+// Netcon thread: hand one event to JS
+void EmitNetconEvent(NetconClient* client, const char* type, int32_t tick, int32_t totalTicks, int error) {
+  NetconEvent* event = new NetconEvent{ type, tick, totalTicks, error };
+  napi_status status = client->tsfn.NonBlockingCall(event,
+    [](Napi::Env env, Napi::Function jsCallback, NetconEvent* event) {
+      if (env != nullptr && jsCallback != nullptr) {
+        Napi::Object payload = Napi::Object::New(env);
+        payload.Set("type", Napi::String::New(env, event->type));
+        if (strcmp(event->type, "tick") == 0) {
+          payload.Set("tick", Napi::Number::New(env, event->tick));
+          payload.Set("totalTicks", Napi::Number::New(env, event->totalTicks));
+        } else if (event->error) {
+          payload.Set("error", Napi::Number::New(env, event->error));
+        }
+        jsCallback.Call({ payload });
+      }
+      delete event;
+    });
+  if (status != napi_ok) {
+    delete event; // Queue closing (client being torn down)
+  }
+}
+
+// Netcon thread: match `word` case-insensitively, then at least one blank if
+// `blankAfter`. Returns the position after it, or nullptr.
+const char* MatchNetconWord(const char* cursor, const char* word, bool blankAfter) {
+  for (; *word; word++, cursor++) {
+    if (tolower(static_cast<unsigned char>(*cursor)) != *word) {
+      return nullptr;
+    }
+  }
+  if (!blankAfter) {
+    return cursor;
+  }
+  if (!isspace(static_cast<unsigned char>(*cursor))) {
+    return nullptr;
+  }
+  while (isspace(static_cast<unsigned char>(*cursor))) {
+    cursor++;
+  }
+  return cursor;
+}
+
+// Netcon thread: pick the tick out of a demo_goto status line, matched like
+// /Currently\s+playing\s+(\d+)\s+of/i; the total after "of" is kept when present
+void ParseNetconLine(NetconClient* client, const std::string& line) {
+  const char* text = line.c_str();
+  for (const char* start = text; *start; start++) {
+    if (tolower(static_cast<unsigned char>(*start)) != 'c') {
+      continue;
+    }
+    const char* cursor = MatchNetconWord(start, "currently", true);
+    cursor = cursor ? MatchNetconWord(cursor, "playing", true) : nullptr;
+    if (!cursor || !isdigit(static_cast<unsigned char>(*cursor))) {
+      continue;
+    }
+    char* end;
+    long tick = strtol(cursor, &end, 10);
+    if (end == cursor || !isspace(static_cast<unsigned char>(*end))) {
+      continue;
+    }
+    cursor = end;
+    while (isspace(static_cast<unsigned char>(*cursor))) {
+      cursor++;
+    }
+    cursor = MatchNetconWord(cursor, "of", false);
+    if (!cursor) {
+      continue;
+    }
+
+    long totalTicks = client->lastTotalTicks;
+    while (isspace(static_cast<unsigned char>(*cursor))) {
+      cursor++;
+    }
+    if (isdigit(static_cast<unsigned char>(*cursor))) {
+      totalTicks = strtol(cursor, &end, 10);
+    }
+    if (tick != client->lastTick || totalTicks != client->lastTotalTicks || client->reportNextTick.exchange(false)) {
+      client->lastTick = static_cast<int32_t>(tick);
+      client->lastTotalTicks = static_cast<int32_t>(totalTicks);
+      EmitNetconEvent(client, "tick", client->lastTick, client->lastTotalTicks, 0);
+    }
+    return;
+  }
+}
+
+// Netcon thread: read everything available and split it into lines. False once the peer closed.
+bool ReadNetconOutput(NetconClient* client, SOCKET sock) {
+  char buffer[4096];
+  for (;;) {
+    int received = recv(sock, buffer, sizeof(buffer), 0);
+    if (received == 0) {
+      return false;
+    }
+    if (received == SOCKET_ERROR) {
+      return WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+    for (int i = 0; i < received; i++) {
+      char c = buffer[i];
+      if (c == '\n' || c == '\r' || c == '\0') {
+        if (!client->incoming.empty()) {
+          ParseNetconLine(client, client->incoming);
+          client->incoming.clear();
+        }
+      } else if (client->incoming.size() < NETCON_MAX_LINE_BYTES) {
+        client->incoming.push_back(c);
+      }
+    }
+  }
+}
+
+// Netcon thread: write as much of `pending` as the socket takes. False on a socket error.
+bool FlushNetconOutput(SOCKET sock, std::string* pending) {
+  while (!pending->empty()) {
+    int sent = send(sock, pending->data(), static_cast<int>(pending->size()), 0);
+    if (sent == SOCKET_ERROR) {
+      return WSAGetLastError() == WSAEWOULDBLOCK; // FD_WRITE wakes us to retry
+    }
+    pending->erase(0, static_cast<size_t>(sent));
+  }
+  return true;
+}
+
+// Netcon thread: non-blocking connect, so a stop is never held up by SYN retries
+bool ConnectNetcon(NetconClient* client, SOCKET sock, WSAEVENT socketEvent) {
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(client->port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+    return true;
+  }
+  if (WSAGetLastError() != WSAEWOULDBLOCK) {
+    return false;
+  }
+
+  HANDLE waits[2] = { socketEvent, client->wakeEvent };
+  ULONGLONG deadline = GetTickCount64() + NETCON_CONNECT_TIMEOUT_MS;
+  while (!client->stopping.load()) {
+    ULONGLONG now = GetTickCount64();
+    if (now >= deadline) {
+      return false;
+    }
+    DWORD result = WaitForMultipleObjects(2, waits, FALSE, static_cast<DWORD>(deadline - now));
+    if (result != WAIT_OBJECT_0) {
+      continue; // Woken (commands are only accepted once connected) or timed out
+    }
+    WSANETWORKEVENTS events;
+    if (WSAEnumNetworkEvents(sock, socketEvent, &events) != 0) {
+      return false;
+    }
+    if (events.lNetworkEvents & FD_CONNECT) {
+      return events.iErrorCode[FD_CONNECT_BIT] == 0;
+    }
+  }
+  return false;
+}
+
+// Netcon thread: one connected session, until the peer goes away or a stop
+void RunNetconSession(NetconClient* client, SOCKET sock, WSAEVENT socketEvent) {
+  HANDLE waits[2] = { socketEvent, client->wakeEvent };
+  std::string pending;
+  ULONGLONG nextPoll = GetTickCount64();
+  client->lastTick = -1;
+  client->lastTotalTicks = -1;
+  client->incoming.clear();
+
+  while (!client->stopping.load()) {
+    {
+      std::lock_guard<std::mutex> lock(client->mutex);
+      pending += client->queued;
+      client->queued.clear();
+    }
+    uint32_t interval = client->tickIntervalMs.load();
+    ULONGLONG now = GetTickCount64();
+    if (interval && now >= nextPoll) {
+      pending += "demo_goto\n";
+      nextPoll = now + interval;
+    }
+    if (!FlushNetconOutput(sock, &pending)) {
+      return;
+    }
+
+    DWORD timeout = interval ? static_cast<DWORD>(nextPoll > now ? nextPoll - now : 0) : INFINITE;
+    if (WaitForMultipleObjects(2, waits, FALSE, timeout) != WAIT_OBJECT_0) {
+      continue;
+    }
+    WSANETWORKEVENTS events;
+    if (WSAEnumNetworkEvents(sock, socketEvent, &events) != 0) {
+      return;
+    }
+    if ((events.lNetworkEvents & (FD_READ | FD_CLOSE)) && !ReadNetconOutput(client, sock)) {
+      return;
+    }
+    if (events.lNetworkEvents & FD_CLOSE) {
+      return;
+    }
+  }
+}
+
+void NetconThreadMain(NetconClient* client) {
+  WSADATA wsaData;
+  if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+    EmitNetconEvent(client, "error", 0, 0, WSAGetLastError());
+    return;
+  }
+
+  while (!client->stopping.load()) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    WSAEVENT socketEvent = WSACreateEvent();
+    bool ready = sock != INVALID_SOCKET && socketEvent != WSA_INVALID_EVENT &&
+      WSAEventSelect(sock, socketEvent, FD_CONNECT | FD_READ | FD_WRITE | FD_CLOSE) == 0;
+
+    if (ready && ConnectNetcon(client, sock, socketEvent)) {
+      BOOL noDelay = TRUE; // Commands are tiny and latency-sensitive
+      setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+      client->connected.store(true);
+      EmitNetconEvent(client, "connected", 0, 0, 0);
+      RunNetconSession(client, sock, socketEvent);
+      client->connected.store(false);
+      {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->queued.clear(); // Meant for the session that just ended
+      }
+      EmitNetconEvent(client, "disconnected", 0, 0, 0);
+    }
+
+    if (socketEvent != WSA_INVALID_EVENT) {
+      WSACloseEvent(socketEvent);
+    }
+    if (sock != INVALID_SOCKET) {
+      closesocket(sock);
+    }
+    if (!client->stopping.load()) {
+      WaitForSingleObject(client->wakeEvent, NETCON_RECONNECT_MS);
+    }
+  }
+
+  WSACleanup();
+}
+
+void JoinNetconThread(NetconClient* client) {
+  client->stopping.store(true);
+  SetEvent(client->wakeEvent);
+  client->thread.join();
+  CloseHandle(client->wakeEvent);
+  client->addon->netcon = nullptr;
+}
+
+// Stop the client (JS thread); its thread-safe function's finalizer frees it
+void StopNetconHost(Cs2WindowTracker* addon) {
+  NetconClient* client = addon->netcon;
+  if (!client) {
+    return;
+  }
+  JoinNetconThread(client);
+  client->tsfn.Release();
+}
+
+// startNetconClient(port: number, cb: (event: { type, tick?, totalTicks?, error? }) => void,
+//   options?: { tickIntervalMs?: number }): boolean
+// Keeps a connection to 127.0.0.1:port, reconnecting every second while CS2 is
+// not listening. Event types: 'connected', 'disconnected', 'tick' (tick, totalTicks;
+// only when the demo tick changed) and 'error' (Winsock unavailable). Replaces a
+// previous client.
+Napi::Value StartNetconClient(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (number port, function callback)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  int32_t port = info[0].As<Napi::Number>().Int32Value();
+  if (port <= 0 || port > 65535) {
+    Napi::RangeError::New(env, "Port out of range").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  uint32_t tickIntervalMs = 0;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Value interval = info[2].As<Napi::Object>().Get("tickIntervalMs");
+    if (interval.IsNumber()) {
+      tickIntervalMs = static_cast<uint32_t>(std::max(0, interval.As<Napi::Number>().Int32Value()));
+    }
+  }
+
+  Cs2WindowTracker* addon = AddonFor(env);
+  StopNetconHost(addon);
+
+  NetconClient* client = new NetconClient();
+  client->addon = addon;
+  client->port = static_cast<uint16_t>(port);
+  client->wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+  client->stopping.store(false);
+  client->connected.store(false);
+  client->tickIntervalMs.store(tickIntervalMs);
+  client->reportNextTick.store(false);
+  client->lastTick = -1;
+  client->lastTotalTicks = -1;
+  if (!client->wakeEvent) {
+    delete client;
+    Napi::Error::New(env, "Failed to create netcon wake event").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  client->tsfn = Napi::ThreadSafeFunction::New(
+    env,
+    info[1].As<Napi::Function>(),
+    "cs2Netcon",
+    0,
+    1,
+    [](Napi::Env, NetconClient* finalized) {
+      // Environment teardown without stopNetconClient(): the thread is still running
+      if (finalized->addon->netcon == finalized) {
+        JoinNetconThread(finalized);
+      }
+      delete finalized;
+    },
+    client
+  );
+  addon->netcon = client;
+  client->thread = std::thread(NetconThreadMain, client);
+
+  return Napi::Boolean::New(env, true);
+}
+
+// netconSend(commands: string | string[]): boolean
+// Queues the commands to be written in order, back to back. Returns false (and
+// queues nothing) while not connected.
+Napi::Value NetconSend(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  std::string commands;
+  if (info.Length() >= 1 && info[0].IsString()) {
+    commands = info[0].As<Napi::String>().Utf8Value() + "\n";
+  } else if (info.Length() >= 1 && info[0].IsArray()) {
+    Napi::Array array = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+      Napi::Value command = array.Get(i);
+      if (command.IsString()) {
+        commands += command.As<Napi::String>().Utf8Value() + "\n";
+      }
+    }
+  } else {
+    Napi::TypeError::New(env, "Expected string | string[] commands").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  NetconClient* client = AddonFor(env)->netcon;
+  if (!client || !client->connected.load()) {
+    return Napi::Boolean::New(env, false);
+  }
+  {
+    std::lock_guard<std::mutex> lock(client->mutex);
+    client->queued += commands;
+  }
+  SetEvent(client->wakeEvent);
+  return Napi::Boolean::New(env, true);
+}
+
+// setNetconTickInterval(ms: number): boolean
+// Polls demo_goto every `ms` while connected (0 stops polling). False without a client.
+Napi::Value SetNetconTickInterval(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected number").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  NetconClient* client = AddonFor(env)->netcon;
+  if (!client) {
+    return Napi::Boolean::New(env, false);
+  }
+  client->tickIntervalMs.store(static_cast<uint32_t>(std::max(0, info[0].As<Napi::Number>().Int32Value())));
+  client->reportNextTick.store(true); // Report the next poll even if the tick did not move
+  SetEvent(client->wakeEvent);
+  return Napi::Boolean::New(env, true);
+}
+
+// isNetconConnected(): boolean
+Napi::Value IsNetconConnected(const Napi::CallbackInfo& info) {
+  NetconClient* client = AddonFor(info.Env())->netcon;
+  return Napi::Boolean::New(info.Env(), client && client->connected.load());
+}
+
+// stopNetconClient(): void
+Napi::Value StopNetconClient(const Napi::CallbackInfo& info) {
+  StopNetconHost(AddonFor(info.Env()));
+  return info.Env().Undefined();
+}
@@ -0,0 +1,358 @@
+#include "addon.h"
+#include <psapi.h>
+#include <pdh.h>
+
+// Resource sampler: CPU, memory, I/O and GPU use of registered processes (CS2,
+// the parser, ffmpeg, HLAE), read on a background thread without spawning
+// tasklist-style tools. Samples go into a ring JS drains in batches. GPU use
+// comes from the "GPU Engine" performance counters where they exist.
+#define RESOURCE_SAMPLE_DEFAULT_INTERVAL_MS 1000
+#define RESOURCE_SAMPLE_MIN_INTERVAL_MS 100
+#define RESOURCE_SAMPLE_RING_CAPACITY 1024 // Must be a power of two
+#define RESOURCE_SAMPLE_STRIDE 11 // Float64Array slots per drained sample
+#define RESOURCE_SAMPLE_EXITED 0x1 // The process has exited; its last sample, with final totals
+
+struct ResourceSample {
+  DWORD pid;
+  double timeMs; // Unix time
+  uint32_t flags;
+  double cpuPercent; // Of all logical processors, since the previous sample; -1 on the first
+  double cpuTimeMs; // Kernel + user, since the process started
+  uint64_t workingSetBytes;
+  uint64_t peakWorkingSetBytes;
+  uint64_t privateBytes;
+  uint64_t readBytes; // Since the process started
+  uint64_t writeBytes;
+  double gpuPercent; // Busiest GPU engine; -1 if unavailable
+};
+
+// Single-producer/single-consumer like EventRing: the sampler thread pushes,
+// the JS thread drains
+struct ResourceSampleRing {
+  ResourceSample records[RESOURCE_SAMPLE_RING_CAPACITY];
+  std::atomic<uint32_t> head;
+  std::atomic<uint32_t> tail;
+  std::atomic<uint64_t> dropped;
+};
+
+struct SampledProcess {
+  DWORD pid;
+  HANDLE handle; // QUERY_LIMITED_INFORMATION | SYNCHRONIZE; stays open after exit for the totals
+  bool exited;
+  uint64_t lastCpu100ns; // For the next sample's cpuPercent; 0 before the first
+  uint64_t lastWall100ns;
+  ResourceSample last;
+};
+
+struct ResourceSampler {
+  std::thread thread;
+  HANDLE wakeEvent; // Stop or interval change
+  std::atomic<bool> stopping;
+  std::atomic<uint32_t> intervalMs;
+  std::mutex mutex;
+  std::vector<SampledProcess> processes; // Guarded by mutex
+  PDH_HQUERY gpuQuery; // Sampler thread only; NULL if GPU counters are unavailable
+  PDH_HCOUNTER gpuCounter;
+  ResourceSampleRing ring;
+};
+
+uint64_t FileTimeTo100ns(const FILETIME& time) {
+  return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+
+bool ResourceRingPush(ResourceSampleRing* ring, const ResourceSample& sample) {
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  if (head - tail >= RESOURCE_SAMPLE_RING_CAPACITY) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  ring->records[head & (RESOURCE_SAMPLE_RING_CAPACITY - 1)] = sample;
+  ring->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// Busiest engine per PID from the "GPU Engine" counter instances, which are
+// named pid_<pid>_luid_..._engtype_<type>
+void CollectGpuUtilization(ResourceSampler* sampler, std::map<DWORD, double>* byPid) {
+  if (!sampler->gpuQuery || PdhCollectQueryData(sampler->gpuQuery) != ERROR_SUCCESS) {
+    return;
+  }
+
+  DWORD bufferBytes = 0;
+  DWORD itemCount = 0;
+  if (PdhGetFormattedCounterArrayW(sampler->gpuCounter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100,
+      &bufferBytes, &itemCount, NULL) != PDH_MORE_DATA) {
+    return; // Nothing yet: rate counters need two collections
+  }
+  std::vector<uint8_t> buffer(bufferBytes);
+  PDH_FMT_COUNTERVALUE_ITEM_W* items = reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(buffer.data());
+  if (PdhGetFormattedCounterArrayW(sampler->gpuCounter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100,
+      &bufferBytes, &itemCount, items) != ERROR_SUCCESS) {
+    return;
+  }
+
+  for (DWORD i = 0; i < itemCount; i++) {
+    const PDH_FMT_COUNTERVALUE& value = items[i].FmtValue;
+    if (wcsncmp(items[i].szName, L"pid_", 4) != 0 ||
+        (value.CStatus != PDH_CSTATUS_VALID_DATA && value.CStatus != PDH_CSTATUS_NEW_DATA)) {
+      continue;
+    }
+    DWORD pid = static_cast<DWORD>(wcstoul(items[i].szName + 4, nullptr, 10));
+    double& busiest = (*byPid)[pid];
+    busiest = std::max(busiest, value.doubleValue);
+  }
+}
+
+// Read one process. False once it has exited (the sample then carries its totals).
+bool SampleProcess(SampledProcess* process, uint64_t wall100ns, DWORD processorCount,
+                   const std::map<DWORD, double>* gpuByPid, ResourceSample* sample) {
+  bool exited = WaitForSingleObject(process->handle, 0) == WAIT_OBJECT_0;
+  *sample = process->last;
+  sample->pid = process->pid;
+  sample->timeMs = static_cast<double>(wall100ns - 116444736000000000ULL) / 10000.0;
+  sample->flags = exited ? RESOURCE_SAMPLE_EXITED : 0;
+  sample->cpuPercent = -1;
+
+  FILETIME creation, exit, kernel, user;
+  if (GetProcessTimes(process->handle, &creation, &exit, &kernel, &user)) {
+    uint64_t cpu100ns = FileTimeTo100ns(kernel) + FileTimeTo100ns(user);
+    sample->cpuTimeMs = static_cast<double>(cpu100ns) / 10000.0;
+    if (process->lastWall100ns && wall100ns > process->lastWall100ns && cpu100ns >= process->lastCpu100ns) {
+      sample->cpuPercent = 100.0 * static_cast<double>(cpu100ns - process->lastCpu100ns) /
+        (static_cast<double>(wall100ns - process->lastWall100ns) * processorCount);
+    }
+    process->lastCpu100ns = cpu100ns;
+    process->lastWall100ns = wall100ns;
+  }
+
+  PROCESS_MEMORY_COUNTERS_EX memory = {};
+  memory.cb = sizeof(memory);
+  if (GetProcessMemoryInfo(process->handle, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memory), sizeof(memory))) {
+    sample->workingSetBytes = memory.WorkingSetSize;
+    sample->peakWorkingSetBytes = memory.PeakWorkingSetSize;
+    sample->privateBytes = memory.PrivateUsage;
+  }
+
+  IO_COUNTERS io;
+  if (GetProcessIoCounters(process->handle, &io)) {
+    sample->readBytes = io.ReadTransferCount;
+    sample->writeBytes = io.WriteTransferCount;
+  }
+
+  auto gpu = gpuByPid->find(process->pid);
+  sample->gpuPercent = gpu != gpuByPid->end() ? gpu->second : (gpuByPid->empty() ? -1 : 0);
+
+  process->last = *sample;
+  return !exited;
+}
+
+void ResourceSamplerThreadMain(ResourceSampler* sampler) {
+  // Lower than the game and the UI: a late sample costs nothing
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+  sampler->gpuQuery = NULL;
+  if (PdhOpenQueryW(NULL, 0, &sampler->gpuQuery) == ERROR_SUCCESS &&
+      PdhAddEnglishCounterW(sampler->gpuQuery, L"\\GPU Engine(*)\\Utilization Percentage", 0, &sampler->gpuCounter) != ERROR_SUCCESS) {
+    PdhCloseQuery(sampler->gpuQuery);
+    sampler->gpuQuery = NULL;
+  }
+  DWORD processorCount = std::max<DWORD>(1, GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
+
+  while (!sampler->stopping.load()) {
+    {
+      std::lock_guard<std::mutex> lock(sampler->mutex);
+      bool anyRunning = false;
+      for (const SampledProcess& process : sampler->processes) {
+        anyRunning = anyRunning || !process.exited;
+      }
+
+      if (anyRunning) {
+        std::map<DWORD, double> gpuByPid;
+        CollectGpuUtilization(sampler, &gpuByPid);
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+        uint64_t wall100ns = FileTimeTo100ns(now);
+        for (SampledProcess& process : sampler->processes) {
+          if (process.exited) {
+            continue;
+          }
+          ResourceSample sample;
+          process.exited = !SampleProcess(&process, wall100ns, processorCount, &gpuByPid, &sample);
+          ResourceRingPush(&sampler->ring, sample);
+        }
+      }
+    }
+    WaitForSingleObject(sampler->wakeEvent, sampler->intervalMs.load());
+  }
+
+  if (sampler->gpuQuery) {
+    PdhCloseQuery(sampler->gpuQuery);
+  }
+}
+
+void StopResourceSampler(Cs2WindowTracker* addon) {
+  ResourceSampler* sampler = addon->sampler;
+  sampler->stopping.store(true);
+  SetEvent(sampler->wakeEvent);
+  sampler->thread.join();
+  for (const SampledProcess& process : sampler->processes) {
+    CloseHandle(process.handle);
+  }
+  CloseHandle(sampler->wakeEvent);
+  delete sampler;
+  addon->sampler = nullptr;
+}
+
+Napi::Object ResourceSampleToObject(Napi::Env env, const ResourceSample& sample) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("pid", Napi::Number::New(env, sample.pid));
+  result.Set("timeMs", Napi::Number::New(env, sample.timeMs));
+  result.Set("exited", Napi::Boolean::New(env, (sample.flags & RESOURCE_SAMPLE_EXITED) != 0));
+  result.Set("cpuPercent", Napi::Number::New(env, sample.cpuPercent));
+  result.Set("cpuTimeMs", Napi::Number::New(env, sample.cpuTimeMs));
+  result.Set("workingSetBytes", Napi::Number::New(env, static_cast<double>(sample.workingSetBytes)));
+  result.Set("peakWorkingSetBytes", Napi::Number::New(env, static_cast<double>(sample.peakWorkingSetBytes)));
+  result.Set("privateBytes", Napi::Number::New(env, static_cast<double>(sample.privateBytes)));
+  result.Set("readBytes", Napi::Number::New(env, static_cast<double>(sample.readBytes)));
+  result.Set("writeBytes", Napi::Number::New(env, static_cast<double>(sample.writeBytes)));
+  result.Set("gpuPercent", Napi::Number::New(env, sample.gpuPercent));
+  return result;
+}
+
+// addSampledProcess(pid: number, options?: { intervalMs?: number }): boolean
+// Start sampling a process (the sampler thread starts with the first). The
+// interval applies to every process. False if the process cannot be opened.
+Napi::Value AddSampledProcess(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (pid, options?)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  DWORD pid = info[0].As<Napi::Number>().Uint32Value();
+  Cs2WindowTracker* addon = AddonFor(env);
+  if (!addon->sampler) {
+    ResourceSampler* sampler = new ResourceSampler();
+    sampler->wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    sampler->stopping.store(false);
+    sampler->intervalMs.store(RESOURCE_SAMPLE_DEFAULT_INTERVAL_MS);
+    sampler->ring.head.store(0, std::memory_order_relaxed);
+    sampler->ring.tail.store(0, std::memory_order_relaxed);
+    sampler->ring.dropped.store(0, std::memory_order_relaxed);
+    sampler->thread = std::thread(ResourceSamplerThreadMain, sampler);
+    addon->sampler = sampler;
+  }
+  ResourceSampler* sampler = addon->sampler;
+
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Value intervalValue = info[1].As<Napi::Object>().Get("intervalMs");
+    if (intervalValue.IsNumber()) {
+      sampler->intervalMs.store(std::max<uint32_t>(RESOURCE_SAMPLE_MIN_INTERVAL_MS, intervalValue.As<Napi::Number>().Uint32Value()));
+      SetEvent(sampler->wakeEvent);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(sampler->mutex);
+  for (const SampledProcess& process : sampler->processes) {
+    if (process.pid == pid) {
+      return Napi::Boolean::New(env, true);
+    }
+  }
+  HANDLE handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid);
+  if (!handle) {
+    return Napi::Boolean::New(env, false);
+  }
+  SampledProcess process = {};
+  process.pid = pid;
+  process.handle = handle;
+  process.last.pid = pid;
+  process.last.cpuPercent = -1;
+  process.last.gpuPercent = -1;
+  sampler->processes.push_back(process);
+  SetEvent(sampler->wakeEvent); // First sample now rather than an interval later
+  return Napi::Boolean::New(env, true);
+}
+
+// removeSampledProcess(pid: number): ResourceSample | null
+// Stop sampling a process and return a last sample with its totals so far
+// (final ones if it has exited). Null if it was not being sampled.
+Napi::Value RemoveSampledProcess(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected pid").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ResourceSampler* sampler = AddonFor(env)->sampler;
+  if (!sampler) {
+    return env.Null();
+  }
+  DWORD pid = info[0].As<Napi::Number>().Uint32Value();
+  std::lock_guard<std::mutex> lock(sampler->mutex);
+  auto& processes = sampler->processes;
+  for (size_t i = 0; i < processes.size(); i++) {
+    SampledProcess& process = processes[i];
+    if (process.pid != pid) {
+      continue;
+    }
+    ResourceSample sample = process.last;
+    if (!process.exited) {
+      double gpuPercent = process.last.gpuPercent; // Not collected again: that takes the sampler's query
+      FILETIME now;
+      GetSystemTimeAsFileTime(&now);
+      std::map<DWORD, double> noGpu;
+      SampleProcess(&process, FileTimeTo100ns(now), std::max<DWORD>(1, GetActiveProcessorCount(ALL_PROCESSOR_GROUPS)),
+        &noGpu, &sample);
+      sample.gpuPercent = gpuPercent;
+    }
+    CloseHandle(process.handle);
+    processes.erase(processes.begin() + i);
+    return ResourceSampleToObject(env, sample);
+  }
+  return env.Null();
+}
+
+// drainResourceSamples(buffer: Float64Array): number
+// Copy queued samples into buffer, RESOURCE_SAMPLE_STRIDE slots each: pid,
+// timeMs, flags, cpuPercent, cpuTimeMs, workingSetBytes, peakWorkingSetBytes,
+// privateBytes, readBytes, writeBytes, gpuPercent. Returns the count written;
+// the rest stay queued.
+Napi::Value DrainResourceSamples(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsTypedArray() ||
+      info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array) {
+    Napi::TypeError::New(env, "Expected Float64Array").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ResourceSampler* sampler = AddonFor(env)->sampler;
+  if (!sampler) {
+    return Napi::Number::New(env, 0);
+  }
+
+  Napi::Float64Array array = info[0].As<Napi::Float64Array>();
+  ResourceSampleRing* ring = &sampler->ring;
+  uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  uint32_t head = ring->head.load(std::memory_order_acquire);
+  size_t count = std::min<size_t>(head - tail, array.ElementLength() / RESOURCE_SAMPLE_STRIDE);
+  double* out = array.Data();
+  for (size_t i = 0; i < count; i++, out += RESOURCE_SAMPLE_STRIDE) {
+    const ResourceSample& sample = ring->records[(tail + i) & (RESOURCE_SAMPLE_RING_CAPACITY - 1)];
+    out[0] = sample.pid;
+    out[1] = sample.timeMs;
+    out[2] = sample.flags;
+    out[3] = sample.cpuPercent;
+    out[4] = sample.cpuTimeMs;
+    out[5] = static_cast<double>(sample.workingSetBytes);
+    out[6] = static_cast<double>(sample.peakWorkingSetBytes);
+    out[7] = static_cast<double>(sample.privateBytes);
+    out[8] = static_cast<double>(sample.readBytes);
+    out[9] = static_cast<double>(sample.writeBytes);
+    out[10] = sample.gpuPercent;
+  }
+  ring->tail.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+  return Napi::Number::New(env, static_cast<double>(count));
+}
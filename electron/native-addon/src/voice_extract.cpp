@@ -0,0 +1,822 @@
+#include "addon.h"
+#include "demo_format.h"
+#include <mmsystem.h>
+#include <mmreg.h>
+
+// Voice extraction: walks a PBDEMS2 demo's packets for svc_VoiceData, decodes
+// each player's Opus frames with the bundled opus.dll on a thread pool (a
+// player's frames depend on each other, players do not) and writes 48 kHz mono
+// 16-bit WAVs straight from the decoded buffers. Replaces spawning csgove per
+// demo; CS:GO (HL2DEMO) demos, which need the CELT codec, are left to it.
+#define VOICE_SAMPLE_RATE 48000
+#define VOICE_MAX_FRAME_SAMPLES 5760 // 120 ms, the longest Opus frame
+#define VOICE_DEFAULT_TICK_RATE 64.0
+#define VOICE_MIX_BLOCK_SAMPLES (VOICE_SAMPLE_RATE * 4)
+#define DEMO_CMD_PACKET 7 // EDemoCommands::DEM_Packet
+#define DEMO_CMD_SIGNON_PACKET 8 // EDemoCommands::DEM_SignonPacket
+#define DEMO_CMD_FULL_PACKET 13 // EDemoCommands::DEM_FullPacket
+#define SVC_VOICE_DATA 47 // SVC_Messages::svc_VoiceData
+#define VOICE_FORMAT_STEAM 0 // VoiceDataFormat_t
+#define VOICE_FORMAT_OPUS 2
+#define STEAM_VOICE_SILENCE 0x00 // Steam voice payload types
+#define STEAM_VOICE_OPUS_PLC 0x06
+#define STEAM_VOICE_SAMPLE_RATE 0x0B
+
+#define VOICE_READ_CHUNK (1024 * 1024)
+
+// Sequential ReadFile reader over a demo's frames. A mapped view would raise
+// EXCEPTION_IN_PAGE_ERROR if the demo shrank or its volume went away while
+// being walked; a read just comes back short. Holds at least the current frame.
+struct DemoFrameReader {
+  HANDLE file;
+  std::vector<uint8_t> buffer;
+  size_t start = 0; // The current frame's first byte in buffer
+  size_t filled = 0;
+  bool eof = false;
+  DWORD readError = 0;
+
+  // Have at least `need` bytes from `start` in the buffer, or all that is left
+  void Fill(size_t need) {
+    if (buffer.size() - start < need) {
+      memmove(buffer.data(), buffer.data() + start, filled - start);
+      filled -= start;
+      start = 0;
+      if (buffer.size() < need) {
+        buffer.resize((need + VOICE_READ_CHUNK - 1) / VOICE_READ_CHUNK * VOICE_READ_CHUNK);
+      }
+    }
+    while (filled - start < need && !eof) {
+      DWORD read = 0;
+      if (!ReadFile(file, buffer.data() + filled, static_cast<DWORD>(buffer.size() - filled), &read, NULL)) {
+        readError = GetLastError();
+        eof = true;
+      } else if (read == 0) {
+        eof = true;
+      }
+      filled += read;
+    }
+  }
+
+  // The next frame, as NextDemoFrame decodes it; false at the end of what
+  // could be read or at the first frame that does not decode
+  bool Next(uint32_t* command, uint32_t* tick, std::vector<uint8_t>* scratch,
+            const uint8_t** payload, size_t* payloadLength) {
+    Fill(DEMO_FRAME_PREFIX_BYTES);
+    const uint8_t* cursor = buffer.data() + start;
+    const uint8_t* end = buffer.data() + filled;
+    uint64_t rawCommand;
+    uint64_t rawTick;
+    uint64_t size;
+    if (!ReadVarint(&cursor, end, &rawCommand) || !ReadVarint(&cursor, end, &rawTick) ||
+        !ReadVarint(&cursor, end, &size) || size > DEMO_MAX_FRAME_BYTES) {
+      return false;
+    }
+    Fill(static_cast<size_t>(cursor - (buffer.data() + start)) + static_cast<size_t>(size));
+    uint64_t offset = 0;
+    if (!NextDemoFrame(buffer.data() + start, filled - start, &offset, command, tick, scratch, payload, payloadLength)) {
+      return false;
+    }
+    start += static_cast<size_t>(offset);
+    return true;
+  }
+};
+
+typedef void* (*OpusDecoderCreateProc)(int32_t sampleRate, int channels, int* error);
+typedef int (*OpusDecodeProc)(void* decoder, const unsigned char* data, int32_t length, int16_t* pcm, int frameSize, int decodeFec);
+typedef void (*OpusDecoderDestroyProc)(void* decoder);
+
+struct OpusApi {
+  HMODULE module;
+  OpusDecoderCreateProc create;
+  OpusDecodeProc decode;
+  OpusDecoderDestroyProc destroy;
+};
+
+enum VoiceFrameKind {
+  VOICE_FRAME_OPUS,
+  VOICE_FRAME_SILENCE, // `length` samples at 48 kHz
+  VOICE_FRAME_RESET, // Steam stream restarted: fresh decoder state
+};
+
+// One Opus frame (or silence run) of a player, in demo order
+struct VoiceFrame {
+  uint64_t sample; // Where the voice message's tick falls on the 48 kHz timeline
+  uint32_t offset; // Into VoicePlayer::bytes
+  uint32_t length;
+  uint8_t kind;
+};
+
+// Contiguous decoded audio: pcm[pcmOffset, pcmOffset + count) plays at `start`
+struct VoiceSegment {
+  uint64_t start;
+  size_t pcmOffset;
+  size_t count;
+};
+
+struct VoicePlayer {
+  uint64_t xuid;
+  std::vector<uint8_t> bytes; // Opus frames copied out of the packets
+  std::vector<VoiceFrame> frames;
+  std::vector<int16_t> pcm; // Decoded, gaps removed
+  std::vector<VoiceSegment> segments;
+  std::wstring path; // Split modes: this player's file
+  std::string error;
+};
+
+// Source 2 packets are bitstreams of [ubitvar type][varint size][protobuf], LSB first
+struct PacketBitReader {
+  const uint8_t* data;
+  size_t bitLength;
+  size_t position;
+};
+
+uint32_t ReadPacketBits(PacketBitReader* reader, unsigned count) {
+  uint32_t value = 0;
+  for (unsigned i = 0; i < count && reader->position < reader->bitLength; i++, reader->position++) {
+    value |= static_cast<uint32_t>((reader->data[reader->position >> 3] >> (reader->position & 7)) & 1) << i;
+  }
+  return value;
+}
+
+uint32_t ReadPacketUBitVar(PacketBitReader* reader) {
+  uint32_t value = ReadPacketBits(reader, 6);
+  switch (value & 0x30) {
+    case 0x10: return (value & 15) | (ReadPacketBits(reader, 4) << 4);
+    case 0x20: return (value & 15) | (ReadPacketBits(reader, 8) << 4);
+    case 0x30: return (value & 15) | (ReadPacketBits(reader, 28) << 4);
+    default: return value;
+  }
+}
+
+uint32_t ReadPacketVarint32(PacketBitReader* reader) {
+  uint32_t value = 0;
+  for (unsigned shift = 0; shift < 35; shift += 7) {
+    uint32_t byte = ReadPacketBits(reader, 8);
+    value |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  return value;
+}
+
+class ExtractVoiceWorker : public Napi::AsyncWorker {
+public:
+  ExtractVoiceWorker(Napi::Env env)
+    : Napi::AsyncWorker(env, "cs2ExtractVoice"), mode(VOICE_MODE_SPLIT_COMPACT), deferred(env),
+      tickRate(VOICE_DEFAULT_TICK_RATE), demoTicks(0), messages(0) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+  enum Mode {
+    VOICE_MODE_SPLIT_COMPACT, // A file per player, silences removed
+    VOICE_MODE_SPLIT_FULL, // A file per player, on the demo's timeline
+    VOICE_MODE_SINGLE_FULL, // All players mixed into one file on the demo's timeline
+  };
+
+  std::wstring demoPath;
+  std::wstring outputDirectory;
+  std::wstring codecDirectory;
+  std::wstring baseName; // Output files are <baseName>_<steamId>.wav, or <baseName>.wav mixed
+  Mode mode;
+  std::vector<uint64_t> wanted; // Empty: every player
+  std::string mixedPath;
+
+protected:
+  void Execute() override {
+    OpusApi opus = {};
+    std::wstring dll = codecDirectory.empty() ? L"opus.dll" : codecDirectory + L"\\opus.dll";
+    opus.module = LoadLibraryExW(dll.c_str(), NULL, codecDirectory.empty() ? 0 : LOAD_WITH_ALTERED_SEARCH_PATH);
+    if (opus.module) {
+      opus.create = reinterpret_cast<OpusDecoderCreateProc>(GetProcAddress(opus.module, "opus_decoder_create"));
+      opus.decode = reinterpret_cast<OpusDecodeProc>(GetProcAddress(opus.module, "opus_decode"));
+      opus.destroy = reinterpret_cast<OpusDecoderDestroyProc>(GetProcAddress(opus.module, "opus_decoder_destroy"));
+    }
+    if (!opus.create || !opus.decode || !opus.destroy) {
+      SetError("Failed to load opus.dll. Error code: " + std::to_string(GetLastError()));
+      if (opus.module) {
+        FreeLibrary(opus.module);
+      }
+      return;
+    }
+
+    std::string error = CollectVoiceFrames();
+    if (error.empty()) {
+      RunOnPool([this, &opus](VoicePlayer* player) { DecodePlayer(&opus, player); });
+      if (mode == VOICE_MODE_SINGLE_FULL) {
+        error = WriteMixedFile();
+      } else {
+        RunOnPool([this](VoicePlayer* player) { WritePlayerFile(player); });
+      }
+    }
+    FreeLibrary(opus.module);
+    if (!error.empty()) {
+      SetError(error);
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Object result = Napi::Object::New(env);
+    Napi::Array files = Napi::Array::New(env);
+    uint32_t fileCount = 0;
+    uint64_t voicedSamples = 0;
+    if (mode == VOICE_MODE_SINGLE_FULL && !mixedPath.empty()) {
+      Napi::Object file = Napi::Object::New(env);
+      file.Set("path", Napi::String::New(env, mixedPath));
+      file.Set("samples", Napi::Number::New(env, static_cast<double>(MixedSamples())));
+      files.Set(fileCount++, file);
+    }
+    Napi::Array players = Napi::Array::New(env);
+    uint32_t playerCount = 0;
+    for (const std::unique_ptr<VoicePlayer>& player : this->players) {
+      Napi::Object entry = Napi::Object::New(env);
+      entry.Set("steamId", Napi::String::New(env, std::to_string(player->xuid)));
+      entry.Set("voicedSamples", Napi::Number::New(env, static_cast<double>(player->pcm.size())));
+      entry.Set("segments", Napi::Number::New(env, static_cast<double>(player->segments.size())));
+      if (!player->error.empty()) {
+        entry.Set("error", Napi::String::New(env, player->error));
+      }
+      players.Set(playerCount++, entry);
+      voicedSamples += player->pcm.size();
+
+      if (mode != VOICE_MODE_SINGLE_FULL && !player->path.empty() && player->error.empty()) {
+        Napi::Object file = Napi::Object::New(env);
+        file.Set("path", Napi::String::New(env, WideToUtf8(player->path)));
+        file.Set("steamId", Napi::String::New(env, std::to_string(player->xuid)));
+        file.Set("samples", Napi::Number::New(env, static_cast<double>(PlayerFileSamples(player.get()))));
+        files.Set(fileCount++, file);
+      }
+    }
+    result.Set("files", files);
+    result.Set("players", players);
+    result.Set("sampleRate", Napi::Number::New(env, VOICE_SAMPLE_RATE));
+    result.Set("voicedMs", Napi::Number::New(env, static_cast<double>(voicedSamples) * 1000.0 / VOICE_SAMPLE_RATE));
+    result.Set("messages", Napi::Number::New(env, static_cast<double>(messages)));
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred deferred;
+  std::vector<std::unique_ptr<VoicePlayer>> players; // In order of first voice message
+  std::map<uint64_t, VoicePlayer*> playersByXuid;
+  double tickRate;
+  uint64_t demoTicks; // From the file info frame (0 if missing)
+  uint64_t messages;
+
+  // Runs `work` once per player on up to DEMO_SCAN_MAX_THREADS threads
+  template <typename Work>
+  void RunOnPool(Work work) {
+    std::atomic<size_t> next(0);
+    size_t threadCount = std::min<size_t>(players.size(),
+      std::max<size_t>(1, std::min<size_t>(DEMO_SCAN_MAX_THREADS, std::thread::hardware_concurrency())));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++) {
+      threads.emplace_back([this, &next, &work]() {
+        for (size_t i = next.fetch_add(1); i < players.size(); i = next.fetch_add(1)) {
+          work(players[i].get());
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  uint64_t TimelineSamples() {
+    return static_cast<uint64_t>(static_cast<double>(demoTicks) * VOICE_SAMPLE_RATE / tickRate);
+  }
+
+  uint64_t PlayerFileSamples(VoicePlayer* player) {
+    if (mode == VOICE_MODE_SPLIT_COMPACT) {
+      return player->pcm.size();
+    }
+    uint64_t samples = TimelineSamples();
+    if (!player->segments.empty()) {
+      const VoiceSegment& last = player->segments.back();
+      samples = std::max<uint64_t>(samples, last.start + last.count);
+    }
+    return samples;
+  }
+
+  uint64_t MixedSamples() {
+    uint64_t samples = TimelineSamples();
+    for (const std::unique_ptr<VoicePlayer>& player : players) {
+      if (!player->segments.empty()) {
+        samples = std::max<uint64_t>(samples, player->segments.back().start + player->segments.back().count);
+      }
+    }
+    return samples;
+  }
+
+  VoicePlayer* PlayerFor(uint64_t xuid) {
+    auto found = playersByXuid.find(xuid);
+    if (found != playersByXuid.end()) {
+      return found->second;
+    }
+    if (!wanted.empty() && std::find(wanted.begin(), wanted.end(), xuid) == wanted.end()) {
+      return nullptr;
+    }
+    players.emplace_back(new VoicePlayer());
+    VoicePlayer* player = players.back().get();
+    player->xuid = xuid;
+    playersByXuid[xuid] = player;
+    return player;
+  }
+
+  void AddFrame(VoicePlayer* player, uint64_t sample, uint8_t kind, const uint8_t* data, size_t length) {
+    VoiceFrame frame;
+    frame.sample = sample;
+    frame.offset = static_cast<uint32_t>(player->bytes.size());
+    frame.length = static_cast<uint32_t>(length);
+    frame.kind = kind;
+    if (kind == VOICE_FRAME_OPUS) {
+      player->bytes.insert(player->bytes.end(), data, data + length);
+    }
+    player->frames.push_back(frame);
+  }
+
+  // Steam voice payload: [u64 steamid]{[u8 type][...]}[u32 crc]. Only the Opus PLC
+  // chunks ([u16 length]{[u16 size][u16 sequence][size bytes]}) and silence carry audio.
+  void AddSteamVoice(VoicePlayer* player, uint64_t sample, const uint8_t* data, size_t length) {
+    if (length < 12) {
+      return;
+    }
+    const uint8_t* cursor = data + 8;
+    const uint8_t* end = data + length - 4;
+    uint32_t sampleRate = 24000;
+    while (cursor < end) {
+      uint8_t type = *cursor++;
+      if (end - cursor < 2) {
+        break;
+      }
+      uint32_t value = cursor[0] | (cursor[1] << 8);
+      cursor += 2;
+      if (type == STEAM_VOICE_SAMPLE_RATE) {
+        sampleRate = value ? value : sampleRate;
+      } else if (type == STEAM_VOICE_SILENCE) {
+        AddFrame(player, sample, VOICE_FRAME_SILENCE, nullptr,
+          static_cast<size_t>(static_cast<uint64_t>(value) * VOICE_SAMPLE_RATE / sampleRate));
+      } else {
+        if (value > static_cast<uint32_t>(end - cursor)) {
+          break;
+        }
+        if (type == STEAM_VOICE_OPUS_PLC) {
+          const uint8_t* chunk = cursor;
+          const uint8_t* chunkEnd = cursor + value;
+          while (chunkEnd - chunk >= 4) {
+            uint32_t frameSize = chunk[0] | (chunk[1] << 8);
+            chunk += 4; // Size and sequence
+            if (frameSize == 0xffff) {
+              AddFrame(player, sample, VOICE_FRAME_RESET, nullptr, 0);
+              break;
+            }
+            if (frameSize > static_cast<uint32_t>(chunkEnd - chunk)) {
+              break;
+            }
+            AddFrame(player, sample, VOICE_FRAME_OPUS, chunk, frameSize);
+            chunk += frameSize;
+          }
+        }
+        cursor += value;
+      }
+    }
+  }
+
+  // CSVCMsg_VoiceData: audio (1, CMsgVoiceAudio), xuid (4, fixed64)
+  void AddVoiceMessage(uint32_t tick, const uint8_t* data, size_t length) {
+    const uint8_t* cursor = data;
+    ProtoField field;
+    uint64_t xuid = 0;
+    const uint8_t* audio = nullptr;
+    size_t audioLength = 0;
+    while (NextProtoField(&cursor, data + length, &field)) {
+      if (field.number == 1 && field.wireType == 2) {
+        audio = field.data;
+        audioLength = field.length;
+      } else if (field.number == 4) {
+        xuid = field.value;
+      }
+    }
+    VoicePlayer* player = xuid && audio ? PlayerFor(xuid) : nullptr;
+    if (!player) {
+      return;
+    }
+    messages++;
+
+    // CMsgVoiceAudio: format (1), voice_data (2), num_packets (7), packet_offsets (8, packed end offsets)
+    uint64_t format = VOICE_FORMAT_STEAM;
+    const uint8_t* voice = nullptr;
+    size_t voiceLength = 0;
+    std::vector<uint32_t> packetEnds;
+    cursor = audio;
+    while (NextProtoField(&cursor, audio + audioLength, &field)) {
+      if (field.number == 1) {
+        format = field.value;
+      } else if (field.number == 2 && field.wireType == 2) {
+        voice = field.data;
+        voiceLength = field.length;
+      } else if (field.number == 8) {
+        if (field.wireType == 0) {
+          packetEnds.push_back(static_cast<uint32_t>(field.value));
+        } else if (field.wireType == 2) {
+          const uint8_t* packed = field.data;
+          uint64_t value;
+          while (packed < field.data + field.length && ReadVarint(&packed, field.data + field.length, &value)) {
+            packetEnds.push_back(static_cast<uint32_t>(value));
+          }
+        }
+      }
+    }
+    if (!voice || voiceLength == 0) {
+      return;
+    }
+
+    uint64_t sample = static_cast<uint64_t>(static_cast<double>(tick) * VOICE_SAMPLE_RATE / tickRate);
+    if (format == VOICE_FORMAT_OPUS) {
+      if (packetEnds.empty()) {
+        packetEnds.push_back(static_cast<uint32_t>(voiceLength));
+      }
+      uint32_t start = 0;
+      for (uint32_t end : packetEnds) {
+        if (end <= start || end > voiceLength) {
+          break;
+        }
+        AddFrame(player, sample, VOICE_FRAME_OPUS, voice + start, end - start);
+        start = end;
+      }
+    } else if (format == VOICE_FORMAT_STEAM) {
+      AddSteamVoice(player, sample, voice, voiceLength);
+    }
+  }
+
+  void ScanPacket(uint32_t tick, const uint8_t* data, size_t length) {
+    PacketBitReader reader = { data, length * 8, 0 };
+    std::vector<uint8_t> message;
+    while (reader.bitLength - reader.position >= 8) {
+      uint32_t type = ReadPacketUBitVar(&reader);
+      uint32_t size = ReadPacketVarint32(&reader);
+      if (static_cast<uint64_t>(size) * 8 > reader.bitLength - reader.position) {
+        return;
+      }
+      if (type != SVC_VOICE_DATA) {
+        reader.position += static_cast<size_t>(size) * 8;
+        continue;
+      }
+      message.resize(size);
+      if ((reader.position & 7) == 0) {
+        memcpy(message.data(), data + (reader.position >> 3), size);
+        reader.position += static_cast<size_t>(size) * 8;
+      } else {
+        for (uint32_t i = 0; i < size; i++) {
+          message[i] = static_cast<uint8_t>(ReadPacketBits(&reader, 8));
+        }
+      }
+      AddVoiceMessage(tick, message.data(), message.size());
+    }
+  }
+
+  // CDemoPacket.data (3)
+  void ScanDemoPacket(uint32_t tick, const uint8_t* data, size_t length) {
+    const uint8_t* cursor = data;
+    ProtoField field;
+    while (NextProtoField(&cursor, data + length, &field)) {
+      if (field.number == 3 && field.wireType == 2) {
+        ScanPacket(tick, field.data, field.length);
+      }
+    }
+  }
+
+  // Read the demo front to back and gather every wanted player's frames, in
+  // demo order. A demo cut off or still growing ends at its last whole frame.
+  std::string CollectVoiceFrames() {
+    HANDLE file = CreateFileW(demoPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      return "Failed to open demo. Error code: " + std::to_string(GetLastError());
+    }
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(file, &size);
+    uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+    if (fileSize == 0) {
+      CloseHandle(file);
+      return "Empty demo file";
+    }
+
+    DemoScanResult header = {};
+    header.size = fileSize;
+    ParseDemoHeaders(file, &header);
+    std::string error = header.error;
+    if (error.empty() && header.hasFileInfo && header.playbackTicks > 0 && header.playbackTime > 0) {
+      tickRate = header.playbackTicks / header.playbackTime;
+      demoTicks = static_cast<uint64_t>(header.playbackTicks);
+    }
+
+    // The header reads were positioned; frames follow the 16-byte prefix
+    LARGE_INTEGER firstFrame = {};
+    firstFrame.QuadPart = 16;
+    if (error.empty() && !SetFilePointerEx(file, firstFrame, NULL, FILE_BEGIN)) {
+      error = "Failed to read demo. Error code: " + std::to_string(GetLastError());
+    }
+
+    DemoFrameReader reader = {};
+    reader.file = file;
+    std::vector<uint8_t> scratch;
+    uint32_t command;
+    uint32_t tick;
+    const uint8_t* payload;
+    size_t payloadLength;
+    while (error.empty() && reader.Next(&command, &tick, &scratch, &payload, &payloadLength)) {
+      if (tick == 0xffffffff) {
+        tick = 0; // Signon frames come before the first tick
+      }
+      if (command == DEMO_CMD_PACKET || command == DEMO_CMD_SIGNON_PACKET) {
+        ScanDemoPacket(tick, payload, payloadLength);
+      } else if (command == DEMO_CMD_FULL_PACKET) {
+        // CDemoFullPacket.packet (2)
+        const uint8_t* cursor = payload;
+        ProtoField field;
+        while (NextProtoField(&cursor, payload + payloadLength, &field)) {
+          if (field.number == 2 && field.wireType == 2) {
+            ScanDemoPacket(tick, field.data, field.length);
+          }
+        }
+      }
+    }
+    if (error.empty() && reader.readError) {
+      error = "Failed to read demo. Error code: " + std::to_string(reader.readError);
+    }
+    CloseHandle(file);
+    return error;
+  }
+
+  // Pool thread: decode a player's frames into pcm, splitting at gaps. A frame
+  // never plays before the end of the previous one.
+  void DecodePlayer(const OpusApi* opus, VoicePlayer* player) {
+    int status = 0;
+    void* decoder = opus->create(VOICE_SAMPLE_RATE, 1, &status);
+    if (!decoder) {
+      player->error = "opus_decoder_create failed: " + std::to_string(status);
+      return;
+    }
+    uint64_t cursor = 0; // Timeline position after the last decoded sample
+    for (const VoiceFrame& frame : player->frames) {
+      if (frame.kind == VOICE_FRAME_RESET) {
+        opus->destroy(decoder);
+        decoder = opus->create(VOICE_SAMPLE_RATE, 1, &status);
+        if (!decoder) {
+          player->error = "opus_decoder_create failed: " + std::to_string(status);
+          return;
+        }
+        continue;
+      }
+      uint64_t start = std::max(frame.sample, cursor);
+      if (frame.kind == VOICE_FRAME_SILENCE) {
+        cursor = start + frame.length;
+        continue;
+      }
+
+      size_t pcmOffset = player->pcm.size();
+      player->pcm.resize(pcmOffset + VOICE_MAX_FRAME_SAMPLES);
+      int decoded = opus->decode(decoder, player->bytes.data() + frame.offset, static_cast<int32_t>(frame.length),
+        player->pcm.data() + pcmOffset, VOICE_MAX_FRAME_SAMPLES, 0);
+      if (decoded <= 0) {
+        player->pcm.resize(pcmOffset); // Corrupt frame: skip it
+        continue;
+      }
+      player->pcm.resize(pcmOffset + decoded);
+      if (player->segments.empty() || start != cursor) {
+        player->segments.push_back({ start, pcmOffset, 0 });
+      }
+      player->segments.back().count += decoded;
+      cursor = start + decoded;
+    }
+    opus->destroy(decoder);
+    std::vector<uint8_t>().swap(player->bytes);
+    std::vector<VoiceFrame>().swap(player->frames);
+  }
+
+  static void WriteWavHeader(uint8_t* header, uint64_t samples) {
+    uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(samples * 2, 0xffffffffull - 36));
+    uint32_t riffBytes = dataBytes + 36;
+    uint32_t formatBytes = 16;
+    uint16_t format = WAVE_FORMAT_PCM;
+    uint16_t channels = 1;
+    uint32_t sampleRate = VOICE_SAMPLE_RATE;
+    uint32_t byteRate = VOICE_SAMPLE_RATE * 2;
+    uint16_t blockAlign = 2;
+    uint16_t bitsPerSample = 16;
+    memcpy(header, "RIFF", 4);
+    memcpy(header + 4, &riffBytes, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    memcpy(header + 16, &formatBytes, 4);
+    memcpy(header + 20, &format, 2);
+    memcpy(header + 22, &channels, 2);
+    memcpy(header + 24, &sampleRate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &blockAlign, 2);
+    memcpy(header + 34, &bitsPerSample, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+  }
+
+  // Write samples at timeline position `sample`; gaps left by seeking past the
+  // end are zero-filled by the file system
+  static bool WriteSamplesAt(HANDLE file, uint64_t sample, const int16_t* samples, size_t count) {
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(44 + sample * 2);
+    if (!SetFilePointerEx(file, position, NULL, FILE_BEGIN)) {
+      return false;
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(samples);
+    size_t remaining = count * 2;
+    while (remaining > 0) {
+      DWORD chunk = static_cast<DWORD>(std::min<size_t>(remaining, 64 * 1024 * 1024));
+      DWORD written = 0;
+      if (!WriteFile(file, bytes, chunk, &written, NULL) || written != chunk) {
+        return false;
+      }
+      bytes += chunk;
+      remaining -= chunk;
+    }
+    return true;
+  }
+
+  static bool FinishWavFile(HANDLE file, uint64_t samples) {
+    uint8_t header[44];
+    WriteWavHeader(header, samples);
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(44 + samples * 2);
+    LARGE_INTEGER start = {};
+    DWORD written = 0;
+    return SetFilePointerEx(file, position, NULL, FILE_BEGIN) && SetEndOfFile(file) &&
+      SetFilePointerEx(file, start, NULL, FILE_BEGIN) &&
+      WriteFile(file, header, sizeof(header), &written, NULL) && written == sizeof(header);
+  }
+
+  // Pool thread: compact files are the decoded buffer as is; full ones place each segment on the timeline
+  void WritePlayerFile(VoicePlayer* player) {
+    if (!player->error.empty() || player->pcm.empty()) {
+      return; // Silent throughout (or undecodable): no file
+    }
+    player->path = outputDirectory + L"\\" + baseName + L"_" + std::to_wstring(player->xuid) + L".wav";
+    HANDLE file = CreateFileW(player->path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      player->error = "Failed to create voice file. Error code: " + std::to_string(GetLastError());
+      return;
+    }
+    bool ok = true;
+    if (mode == VOICE_MODE_SPLIT_COMPACT) {
+      ok = WriteSamplesAt(file, 0, player->pcm.data(), player->pcm.size());
+    } else {
+      for (size_t i = 0; ok && i < player->segments.size(); i++) {
+        const VoiceSegment& segment = player->segments[i];
+        ok = WriteSamplesAt(file, segment.start, player->pcm.data() + segment.pcmOffset, segment.count);
+      }
+    }
+    ok = ok && FinishWavFile(file, PlayerFileSamples(player));
+    if (!ok) {
+      player->error = "Failed to write voice file. Error code: " + std::to_string(GetLastError());
+    }
+    CloseHandle(file);
+    if (!ok) {
+      DeleteFileW(player->path.c_str());
+    }
+  }
+
+  // Mix every player onto one timeline, a block at a time; silent blocks are skipped
+  std::string WriteMixedFile() {
+    bool anyVoice = false;
+    for (const std::unique_ptr<VoicePlayer>& player : players) {
+      anyVoice = anyVoice || !player->pcm.empty();
+    }
+    if (!anyVoice) {
+      return std::string();
+    }
+    std::wstring path = outputDirectory + L"\\" + baseName + L".wav";
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      return "Failed to create voice file. Error code: " + std::to_string(GetLastError());
+    }
+
+    uint64_t total = MixedSamples();
+    std::vector<int32_t> sums(VOICE_MIX_BLOCK_SAMPLES);
+    std::vector<int16_t> block(VOICE_MIX_BLOCK_SAMPLES);
+    std::vector<size_t> nextSegment(players.size(), 0);
+    bool ok = true;
+    for (uint64_t blockStart = 0; ok && blockStart < total; blockStart += VOICE_MIX_BLOCK_SAMPLES) {
+      uint64_t blockEnd = std::min<uint64_t>(total, blockStart + VOICE_MIX_BLOCK_SAMPLES);
+      bool voiced = false;
+      std::fill(sums.begin(), sums.end(), 0);
+      for (size_t p = 0; p < players.size(); p++) {
+        VoicePlayer* player = players[p].get();
+        for (size_t i = nextSegment[p]; i < player->segments.size(); i++) {
+          const VoiceSegment& segment = player->segments[i];
+          if (segment.start >= blockEnd) {
+            break;
+          }
+          uint64_t from = std::max(segment.start, blockStart);
+          uint64_t to = std::min(segment.start + segment.count, blockEnd);
+          const int16_t* source = player->pcm.data() + segment.pcmOffset + (from - segment.start);
+          for (uint64_t s = from; s < to; s++) {
+            sums[static_cast<size_t>(s - blockStart)] += *source++;
+          }
+          voiced = voiced || to > from;
+          if (segment.start + segment.count <= blockEnd) {
+            nextSegment[p] = i + 1; // Done with it
+          }
+        }
+      }
+      if (!voiced) {
+        continue;
+      }
+      size_t count = static_cast<size_t>(blockEnd - blockStart);
+      for (size_t s = 0; s < count; s++) {
+        block[s] = static_cast<int16_t>(std::max(-32768, std::min(32767, sums[s])));
+      }
+      ok = WriteSamplesAt(file, blockStart, block.data(), count);
+    }
+    ok = ok && FinishWavFile(file, total);
+    DWORD error = GetLastError();
+    CloseHandle(file);
+    if (!ok) {
+      DeleteFileW(path.c_str());
+      return "Failed to write voice file. Error code: " + std::to_string(error);
+    }
+    mixedPath = WideToUtf8(path);
+    return std::string();
+  }
+};
+
+// extractVoice(demoPath: string, options: { outputDirectory: string, mode?: 'split-compact' |
+//   'split-full' | 'single-full', steamIds?: string[], codecDirectory?: string }):
+//   Promise<{ files: Array<{ path, steamId?, samples }>, players: Array<{ steamId,
+//   voicedSamples, segments, error? }>, sampleRate, voicedMs, messages }>
+// Decodes the voice of every player (or just steamIds) in a CS2 demo into 48 kHz
+// mono 16-bit WAVs named <demo>_<steamId>.wav (<demo>.wav when mixed). The
+// full modes keep each line at its demo time. opus.dll is loaded from
+// codecDirectory. Rejects for CS:GO demos and when opus.dll cannot be loaded.
+Napi::Value ExtractVoice(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsObject()) {
+    Napi::TypeError::New(env, "Expected (string demoPath, object options)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Object options = info[1].As<Napi::Object>();
+  Napi::Value outputOpt = options.Get("outputDirectory");
+  if (!outputOpt.IsString()) {
+    Napi::TypeError::New(env, "options.outputDirectory must be a string").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ExtractVoiceWorker* worker = new ExtractVoiceWorker(env);
+  std::u16string utf16 = info[0].As<Napi::String>().Utf16Value();
+  worker->demoPath.assign(utf16.begin(), utf16.end());
+  utf16 = outputOpt.As<Napi::String>().Utf16Value();
+  worker->outputDirectory.assign(utf16.begin(), utf16.end());
+  Napi::Value codecOpt = options.Get("codecDirectory");
+  if (codecOpt.IsString()) {
+    utf16 = codecOpt.As<Napi::String>().Utf16Value();
+    worker->codecDirectory.assign(utf16.begin(), utf16.end());
+  }
+  Napi::Value modeOpt = options.Get("mode");
+  if (modeOpt.IsString()) {
+    std::string mode = modeOpt.As<Napi::String>().Utf8Value();
+    if (mode == "split-full") {
+      worker->mode = ExtractVoiceWorker::VOICE_MODE_SPLIT_FULL;
+    } else if (mode == "single-full") {
+      worker->mode = ExtractVoiceWorker::VOICE_MODE_SINGLE_FULL;
+    }
+  }
+  Napi::Value steamIdsOpt = options.Get("steamIds");
+  if (steamIdsOpt.IsArray()) {
+    Napi::Array steamIds = steamIdsOpt.As<Napi::Array>();
+    for (uint32_t i = 0; i < steamIds.Length(); i++) {
+      Napi::Value steamId = steamIds.Get(i);
+      if (steamId.IsString()) {
+        worker->wanted.push_back(strtoull(steamId.As<Napi::String>().Utf8Value().c_str(), nullptr, 10));
+      }
+    }
+  }
+
+  // Demo file name without .dem
+  size_t nameStart = worker->demoPath.find_last_of(L"\\/");
+  worker->baseName = worker->demoPath.substr(nameStart == std::wstring::npos ? 0 : nameStart + 1);
+  size_t extension = worker->baseName.find_last_of(L'.');
+  if (extension != std::wstring::npos && extension > 0) {
+    worker->baseName.resize(extension);
+  }
+  while (!worker->outputDirectory.empty() &&
+         (worker->outputDirectory.back() == L'\\' || worker->outputDirectory.back() == L'/')) {
+    worker->outputDirectory.pop_back();
+  }
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
@@ -0,0 +1,418 @@
+#include "addon.h"
+#include <mmsystem.h>
+#include <mmreg.h>
+
+// Waveform peaks: min/max/RMS pyramids over 16-bit PCM for the voice views, built
+// on a worker thread from a WAV file or PCM handed over from JS. Level 0 holds one
+// peak per samplesPerPeak frames; every further level halves the resolution, so
+// any zoom level is a slice of an existing array.
+#define WAVEFORM_DEFAULT_SAMPLES_PER_PEAK 256
+#define WAVEFORM_MAX_LEVELS 16
+#define WAVEFORM_READ_CHUNK (256 * 1024)
+
+// Running min/max/sum of squares over interleaved samples
+struct PcmBlockStats {
+  int16_t min;
+  int16_t max;
+  uint64_t sumSq;
+};
+
+void ResetPcmBlockStats(PcmBlockStats* stats) {
+  stats->min = INT16_MAX;
+  stats->max = INT16_MIN;
+  stats->sumSq = 0;
+}
+
+// Fold `count` samples into `stats`, eight at a time with SSE2 where available
+void ScanPcmSamples(const int16_t* samples, size_t count, PcmBlockStats* stats) {
+  size_t i = 0;
+  int16_t lo = stats->min;
+  int16_t hi = stats->max;
+  uint64_t sumSq = stats->sumSq;
+#if NATIVE_SSE2
+  if (count >= 8) {
+    __m128i vmin = _mm_set1_epi16(lo);
+    __m128i vmax = _mm_set1_epi16(hi);
+    __m128i vsum = _mm_setzero_si128(); // 2 x uint64
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+      vmin = _mm_min_epi16(vmin, v);
+      vmax = _mm_max_epi16(vmax, v);
+      // Pairwise a*a + b*b; only -32768 in both lanes reaches 2^31, which is
+      // still right when the lanes are widened as unsigned
+      __m128i squares = _mm_madd_epi16(v, v);
+      vsum = _mm_add_epi64(vsum, _mm_unpacklo_epi32(squares, zero));
+      vsum = _mm_add_epi64(vsum, _mm_unpackhi_epi32(squares, zero));
+    }
+    int16_t mins[8];
+    int16_t maxs[8];
+    uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mins), vmin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxs), vmax);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), vsum);
+    for (size_t lane = 0; lane < 8; lane++) {
+      lo = std::min(lo, mins[lane]);
+      hi = std::max(hi, maxs[lane]);
+    }
+    sumSq += sums[0] + sums[1];
+  }
+#endif
+  for (; i < count; i++) {
+    int32_t sample = samples[i];
+    lo = std::min<int16_t>(lo, static_cast<int16_t>(sample));
+    hi = std::max<int16_t>(hi, static_cast<int16_t>(sample));
+    sumSq += static_cast<uint64_t>(sample * sample);
+  }
+  stats->min = lo;
+  stats->max = hi;
+  stats->sumSq = sumSq;
+}
+
+struct PeakLevel {
+  uint64_t samplesPerPeak; // Frames per peak
+  std::vector<int16_t> peaks; // [min, max] per peak
+  std::vector<double> sumSq; // Per peak, over every channel's samples
+  std::vector<uint64_t> counts; // Samples per peak (the last one may be short)
+};
+
+// Streams interleaved 16-bit samples into level 0
+struct PeakBuilder {
+  uint64_t blockSamples; // samplesPerPeak * channels
+  PcmBlockStats current;
+  uint64_t currentCount;
+  PeakLevel level;
+};
+
+void InitPeakBuilder(PeakBuilder* builder, uint64_t samplesPerPeak, uint32_t channels) {
+  builder->blockSamples = samplesPerPeak * channels;
+  builder->currentCount = 0;
+  ResetPcmBlockStats(&builder->current);
+  builder->level.samplesPerPeak = samplesPerPeak;
+}
+
+void FlushPeak(PeakBuilder* builder) {
+  if (builder->currentCount == 0) {
+    return;
+  }
+  builder->level.peaks.push_back(builder->current.min);
+  builder->level.peaks.push_back(builder->current.max);
+  builder->level.sumSq.push_back(static_cast<double>(builder->current.sumSq));
+  builder->level.counts.push_back(builder->currentCount);
+  builder->currentCount = 0;
+  ResetPcmBlockStats(&builder->current);
+}
+
+void AddPcmSamples(PeakBuilder* builder, const int16_t* samples, size_t count) {
+  while (count > 0) {
+    size_t take = static_cast<size_t>(std::min<uint64_t>(count, builder->blockSamples - builder->currentCount));
+    ScanPcmSamples(samples, take, &builder->current);
+    builder->currentCount += take;
+    samples += take;
+    count -= take;
+    if (builder->currentCount == builder->blockSamples) {
+      FlushPeak(builder);
+    }
+  }
+}
+
+// Next pyramid level: adjacent peaks merged pairwise
+PeakLevel HalvePeakLevel(const PeakLevel& source) {
+  PeakLevel level;
+  level.samplesPerPeak = source.samplesPerPeak * 2;
+  size_t sourceCount = source.counts.size();
+  for (size_t i = 0; i < sourceCount; i += 2) {
+    bool pair = i + 1 < sourceCount;
+    level.peaks.push_back(pair ? std::min(source.peaks[i * 2], source.peaks[i * 2 + 2]) : source.peaks[i * 2]);
+    level.peaks.push_back(pair ? std::max(source.peaks[i * 2 + 1], source.peaks[i * 2 + 3]) : source.peaks[i * 2 + 1]);
+    level.sumSq.push_back(source.sumSq[i] + (pair ? source.sumSq[i + 1] : 0));
+    level.counts.push_back(source.counts[i] + (pair ? source.counts[i + 1] : 0));
+  }
+  return level;
+}
+
+// Convert little-endian PCM bytes to 16-bit samples. Returns the bytes consumed
+// (whole samples only; the caller carries the rest over).
+size_t ConvertPcmToInt16(const uint8_t* bytes, size_t length, uint16_t format, uint16_t bitsPerSample, std::vector<int16_t>* out) {
+  size_t bytesPerSample = bitsPerSample / 8;
+  size_t count = length / bytesPerSample;
+  out->resize(count);
+  int16_t* samples = out->data();
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t* p = bytes + i * bytesPerSample;
+    if (format == WAVE_FORMAT_IEEE_FLOAT) {
+      float value;
+      memcpy(&value, p, sizeof(value));
+      samples[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, value * 32768.0f)));
+    } else if (bitsPerSample == 8) {
+      samples[i] = static_cast<int16_t>((p[0] - 128) << 8);
+    } else {
+      // 16/24/32-bit signed: the top two bytes are the 16-bit sample
+      samples[i] = static_cast<int16_t>(p[bytesPerSample - 2] | (p[bytesPerSample - 1] << 8));
+    }
+  }
+  return count * bytesPerSample;
+}
+
+struct WavFormat {
+  uint16_t format; // WAVE_FORMAT_PCM or WAVE_FORMAT_IEEE_FLOAT
+  uint16_t channels;
+  uint32_t sampleRate;
+  uint16_t bitsPerSample;
+  uint64_t dataOffset;
+  uint64_t dataLength;
+};
+
+// Find the fmt and data chunks. The header lives in the first few KB of every
+// WAV the voice pipeline writes.
+bool ParseWavHeader(const uint8_t* header, size_t length, uint64_t fileSize, WavFormat* wav, std::string* error) {
+  if (length < 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+    *error = "Not a RIFF/WAVE file";
+    return false;
+  }
+
+  bool haveFormat = false;
+  size_t offset = 12;
+  while (offset + 8 <= length) {
+    uint32_t chunkSize;
+    memcpy(&chunkSize, header + offset + 4, sizeof(chunkSize));
+    const uint8_t* chunk = header + offset + 8;
+    if (memcmp(header + offset, "fmt ", 4) == 0 && chunkSize >= 16 && offset + 8 + 16 <= length) {
+      memcpy(&wav->format, chunk, 2);
+      memcpy(&wav->channels, chunk + 2, 2);
+      memcpy(&wav->sampleRate, chunk + 4, 4);
+      memcpy(&wav->bitsPerSample, chunk + 14, 2);
+      // WAVE_FORMAT_EXTENSIBLE: the real format is the first two bytes of the subformat GUID
+      if (wav->format == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26 && offset + 8 + 26 <= length) {
+        memcpy(&wav->format, chunk + 24, 2);
+      }
+      haveFormat = true;
+    } else if (memcmp(header + offset, "data", 4) == 0) {
+      wav->dataOffset = offset + 8;
+      wav->dataLength = std::min<uint64_t>(chunkSize, fileSize > wav->dataOffset ? fileSize - wav->dataOffset : 0);
+      break;
+    }
+    offset += 8 + ((static_cast<size_t>(chunkSize) + 1) & ~static_cast<size_t>(1));
+  }
+
+  if (!haveFormat || wav->dataOffset == 0) {
+    *error = "WAV fmt/data chunk not found";
+    return false;
+  }
+  bool supported = wav->channels > 0 && wav->sampleRate > 0 &&
+    ((wav->format == WAVE_FORMAT_PCM && (wav->bitsPerSample == 8 || wav->bitsPerSample == 16 ||
+      wav->bitsPerSample == 24 || wav->bitsPerSample == 32)) ||
+     (wav->format == WAVE_FORMAT_IEEE_FLOAT && wav->bitsPerSample == 32));
+  if (!supported) {
+    *error = "Unsupported WAV format " + std::to_string(wav->format) + " (" + std::to_string(wav->bitsPerSample) + "-bit)";
+    return false;
+  }
+  return true;
+}
+
+// Builds the pyramid off the JS thread; resolves
+// { sampleRate, channels, frames, duration, levels: [{ samplesPerPeak, peaks, rms }] }
+class WaveformPeaksWorker : public Napi::AsyncWorker {
+public:
+  WaveformPeaksWorker(Napi::Env env)
+    : Napi::AsyncWorker(env, "cs2WaveformPeaks"), deferred(env) {}
+
+  Napi::Promise Promise() { return deferred.Promise(); }
+
+  std::wstring path; // WAV file, or empty for PCM input
+  std::vector<int16_t> pcm16;
+  std::vector<float> pcmFloat;
+  uint32_t channels = 1;
+  uint32_t sampleRate = 16000;
+  uint64_t samplesPerPeak = WAVEFORM_DEFAULT_SAMPLES_PER_PEAK;
+  uint32_t peakCount = 0; // If set, level 0 gets this many peaks regardless of length
+  uint32_t maxLevels = WAVEFORM_MAX_LEVELS;
+
+protected:
+  void Execute() override {
+    if (!path.empty()) {
+      if (!ReadWavFile()) {
+        return; // The builder was never started
+      }
+    } else {
+      uint64_t sampleCount = pcm16.empty() ? pcmFloat.size() : pcm16.size();
+      frames = sampleCount / channels;
+      StartLevels();
+      if (!pcm16.empty()) {
+        AddPcmSamples(&builder, pcm16.data(), static_cast<size_t>(frames * channels));
+      } else {
+        std::vector<int16_t> converted;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pcmFloat.data());
+        ConvertPcmToInt16(bytes, static_cast<size_t>(frames * channels) * sizeof(float), WAVE_FORMAT_IEEE_FLOAT, 32, &converted);
+        AddPcmSamples(&builder, converted.data(), converted.size());
+      }
+    }
+    FlushPeak(&builder);
+
+    levels.push_back(std::move(builder.level));
+    while (levels.size() < maxLevels && levels.back().counts.size() > 1) {
+      levels.push_back(HalvePeakLevel(levels.back()));
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("sampleRate", Napi::Number::New(env, sampleRate));
+    result.Set("channels", Napi::Number::New(env, channels));
+    result.Set("frames", Napi::Number::New(env, static_cast<double>(frames)));
+    result.Set("duration", Napi::Number::New(env, sampleRate ? static_cast<double>(frames) / sampleRate : 0));
+
+    Napi::Array levelArray = Napi::Array::New(env, levels.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+      const PeakLevel& level = levels[i];
+      size_t count = level.counts.size();
+      Napi::Int16Array peaks = Napi::Int16Array::New(env, count * 2);
+      if (count) {
+        memcpy(peaks.Data(), level.peaks.data(), count * 2 * sizeof(int16_t));
+      }
+      Napi::Float32Array rms = Napi::Float32Array::New(env, count);
+      for (size_t p = 0; p < count; p++) {
+        rms.Data()[p] = static_cast<float>(std::sqrt(level.sumSq[p] / level.counts[p]) / 32768.0);
+      }
+      Napi::Object levelObject = Napi::Object::New(env);
+      levelObject.Set("samplesPerPeak", Napi::Number::New(env, static_cast<double>(level.samplesPerPeak)));
+      levelObject.Set("peaks", peaks);
+      levelObject.Set("rms", rms);
+      levelArray.Set(static_cast<uint32_t>(i), levelObject);
+    }
+    result.Set("levels", levelArray);
+    deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& error) override {
+    deferred.Reject(error.Value());
+  }
+
+private:
+  void StartLevels() {
+    if (peakCount > 0) {
+      samplesPerPeak = std::max<uint64_t>(1, (frames + peakCount - 1) / peakCount);
+    }
+    InitPeakBuilder(&builder, samplesPerPeak, channels);
+  }
+
+  // False (with the error set) if the file cannot be read as a WAV
+  bool ReadWavFile() {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      SetError("Failed to open audio file. Error code: " + std::to_string(GetLastError()));
+      return false;
+    }
+
+    std::vector<uint8_t> buffer(WAVEFORM_READ_CHUNK);
+    LARGE_INTEGER fileSize = {};
+    DWORD read = 0;
+    WavFormat wav = {};
+    std::string error;
+    if (!GetFileSizeEx(file, &fileSize) || !ReadFile(file, buffer.data(), 4096, &read, NULL) ||
+        !ParseWavHeader(buffer.data(), read, static_cast<uint64_t>(fileSize.QuadPart), &wav, &error)) {
+      CloseHandle(file);
+      SetError(error.empty() ? "Failed to read audio file. Error code: " + std::to_string(GetLastError()) : error);
+      return false;
+    }
+
+    channels = wav.channels;
+    sampleRate = wav.sampleRate;
+    frames = wav.dataLength / (static_cast<uint64_t>(wav.bitsPerSample / 8) * channels);
+    StartLevels();
+
+    // Stream the data chunk; partial samples at chunk ends are carried over
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(wav.dataOffset);
+    SetFilePointerEx(file, position, NULL, FILE_BEGIN);
+    std::vector<int16_t> samples;
+    uint64_t remaining = frames * (wav.bitsPerSample / 8) * channels;
+    size_t carried = 0;
+    while (remaining > 0) {
+      DWORD toRead = static_cast<DWORD>(std::min<uint64_t>(remaining, buffer.size() - carried));
+      if (!ReadFile(file, buffer.data() + carried, toRead, &read, NULL) || read == 0) {
+        break;
+      }
+      remaining -= read;
+      size_t available = carried + read;
+      size_t consumed = ConvertPcmToInt16(buffer.data(), available, wav.format, wav.bitsPerSample, &samples);
+      AddPcmSamples(&builder, samples.data(), samples.size());
+      carried = available - consumed;
+      memmove(buffer.data(), buffer.data() + consumed, carried);
+    }
+    CloseHandle(file);
+    return true;
+  }
+
+  uint64_t frames = 0;
+  PeakBuilder builder;
+  std::vector<PeakLevel> levels;
+  Napi::Promise::Deferred deferred;
+};
+
+// computeWaveformPeaks(input: string wavPath | Int16Array | Float32Array,
+//                      options?: { channels?: number, sampleRate?: number, samplesPerPeak?: number,
+//                                  peakCount?: number, levels?: number }):
+//   Promise<{ sampleRate, channels, frames, duration,
+//             levels: Array<{ samplesPerPeak, peaks: Int16Array, rms: Float32Array }> }>
+// peaks holds [min, max] pairs over all channels; rms is 0..1 of full scale. PCM input is
+// interleaved (channels/sampleRate describe it; a WAV header overrides them). peakCount
+// sizes level 0 to that many peaks instead of samplesPerPeak (default 256) frames each.
+Napi::Value ComputeWaveformPeaks(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  bool isPcm = info.Length() >= 1 && info[0].IsTypedArray() &&
+    (info[0].As<Napi::TypedArray>().TypedArrayType() == napi_int16_array ||
+     info[0].As<Napi::TypedArray>().TypedArrayType() == napi_float32_array);
+  if (!isPcm && !(info.Length() >= 1 && info[0].IsString())) {
+    Napi::TypeError::New(env, "Expected WAV path, Int16Array or Float32Array").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  WaveformPeaksWorker* worker = new WaveformPeaksWorker(env);
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    Napi::Value channels = options.Get("channels");
+    Napi::Value sampleRate = options.Get("sampleRate");
+    Napi::Value samplesPerPeak = options.Get("samplesPerPeak");
+    Napi::Value peakCount = options.Get("peakCount");
+    Napi::Value levels = options.Get("levels");
+    if (channels.IsNumber()) {
+      worker->channels = std::max<uint32_t>(1, channels.As<Napi::Number>().Uint32Value());
+    }
+    if (sampleRate.IsNumber()) {
+      worker->sampleRate = sampleRate.As<Napi::Number>().Uint32Value();
+    }
+    if (samplesPerPeak.IsNumber()) {
+      worker->samplesPerPeak = std::max<uint32_t>(1, samplesPerPeak.As<Napi::Number>().Uint32Value());
+    }
+    if (peakCount.IsNumber()) {
+      worker->peakCount = peakCount.As<Napi::Number>().Uint32Value();
+    }
+    if (levels.IsNumber()) {
+      worker->maxLevels = std::min<uint32_t>(WAVEFORM_MAX_LEVELS, std::max<uint32_t>(1, levels.As<Napi::Number>().Uint32Value()));
+    }
+  }
+
+  if (isPcm) {
+    // Copied so the worker never reads memory JS could detach or overwrite
+    Napi::TypedArray array = info[0].As<Napi::TypedArray>();
+    const uint8_t* data = static_cast<const uint8_t*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+    if (array.TypedArrayType() == napi_int16_array) {
+      const int16_t* samples = reinterpret_cast<const int16_t*>(data);
+      worker->pcm16.assign(samples, samples + array.ElementLength());
+    } else {
+      const float* samples = reinterpret_cast<const float*>(data);
+      worker->pcmFloat.assign(samples, samples + array.ElementLength());
+    }
+  } else {
+    std::u16string path = info[0].As<Napi::String>().Utf16Value();
+    worker->path.assign(path.begin(), path.end());
+  }
+
+  Napi::Promise promise = worker->Promise();
+  worker->Queue(); // Deletes itself after OnOK/OnError
+  return promise;
+}
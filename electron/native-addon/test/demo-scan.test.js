@@ -0,0 +1,166 @@
+// scanDemos(): PBDEMS2 file header and file info parsing, including demos that
+// are cut off, corrupt or not demos at all.
+
+const { test } = require('node:test');
+const assert = require('node:assert/strict');
+const path = require('path');
+const {
+  addon, skip, makeTempDir, writeFixture, varint, proto, snappy, demoFrame, fileHeader, fileInfo, buildDemo,
+  DEMO_CMD_FILE_HEADER, DEMO_CMD_PACKET,
+} = require('./fixtures');
+
+const HEADER = {
+  networkProtocol: 14070,
+  serverName: 'Valve CS2 EU West Server (srcds1008-fra2.128.1)',
+  clientName: 'SourceTV Demo',
+  mapName: 'de_ancient',
+  gameDirectory: '/opt/srcds/cs2/csgo_v2000477/csgo',
+  demoVersionName: 'valve_demo_2',
+  buildNum: 10526,
+};
+const INFO = { playbackTime: 2318.5, playbackTicks: 148384, playbackFrames: 74190, roundStartTicks: [714, 9034, 17650] };
+
+async function scanOne(file) {
+  const [result] = await addon.scanDemos([file]);
+  return result;
+}
+
+function assertHeader(result, expected = HEADER) {
+  for (const [key, value] of Object.entries(expected)) {
+    assert.equal(result[key], value, key);
+  }
+}
+
+test('scanDemos reads the file header and file info', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: fileHeader(HEADER), info: fileInfo(INFO), frames: [demoFrame(DEMO_CMD_PACKET, 12, Buffer.alloc(200))] });
+  const file = writeFixture(dir, 'match.dem', demo);
+
+  const result = await scanOne(file);
+  assert.equal(result.error, undefined);
+  assert.equal(result.path, file);
+  assert.equal(result.size, demo.length);
+  assert.ok(result.mtimeMs > 0);
+  assertHeader(result);
+  assert.equal(result.playbackTime, INFO.playbackTime);
+  assert.equal(result.playbackTicks, INFO.playbackTicks);
+  assert.equal(result.playbackFrames, INFO.playbackFrames);
+  assert.equal(result.rounds, INFO.roundStartTicks.length);
+});
+
+test('scanDemos inflates a Snappy-compressed header frame', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const expected = { ...HEADER, clientName: 'SourceTV SourceTV Demo' };
+  const header = fileHeader(expected);
+  // The second "SourceTV " is a back-reference into the first
+  const repeat = header.indexOf('SourceTV SourceTV') + 9;
+  const compressed = snappy.block(header.length,
+    snappy.literal(header.subarray(0, repeat)),
+    snappy.copy(9, 9),
+    snappy.literal(header.subarray(repeat + 9)));
+  const { demo } = buildDemo({ headerFrame: demoFrame(DEMO_CMD_FILE_HEADER, 0, compressed, { compressed: true }), info: fileInfo(INFO) });
+
+  const result = await scanOne(writeFixture(dir, 'compressed.dem', demo));
+  assert.equal(result.error, undefined);
+  assertHeader(result, expected);
+  assert.equal(result.playbackTicks, INFO.playbackTicks);
+});
+
+test('scanDemos counts rounds stored unpacked', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const cs = Buffer.concat([proto.varint(1, 714), proto.varint(1, 9034)]);
+  const info = Buffer.concat([proto.float(1, 60), proto.varint(2, 3840), proto.bytes(4, proto.bytes(5, cs))]);
+  const { demo } = buildDemo({ header: fileHeader(HEADER), info });
+
+  const result = await scanOne(writeFixture(dir, 'unpacked.dem', demo));
+  assert.equal(result.rounds, 2);
+  assert.equal(result.playbackTicks, 3840);
+});
+
+test('scanDemos keeps the header of a demo cut off before its file info', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo, infoOffset } = buildDemo({ header: fileHeader(HEADER), info: fileInfo(INFO), frames: [demoFrame(DEMO_CMD_PACKET, 12, Buffer.alloc(64))] });
+
+  // Ends right where the file info frame would start, and halfway through it
+  for (const length of [infoOffset, infoOffset + 5]) {
+    const result = await scanOne(writeFixture(dir, `cut-${length}.dem`, demo.subarray(0, length)));
+    assert.equal(result.error, undefined, `cut at ${length}`);
+    assert.equal(result.size, length);
+    assertHeader(result);
+    assert.equal(result.playbackTime, undefined);
+    assert.equal(result.rounds, undefined);
+  }
+});
+
+test('scanDemos reports a demo truncated inside its header frame', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: fileHeader(HEADER), info: fileInfo(INFO) });
+
+  for (const length of [16, 17, 19, 40]) {
+    const result = await scanOne(writeFixture(dir, `cut-${length}.dem`, demo.subarray(0, length)));
+    assert.equal(result.error, 'Missing demo file header', `cut at ${length}`);
+    assert.equal(result.mapName, undefined);
+  }
+});
+
+test('scanDemos rejects an oversized frame size varint', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const header = fileHeader(HEADER);
+  // Eleven bytes: past the ten a 64-bit varint may take
+  const overlong = Buffer.concat([varint(DEMO_CMD_FILE_HEADER), varint(0), Buffer.alloc(10, 0xff), Buffer.from([0x01]), header]);
+  // A well-formed size past the 16 MiB frame limit
+  const oversized = Buffer.concat([varint(DEMO_CMD_FILE_HEADER), varint(0), varint(17 * 1024 * 1024), header]);
+
+  for (const [name, headerFrame] of [['overlong', overlong], ['oversized', oversized]]) {
+    const { demo } = buildDemo({ headerFrame, info: fileInfo(INFO) });
+    const result = await scanOne(writeFixture(dir, `${name}.dem`, demo));
+    assert.equal(result.error, 'Missing demo file header', name);
+  }
+});
+
+test('scanDemos stops at an oversized varint inside the file info', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const info = Buffer.concat([proto.float(1, 12.5), varint((2 << 3) | 0), Buffer.alloc(11, 0xff)]);
+  const { demo } = buildDemo({ header: fileHeader(HEADER), info });
+
+  const result = await scanOne(writeFixture(dir, 'bad-info.dem', demo));
+  assert.equal(result.error, undefined);
+  assert.equal(result.playbackTime, 12.5);
+  assert.equal(result.playbackTicks, 0);
+});
+
+test('scanDemos reports files that are not CS2 demos', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: fileHeader(HEADER) });
+  const firstFrameNotHeader = buildDemo({ headerFrame: demoFrame(DEMO_CMD_PACKET, 0, fileHeader(HEADER)) }).demo;
+  const csgo = Buffer.alloc(1072);
+  csgo.write('HL2DEMO\0', 0, 'latin1');
+
+  const results = await addon.scanDemos([
+    writeFixture(dir, 'empty.dem', Buffer.alloc(0)),
+    writeFixture(dir, 'csgo.dem', csgo),
+    writeFixture(dir, 'short.dem', demo.subarray(0, 12)),
+    writeFixture(dir, 'no-header.dem', firstFrameNotHeader),
+    path.join(dir, 'missing.dem'),
+  ]);
+  assert.deepEqual(results.map((result) => result.error), [
+    'Empty demo file',
+    'Not a CS2 (PBDEMS2) demo',
+    'Not a CS2 (PBDEMS2) demo',
+    'Missing demo file header',
+    'Failed to open demo. Error code: 2',
+  ]);
+});
+
+test('scanDemos keeps the input order across scanner threads', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const files = [];
+  for (let i = 0; i < 24; i++) {
+    const { demo } = buildDemo({ header: fileHeader({ ...HEADER, mapName: `de_map${i}`, buildNum: i }), info: fileInfo(INFO) });
+    files.push(writeFixture(dir, `demo${i}.dem`, demo));
+  }
+
+  const results = await addon.scanDemos(files);
+  assert.deepEqual(results.map((result) => result.mapName), files.map((_, i) => `de_map${i}`));
+  assert.deepEqual(results.map((result) => result.buildNum), files.map((_, i) => i));
+});
@@ -0,0 +1,244 @@
+// Fixture builders for the addon tests: PBDEMS2 demos and the Source 2 packets
+// inside them, WAV files and temp directories. Everything is built byte by byte
+// so each test can cut, overflow or corrupt exactly the field it is about.
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const RELEASE_DIR = path.resolve(__dirname, '..', 'build', 'Release');
+const ADDON_PATH = path.join(RELEASE_DIR, 'cs2_window_tracker.node');
+const CODEC_DIRECTORY = path.resolve(__dirname, '..', '..', '..', 'bin', 'win'); // opus.dll
+
+// The parsers are Windows-only; elsewhere every test is skipped. On Windows a
+// missing build fails loudly (npm run test:addon builds first).
+const addon = process.platform === 'win32' ? require(ADDON_PATH) : null;
+const skip = addon ? false : `Windows-only addon; skipping on ${process.platform}`;
+
+const DEMO_CMD_FILE_HEADER = 1;
+const DEMO_CMD_FILE_INFO = 2;
+const DEMO_CMD_PACKET = 7;
+const DEMO_CMD_SIGNON_PACKET = 8;
+const DEMO_CMD_COMPRESSED = 64;
+const SVC_VOICE_DATA = 47;
+const VOICE_FORMAT_OPUS = 2;
+
+function sleep(ms) {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// A fresh directory under the OS temp dir, removed once test `t` ends
+function makeTempDir(t) {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'cs2-addon-test-'));
+  t.after(() => fs.rmSync(dir, { recursive: true, force: true }));
+  return dir;
+}
+
+function writeFixture(dir, name, data) {
+  const file = path.join(dir, name);
+  fs.writeFileSync(file, data);
+  return file;
+}
+
+// Base-128 varint (number or BigInt)
+function varint(value) {
+  let remaining = BigInt(value);
+  const bytes = [];
+  do {
+    let byte = Number(remaining & 0x7fn);
+    remaining >>= 7n;
+    if (remaining > 0n) {
+      byte |= 0x80;
+    }
+    bytes.push(byte);
+  } while (remaining > 0n);
+  return Buffer.from(bytes);
+}
+
+// Protobuf fields
+const proto = {
+  varint: (number, value) => Buffer.concat([varint((number << 3) | 0), varint(value)]),
+  fixed64: (number, value) => {
+    const data = Buffer.alloc(8);
+    data.writeBigUInt64LE(BigInt(value));
+    return Buffer.concat([varint((number << 3) | 1), data]);
+  },
+  bytes: (number, data) => Buffer.concat([varint((number << 3) | 2), varint(data.length), Buffer.from(data)]),
+  string: (number, text) => proto.bytes(number, Buffer.from(text, 'utf8')),
+  float: (number, value) => {
+    const data = Buffer.alloc(4);
+    data.writeFloatLE(value);
+    return Buffer.concat([varint((number << 3) | 5), data]);
+  },
+  packed: (number, values) => proto.bytes(number, Buffer.concat(values.map(varint))),
+};
+
+// Raw Snappy block: the uncompressed length, then literal and copy elements
+const snappy = {
+  block: (length, ...elements) => Buffer.concat([varint(length), ...elements]),
+  literal: (data) => {
+    if (data.length <= 60) {
+      return Buffer.concat([Buffer.from([(data.length - 1) << 2]), data]);
+    }
+    return Buffer.concat([Buffer.from([60 << 2, data.length - 1]), data]); // One length byte
+  },
+  copy: (offset, length) => Buffer.from([((length - 4) << 2) | ((offset >> 8) << 5) | 1, offset & 0xff]), // 4..11 bytes back up to 2047
+};
+
+// [varint cmd][varint tick][varint size][payload]
+function demoFrame(command, tick, payload, { compressed = false } = {}) {
+  return Buffer.concat([varint(compressed ? command | DEMO_CMD_COMPRESSED : command), varint(tick), varint(payload.length), payload]);
+}
+
+// CDemoFileHeader
+function fileHeader(fields) {
+  return Buffer.concat([
+    proto.varint(2, fields.networkProtocol),
+    proto.string(3, fields.serverName),
+    proto.string(4, fields.clientName),
+    proto.string(5, fields.mapName),
+    proto.string(6, fields.gameDirectory),
+    proto.string(11, fields.demoVersionName),
+    proto.varint(13, fields.buildNum),
+  ]);
+}
+
+// CDemoFileInfo, with round starts in game_info.cs.round_start_ticks
+function fileInfo({ playbackTime, playbackTicks, playbackFrames, roundStartTicks = [] }) {
+  const cs = proto.packed(1, roundStartTicks);
+  return Buffer.concat([
+    proto.float(1, playbackTime),
+    proto.varint(2, playbackTicks),
+    proto.varint(3, playbackFrames),
+    proto.bytes(4, proto.bytes(5, cs)),
+  ]);
+}
+
+// "PBDEMS2\0", the file info offset, then the header frame, `frames` and the
+// file info frame (when given) at the end, where CS2 writes it
+function buildDemo({ header, info = null, frames = [], headerFrame = null }) {
+  const body = [headerFrame || demoFrame(DEMO_CMD_FILE_HEADER, 0, header), ...frames];
+  const infoOffset = 16 + body.reduce((total, frame) => total + frame.length, 0);
+  const prefix = Buffer.alloc(16);
+  prefix.write('PBDEMS2\0', 0, 'latin1');
+  prefix.writeUInt32LE(info ? infoOffset : 0, 8);
+  const demo = Buffer.concat([prefix, ...body, ...(info ? [demoFrame(DEMO_CMD_FILE_INFO, 0, info)] : [])]);
+  return { demo, infoOffset };
+}
+
+// LSB-first bitstream, as Source 2 net messages are packed
+class BitWriter {
+  constructor() {
+    this.bytes = [];
+    this.length = 0;
+  }
+
+  bits(value, count) {
+    for (let i = 0; i < count; i++, this.length++) {
+      if ((this.length & 7) === 0) {
+        this.bytes.push(0);
+      }
+      this.bytes[this.length >> 3] |= ((value >>> i) & 1) << (this.length & 7);
+    }
+    return this;
+  }
+
+  ubitvar(value) {
+    if (value < 16) return this.bits(value, 6);
+    if (value < 256) return this.bits((value & 15) | 0x10, 6).bits(value >>> 4, 4);
+    if (value < 4096) return this.bits((value & 15) | 0x20, 6).bits(value >>> 4, 8);
+    return this.bits((value & 15) | 0x30, 6).bits(value >>> 4, 28);
+  }
+
+  raw(data) {
+    for (const byte of data) {
+      this.bits(byte, 8);
+    }
+    return this;
+  }
+
+  // [ubitvar type][varint32 size][message]
+  message(type, data) {
+    return this.ubitvar(type).raw(varint(data.length)).raw(data);
+  }
+
+  toBuffer() {
+    return Buffer.from(this.bytes);
+  }
+}
+
+// CSVCMsg_VoiceData carrying Opus frames (CMsgVoiceAudio.packet_offsets are end offsets)
+function voiceMessage(xuid, opusFrames) {
+  const ends = [];
+  let end = 0;
+  for (const frame of opusFrames) {
+    end += frame.length;
+    ends.push(end);
+  }
+  const audio = Buffer.concat([
+    proto.varint(1, VOICE_FORMAT_OPUS),
+    proto.bytes(2, Buffer.concat(opusFrames)),
+    proto.packed(8, ends),
+  ]);
+  return Buffer.concat([proto.bytes(1, audio), proto.fixed64(4, xuid)]);
+}
+
+// CDemoPacket around a net message bitstream
+function demoPacket(bitstream) {
+  return proto.bytes(3, bitstream);
+}
+
+// RIFF/WAVE with fmt, optional extra chunks and data; dataLength overrides the
+// data chunk's declared size (for truncated files)
+function buildWav({ format = 1, channels = 1, sampleRate = 48000, bitsPerSample = 16, data, dataLength, extraChunks = [] }) {
+  const fmt = Buffer.alloc(24);
+  fmt.write('fmt ', 0, 'latin1');
+  fmt.writeUInt32LE(16, 4);
+  fmt.writeUInt16LE(format, 8);
+  fmt.writeUInt16LE(channels, 10);
+  fmt.writeUInt32LE(sampleRate, 12);
+  fmt.writeUInt32LE(sampleRate * channels * (bitsPerSample / 8), 16);
+  fmt.writeUInt16LE(channels * (bitsPerSample / 8), 20);
+  fmt.writeUInt16LE(bitsPerSample, 22);
+  const chunks = extraChunks.map(({ id, body }) => {
+    const chunk = Buffer.alloc(8 + body.length + (body.length & 1)); // Odd chunks are padded
+    chunk.write(id, 0, 'latin1');
+    chunk.writeUInt32LE(body.length, 4);
+    body.copy(chunk, 8);
+    return chunk;
+  });
+  const dataHeader = Buffer.alloc(8);
+  dataHeader.write('data', 0, 'latin1');
+  dataHeader.writeUInt32LE(dataLength ?? data.length, 4);
+  const riff = Buffer.alloc(12);
+  riff.write('RIFF', 0, 'latin1');
+  riff.writeUInt32LE(4 + fmt.length + chunks.reduce((total, chunk) => total + chunk.length, 0) + 8 + data.length, 4);
+  riff.write('WAVE', 8, 'latin1');
+  return Buffer.concat([riff, fmt, ...chunks, dataHeader, data]);
+}
+
+module.exports = {
+  addon,
+  skip,
+  ADDON_PATH,
+  CODEC_DIRECTORY,
+  DEMO_CMD_FILE_HEADER,
+  DEMO_CMD_FILE_INFO,
+  DEMO_CMD_PACKET,
+  DEMO_CMD_SIGNON_PACKET,
+  SVC_VOICE_DATA,
+  sleep,
+  makeTempDir,
+  writeFixture,
+  varint,
+  proto,
+  snappy,
+  demoFrame,
+  fileHeader,
+  fileInfo,
+  buildDemo,
+  BitWriter,
+  voiceMessage,
+  demoPacket,
+  buildWav,
+};
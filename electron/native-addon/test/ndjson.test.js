@@ -0,0 +1,126 @@
+// startNdjsonReader(): lines written into the reader's pipe, decoded by the SSE2
+// line splitter and JSON scanner. Covers lines split across writes, a last line
+// without its newline, lines at and over the 1 MiB cut and malformed JSON.
+
+const { test } = require('node:test');
+const assert = require('node:assert/strict');
+const fs = require('fs');
+const { addon, skip, sleep } = require('./fixtures');
+
+const MAX_LINE_BYTES = 1024 * 1024; // NDJSON_MAX_LINE_BYTES
+
+// Write `chunks` into a new reader's pipe (pausing between them so they tend to
+// arrive as separate reads), close it and collect every record and the end summary
+function readNdjson(chunks, options = {}) {
+  return new Promise((resolve, reject) => {
+    const records = [];
+    const reader = addon.startNdjsonReader((batch, end) => {
+      records.push(...batch);
+      if (end) {
+        resolve({ records, end });
+      }
+    }, options);
+
+    (async () => {
+      const fd = fs.openSync(reader.pipePath, 'w');
+      try {
+        for (const chunk of chunks) {
+          const data = Buffer.from(chunk);
+          for (let written = 0; written < data.length;) {
+            written += fs.writeSync(fd, data, written);
+          }
+          await sleep(5);
+        }
+      } finally {
+        fs.closeSync(fd);
+      }
+    })().catch(reject);
+  });
+}
+
+// A JSON object line of exactly `length` bytes
+function lineOfLength(length) {
+  return `{"s":"${'x'.repeat(length - 8)}"}`;
+}
+
+test('NDJSON reader decodes top-level scalar fields', { skip }, async () => {
+  const lines = [
+    '{"type":"progress","percent":12.5,"done":false,"eta":null}',
+    '  {"type":"event","name":"caf\\u00e9 \\"q\\"\\n","nested":{"a":[1,{"b":2}]},"emoji":"\\ud83d\\ude00"}  ',
+    '',
+    '{}',
+  ];
+  const input = lines.join('\r\n') + '\r\n';
+  const { records, end } = await readNdjson([input]);
+
+  assert.deepEqual(records.map((record) => record.value), [
+    { type: 'progress', percent: 12.5, done: false, eta: null },
+    { type: 'event', name: 'café "q"\n', emoji: '\u{1f600}' }, // Nested values are validated, not decoded
+    {},
+  ]);
+  assert.ok(records.every((record) => record.line === undefined));
+  assert.deepEqual(end, { bytes: Buffer.byteLength(input), lines: 3, invalidLines: 0, error: 0 });
+});
+
+test('NDJSON reader joins lines split across writes and keeps an unterminated last line', { skip }, async () => {
+  const { records, end } = await readNdjson(['{"type":"a",', '"n":1}\n{"type"', ':"b","n":2}\n{"type":"c","n":3}'], { lines: true });
+
+  assert.deepEqual(records.map((record) => record.value), [
+    { type: 'a', n: 1 },
+    { type: 'b', n: 2 },
+    { type: 'c', n: 3 },
+  ]);
+  assert.deepEqual(records.map((record) => record.line), ['{"type":"a","n":1}', '{"type":"b","n":2}', '{"type":"c","n":3}']);
+  assert.equal(end.lines, 3);
+  assert.equal(end.invalidLines, 0);
+});
+
+test('NDJSON reader reports lines that are not JSON objects', { skip }, async () => {
+  const invalid = [
+    'plain text',
+    '[1,2,3]',
+    '{"a":1',
+    '{"a":01}',
+    '{"a":"raw\tcontrol"}',
+    '{"a":1} trailing',
+    `{"deep":${'['.repeat(70)}${']'.repeat(70)}}`, // Past the nesting limit
+  ];
+  const valid = `{"shallow":${'['.repeat(8)}${']'.repeat(8)},"ok":true}`;
+  const { records, end } = await readNdjson([[...invalid, valid].join('\n') + '\n']);
+
+  assert.deepEqual(records.map((record) => record.value), [...invalid.map(() => null), { ok: true }]);
+  assert.deepEqual(records.slice(0, invalid.length).map((record) => record.line), invalid);
+  assert.equal(end.lines, invalid.length + 1);
+  assert.equal(end.invalidLines, invalid.length);
+});
+
+test('NDJSON reader cuts lines longer than 1 MiB', { skip }, async () => {
+  const atLimit = lineOfLength(MAX_LINE_BYTES);
+  const overLimit = lineOfLength(MAX_LINE_BYTES + 1);
+  const after = '{"type":"after"}';
+  const unterminated = lineOfLength(MAX_LINE_BYTES + 4096);
+  const { records, end } = await readNdjson([`${atLimit}\n${overLimit}\n${after}\n`, unterminated]);
+
+  assert.equal(records.length, 4);
+  assert.equal(records[0].value.s.length, MAX_LINE_BYTES - 8);
+  for (const cut of [records[1], records[3]]) {
+    assert.equal(cut.value, null);
+    assert.equal(cut.line.length, MAX_LINE_BYTES);
+    assert.ok(cut.line.startsWith('{"s":"xxx'));
+  }
+  assert.deepEqual(records[2].value, { type: 'after' });
+  assert.equal(end.lines, 4);
+  assert.equal(end.invalidLines, 2);
+  assert.equal(end.bytes, atLimit.length + overLimit.length + after.length + unterminated.length + 3);
+});
+
+test('NDJSON reader coalesces undelivered records of the same type', { skip }, async () => {
+  const lines = [1, 2, 3].map((n) => `{"type":"progress","n":${n}}`).concat('{"type":"done"}');
+  const { records } = await readNdjson([lines.join('\n') + '\n'], { coalesce: ['progress'] });
+
+  // However the batches fell, every progress record is delivered or folded into a later one
+  const progress = records.filter((record) => record.value.type === 'progress');
+  assert.equal(progress.reduce((total, record) => total + 1 + (record.coalesced ?? 0), 0), 3);
+  assert.equal(progress.at(-1).value.n, 3);
+  assert.deepEqual(records.at(-1).value, { type: 'done' });
+});
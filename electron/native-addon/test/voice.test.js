@@ -0,0 +1,139 @@
+// extractVoice(): svc_VoiceData packets found in demo frames, decoded with the
+// bundled opus.dll. Covers packed and compressed frames, net messages whose size
+// runs past their packet, oversized varints and demos cut off mid-frame.
+
+const { test } = require('node:test');
+const assert = require('node:assert/strict');
+const fs = require('fs');
+const path = require('path');
+const {
+  addon, skip, CODEC_DIRECTORY, makeTempDir, writeFixture, varint, snappy, demoFrame, fileHeader, fileInfo, buildDemo,
+  BitWriter, voiceMessage, demoPacket, DEMO_CMD_FILE_HEADER, DEMO_CMD_PACKET, DEMO_CMD_SIGNON_PACKET, SVC_VOICE_DATA,
+} = require('./fixtures');
+
+const PLAYER_A = 76561198000000001n;
+const PLAYER_B = 76561198000000002n;
+const NET_TICK = 4; // NET_Messages::net_Tick
+const SVC_SERVER_INFO = 40; // Above 15, so its type takes the extended ubitvar form
+const OPUS_FRAME = Buffer.from([0xf8]); // TOC byte only: a 20 ms frame, decoded as packet loss concealment
+const SIGNON_TICK = 0xffffffff;
+
+const HEADER = fileHeader({
+  networkProtocol: 14070, serverName: 'test', clientName: 'SourceTV Demo', mapName: 'de_nuke',
+  gameDirectory: 'csgo', demoVersionName: 'valve_demo_2', buildNum: 10526,
+});
+const INFO = fileInfo({ playbackTime: 2, playbackTicks: 128, playbackFrames: 128 }); // 64 ticks/s
+
+function packet(build) {
+  const writer = new BitWriter();
+  build(writer);
+  return demoPacket(writer.toBuffer());
+}
+
+function compressedFrame(command, tick, payload) {
+  return demoFrame(command, tick, snappy.block(payload.length, snappy.literal(payload)), { compressed: true });
+}
+
+// A voice line from A at signon and at tick 64 (compressed frame), one from B at tick 32
+function voiceFrames() {
+  return [
+    demoFrame(DEMO_CMD_SIGNON_PACKET, SIGNON_TICK, packet((w) => w
+      .message(NET_TICK, Buffer.from([0x08, 0x01]))
+      .message(SVC_VOICE_DATA, voiceMessage(PLAYER_A, [OPUS_FRAME, OPUS_FRAME])))),
+    demoFrame(DEMO_CMD_PACKET, 32, packet((w) => w
+      .message(SVC_SERVER_INFO, Buffer.alloc(37, 0x5a))
+      .message(SVC_VOICE_DATA, voiceMessage(PLAYER_B, [OPUS_FRAME])))),
+    compressedFrame(DEMO_CMD_PACKET, 64, packet((w) => w.message(SVC_VOICE_DATA, voiceMessage(PLAYER_A, [OPUS_FRAME])))),
+  ];
+}
+
+function extract(demoPath, outputDirectory, options = {}) {
+  return addon.extractVoice(demoPath, { outputDirectory, codecDirectory: CODEC_DIRECTORY, ...options });
+}
+
+test('extractVoice decodes every player\'s voice messages', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: HEADER, info: INFO, frames: voiceFrames() });
+  const demoPath = writeFixture(dir, 'voice.dem', demo);
+
+  const result = await extract(demoPath, dir);
+  assert.equal(result.sampleRate, 48000);
+  assert.equal(result.messages, 3);
+  assert.deepEqual(result.players.map((player) => player.steamId), [PLAYER_A.toString(), PLAYER_B.toString()]);
+  assert.deepEqual(result.players.map((player) => player.segments), [2, 1]); // A's lines are a second apart
+  for (const player of result.players) {
+    assert.equal(player.error, undefined);
+    assert.ok(player.voicedSamples > 0);
+  }
+
+  assert.deepEqual(result.files.map((file) => file.steamId), result.players.map((player) => player.steamId));
+  for (const [i, file] of result.files.entries()) {
+    assert.equal(file.path, path.join(dir, `voice_${file.steamId}.wav`));
+    assert.equal(file.samples, result.players[i].voicedSamples);
+    assert.equal(fs.statSync(file.path).size, 44 + file.samples * 2);
+  }
+});
+
+test('extractVoice mixes onto the demo timeline and filters players', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: HEADER, info: INFO, frames: voiceFrames() });
+  const demoPath = writeFixture(dir, 'voice.dem', demo);
+
+  const mixed = await extract(demoPath, dir, { mode: 'single-full' });
+  assert.equal(mixed.files.length, 1);
+  assert.equal(mixed.files[0].path, path.join(dir, 'voice.wav'));
+  assert.equal(mixed.files[0].samples, 2 * 48000); // The demo's 128 ticks at 64 ticks/s
+  assert.equal(fs.statSync(mixed.files[0].path).size, 44 + mixed.files[0].samples * 2);
+
+  const onlyB = await extract(demoPath, dir, { steamIds: [PLAYER_B.toString()] });
+  assert.equal(onlyB.messages, 1);
+  assert.deepEqual(onlyB.players.map((player) => player.steamId), [PLAYER_B.toString()]);
+});
+
+test('extractVoice stops a packet at a message that overruns it', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const frames = [
+    // A counts; the next message claims 100 bytes with 3 left
+    demoFrame(DEMO_CMD_PACKET, 0, packet((w) => w
+      .message(SVC_VOICE_DATA, voiceMessage(PLAYER_A, [OPUS_FRAME]))
+      .ubitvar(SVC_VOICE_DATA).raw(varint(100)).raw([1, 2, 3]))),
+    // Size varint with every continuation bit set: nothing after it is read
+    demoFrame(DEMO_CMD_PACKET, 16, packet((w) => w
+      .ubitvar(NET_TICK).raw([0xff, 0xff, 0xff, 0xff, 0xff, 0x0f])
+      .message(SVC_VOICE_DATA, voiceMessage(PLAYER_B, [OPUS_FRAME])))),
+    // Audio without a xuid is skipped; B in a later packet still counts
+    demoFrame(DEMO_CMD_PACKET, 32, packet((w) => w
+      .message(SVC_VOICE_DATA, voiceMessage(0n, [OPUS_FRAME]))
+      .message(SVC_VOICE_DATA, voiceMessage(PLAYER_B, [OPUS_FRAME])))),
+  ];
+  const { demo } = buildDemo({ header: HEADER, info: INFO, frames });
+
+  const result = await extract(writeFixture(dir, 'overrun.dem', demo), dir);
+  assert.equal(result.messages, 2);
+  assert.deepEqual(result.players.map((player) => player.steamId), [PLAYER_A.toString(), PLAYER_B.toString()]);
+});
+
+test('extractVoice keeps the voice before a demo is cut off', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const frames = voiceFrames();
+  const { demo } = buildDemo({ header: HEADER, info: INFO, frames });
+  const headerLength = demoFrame(DEMO_CMD_FILE_HEADER, 0, HEADER).length;
+  const cut = 16 + headerLength + frames[0].length + 3; // Inside B's frame, long before the file info
+
+  const result = await extract(writeFixture(dir, 'cut.dem', demo.subarray(0, cut)), dir);
+  assert.equal(result.messages, 1);
+  assert.deepEqual(result.players.map((player) => player.steamId), [PLAYER_A.toString()]);
+  assert.equal(result.players[0].segments, 1);
+});
+
+test('extractVoice rejects demos it cannot read', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const { demo } = buildDemo({ header: HEADER, info: INFO, frames: voiceFrames() });
+  const notDemo = Buffer.from(demo);
+  notDemo.write('HL2DEMO\0', 0, 'latin1');
+
+  await assert.rejects(extract(writeFixture(dir, 'empty.dem', Buffer.alloc(0)), dir), { message: 'Empty demo file' });
+  await assert.rejects(extract(writeFixture(dir, 'csgo.dem', notDemo), dir), { message: 'Not a CS2 (PBDEMS2) demo' });
+  await assert.rejects(extract(writeFixture(dir, 'short.dem', demo.subarray(0, 20)), dir), { message: 'Missing demo file header' });
+  await assert.rejects(extract(writeFixture(dir, 'codec.dem', demo), dir, { codecDirectory: dir }), /Failed to load opus\.dll/);
+});
@@ -0,0 +1,181 @@
+// computeWaveformPeaks(): min/max/RMS pyramids from PCM and WAV files, checked
+// against a plain JS reduction so the SSE2 blocks and the scalar tails must agree.
+
+const { test } = require('node:test');
+const assert = require('node:assert/strict');
+const path = require('path');
+const { addon, skip, makeTempDir, writeFixture, buildWav } = require('./fixtures');
+
+// Deterministic full-range samples
+function noise(count, seed = 1) {
+  const samples = new Int16Array(count);
+  let state = seed;
+  for (let i = 0; i < count; i++) {
+    state = (Math.imul(state, 1103515245) + 12345) >>> 0;
+    samples[i] = (state >>> 16) - 32768;
+  }
+  return samples;
+}
+
+// What the addon should produce: level 0 over samplesPerPeak frames, then pairwise merges
+function referenceLevels(samples, channels, samplesPerPeak) {
+  const frames = Math.floor(samples.length / channels);
+  const block = samplesPerPeak * channels;
+  let level = { samplesPerPeak, peaks: [], sumSq: [], counts: [] };
+  for (let start = 0; start < frames * channels; start += block) {
+    const slice = samples.subarray(start, Math.min(start + block, frames * channels));
+    let min = 32767;
+    let max = -32768;
+    let sumSq = 0;
+    for (const sample of slice) {
+      min = Math.min(min, sample);
+      max = Math.max(max, sample);
+      sumSq += sample * sample;
+    }
+    level.peaks.push(min, max);
+    level.sumSq.push(sumSq);
+    level.counts.push(slice.length);
+  }
+
+  const levels = [level];
+  while (level.counts.length > 1) {
+    const next = { samplesPerPeak: level.samplesPerPeak * 2, peaks: [], sumSq: [], counts: [] };
+    for (let i = 0; i < level.counts.length; i += 2) {
+      const pair = i + 1 < level.counts.length;
+      next.peaks.push(pair ? Math.min(level.peaks[i * 2], level.peaks[i * 2 + 2]) : level.peaks[i * 2]);
+      next.peaks.push(pair ? Math.max(level.peaks[i * 2 + 1], level.peaks[i * 2 + 3]) : level.peaks[i * 2 + 1]);
+      next.sumSq.push(level.sumSq[i] + (pair ? level.sumSq[i + 1] : 0));
+      next.counts.push(level.counts[i] + (pair ? level.counts[i + 1] : 0));
+    }
+    levels.push(next);
+    level = next;
+  }
+  return levels.map((entry) => ({
+    samplesPerPeak: entry.samplesPerPeak,
+    peaks: entry.peaks,
+    rms: entry.sumSq.map((sumSq, i) => Math.fround(Math.sqrt(sumSq / entry.counts[i]) / 32768)),
+  }));
+}
+
+function assertLevels(result, expected) {
+  assert.equal(result.levels.length, expected.length);
+  result.levels.forEach((level, i) => {
+    assert.equal(level.samplesPerPeak, expected[i].samplesPerPeak, `level ${i}`);
+    assert.ok(level.peaks instanceof Int16Array);
+    assert.ok(level.rms instanceof Float32Array);
+    assert.deepEqual(Array.from(level.peaks), expected[i].peaks, `level ${i} peaks`);
+    assert.deepEqual(Array.from(level.rms), expected[i].rms, `level ${i} rms`);
+  });
+}
+
+// 16-bit little-endian bytes of `samples`
+function pcmBytes(samples) {
+  return Buffer.from(samples.buffer, samples.byteOffset, samples.byteLength);
+}
+
+test('computeWaveformPeaks reduces Int16Array PCM', { skip }, async () => {
+  // Blocks of 13 samples: one SSE2 pass of eight and a five-sample scalar tail,
+  // and a short last peak
+  const samples = noise(1000);
+  const result = await addon.computeWaveformPeaks(samples, { sampleRate: 8000, samplesPerPeak: 13 });
+  assert.equal(result.sampleRate, 8000);
+  assert.equal(result.channels, 1);
+  assert.equal(result.frames, 1000);
+  assert.equal(result.duration, 1000 / 8000);
+  assert.equal(result.levels[0].peaks.length, 2 * Math.ceil(1000 / 13));
+  assertLevels(result, referenceLevels(samples, 1, 13));
+});
+
+test('computeWaveformPeaks handles full-scale negative samples', { skip }, async () => {
+  // -32768 squared in both madd lanes is the one case that reaches 2^31
+  const samples = new Int16Array(64).fill(-32768);
+  const result = await addon.computeWaveformPeaks(samples, { samplesPerPeak: 16 });
+  assert.deepEqual(Array.from(result.levels[0].peaks), Array(8).fill(-32768));
+  assert.deepEqual(Array.from(result.levels[0].rms), [1, 1, 1, 1]);
+  assert.deepEqual(Array.from(result.levels.at(-1).rms), [1]);
+});
+
+test('computeWaveformPeaks honours channels, peakCount and levels', { skip }, async () => {
+  const samples = noise(2 * 4801 + 1, 7); // Stereo, plus a dangling half frame
+  const stereo = await addon.computeWaveformPeaks(samples, { channels: 2, sampleRate: 48000, samplesPerPeak: 100 });
+  assert.equal(stereo.frames, 4801);
+  assertLevels(stereo, referenceLevels(samples, 2, 100));
+
+  const sized = await addon.computeWaveformPeaks(samples, { channels: 2, peakCount: 10, levels: 2 });
+  assert.equal(sized.levels.length, 2);
+  assert.equal(sized.levels[0].samplesPerPeak, Math.ceil(4801 / 10));
+  assert.equal(sized.levels[0].rms.length, 10);
+  assert.equal(sized.levels[1].rms.length, 5);
+});
+
+test('computeWaveformPeaks converts Float32Array PCM', { skip }, async () => {
+  const samples = Float32Array.from([0.5, -0.5, 0.1, -0.1, 1.5, -2, 0, 0.999]);
+  const result = await addon.computeWaveformPeaks(samples, { samplesPerPeak: 2 });
+  // Scaled by 32768, clamped and truncated toward zero
+  const converted = Int16Array.from(samples, (value) => Math.trunc(Math.max(-32768, Math.min(32767, value * 32768))));
+  assertLevels(result, referenceLevels(converted, 1, 2));
+});
+
+test('computeWaveformPeaks reads WAV files', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const samples = noise(3000, 3);
+  const expected = referenceLevels(samples, 1, 64);
+
+  const pcm16 = writeFixture(dir, 'pcm16.wav', buildWav({ sampleRate: 16000, data: pcmBytes(samples),
+    extraChunks: [{ id: 'LIST', body: Buffer.from('odd') }] })); // Padded odd chunk before the data
+  const result = await addon.computeWaveformPeaks(pcm16, { samplesPerPeak: 64 });
+  assert.equal(result.sampleRate, 16000);
+  assert.equal(result.frames, 3000);
+  assertLevels(result, expected);
+
+  // 24-bit and float hold the same 16-bit samples
+  const pcm24 = Buffer.alloc(samples.length * 3);
+  const float = Buffer.alloc(samples.length * 4);
+  samples.forEach((sample, i) => {
+    pcm24.writeInt16LE(sample, i * 3 + 1);
+    float.writeFloatLE(sample / 32768, i * 4);
+  });
+  for (const [name, wav] of [
+    ['pcm24.wav', buildWav({ bitsPerSample: 24, data: pcm24 })],
+    ['float.wav', buildWav({ format: 3, bitsPerSample: 32, data: float })],
+  ]) {
+    assertLevels(await addon.computeWaveformPeaks(writeFixture(dir, name, wav), { samplesPerPeak: 64 }), expected);
+  }
+
+  const stereo = await addon.computeWaveformPeaks(
+    writeFixture(dir, 'stereo.wav', buildWav({ channels: 2, data: pcmBytes(samples) })), { samplesPerPeak: 64 });
+  assert.equal(stereo.channels, 2);
+  assert.equal(stereo.frames, 1500);
+  assertLevels(stereo, referenceLevels(samples, 2, 64));
+});
+
+test('computeWaveformPeaks reads what a truncated WAV still holds', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const samples = noise(4000, 5);
+  // The data chunk claims all 4000 samples; the file ends halfway through sample 2500
+  const wav = buildWav({ data: pcmBytes(samples).subarray(0, 2500 * 2 + 1), dataLength: samples.length * 2 });
+
+  const result = await addon.computeWaveformPeaks(writeFixture(dir, 'cut.wav', wav), { samplesPerPeak: 128 });
+  assert.equal(result.frames, 2500);
+  assertLevels(result, referenceLevels(samples.subarray(0, 2500), 1, 128));
+
+  // Header only: no samples, one empty level
+  const empty = await addon.computeWaveformPeaks(
+    writeFixture(dir, 'header-only.wav', buildWav({ data: Buffer.alloc(0), dataLength: 96000 })));
+  assert.equal(empty.frames, 0);
+  assert.equal(empty.levels.length, 1);
+  assert.equal(empty.levels[0].peaks.length, 0);
+});
+
+test('computeWaveformPeaks rejects files that are not WAVs', { skip }, async (t) => {
+  const dir = makeTempDir(t);
+  const wav = buildWav({ data: pcmBytes(noise(100)) });
+
+  await assert.rejects(addon.computeWaveformPeaks(writeFixture(dir, 'text.wav', 'not a wav')), { message: 'Not a RIFF/WAVE file' });
+  await assert.rejects(addon.computeWaveformPeaks(writeFixture(dir, 'short.wav', wav.subarray(0, 30))),
+    { message: 'WAV fmt/data chunk not found' });
+  await assert.rejects(addon.computeWaveformPeaks(writeFixture(dir, 'adpcm.wav', buildWav({ format: 2, data: Buffer.alloc(64) }))),
+    { message: 'Unsupported WAV format 2 (16-bit)' });
+  await assert.rejects(addon.computeWaveformPeaks(path.join(dir, 'missing.wav')), /Failed to open audio file\. Error code: 2/);
+  assert.throws(() => addon.computeWaveformPeaks(new Uint8Array(4)), TypeError);
+});
@@ -5,15 +5,29 @@
  * - Becomes interactive when cursor hovers over interactive UI regions
  * - Returns to click-through when cursor leaves
  * - Prevents overlay from disappearing during hover transitions
+ *
+ * On Windows the addon hit-tests the renderer's interactive regions natively and
+ * flips click-through itself; hover notifications then come from the addon, and
+ * the IPC hover path (with its grace period and safety delay) is only a fallback.
+ * The hit test then owns the window's click-through bit: go through
+ * setInteractiveMode() instead of calling setIgnoreMouseEvents() on the window.
  */
 
 import { BrowserWindow } from 'electron'
+import {
+  startOverlayHitTest,
+  setOverlayHitRegions,
+  setOverlayHitTestSuspended,
+  stopOverlayHitTest,
+} from './native-addon'
+import type { WindowBounds } from './native-addon'
 
 interface HoverState {
   isHovered: boolean
   hoverGraceUntil: number | null // Timestamp until which hover grace period is active (ms)
   clickThroughSafetyTimer: NodeJS.Timeout | null // Timer to delay re-enabling click-through
   needsFocusable: boolean // Whether we need focusable=true for clicks to work
+  nativeHitTest: boolean // Click-through is toggled by the addon's hit test
 }
 
 const HOVER_GRACE_PERIOD_MS = 300 // Grace period when hover becomes true
@@ -25,6 +39,7 @@ class OverlayHoverController {
     hoverGraceUntil: null,
     clickThroughSafetyTimer: null,
     needsFocusable: false, // Start with focusable=false, enable if clicks don't work
+    nativeHitTest: false,
   }
 
   private overlayWindow: BrowserWindow | null = null
@@ -33,13 +48,77 @@ class OverlayHoverController {
    * Set the overlay window to control
    */
   setOverlayWindow(window: BrowserWindow | null): void {
+    if (this.state.nativeHitTest) {
+      stopOverlayHitTest()
+      this.state.nativeHitTest = false
+    }
+    // A pending IPC-path re-enable must not touch the next window's style
+    if (this.state.clickThroughSafetyTimer) {
+      clearTimeout(this.state.clickThroughSafetyTimer)
+      this.state.clickThroughSafetyTimer = null
+    }
     this.overlayWindow = window
+    this.state.isHovered = false
+
+    if (window && !window.isDestroyed() && process.platform === 'win32') {
+      this.state.nativeHitTest = startOverlayHitTest(window.getNativeWindowHandle(), (hovered) => {
+        this.handleNativeHover(hovered)
+      })
+      console.log(`[OverlayHoverController] Native hit testing: ${this.state.nativeHitTest}`)
+    }
+  }
+
+  /**
+   * Update the interactive regions (overlay client area, CSS pixels) for native hit testing
+   * @param scaleFactor Renderer devicePixelRatio (regions are hit-tested in physical pixels)
+   */
+  setInteractiveRegions(regions: WindowBounds[], scaleFactor: number): void {
+    if (!this.state.nativeHitTest) {
+      return
+    }
+    setOverlayHitRegions(regions.map((region) => ({
+      x: region.x * scaleFactor,
+      y: region.y * scaleFactor,
+      width: region.width * scaleFactor,
+      height: region.height * scaleFactor,
+    })))
+  }
+
+  /**
+   * Fully interactive overlay (hotkey mode) or click-through outside the hover regions.
+   * With the native hit test running, that is its job (suspended while interactive);
+   * otherwise the window's ignore-mouse-events state is set here
+   */
+  setInteractiveMode(interactive: boolean): void {
+    if (this.state.nativeHitTest) {
+      setOverlayHitTestSuspended(interactive)
+      return
+    }
+    if (this.overlayWindow && !this.overlayWindow.isDestroyed()) {
+      this.overlayWindow.setIgnoreMouseEvents(!interactive, { forward: true })
+    }
+  }
+
+  /**
+   * Hover change from the native hit test (click-through is already switched)
+   */
+  private handleNativeHover(hovered: boolean): void {
+    if (this.state.isHovered === hovered) {
+      return
+    }
+    this.state.isHovered = hovered
+    console.log(`[OverlayHoverController] Native ${hovered ? 'hoverenter' : 'hoverleave'}`)
   }
 
   /**
    * Handle hover state change from renderer
    */
   async setHovered(hovered: boolean): Promise<void> {
+    // The native hit test is authoritative and has already switched click-through
+    if (this.state.nativeHitTest) {
+      return
+    }
+
     const wasHovered = this.state.isHovered
     
     // Only process if state actually changed
@@ -165,6 +244,10 @@ class OverlayHoverController {
       this.state.clickThroughSafetyTimer = null
     }
     this.state.hoverGraceUntil = null
+    if (this.state.nativeHitTest) {
+      stopOverlayHitTest()
+      this.state.nativeHitTest = false
+    }
     this.overlayWindow = null
   }
 }
@@ -142,10 +142,11 @@ contextBridge.exposeInMainWorld('electronAPI', {
   },
 
   // Listeners (return unsubscribe so callers can remove only their own listener)
-  onParserMessage: (callback: (message: string | { processId: string; message: string }) => void) => {
-    const wrapper = (_: unknown, message: string | { processId: string; message: string }) => callback(message)
-    ipcRenderer.on('parser:message', wrapper)
-    return () => ipcRenderer.removeListener('parser:message', wrapper)
+  // One call per batch of parser stdout records, already decoded
+  onParserMessages: (callback: (batch: { processId?: string; messages: Array<{ type: string; [key: string]: unknown }> }) => void) => {
+    const wrapper = (_: unknown, batch: { processId?: string; messages: Array<{ type: string; [key: string]: unknown }> }) => callback(batch)
+    ipcRenderer.on('parser:messages', wrapper)
+    return () => ipcRenderer.removeListener('parser:messages', wrapper)
   },
   onParserLog: (callback: (log: string) => void) => {
     const wrapper = (_: unknown, log: string) => callback(log)
@@ -178,6 +179,9 @@ contextBridge.exposeInMainWorld('electronAPI', {
   onDemosFileRemoved: (callback: (data: { filePath: string }) => void) => {
     ipcRenderer.on('demos:fileRemoved', (_, data) => callback(data))
   },
+  onDemosRescan: (callback: (data: { folderPath: string }) => void) => {
+    ipcRenderer.on('demos:rescan', (_, data) => callback(data))
+  },
 
   // Remove listeners
   removeAllListeners: (channel: string) => {
@@ -240,6 +244,8 @@ contextBridge.exposeInMainWorld('electronAPI', {
     sendIncident: (incident: any) => ipcRenderer.invoke('overlay:sendIncident', incident),
     setInteractiveRegionHovered: (hovered: boolean) => ipcRenderer.invoke('overlay:hovered', hovered),
     getInteractiveRegionHovered: () => ipcRenderer.invoke('overlay:getHovered'),
+    setInteractiveRegions: (regions: Array<{ x: number; y: number; width: number; height: number }>, scaleFactor: number) =>
+      ipcRenderer.invoke('overlay:interactiveRegions', regions, scaleFactor),
     onInteractive: (callback: (value: boolean) => void) => {
       ipcRenderer.on('overlay:interactiveChanged', (_, value) => callback(value))
     },
@@ -1,6 +1,7 @@
 import * as path from 'path'
 import * as fs from 'fs'
 import { app } from 'electron'
+import type { HookStats, ResourceSample } from './native-addon'
 const initSqlJs = require('sql.js')
 
 let statsDb: any = null
@@ -213,6 +214,53 @@ export function trackVoiceExtracted(durationMs: number, fileCount: number = 1):
   }
 }
 
+// Track overlay hook throughput/latency for one CS2 tracking session
+export function trackOverlaySession(hookStats: HookStats): void {
+  try {
+    incrementStat('overlay_sessions')
+    incrementStat('overlay_events_delivered', hookStats.delivered)
+    incrementStat('overlay_events_coalesced', hookStats.coalesced)
+    incrementStat('overlay_events_dropped', hookStats.dropped)
+
+    if (!hookStats.latency) {
+      return
+    }
+
+    // Keep the worst session's tail latencies so regressions stand out
+    const worstDeliveryCurrent = parseInt(getStat('overlay_worst_p99_delivery_us', '0'), 10)
+    if (hookStats.latency.delivery.p99Us > worstDeliveryCurrent) {
+      setStat('overlay_worst_p99_delivery_us', hookStats.latency.delivery.p99Us.toString())
+    }
+
+    const worstBoundsCurrent = parseInt(getStat('overlay_worst_p99_bounds_us', '0'), 10)
+    if (hookStats.latency.bounds.p99Us > worstBoundsCurrent) {
+      setStat('overlay_worst_p99_bounds_us', hookStats.latency.bounds.p99Us.toString())
+    }
+
+    setStat('overlay_last_p50_bounds_us', hookStats.latency.bounds.p50Us.toString())
+    setStat('overlay_last_p99_bounds_us', hookStats.latency.bounds.p99Us.toString())
+  } catch (err) {
+    console.error('Error tracking overlay session:', err)
+  }
+}
+
+// Track what one parser run or CS2 session cost, from the native resource sampler
+export function trackProcessResources(kind: 'parser' | 'cs2', sample: ResourceSample): void {
+  try {
+    const peakWorkingSet = Math.round(sample.peakWorkingSetBytes)
+    const worstPeakCurrent = parseInt(getStat(`${kind}_worst_peak_working_set_bytes`, '0'), 10)
+    if (peakWorkingSet > worstPeakCurrent) {
+      setStat(`${kind}_worst_peak_working_set_bytes`, peakWorkingSet.toString())
+    }
+
+    setStat(`${kind}_last_peak_working_set_bytes`, peakWorkingSet.toString())
+    setStat(`${kind}_last_cpu_time_ms`, Math.round(sample.cpuTimeMs).toString())
+    setStat(`${kind}_last_read_bytes`, Math.round(sample.readBytes).toString())
+  } catch (err) {
+    console.error('Error tracking process resources:', err)
+  }
+}
+
 // Get all stats
 export function getAllStats(): Record<string, number> {
   if (!statsDb) {
@@ -1,5 +1,6 @@
 import * as fs from 'fs'
 import type { TranscriptSegment, WhisperModelSize } from './transcriptionService'
+import { withMatchDbsClosed } from './native-addon'
 
 const initSqlJs = require('sql.js')
 
@@ -26,7 +27,8 @@ export async function ensureTranscriptTable(dbPath: string): Promise<void> {
   try {
     db.run(CREATE_TABLE_SQL)
     const data = db.export()
-    fs.writeFileSync(dbPath, Buffer.from(data))
+    // Pooled native readers keep the file mapped
+    withMatchDbsClosed([dbPath], () => fs.writeFileSync(dbPath, Buffer.from(data)))
   } finally {
     db.close()
   }
@@ -93,7 +95,8 @@ export async function saveTranscript(
       [steamId, audioFilename, model, language, JSON.stringify(segments), Date.now()]
     )
     const data = db.export()
-    fs.writeFileSync(dbPath, Buffer.from(data))
+    // Pooled native readers keep the file mapped
+    withMatchDbsClosed([dbPath], () => fs.writeFileSync(dbPath, Buffer.from(data)))
   } finally {
     db.close()
   }
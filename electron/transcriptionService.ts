@@ -4,6 +4,7 @@ import * as os from 'os'
 import * as crypto from 'crypto'
 import { spawn } from 'child_process'
 import { app } from 'electron'
+import { governProcess } from './native-addon'
 
 export type WhisperModelSize = 'tiny' | 'base' | 'small' | 'medium' | 'large'
 
@@ -283,6 +284,7 @@ async function findFileRecursive(dir: string, filename: string): Promise<string
 function runCommand(cmd: string, args: string[]): Promise<void> {
   return new Promise((resolve, reject) => {
     const proc = spawn(cmd, args)
+    governProcess(proc.pid)
     proc.on('close', (code) => {
       if (code === 0) resolve()
       else reject(new Error(`${cmd} exited with code ${code}`))
@@ -363,6 +365,8 @@ export async function transcribeAudio(
 
 function runWhisper(binary: string, args: string[], onProgress?: TranscribeProgressCallback): Promise<void> {
   return new Promise((resolve, reject) => {
+    // Not governed: at a 25% job cap and idle priority, a transcription started
+    // while CS2 has focus would barely progress
     const proc = spawn(binary, args, { stdio: ['ignore', 'pipe', 'pipe'] })
     const stderrChunks: string[] = []
     const startTime = Date.now()
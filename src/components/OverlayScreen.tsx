@@ -29,6 +29,8 @@ function OverlayScreen() {
   const [keyboardIcons, setKeyboardIcons] = useState<Map<string, string>>(new Map())
   const hoverDebounceTimer = useRef<NodeJS.Timeout | null>(null)
   const lastHoverState = useRef<boolean>(false)
+  const incidentRegionRef = useRef<HTMLDivElement | null>(null)
+  const debugRegionRef = useRef<HTMLDivElement | null>(null)
 
   // Debounced hover state update
   const updateHoverState = useCallback((hovered: boolean) => {
@@ -117,6 +119,37 @@ function OverlayScreen() {
     }
   }, [])
 
+  // Report interactive regions to the main process, which hit-tests them natively
+  // to toggle click-through (re-sent whenever a region appears, disappears or resizes)
+  useEffect(() => {
+    const regionElements = [incidentRegionRef.current, debugRegionRef.current]
+      .filter((element): element is HTMLDivElement => element !== null)
+    const reportRegions = () => {
+      if (!window.electronAPI?.overlay.setInteractiveRegions) {
+        return
+      }
+      const regions = regionElements.map((element) => {
+        const rect = element.getBoundingClientRect()
+        return { x: rect.left, y: rect.top, width: rect.width, height: rect.height }
+      })
+      window.electronAPI.overlay.setInteractiveRegions(regions, window.devicePixelRatio).catch(err => {
+        console.error('[OverlayScreen] Failed to set interactive regions:', err)
+      })
+    }
+
+    // Observing reports the initial size, so this also covers the first report
+    const observer = new ResizeObserver(reportRegions)
+    regionElements.forEach((element) => observer.observe(element))
+    if (regionElements.length === 0) {
+      reportRegions()
+    }
+    window.addEventListener('resize', reportRegions)
+    return () => {
+      observer.disconnect()
+      window.removeEventListener('resize', reportRegions)
+    }
+  }, [incident, debugMode])
+
   // When overlay has focus, Escape hides the overlay (so Escape is not used as global hotkey and game can use it to pause)
   useEffect(() => {
     const handleKeyDown = (e: KeyboardEvent) => {
@@ -268,6 +301,7 @@ function OverlayScreen() {
       {/* Events list or Incident panel - only visible when there's an incident; offset from top to avoid game menu */}
       {incident && (
         <div 
+          ref={incidentRegionRef}
           className={`absolute top-24 left-4 pointer-events-auto z-50 ${isHovered ? 'outline outline-2 outline-blue-500 outline-offset-2 rounded-lg' : ''}`}
           onMouseEnter={handleInteractiveRegionEnter}
           onMouseLeave={handleInteractiveRegionLeave}
@@ -295,6 +329,7 @@ function OverlayScreen() {
       {/* Debug command panel - top-right when debug mode is enabled */}
       {debugMode && (
         <div
+          ref={debugRegionRef}
           className={`absolute top-4 right-4 pointer-events-auto z-40 ${isHovered ? 'outline outline-2 outline-blue-500 outline-offset-2 rounded-lg' : ''}`}
           onMouseEnter={handleInteractiveRegionEnter}
           onMouseLeave={handleInteractiveRegionLeave}
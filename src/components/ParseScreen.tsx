@@ -1,6 +1,6 @@
 import { useState, useEffect, useRef } from 'react'
 import { Copy, Check } from 'lucide-react'
-import { parseNDJSONLine } from '../utils/ndjson'
+import type { ParsedMessage } from '../utils/ndjson'
 
 interface LogEntry {
   id: number
@@ -34,11 +34,7 @@ function ParseScreen() {
     if (!window.electronAPI) return
 
     // Set up IPC listeners
-    const handleMessage = (payload: string | { processId: string; message: string }) => {
-      const message = typeof payload === 'string' ? payload : payload.message
-      const parsed = parseNDJSONLine(message)
-      if (!parsed) return
-
+    const handleMessage = (parsed: ParsedMessage) => {
       if (parsed.type === 'progress') {
         setProgress({
           stage: (parsed.stage as string) || 'parsing',
@@ -64,6 +60,10 @@ function ParseScreen() {
       }
     }
 
+    const handleMessages = (batch: { messages: ParsedMessage[] }) => {
+      batch.messages.forEach(handleMessage)
+    }
+
     const handleLog = (log: string) => {
       addLog('info', log)
     }
@@ -82,7 +82,7 @@ function ParseScreen() {
       addLog('error', `Parser error: ${error}`)
     }
 
-    const unsubMessage = window.electronAPI.onParserMessage(handleMessage)
+    const unsubMessage = window.electronAPI.onParserMessages(handleMessages)
     const unsubLog = window.electronAPI.onParserLog(handleLog)
     const unsubExit = window.electronAPI.onParserExit(handleExit)
     const unsubError = window.electronAPI.onParserError(handleError)
@@ -1,6 +1,6 @@
 import { useState, useEffect, useRef } from 'react'
 import Modal from './Modal'
-import { parseNDJSONLine } from '../utils/ndjson'
+import type { ParsedMessage } from '../utils/ndjson'
 import { X } from 'lucide-react'
 import { t } from '../utils/translations'
 import { useParsingStatus } from '../contexts/ParsingStatusContext'
@@ -94,11 +94,7 @@ export default function ParsingModal({
     if (!window.electronAPI) return
 
     // Set up IPC listeners
-    const handleMessage = (payload: string | { processId: string; message: string }) => {
-      const message = typeof payload === 'string' ? payload : payload.message
-      const parsed = parseNDJSONLine(message)
-      if (!parsed) return
-
+    const handleMessage = (parsed: ParsedMessage) => {
       if (parsed.type === 'progress') {
         setProgress({
           stage: (parsed.stage as string) || 'parsing',
@@ -120,6 +116,10 @@ export default function ParsingModal({
       }
     }
 
+    const handleMessages = (batch: { messages: ParsedMessage[] }) => {
+      batch.messages.forEach(handleMessage)
+    }
+
     const handleLog = (log: string) => {
       addLog('info', log)
     }
@@ -186,7 +186,7 @@ export default function ParsingModal({
       // Keep modal open on error - don't auto-close
     }
 
-    const unsubMessage = window.electronAPI.onParserMessage(handleMessage)
+    const unsubMessage = window.electronAPI.onParserMessages(handleMessages)
     const unsubLog = window.electronAPI.onParserLog(handleLog)
     const unsubExit = window.electronAPI.onParserExit(handleExit)
     const unsubError = window.electronAPI.onParserError(handleError)
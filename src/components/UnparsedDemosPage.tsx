@@ -1,6 +1,7 @@
 import { useState, useEffect } from 'react'
 import { Loader2, Play, FolderOpen, Search } from 'lucide-react'
 import { t } from '../utils/translations'
+import { formatDuration } from '../utils/formatters'
 import Toast from './Toast'
 import ParsingModal from './ParsingModal'
 
@@ -9,6 +10,10 @@ interface UnparsedDemo {
   filePath: string
   fileSize: number
   createdAt: string
+  map?: string
+  serverName?: string
+  duration?: number
+  rounds?: number
 }
 
 function UnparsedDemosPage() {
@@ -53,10 +58,8 @@ function UnparsedDemosPage() {
     if (window.electronAPI?.onDemosFileAdded) {
       const unsubscribeAdded = window.electronAPI.onDemosFileAdded(({ filePath }) => {
         console.log('[UnparsedDemosPage] New demo file detected:', filePath)
-        // Refresh the list after a short delay (to allow file to be fully written)
-        setTimeout(() => {
-          fetchUnparsedDemos()
-        }, 1000)
+        // The watcher only reports demos that have finished writing
+        fetchUnparsedDemos()
       })
       
       const unsubscribeRemoved = window.electronAPI.onDemosFileRemoved(({ filePath }) => {
@@ -64,11 +67,17 @@ function UnparsedDemosPage() {
         // Refresh the list
         fetchUnparsedDemos()
       })
+
+      window.electronAPI.onDemosRescan(({ folderPath }) => {
+        console.log('[UnparsedDemosPage] Watcher missed changes, rescanning:', folderPath)
+        fetchUnparsedDemos()
+      })
       
       return () => {
         if (window.electronAPI) {
           window.electronAPI.removeAllListeners('demos:fileAdded')
           window.electronAPI.removeAllListeners('demos:fileRemoved')
+          window.electronAPI.removeAllListeners('demos:rescan')
         }
       }
     }
@@ -76,8 +85,10 @@ function UnparsedDemosPage() {
 
   // Filter and sort demos
   useEffect(() => {
+    const query = searchQuery.toLowerCase()
     let filtered = demos.filter((demo) =>
-      demo.fileName.toLowerCase().includes(searchQuery.toLowerCase())
+      demo.fileName.toLowerCase().includes(query) ||
+      (demo.map?.toLowerCase().includes(query) ?? false)
     )
 
     filtered.sort((a, b) => {
@@ -277,6 +288,13 @@ function UnparsedDemosPage() {
                     <div className="text-white font-mono text-sm truncate" title={demo.fileName}>
                       {demo.fileName}
                     </div>
+                    {(demo.map || demo.duration) && (
+                      <div className="text-gray-500 text-xs truncate" title={demo.serverName}>
+                        {[demo.map, demo.duration ? formatDuration(demo.duration) : null, demo.serverName]
+                          .filter(Boolean)
+                          .join(' · ')}
+                      </div>
+                    )}
                   </div>
                   <div className="col-span-2 text-gray-400 text-sm">{formatFileSize(demo.fileSize)}</div>
                   <div className="col-span-3 text-gray-400 text-sm">{formatDate(demo.createdAt)}</div>
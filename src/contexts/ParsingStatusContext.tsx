@@ -6,7 +6,7 @@ import {
   useEffect,
   ReactNode,
 } from 'react'
-import { parseNDJSONLine } from '../utils/ndjson'
+import type { ParsedMessage } from '../utils/ndjson'
 
 export interface ParsingProgress {
   stage: string
@@ -92,11 +92,7 @@ export function ParsingStatusProvider({ children }: { children: ReactNode }) {
       setShowParsingPanel(false)
     }
 
-    const handleMessage = (payload: string | { processId: string; message: string }) => {
-      const message = typeof payload === 'string' ? payload : payload.message
-      const parsed = parseNDJSONLine(message)
-      if (!parsed) return
-
+    const handleMessage = (parsed: ParsedMessage) => {
       if (parsed.type === 'progress') {
         const progress: ParsingProgress = {
           stage: (parsed.stage as string) || 'parsing',
@@ -117,6 +113,10 @@ export function ParsingStatusProvider({ children }: { children: ReactNode }) {
       }
     }
 
+    const handleMessages = (batch: { messages: ParsedMessage[] }) => {
+      batch.messages.forEach(handleMessage)
+    }
+
     const handleExit = (data: { code: number | null; signal: string | null; processId?: string }) => {
       setState((prev) => ({
         ...prev,
@@ -131,7 +131,7 @@ export function ParsingStatusProvider({ children }: { children: ReactNode }) {
     }
 
     const unsubStarted = window.electronAPI.onParserStarted(handleStarted)
-    const unsubMessage = window.electronAPI.onParserMessage(handleMessage)
+    const unsubMessage = window.electronAPI.onParserMessages(handleMessages)
     const unsubExit = window.electronAPI.onParserExit(handleExit)
 
     return () => {
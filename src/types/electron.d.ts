@@ -15,7 +15,7 @@ export interface ElectronAPI {
   parseDemo: (args: { demoPath: string }) => Promise<{ matchId: string; dbPath: string }>
   stopParser: () => Promise<void>
   listMatches: () => Promise<Array<{ id: string; map: string; startedAt: string | null; playerCount: number; demoPath: string | null; isMissingDemo?: boolean; createdAtIso?: string | null; source?: string | null; buildNum?: number | null }>>
-  getUnparsedDemos: () => Promise<Array<{ fileName: string; filePath: string; fileSize: number; createdAt: string }>>
+  getUnparsedDemos: () => Promise<Array<{ fileName: string; filePath: string; fileSize: number; createdAt: string; map?: string; serverName?: string; duration?: number; rounds?: number }>>
   getMatchSummary: (matchId: string) => Promise<{ matchId: string; players: any[] }>
   getMatchPlayers: (matchId: string) => Promise<{ matchId: string; players: Array<{ steamId: string; name: string }> }>
   getMatchEvents: (matchId: string, filters?: { type?: string; steamid?: string; victimSteamId?: string; round?: number }) => Promise<any>
@@ -140,7 +140,7 @@ export interface ElectronAPI {
   }) => void) => void
   showItemInFolder: (filePath: string) => Promise<void>
   onDemoOpen: (callback: (filePath: string) => void) => () => void
-  onParserMessage: (callback: (message: string | { processId: string; message: string }) => void) => () => void
+  onParserMessages: (callback: (batch: { processId?: string; messages: Array<{ type: string; [key: string]: unknown }> }) => void) => () => void
   onParserLog: (callback: (log: string) => void) => () => void
   onParserExit: (callback: (data: { code: number | null; signal: string | null; processId?: string }) => void) => () => void
   onParserStarted: (callback: (data: { matchId: string; demoPath: string }) => void) => () => void
@@ -148,6 +148,7 @@ export interface ElectronAPI {
   onParserError: (callback: (error: string) => void) => () => void
   onDemosFileAdded: (callback: (data: { filePath: string }) => void) => void
   onDemosFileRemoved: (callback: (data: { filePath: string }) => void) => void
+  onDemosRescan: (callback: (data: { folderPath: string }) => void) => void
   onMatchesCleanup: (callback: (data: { deleted: number; details: Array<{ matchId: string; reason: string }> }) => void) => void
   onMatchesTrimmed: (callback: (data: { deleted: number; details: Array<{ matchId: string; reason: string }> }) => void) => void
   onMatchesList: (callback: (matches: Array<{ id: string; map: string; startedAt: string | null; playerCount: number; demoPath: string | null; isMissingDemo?: boolean; createdAtIso?: string | null; source?: string | null; buildNum?: number | null }>) => void) => void
@@ -175,6 +176,7 @@ export interface ElectronAPI {
     isVisible: () => Promise<boolean>
     setInteractiveRegionHovered: (hovered: boolean) => Promise<void>
     getInteractiveRegionHovered: () => Promise<boolean>
+    setInteractiveRegions: (regions: Array<{ x: number; y: number; width: number; height: number }>, scaleFactor: number) => Promise<void>
     onInteractive: (callback: (value: boolean) => void) => void
     onIncident: (callback: (incident: Incident | null) => void) => void
     onActionResult: (callback: (result: { success: boolean; action: string; player?: string; error?: string; clearLoadingOnly?: boolean }) => void) => void